@@ -0,0 +1,241 @@
+#ifndef BATCH_MODEL_H_INCLUDED
+#define BATCH_MODEL_H_INCLUDED
+
+#include <memory>
+#include <vector>
+
+#include "batch/batch_layers.h"
+#include "model_loader.h"
+
+namespace RTNeural
+{
+
+/**
+ *  A dynamic sequential neural network model, which processes
+ *  a batch of independent streams at once.
+ *
+ *  This is intended for offline processing of many signals through
+ *  the same (large) model: at each step, every layer processes all
+ *  the streams with one matrix multiply, rather than one matrix-vector
+ *  multiply per stream.
+ *
+ *  Instances of this class should typically be created with
+ *  `json_parser::parseJsonBatch`.
+ */
+template <typename T>
+class BatchModel
+{
+public:
+    /** Constructs a batch model for a given input size and maximum number of streams. */
+    BatchModel(int in_size, int max_batch_size)
+        : in_size(in_size)
+        , max_batch_size(max_batch_size)
+        , ins((size_t)max_batch_size * in_size, (T)0)
+        , active(new bool[(size_t)max_batch_size])
+    {
+        std::fill(active.get(), active.get() + max_batch_size, true);
+    }
+
+    /** Destructor. */
+    ~BatchModel()
+    {
+        for(auto l : layers)
+            delete l;
+        layers.clear();
+    }
+
+    /** Returns the model's input size */
+    int getInSize() const { return in_size; }
+
+    /** Returns the model's output size */
+    int getOutSize() const { return layers.back()->out_size; }
+
+    /** Returns the maximum number of streams that can be processed at once. */
+    int getMaxBatchSize() const { return max_batch_size; }
+
+    /** Returns the required input size for the next layer being added to the network. */
+    int getNextInSize() const
+    {
+        if(layers.empty())
+            return in_size;
+
+        return layers.back()->out_size;
+    }
+
+    /** Adds a new layer to the sequential model. */
+    void addLayer(BatchLayer<T>* layer)
+    {
+        layers.push_back(layer);
+        outs.push_back(vec_type((size_t)max_batch_size * layer->out_size, (T)0));
+    }
+
+    /** Resets the state of every stream in the network. */
+    void reset()
+    {
+        for(auto* l : layers)
+            l->reset();
+    }
+
+    /**
+     * Performs one step of forward propagation for a batch of streams.
+     *
+     * The input must have size input[batch_size][in_size], and the returned
+     * outputs have size output[batch_size][out_size]. Streams that are marked
+     * as inactive keep their state from the previous step.
+     */
+    inline const T* forward(const T* input, int batch_size, const bool* streamActive = nullptr) noexcept
+    {
+        layers[0]->forward(input, outs[0].data(), batch_size, streamActive);
+
+        for(int i = 1; i < (int)layers.size(); ++i)
+            layers[i]->forward(outs[i - 1].data(), outs[i].data(), batch_size, streamActive);
+
+        return outs.back().data();
+    }
+
+    /**
+     * Processes a set of independent sequences from the start, resetting
+     * the model state beforehand. Sequences may have different lengths.
+     *
+     * `inputs[s]` must contain `lengths[s] * in_size` interleaved samples, and
+     * `outputs[s]` must have space for `lengths[s] * out_size` samples.
+     * If there are more sequences than the maximum batch size, the sequences
+     * are processed in groups.
+     */
+    void process(const T* const* inputs, T* const* outputs, const int* lengths, int num_sequences)
+    {
+        const auto out_size = getOutSize();
+        for(int s0 = 0; s0 < num_sequences; s0 += max_batch_size)
+        {
+            const auto batch_size = std::min(max_batch_size, num_sequences - s0);
+            const auto max_length = *std::max_element(lengths + s0, lengths + s0 + batch_size);
+
+            reset();
+            for(int n = 0; n < max_length; ++n)
+            {
+                for(int b = 0; b < batch_size; ++b)
+                {
+                    const auto s = s0 + b;
+                    active[b] = n < lengths[s];
+                    if(active[b])
+                        std::copy(inputs[s] + n * in_size, inputs[s] + (n + 1) * in_size, ins.begin() + b * in_size);
+                    else
+                        std::fill(ins.begin() + b * in_size, ins.begin() + (b + 1) * in_size, (T)0);
+                }
+
+                const auto* y = forward(ins.data(), batch_size, active.get());
+
+                for(int b = 0; b < batch_size; ++b)
+                    if(active[b])
+                        std::copy(y + b * out_size, y + (b + 1) * out_size, outputs[s0 + b] + n * out_size);
+            }
+        }
+    }
+
+    /** A vector storing the network layers in sequential order. */
+    std::vector<BatchLayer<T>*> layers;
+
+private:
+    using vec_type = std::vector<T>;
+
+    const int in_size;
+    const int max_batch_size;
+    std::vector<vec_type> outs;
+
+    vec_type ins;
+    std::unique_ptr<bool[]> active;
+};
+
+namespace json_parser
+{
+    /**
+     * Creates a batch neural network model from a json stream.
+     * Returns nullptr if the model has layers that the batch model does not support.
+     */
+    template <typename T>
+    std::unique_ptr<BatchModel<T>> parseJsonBatch(const nlohmann::json& parent, int max_batch_size, const bool debug = false)
+    {
+        auto shape = parent.at("in_shape");
+        auto layers = parent.at("layers");
+
+        if(!shape.is_array() || !layers.is_array())
+            return {};
+
+        const int nDims = shape.size() == 4 ? shape[2].get<int>() * shape[3].get<int>() : shape.back().get<int>();
+
+        debug_print("# dimensions: " + std::to_string(nDims), debug);
+
+        auto model = std::make_unique<BatchModel<T>>(nDims, max_batch_size);
+
+        for(const auto& l : layers)
+        {
+            const auto type = l.at("type").get<std::string>();
+            debug_print("Layer: " + type, debug);
+
+            const auto layerShape = l.at("shape");
+            const int layerDims = layerShape.size() == 4 ? layerShape[2].get<int>() * layerShape[3].get<int>() : layerShape.back().get<int>();
+
+            debug_print("  Dims: " + std::to_string(layerDims), debug);
+
+            const auto weights = l.at("weights");
+
+            auto add_activation = [=](std::unique_ptr<BatchModel<T>>& _model, const nlohmann::json& _l)
+            {
+                if(_l.contains("activation"))
+                {
+                    const auto activationType = _l["activation"].get<std::string>();
+                    if(!activationType.empty())
+                    {
+                        debug_print("  activation: " + activationType, debug);
+                        auto activation = createActivation<T>(activationType, layerDims);
+                        _model->addLayer(new StatelessBatchLayer<T>(activation.release(), max_batch_size));
+                    }
+                }
+            };
+
+            if(type == "dense" || type == "time-distributed-dense")
+            {
+                auto dense = std::make_unique<DenseBatch<T>>(model->getNextInSize(), layerDims, max_batch_size);
+                loadDense<T>(*dense, weights);
+                model->addLayer(dense.release());
+                add_activation(model, l);
+            }
+            else if(type == "lstm")
+            {
+                if(isCIFG(l))
+                {
+                    debug_print("CIFG LSTM layers are not supported!", debug);
+                    return {};
+                }
+
+                auto lstm = std::make_unique<LSTMLayerBatch<T>>(model->getNextInSize(), layerDims, max_batch_size);
+                loadLSTM<T>(*lstm, weights);
+                model->addLayer(lstm.release());
+            }
+            else if(type == "activation")
+            {
+                add_activation(model, l);
+            }
+            else
+            {
+                debug_print("Unsupported layer type: " + type, debug);
+                return {};
+            }
+        }
+
+        return model;
+    }
+
+    /** Creates a batch neural network model from a json stream. */
+    template <typename T>
+    std::unique_ptr<BatchModel<T>> parseJsonBatch(std::ifstream& jsonStream, int max_batch_size, const bool debug = false)
+    {
+        nlohmann::json parent;
+        jsonStream >> parent;
+        return parseJsonBatch<T>(parent, max_batch_size, debug);
+    }
+} // namespace json_parser
+
+} // namespace RTNeural
+
+#endif // BATCH_MODEL_H_INCLUDED
@@ -0,0 +1,527 @@
+#ifndef BOUNDED_MODEL_H_INCLUDED
+#define BOUNDED_MODEL_H_INCLUDED
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#include "model_loader.h"
+
+namespace RTNeural
+{
+
+#ifndef DOXYGEN
+namespace bounded_detail
+{
+    /** Returns the smallest power of 2 (of at least 4) that is >= size. */
+    constexpr int getBucket(int size)
+    {
+        return size <= 4 ? 4 : 2 * getBucket((size + 1) / 2);
+    }
+
+    /** Rounds a number of elements up to a multiple of the default alignment. */
+    template <typename T>
+    constexpr int alignSize(int size)
+    {
+        return ceil_div(size, (int)std::max(RTNEURAL_DEFAULT_ALIGNMENT / (int)sizeof(T), 1)) * std::max(RTNEURAL_DEFAULT_ALIGNMENT / (int)sizeof(T), 1);
+    }
+
+    template <typename T>
+    using KernelType = void (*)(const T* weights, T* state, const T* ins, T* outs, int in_size);
+
+    // scalar activations, which (unlike RTNeural::sigmoid()) are available with every backend
+    template <typename T>
+    inline T sigmoid_scalar(T x) noexcept
+    {
+        return (T)1 / ((T)1 + std::exp(-x));
+    }
+
+    template <typename T>
+    inline void softmax_scalar(T* x, int size) noexcept
+    {
+        T exp_sum = 0;
+        for(int i = 0; i < size; ++i)
+        {
+            x[i] = std::exp(x[i]);
+            exp_sum += x[i];
+        }
+
+        const auto exp_sum_recip = (T)1 / exp_sum;
+        for(int i = 0; i < size; ++i)
+            x[i] *= exp_sum_recip;
+    }
+
+    /**
+     * Dense kernel, with the outputs padded to P.
+     * weights: bias[P], then W[in_size][P] (column-major, so that each input is accumulated into all of the outputs).
+     */
+    template <typename T, int P>
+    void denseKernel(const T* weights, T*, const T* ins, T* outs, int in_size) noexcept
+    {
+        T sums alignas(RTNEURAL_DEFAULT_ALIGNMENT)[P];
+        std::copy(weights, weights + P, sums);
+
+        const auto* W = weights + P;
+        for(int k = 0; k < in_size; ++k)
+        {
+            const auto x = ins[k];
+            const auto* w = W + k * P;
+            for(int i = 0; i < P; ++i)
+                sums[i] += w[i] * x;
+        }
+
+        std::copy(sums, sums + P, outs);
+    }
+
+    /**
+     * LSTM kernel, with the hidden state padded to P.
+     * weights: bias[4P], then W[in_size][4P], then U[P][4P], with the gates ordered i, f, c, o.
+     * state: h[P], then c[P].
+     */
+    template <typename T, int P>
+    void lstmKernel(const T* weights, T* state, const T* ins, T* outs, int in_size) noexcept
+    {
+        T z alignas(RTNEURAL_DEFAULT_ALIGNMENT)[4 * P];
+        std::copy(weights, weights + 4 * P, z);
+
+        const auto* W = weights + 4 * P;
+        for(int k = 0; k < in_size; ++k)
+        {
+            const auto x = ins[k];
+            const auto* w = W + k * 4 * P;
+            for(int j = 0; j < 4 * P; ++j)
+                z[j] += w[j] * x;
+        }
+
+        auto* h = state;
+        auto* c = state + P;
+        const auto* U = W + in_size * 4 * P;
+        for(int k = 0; k < P; ++k)
+        {
+            const auto x = h[k];
+            const auto* u = U + k * 4 * P;
+            for(int j = 0; j < 4 * P; ++j)
+                z[j] += u[j] * x;
+        }
+
+        for(int j = 0; j < P; ++j)
+        {
+            const auto i = sigmoid_scalar(z[j]);
+            const auto f = sigmoid_scalar(z[P + j]);
+            const auto g = std::tanh(z[2 * P + j]);
+            const auto o = sigmoid_scalar(z[3 * P + j]);
+            c[j] = f * c[j] + i * g;
+            h[j] = o * std::tanh(c[j]);
+        }
+
+        std::copy(h, h + P, outs);
+    }
+
+    /** Layers with no kernel (standalone activations) copy their inputs. */
+    template <typename T>
+    void copyKernel(const T*, T*, const T* ins, T* outs, int in_size) noexcept
+    {
+        std::copy(ins, ins + in_size, outs);
+    }
+
+    /** Selects the kernel for the smallest bucket that fits the layer. */
+    template <typename T, int P, int maxP, bool isLast = (P >= maxP)>
+    struct KernelSelector
+    {
+        static KernelType<T> dense(int bucket) noexcept
+        {
+            return bucket <= P ? &denseKernel<T, P> : KernelSelector<T, 2 * P, maxP>::dense(bucket);
+        }
+
+        static KernelType<T> lstm(int bucket) noexcept
+        {
+            return bucket <= P ? &lstmKernel<T, P> : KernelSelector<T, 2 * P, maxP>::lstm(bucket);
+        }
+    };
+
+    template <typename T, int P, int maxP>
+    struct KernelSelector<T, P, maxP, true>
+    {
+        static KernelType<T> dense(int) noexcept { return &denseKernel<T, P>; }
+        static KernelType<T> lstm(int) noexcept { return &lstmKernel<T, P>; }
+    };
+
+    enum class ActivationType
+    {
+        None,
+        Tanh,
+        ReLu,
+        Sigmoid,
+        Softmax,
+        ELu,
+    };
+
+    inline bool getActivationType(const std::string& name, ActivationType& type)
+    {
+        if(name.empty())
+            type = ActivationType::None;
+        else if(name == "tanh")
+            type = ActivationType::Tanh;
+        else if(name == "relu")
+            type = ActivationType::ReLu;
+        else if(name == "sigmoid")
+            type = ActivationType::Sigmoid;
+        else if(name == "softmax")
+            type = ActivationType::Softmax;
+        else if(name == "elu")
+            type = ActivationType::ELu;
+        else
+            return false;
+
+        return true;
+    }
+
+    template <typename T>
+    void applyActivation(ActivationType type, T* x, int size) noexcept
+    {
+        switch(type)
+        {
+            case ActivationType::None:
+                break;
+            case ActivationType::Tanh:
+                for(int i = 0; i < size; ++i)
+                    x[i] = std::tanh(x[i]);
+                break;
+            case ActivationType::ReLu:
+                for(int i = 0; i < size; ++i)
+                    x[i] = std::max(x[i], (T)0);
+                break;
+            case ActivationType::Sigmoid:
+                for(int i = 0; i < size; ++i)
+                    x[i] = sigmoid_scalar(x[i]);
+                break;
+            case ActivationType::Softmax:
+                softmax_scalar(x, size);
+                break;
+            case ActivationType::ELu:
+                for(int i = 0; i < size; ++i)
+                    x[i] = x[i] > (T)0 ? x[i] : (std::exp(x[i]) - (T)1);
+                break;
+        }
+    }
+} // namespace bounded_detail
+#endif // DOXYGEN
+
+/**
+ *  A model with runtime shapes, stored in fixed-capacity in-object storage.
+ *
+ *  `BoundedModel` sits between `Model<T>` and `ModelT`: like `Model<T>`, the
+ *  layer types and sizes are read from the model json at load time, so any
+ *  model that fits within the limits can be loaded; like `ModelT`, all of the
+ *  weights and state live in fixed, aligned arrays inside the object, and
+ *  nothing is allocated after construction (including when loading weights).
+ *
+ *  The outputs of each layer are padded to a power-of-2 "bucket" (4, 8, 16,
+ *  ..., up to `max_size`), and each layer runs a kernel specialized on its
+ *  bucket, which is selected when the model is loaded. The padded weights
+ *  are zero, so the padded outputs are always zero.
+ *
+ *  Supported layers are `dense` and `lstm`, and the `tanh`, `relu`, `sigmoid`,
+ *  `softmax` and `elu` activations. Each layer (and its activation) counts as
+ *  one of the `max_layers`, except standalone activation layers that follow a
+ *  layer without an activation, which are fused into that layer.
+ *
+ *  With the default `max_weights`, the model has space for `max_layers` LSTM
+ *  layers of `max_size`, which can be large (~1 MB for 64 x 8 floats), so the
+ *  model should usually be allocated on the heap, or `max_weights` reduced:
+ *  ```
+ *  auto model = std::make_unique<BoundedModel<float, 64, 8>>();
+ *  if(!model->parseJson(modelJson))
+ *      return; // the model does not fit!
+ *  ```
+ */
+template <typename T, int max_size, int max_layers,
+    int max_weights = max_layers * bounded_detail::alignSize<T>(4 * bounded_detail::getBucket(max_size) * (1 + max_size + bounded_detail::getBucket(max_size)))>
+class BoundedModel
+{
+public:
+    static constexpr auto max_bucket = bounded_detail::getBucket(max_size);
+
+    BoundedModel()
+    {
+        std::fill(std::begin(weights), std::end(weights), (T)0);
+        std::fill(std::begin(state), std::end(state), (T)0);
+        std::fill(std::begin(ins), std::end(ins), (T)0);
+        for(auto& layerOuts : outs)
+            std::fill(std::begin(layerOuts), std::end(layerOuts), (T)0);
+    }
+
+    /**
+     * Loads the model from its json representation, and resets its state.
+     * Returns false if the model contains an unsupported layer,
+     * or does not fit in the capacity of this model type. In that case,
+     * no model is loaded, so `getNumLayers()` and `getOutSize()` return 0.
+     */
+    bool parseJson(const nlohmann::json& parent, const bool debug = false)
+    {
+        if(!loadLayers(parent, debug))
+        {
+            num_layers = 0;
+            in_size = 0;
+            return false;
+        }
+
+        reset();
+        return true;
+    }
+
+    /** Resets the state of the model. */
+    void reset()
+    {
+        std::fill(std::begin(state), std::end(state), (T)0);
+    }
+
+    /** Performs forward propagation for this model. */
+    inline T forward(const T* input) noexcept
+    {
+        std::copy(input, input + in_size, ins);
+
+        const T* layerIns = ins;
+        for(int l = 0; l < num_layers; ++l)
+        {
+            const auto& layer = layers[l];
+            layer.kernel(weights + layer.weightsOffset, state + l * 2 * max_bucket, layerIns, outs[l], layer.in_size);
+            bounded_detail::applyActivation(layer.activation, outs[l], layer.out_size);
+            layerIns = outs[l];
+        }
+
+        return layerIns[0];
+    }
+
+    /** Returns a pointer to the outputs of the model (of size `getOutSize()`). */
+    inline const T* getOutputs() const noexcept { return num_layers > 0 ? outs[num_layers - 1] : ins; }
+
+    /** Returns the input size of the loaded model. */
+    int getInSize() const noexcept { return in_size; }
+
+    /** Returns the output size of the loaded model. */
+    int getOutSize() const noexcept { return num_layers > 0 ? layers[num_layers - 1].out_size : 0; }
+
+    /** Returns the number of layers in the loaded model (with activations fused). */
+    int getNumLayers() const noexcept { return num_layers; }
+
+    /** Returns the number of weights used by the loaded model (including padding). */
+    int getNumWeightsUsed() const noexcept { return weightsUsed; }
+
+private:
+    /** Loads the layers of the model, and returns false if the model can't be loaded. */
+    bool loadLayers(const nlohmann::json& parent, const bool debug)
+    {
+        using namespace json_parser;
+
+        num_layers = 0;
+        weightsUsed = 0;
+        in_size = 0;
+        std::fill(std::begin(weights), std::end(weights), (T)0);
+
+        const auto shape = parent.at("in_shape");
+        const auto json_layers = parent.at("layers");
+        if(!shape.is_array() || !json_layers.is_array())
+            return false;
+
+        in_size = shape.back().get<int>();
+        if(in_size <= 0 || in_size > max_size)
+        {
+            debug_print("Model input size does not fit! Max: " + std::to_string(max_size), debug);
+            return false;
+        }
+
+        for(const auto& l : json_layers)
+        {
+            const auto type = l.at("type").get<std::string>();
+            const auto layerDims = l.at("shape").back().get<int>();
+            const auto activationName = l.contains("activation") ? l["activation"].get<std::string>() : std::string {};
+            debug_print("Layer: " + type, debug);
+            debug_print("  Dims: " + std::to_string(layerDims), debug);
+
+            bounded_detail::ActivationType activation;
+            if(!bounded_detail::getActivationType(activationName, activation))
+            {
+                debug_print("Unsupported activation: " + activationName, debug);
+                return false;
+            }
+
+            if(type == "activation")
+            {
+                // fuse into the previous layer if possible
+                if(num_layers > 0 && layers[num_layers - 1].activation == bounded_detail::ActivationType::None)
+                {
+                    layers[num_layers - 1].activation = activation;
+                    continue;
+                }
+
+                if(!addLayer(LayerType::Activation, getNextInSize(), layerDims, activation, debug))
+                    return false;
+
+                continue;
+            }
+
+            if(type == "dense" || type == "time-distributed-dense")
+            {
+                if(!addLayer(LayerType::Dense, getNextInSize(), layerDims, activation, debug))
+                    return false;
+
+                loadDenseWeights(layers[num_layers - 1], l.at("weights"));
+            }
+            else if(type == "lstm")
+            {
+                if(isCIFG(l))
+                {
+                    debug_print("CIFG LSTM layers are not supported!", debug);
+                    return false;
+                }
+
+                if(!addLayer(LayerType::LSTM, getNextInSize(), layerDims, activation, debug))
+                    return false;
+
+                loadLSTMWeights(layers[num_layers - 1], l.at("weights"));
+            }
+            else
+            {
+                debug_print("Unsupported layer type: " + type, debug);
+                return false;
+            }
+        }
+
+        return num_layers > 0;
+    }
+
+    enum class LayerType
+    {
+        Dense,
+        LSTM,
+        Activation,
+    };
+
+    struct LayerInfo
+    {
+        LayerType type = LayerType::Dense;
+        int in_size = 0;
+        int out_size = 0;
+        int bucket = 0;
+        int weightsOffset = 0;
+        bounded_detail::ActivationType activation = bounded_detail::ActivationType::None;
+        bounded_detail::KernelType<T> kernel = nullptr;
+    };
+
+    int getNextInSize() const noexcept
+    {
+        return num_layers == 0 ? in_size : layers[num_layers - 1].out_size;
+    }
+
+    bool addLayer(LayerType type, int layer_in_size, int layer_out_size, bounded_detail::ActivationType activation, bool debug)
+    {
+        using namespace json_parser;
+        using Selector = bounded_detail::KernelSelector<T, 4, max_bucket>;
+
+        if(num_layers == max_layers)
+        {
+            debug_print("Model has too many layers! Max: " + std::to_string(max_layers), debug);
+            return false;
+        }
+
+        if(layer_out_size <= 0 || layer_out_size > max_size)
+        {
+            debug_print("Layer size does not fit! Max: " + std::to_string(max_size), debug);
+            return false;
+        }
+
+        auto& layer = layers[num_layers];
+        layer.type = type;
+        layer.in_size = layer_in_size;
+        layer.out_size = layer_out_size;
+        layer.bucket = bounded_detail::getBucket(layer_out_size);
+        layer.activation = activation;
+        layer.weightsOffset = weightsUsed;
+
+        int numWeights = 0;
+        if(type == LayerType::Dense)
+        {
+            numWeights = layer.bucket * (1 + layer_in_size);
+            layer.kernel = Selector::dense(layer.bucket);
+        }
+        else if(type == LayerType::LSTM)
+        {
+            numWeights = 4 * layer.bucket * (1 + layer_in_size + layer.bucket);
+            layer.kernel = Selector::lstm(layer.bucket);
+        }
+        else
+        {
+            layer.kernel = &bounded_detail::copyKernel<T>;
+        }
+
+        numWeights = bounded_detail::alignSize<T>(numWeights);
+        if(weightsUsed + numWeights > max_weights)
+        {
+            debug_print("Model has too many weights! Max: " + std::to_string(max_weights), debug);
+            return false;
+        }
+
+        weightsUsed += numWeights;
+        num_layers++;
+        return true;
+    }
+
+    void loadDenseWeights(const LayerInfo& layer, const nlohmann::json& json_weights)
+    {
+        const auto P = layer.bucket;
+        auto* w = weights + layer.weightsOffset;
+
+        const auto bias = json_weights.at(1);
+        for(int i = 0; i < layer.out_size; ++i)
+            w[i] = bias.at((size_t)i).get<T>();
+
+        const auto kernel = json_weights.at(0);
+        for(int k = 0; k < layer.in_size; ++k)
+        {
+            for(int i = 0; i < layer.out_size; ++i)
+                w[P + k * P + i] = kernel.at((size_t)k).at((size_t)i).get<T>();
+        }
+    }
+
+    void loadLSTMWeights(const LayerInfo& layer, const nlohmann::json& json_weights)
+    {
+        const auto P = layer.bucket;
+        const auto out_size = layer.out_size;
+        auto* w = weights + layer.weightsOffset;
+
+        // json gate blocks are [i, f, c, o] of out_size each, the padded gate blocks are P each
+        auto loadGates = [&](T* dest, const nlohmann::json& src)
+        {
+            for(int g = 0; g < 4; ++g)
+            {
+                for(int j = 0; j < out_size; ++j)
+                    dest[g * P + j] = src.at((size_t)(g * out_size + j)).get<T>();
+            }
+        };
+
+        loadGates(w, json_weights.at(2));
+
+        const auto kernel = json_weights.at(0);
+        for(int k = 0; k < layer.in_size; ++k)
+            loadGates(w + 4 * P + k * 4 * P, kernel.at((size_t)k));
+
+        const auto recurrent = json_weights.at(1);
+        for(int k = 0; k < out_size; ++k)
+            loadGates(w + 4 * P * (1 + layer.in_size) + k * 4 * P, recurrent.at((size_t)k));
+    }
+
+    LayerInfo layers[max_layers];
+    int num_layers = 0;
+    int in_size = 0;
+    int weightsUsed = 0;
+
+    T weights alignas(RTNEURAL_DEFAULT_ALIGNMENT)[max_weights];
+    T state alignas(RTNEURAL_DEFAULT_ALIGNMENT)[max_layers * 2 * max_bucket];
+    T ins alignas(RTNEURAL_DEFAULT_ALIGNMENT)[max_bucket];
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[max_layers][max_bucket];
+};
+
+} // namespace RTNeural
+
+#endif // BOUNDED_MODEL_H_INCLUDED
@@ -0,0 +1,194 @@
+#ifndef CASCADE_MODEL_H_INCLUDED
+#define CASCADE_MODEL_H_INCLUDED
+
+#include <algorithm>
+#include <vector>
+
+namespace RTNeural
+{
+
+/**
+ *  An early-exit cascade of two classifier models.
+ *
+ *  At each step the small model is run first, and its outputs
+ *  (typically the output of a SoftmaxActivation) are returned if
+ *  the largest output is at least the confidence threshold. Otherwise
+ *  the step "escalates" to the large model, and its outputs are returned.
+ *
+ *  The small model runs at every step, so its state is always current.
+ *  The large model only runs on escalation. To keep any recurrent state in
+ *  the large model consistent, the inputs of the steps it has skipped are
+ *  kept in a history buffer, and replayed through the large model before
+ *  the escalated step. If more steps were skipped than the history can hold,
+ *  the large model is reset and warmed up with the history instead. For
+ *  stateless large models, a history length of zero may be used.
+ *
+ *  The model types may be `Model<T>` or `ModelT<...>`, or anything else with
+ *  `reset()`, `forward(const T*)` and `getOutputs()` methods. The cascade
+ *  does not own the models.
+ *  ```
+ *  CascadeModel<float, SmallModelType, LargeModelType> cascade { small, large, in_size, num_classes, 0.9f, 64 };
+ *  cascade.reset();
+ *  const float* probabilities = cascade.forward(input);
+ *  ```
+ */
+template <typename T, typename SmallModelType, typename LargeModelType>
+class CascadeModel
+{
+public:
+    /**
+     * Constructs a cascade for two models with the same input and output sizes.
+     *
+     * @param threshold         Confidence below which a step is escalated to the large model.
+     * @param history_length    Number of skipped steps that can be replayed through the large model.
+     */
+    CascadeModel(SmallModelType& smallModel, LargeModelType& largeModel, int in_size, int num_classes, T threshold, int history_length)
+        : in_size(in_size)
+        , num_classes(num_classes)
+        , history_length(history_length)
+        , smallModel(smallModel)
+        , largeModel(largeModel)
+        , threshold(threshold)
+        , history((size_t)std::max(history_length, 1) * in_size, (T)0)
+    {
+    }
+
+    /** Sets the confidence below which a step is escalated to the large model. */
+    void setThreshold(T newThreshold) noexcept { threshold = newThreshold; }
+
+    /** Returns the confidence threshold. */
+    T getThreshold() const noexcept { return threshold; }
+
+    /** Resets the state of both models, and the escalation statistics. */
+    void reset()
+    {
+        smallModel.reset();
+        largeModel.reset();
+        skipped = 0;
+        historyWrite = 0;
+        resetStats();
+    }
+
+    /** Resets the escalation statistics. */
+    void resetStats() noexcept
+    {
+        numSteps = 0;
+        numEscalations = 0;
+        numLargeSteps = 0;
+    }
+
+    /**
+     * Performs forward propagation for one step of the cascade,
+     * and returns the outputs of whichever model made the decision.
+     */
+    inline const T* forward(const T* input) noexcept
+    {
+        numSteps++;
+
+        smallModel.forward(input);
+        const auto* smallOuts = smallModel.getOutputs();
+        lastConfidence = *std::max_element(smallOuts, smallOuts + num_classes);
+        lastEscalated = lastConfidence < threshold;
+
+        if(!lastEscalated)
+        {
+            pushHistory(input);
+            return smallOuts;
+        }
+
+        numEscalations++;
+        catchUpLargeModel();
+
+        largeModel.forward(input);
+        numLargeSteps++;
+        return largeModel.getOutputs();
+    }
+
+    /** Returns the index of the class with the largest output from the most recent step. */
+    int getPrediction() const noexcept
+    {
+        const auto* outs = lastEscalated ? largeModel.getOutputs() : smallModel.getOutputs();
+        return (int)(std::max_element(outs, outs + num_classes) - outs);
+    }
+
+    /** Returns true if the most recent step was escalated to the large model. */
+    bool wasEscalated() const noexcept { return lastEscalated; }
+
+    /** Returns the small model's confidence for the most recent step. */
+    T getConfidence() const noexcept { return lastConfidence; }
+
+    /** Returns the number of steps processed since the last reset. */
+    size_t getNumSteps() const noexcept { return numSteps; }
+
+    /** Returns the number of steps escalated to the large model since the last reset. */
+    size_t getNumEscalations() const noexcept { return numEscalations; }
+
+    /** Returns the number of steps run by the large model (including replayed steps) since the last reset. */
+    size_t getNumLargeModelSteps() const noexcept { return numLargeSteps; }
+
+    /** Returns the fraction of steps that were escalated to the large model. */
+    double getEscalationRate() const noexcept
+    {
+        return numSteps == 0 ? 0.0 : (double)numEscalations / (double)numSteps;
+    }
+
+    const int in_size;
+    const int num_classes;
+    const int history_length;
+
+private:
+    /** Stores the input for a step that the large model has skipped. */
+    void pushHistory(const T* input) noexcept
+    {
+        // more than history_length skipped steps can't be replayed anyway,
+        // so the count saturates there instead of overflowing on long streams
+        skipped = std::min(skipped + 1, history_length + 1);
+        if(history_length == 0)
+            return;
+
+        std::copy(input, input + in_size, history.begin() + historyWrite * in_size);
+        historyWrite = (historyWrite + 1) % history_length;
+    }
+
+    /** Replays the skipped steps through the large model, oldest first. */
+    void catchUpLargeModel() noexcept
+    {
+        if(skipped == 0)
+            return;
+
+        if(skipped > history_length)
+        {
+            largeModel.reset();
+            skipped = history_length;
+        }
+
+        auto readIdx = (historyWrite + history_length - skipped) % std::max(history_length, 1);
+        for(int i = 0; i < skipped; ++i)
+        {
+            largeModel.forward(history.data() + readIdx * in_size);
+            readIdx = (readIdx + 1) % history_length;
+        }
+
+        numLargeSteps += (size_t)skipped;
+        skipped = 0;
+    }
+
+    SmallModelType& smallModel;
+    LargeModelType& largeModel;
+    T threshold;
+
+    std::vector<T> history; // [history_length][in_size]
+    int historyWrite = 0;
+    int skipped = 0;
+
+    bool lastEscalated = false;
+    T lastConfidence = (T)0;
+
+    size_t numSteps = 0;
+    size_t numEscalations = 0;
+    size_t numLargeSteps = 0;
+};
+
+} // namespace RTNeural
+
+#endif // CASCADE_MODEL_H_INCLUDED
@@ -0,0 +1,800 @@
+#ifndef GRAPH_MODEL_H_INCLUDED
+#define GRAPH_MODEL_H_INCLUDED
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "model_loader.h"
+
+namespace RTNeural
+{
+
+#ifndef DOXYGEN
+namespace graph_detail
+{
+    /**
+     * A pool of persistent worker threads, which can run a batch of tasks,
+     * with the calling thread also running tasks. The threads are created
+     * up front, so running a batch of tasks does not allocate memory.
+     *
+     * The calling (audio) thread never locks a mutex or waits on a condition
+     * variable: the tasks are claimed from an atomic counter, and the caller
+     * spins until the tasks that were claimed by the workers are done. The
+     * workers sleep between batches, and since the caller does not take the
+     * mutex to wake them, a worker may miss a batch, in which case the caller
+     * runs more of the tasks itself.
+     */
+    class WorkerPool
+    {
+    public:
+        explicit WorkerPool(int num_workers)
+        {
+            for(int i = 0; i < num_workers; ++i)
+                threads.emplace_back([this]
+                    { workerLoop(); });
+        }
+
+        ~WorkerPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            startCondition.notify_all();
+
+            for(auto& thread : threads)
+                thread.join();
+        }
+
+        /** Runs fn(0), ..., fn(num_tasks - 1), and returns when all of the tasks are done. */
+        template <typename Fn>
+        void run(int num_tasks, Fn& fn)
+        {
+            if(threads.empty() || num_tasks <= 1)
+            {
+                for(int t = 0; t < num_tasks; ++t)
+                    fn(t);
+                return;
+            }
+
+            // the tasks from the previous batch are all done, so no worker is reading these
+            taskContext = &fn;
+            taskCall = [](void* context, int t)
+            { (*static_cast<Fn*>(context))(t); };
+            doneTasks.store(0, std::memory_order_relaxed);
+            tasks.store((uint64_t)num_tasks << 32, std::memory_order_release);
+
+            generation.fetch_add(1, std::memory_order_release);
+            startCondition.notify_all();
+
+            runTasks();
+
+            while(doneTasks.load(std::memory_order_acquire) < num_tasks)
+                ;
+        }
+
+    private:
+        /** Claims and runs tasks until there are none left in the current batch. */
+        void runTasks()
+        {
+            auto claim = tasks.load(std::memory_order_acquire);
+            for(;;)
+            {
+                // the task count is in the upper 32 bits, and the next task in the lower 32 bits
+                const auto t = (int)(claim & 0xffffffffu);
+                if(t >= (int)(claim >> 32))
+                    return;
+
+                if(!tasks.compare_exchange_weak(claim, claim + 1, std::memory_order_acquire))
+                    continue;
+
+                taskCall(taskContext, t);
+                doneTasks.fetch_add(1, std::memory_order_release);
+                claim = tasks.load(std::memory_order_acquire);
+            }
+        }
+
+        void workerLoop()
+        {
+            size_t lastGeneration = 0;
+            for(;;)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    startCondition.wait(lock, [this, lastGeneration]
+                        { return stopping || generation.load(std::memory_order_acquire) != lastGeneration; });
+
+                    if(stopping)
+                        return;
+
+                    lastGeneration = generation.load(std::memory_order_acquire);
+                }
+
+                runTasks();
+            }
+        }
+
+        std::vector<std::thread> threads;
+        std::mutex mutex;
+        std::condition_variable startCondition;
+
+        void* taskContext = nullptr;
+        void (*taskCall)(void*, int) = nullptr;
+        std::atomic<uint64_t> tasks { 0 };
+        std::atomic<int> doneTasks { 0 };
+        std::atomic<size_t> generation { 0 };
+        bool stopping = false;
+    };
+} // namespace graph_detail
+#endif // DOXYGEN
+
+/** The types of node in a GraphModel. */
+enum class GraphNodeType
+{
+    Layers, // a chain of layers (with the inputs concatenated)
+    Add, // element-wise sum of the inputs
+    Multiply, // element-wise product of the inputs
+    Concat, // concatenation of the inputs
+};
+
+/**
+ *  A dynamic model with a directed acyclic graph of nodes.
+ *
+ *  Each node is either a chain of layers, or a merge (add, multiply, or
+ *  concatenate) of the outputs of other nodes, so that multi-branch,
+ *  residual, and multi-input models can be loaded at runtime. Instances
+ *  of this class should typically be created with `json_parser::parseGraphJson`.
+ *
+ *  When the model is compiled, the nodes are sorted into levels, where the
+ *  nodes in each level only depend on the nodes in earlier levels. The
+ *  buffers holding the outputs of the nodes are planned from the lifetime
+ *  of each output, so a buffer is reused once all of the nodes that read it
+ *  have run, and an add/multiply node writes its output in place into the
+ *  buffer of its first input if no other node reads that input.
+ *
+ *  With `processBlock()`, each node runs over a block of samples at a time,
+ *  and the independent nodes in each level can run on separate worker
+ *  threads (see `setNumThreads()`).
+ */
+template <typename T>
+class GraphModel
+{
+public:
+    GraphModel() = default;
+
+    /** Adds an input to the graph. Returns the ID of the input value. */
+    int addInput(int size)
+    {
+        values.push_back({ size, -1 });
+        inputs.push_back((int)values.size() - 1);
+        return (int)values.size() - 1;
+    }
+
+    /**
+     * Adds a node with a chain of layers, and returns the ID of its output value.
+     * If the node has several inputs, they are concatenated.
+     */
+    int addLayersNode(const std::vector<int>& inputIDs, std::vector<std::unique_ptr<Layer<T>>> layers)
+    {
+        Node node;
+        node.type = GraphNodeType::Layers;
+        node.inputs = inputIDs;
+        node.layers = std::move(layers);
+        return addNode(std::move(node), node.layers.empty() ? 0 : node.layers.back()->out_size);
+    }
+
+    /**
+     * Adds a merge (add, multiply, or concat) node, and returns the ID of its output value.
+     * The inputs of an add or multiply node must all have the same size, otherwise
+     * no node is added, and this returns -1.
+     */
+    int addMergeNode(GraphNodeType type, const std::vector<int>& inputIDs)
+    {
+        Node node;
+        node.type = type;
+        node.inputs = inputIDs;
+
+        int size = 0;
+        for(auto id : inputIDs)
+        {
+            const auto inputSize = values[(size_t)id].size;
+            if(type != GraphNodeType::Concat && size > 0 && inputSize != size)
+                return -1;
+
+            size = type == GraphNodeType::Concat ? size + inputSize : inputSize;
+        }
+
+        return addNode(std::move(node), size);
+    }
+
+    /** Marks a value as an output of the graph. The outputs are concatenated in the order that they are added. */
+    void addOutput(int valueID)
+    {
+        outputs.push_back(valueID);
+    }
+
+    /**
+     * Plans the execution of the graph, for blocks of up to `max_block_size` samples.
+     * Must be called after the graph is built, and before processing.
+     */
+    void compile(int max_block_size = 1)
+    {
+        maxBlockSize = std::max(max_block_size, 1);
+        computeLevels();
+        planBuffers();
+        allocate();
+    }
+
+    /** Sets the number of threads used by `processBlock()` (including the calling thread). */
+    void setNumThreads(int num_threads)
+    {
+        workerPool.reset();
+        if(num_threads > 1)
+            workerPool = std::make_unique<graph_detail::WorkerPool>(num_threads - 1);
+    }
+
+    /** Resets the state of the layers in the graph. */
+    void reset()
+    {
+        for(auto& node : nodes)
+            for(auto& layer : node.layers)
+                layer->reset();
+    }
+
+    /** Performs forward propagation for this model, for the (concatenated) inputs. */
+    inline T forward(const T* input)
+    {
+        writeInputs(input, 1);
+        for(const auto& level : levels)
+        {
+            for(auto nodeIdx : level)
+                runNode(nodes[(size_t)nodeIdx], 1);
+        }
+        readOutputs(outs.data(), 1);
+
+        return outs[0];
+    }
+
+    /** Returns a pointer to the (concatenated) outputs of the model. */
+    inline const T* getOutputs() const noexcept { return outs.data(); }
+
+    /**
+     * Processes a block of samples, with input[num_samples][in_size] and output[num_samples][out_size].
+     * Each node runs over up to `max_block_size` samples at a time.
+     */
+    void processBlock(const T* input, T* output, int num_samples)
+    {
+        for(int start = 0; start < num_samples; start += maxBlockSize)
+        {
+            const auto n = std::min(maxBlockSize, num_samples - start);
+            writeInputs(input + start * in_size, n);
+
+            for(const auto& level : levels)
+            {
+                auto runLevelNode = [this, &level, n](int t)
+                { runNode(nodes[(size_t)level[(size_t)t]], n); };
+
+                if(workerPool != nullptr)
+                    workerPool->run((int)level.size(), runLevelNode);
+                else
+                    for(int t = 0; t < (int)level.size(); ++t)
+                        runLevelNode(t);
+            }
+
+            readOutputs(output + start * out_size, n);
+        }
+
+        if(num_samples > 0)
+            std::copy(output + (num_samples - 1) * out_size, output + num_samples * out_size, outs.begin());
+    }
+
+    /** Returns the total size of the inputs of the graph. */
+    int getInSize() const noexcept { return in_size; }
+
+    /** Returns the total size of the outputs of the graph. */
+    int getOutSize() const noexcept { return out_size; }
+
+    /** Returns the size of a value in the graph. */
+    int getValueSize(int valueID) const noexcept { return values[(size_t)valueID].size; }
+
+    /** Returns the number of nodes in the graph. */
+    int getNumNodes() const noexcept { return (int)nodes.size(); }
+
+    /** Returns the number of levels of independent nodes in the graph. */
+    int getNumLevels() const noexcept { return (int)levels.size(); }
+
+    /** Returns the number of buffers used to hold the values in the graph. */
+    int getNumBuffers() const noexcept { return (int)buffers.size(); }
+
+    /** Returns true if the node writes its output in place, into the buffer of its first input. */
+    bool isInPlace(int nodeIdx) const noexcept { return nodes[(size_t)nodeIdx].inPlace; }
+
+private:
+    struct Value
+    {
+        int size = 0;
+        int producer = -1; // -1 for graph inputs
+        int buffer = -1;
+        int numConsumers = 0;
+    };
+
+    struct Node
+    {
+        GraphNodeType type = GraphNodeType::Layers;
+        std::vector<int> inputs;
+        int output = -1;
+        int level = 0;
+        bool inPlace = false;
+
+        std::vector<std::unique_ptr<Layer<T>>> layers;
+        std::vector<T> concatScratch;
+        std::vector<T> scratch[2];
+    };
+
+    struct Buffer
+    {
+        int capacity = 0;
+        size_t offset = 0;
+        int numUsers = 0;
+    };
+
+    int addNode(Node&& node, int size)
+    {
+        for(auto id : node.inputs)
+            values[(size_t)id].numConsumers++;
+
+        values.push_back({ size, (int)nodes.size() });
+        node.output = (int)values.size() - 1;
+        nodes.push_back(std::move(node));
+        return (int)values.size() - 1;
+    }
+
+    /** Sorts the nodes into levels: each node runs one level after the latest of its inputs. */
+    void computeLevels()
+    {
+        levels.clear();
+        for(size_t i = 0; i < nodes.size(); ++i)
+        {
+            auto& node = nodes[i];
+            node.level = 0;
+            for(auto id : node.inputs)
+            {
+                const auto producer = values[(size_t)id].producer;
+                if(producer >= 0)
+                    node.level = std::max(node.level, nodes[(size_t)producer].level + 1);
+            }
+
+            if(node.level >= (int)levels.size())
+                levels.resize((size_t)node.level + 1);
+            levels[(size_t)node.level].push_back((int)i);
+        }
+    }
+
+    int acquireBuffer(int size)
+    {
+        // use the smallest free buffer that is big enough, or grow the largest free buffer
+        int best = -1;
+        for(int b = 0; b < (int)buffers.size(); ++b)
+        {
+            const auto& buffer = buffers[(size_t)b];
+            if(buffer.numUsers > 0)
+                continue;
+
+            if(best < 0)
+            {
+                best = b;
+                continue;
+            }
+
+            const auto& bestBuffer = buffers[(size_t)best];
+            const auto fits = buffer.capacity >= size;
+            const auto bestFits = bestBuffer.capacity >= size;
+            if((fits && (!bestFits || buffer.capacity < bestBuffer.capacity)) || (!fits && !bestFits && buffer.capacity > bestBuffer.capacity))
+                best = b;
+        }
+
+        if(best < 0)
+        {
+            buffers.push_back({});
+            best = (int)buffers.size() - 1;
+        }
+
+        auto& buffer = buffers[(size_t)best];
+        buffer.capacity = std::max(buffer.capacity, size);
+        buffer.numUsers = 1;
+        return best;
+    }
+
+    void assignBuffer(Value& value, int buffer)
+    {
+        value.buffer = buffer;
+        buffers[(size_t)buffer].numUsers++;
+    }
+
+    void releaseBuffer(const Value& value)
+    {
+        buffers[(size_t)value.buffer].numUsers--;
+    }
+
+    bool isOutput(int valueID) const
+    {
+        return std::find(outputs.begin(), outputs.end(), valueID) != outputs.end();
+    }
+
+    /** Assigns a buffer to each value, reusing the buffers of values that are no longer needed. */
+    void planBuffers()
+    {
+        buffers.clear();
+        std::vector<int> remainingConsumers;
+        for(auto& value : values)
+            remainingConsumers.push_back(value.numConsumers);
+
+        auto releaseIfDone = [&](int valueID)
+        {
+            if(remainingConsumers[(size_t)valueID] == 0 && !isOutput(valueID))
+                releaseBuffer(values[(size_t)valueID]);
+        };
+
+        for(auto id : inputs)
+            values[(size_t)id].buffer = acquireBuffer(values[(size_t)id].size);
+        for(auto id : inputs)
+            releaseIfDone(id);
+
+        for(const auto& level : levels)
+        {
+            for(auto nodeIdx : level)
+            {
+                auto& node = nodes[(size_t)nodeIdx];
+                auto& output = values[(size_t)node.output];
+
+                // an add/multiply node can accumulate into its first input, if nothing else reads it
+                const auto first = node.inputs.empty() ? -1 : node.inputs.front();
+                node.inPlace = (node.type == GraphNodeType::Add || node.type == GraphNodeType::Multiply)
+                               && first >= 0 && values[(size_t)first].producer >= 0
+                               && values[(size_t)first].numConsumers == 1 && !isOutput(first);
+
+                if(node.inPlace)
+                    assignBuffer(output, values[(size_t)first].buffer);
+                else
+                    output.buffer = acquireBuffer(output.size);
+            }
+
+            // nodes in the same level may run concurrently, so buffers are only released at the end of the level
+            for(auto nodeIdx : level)
+            {
+                const auto& node = nodes[(size_t)nodeIdx];
+                for(auto id : node.inputs)
+                {
+                    remainingConsumers[(size_t)id]--;
+                    releaseIfDone(id);
+                }
+
+                if(values[(size_t)node.output].numConsumers == 0)
+                    releaseIfDone(node.output);
+            }
+        }
+    }
+
+    void allocate()
+    {
+        constexpr auto alignment = std::max(RTNEURAL_DEFAULT_ALIGNMENT / (int)sizeof(T), 1);
+
+        size_t arenaSize = 0;
+        for(auto& buffer : buffers)
+        {
+            buffer.offset = arenaSize;
+            arenaSize += (size_t)(ceil_div(buffer.capacity * maxBlockSize, alignment) * alignment);
+        }
+        arena.assign(arenaSize, (T)0);
+
+        for(auto& node : nodes)
+        {
+            if(node.type != GraphNodeType::Layers)
+                continue;
+
+            int concatSize = 0;
+            for(auto id : node.inputs)
+                concatSize += values[(size_t)id].size;
+            node.concatScratch.assign(node.inputs.size() > 1 ? (size_t)concatSize : 0, (T)0);
+
+            int maxLayerSize = 0;
+            for(const auto& layer : node.layers)
+                maxLayerSize = std::max(maxLayerSize, layer->out_size);
+            node.scratch[0].assign((size_t)maxLayerSize, (T)0);
+            node.scratch[1].assign((size_t)maxLayerSize, (T)0);
+        }
+
+        in_size = 0;
+        for(auto id : inputs)
+            in_size += values[(size_t)id].size;
+
+        out_size = 0;
+        for(auto id : outputs)
+            out_size += values[(size_t)id].size;
+        outs.assign((size_t)out_size, (T)0);
+    }
+
+    /** Returns the data for a value, at sample n of the current block. */
+    inline T* getValue(int valueID, int n) noexcept
+    {
+        const auto& buffer = buffers[(size_t)values[(size_t)valueID].buffer];
+        return arena.data() + buffer.offset + (size_t)(n * buffer.capacity);
+    }
+
+    void writeInputs(const T* input, int num_samples) noexcept
+    {
+        for(int n = 0; n < num_samples; ++n)
+        {
+            const auto* x = input + n * in_size;
+            for(auto id : inputs)
+            {
+                const auto size = values[(size_t)id].size;
+                std::copy(x, x + size, getValue(id, n));
+                x += size;
+            }
+        }
+    }
+
+    void readOutputs(T* output, int num_samples) noexcept
+    {
+        for(int n = 0; n < num_samples; ++n)
+        {
+            auto* y = output + n * out_size;
+            for(auto id : outputs)
+            {
+                const auto size = values[(size_t)id].size;
+                const auto* value = getValue(id, n);
+                std::copy(value, value + size, y);
+                y += size;
+            }
+        }
+    }
+
+    void runNode(Node& node, int num_samples) noexcept
+    {
+        const auto outSize = values[(size_t)node.output].size;
+        for(int n = 0; n < num_samples; ++n)
+        {
+            auto* out = getValue(node.output, n);
+            switch(node.type)
+            {
+                case GraphNodeType::Layers:
+                {
+                    const T* in = getValue(node.inputs[0], n);
+                    if(node.inputs.size() > 1)
+                    {
+                        in = node.concatScratch.data();
+                        concatInputs(node, n, node.concatScratch.data());
+                    }
+
+                    const auto numLayers = node.layers.size();
+                    for(size_t l = 0; l < numLayers; ++l)
+                    {
+                        auto* layerOut = l + 1 == numLayers ? out : node.scratch[l % 2].data();
+                        node.layers[l]->forward(in, layerOut);
+                        in = layerOut;
+                    }
+                    break;
+                }
+                case GraphNodeType::Add:
+                case GraphNodeType::Multiply:
+                {
+                    if(!node.inPlace)
+                    {
+                        const auto* in = getValue(node.inputs[0], n);
+                        std::copy(in, in + outSize, out);
+                    }
+
+                    for(size_t i = 1; i < node.inputs.size(); ++i)
+                    {
+                        const auto* in = getValue(node.inputs[i], n);
+                        if(node.type == GraphNodeType::Add)
+                            for(int k = 0; k < outSize; ++k)
+                                out[k] += in[k];
+                        else
+                            for(int k = 0; k < outSize; ++k)
+                                out[k] *= in[k];
+                    }
+                    break;
+                }
+                case GraphNodeType::Concat:
+                    concatInputs(node, n, out);
+                    break;
+            }
+        }
+    }
+
+    void concatInputs(const Node& node, int n, T* out) noexcept
+    {
+        for(auto id : node.inputs)
+        {
+            const auto size = values[(size_t)id].size;
+            const auto* in = getValue(id, n);
+            std::copy(in, in + size, out);
+            out += size;
+        }
+    }
+
+    std::vector<Value> values;
+    std::vector<Node> nodes;
+    std::vector<int> inputs;
+    std::vector<int> outputs;
+
+    std::vector<std::vector<int>> levels;
+    std::vector<Buffer> buffers;
+    std::vector<T> arena;
+    std::vector<T> outs;
+
+    int in_size = 0;
+    int out_size = 0;
+    int maxBlockSize = 1;
+
+    std::unique_ptr<graph_detail::WorkerPool> workerPool;
+};
+
+namespace json_parser
+{
+    /**
+     * Creates a graph model from a json representation of the graph:
+     * ```
+     * {
+     *   "inputs": [ { "name": "audio", "shape": [null, null, 1] }, ... ],
+     *   "nodes": [
+     *     { "name": "a", "inputs": ["audio"], "layers": [ ... ] },
+     *     { "name": "b", "type": "add", "inputs": ["a", "audio"] },  // or "multiply", "concat"
+     *     ...
+     *   ],
+     *   "outputs": ["b"]
+     * }
+     * ```
+     * Nodes may be listed in any order. If "inputs" is missing, the graph has one input
+     * named "input", with size from "in_shape". If "outputs" is missing, the output is the
+     * last node. A sequential model json (with "layers" and no "nodes") is loaded as a
+     * graph with a single chain of layers. Returns nullptr if the graph is not valid.
+     */
+    template <typename T>
+    std::unique_ptr<GraphModel<T>> parseGraphJson(const nlohmann::json& parent, int max_block_size = 1, const bool debug = false)
+    {
+        auto getSize = [](const nlohmann::json& shape)
+        { return shape.size() == 4 ? shape[2].get<int>() * shape[3].get<int>() : shape.back().get<int>(); };
+
+        auto graph = std::make_unique<GraphModel<T>>();
+        std::map<std::string, int> valueIDs;
+
+        if(parent.contains("inputs"))
+        {
+            for(const auto& input : parent.at("inputs"))
+                valueIDs[input.at("name").get<std::string>()] = graph->addInput(getSize(input.at("shape")));
+        }
+        else
+        {
+            valueIDs["input"] = graph->addInput(getSize(parent.at("in_shape")));
+        }
+
+        nlohmann::json nodes;
+        if(parent.contains("nodes"))
+        {
+            nodes = parent.at("nodes");
+        }
+        else
+        {
+            nlohmann::json node;
+            node["name"] = "output";
+            node["inputs"] = { "input" };
+            node["layers"] = parent.at("layers");
+            nodes = nlohmann::json::array({ node });
+        }
+
+        // add the nodes in topological order: each node is added once all of its inputs exist
+        std::vector<bool> added(nodes.size(), false);
+        std::string lastNode;
+        for(size_t numAdded = 0; numAdded < nodes.size();)
+        {
+            bool progress = false;
+            for(size_t i = 0; i < nodes.size(); ++i)
+            {
+                const auto& node = nodes.at(i);
+                if(added[i])
+                    continue;
+
+                std::vector<int> inputIDs;
+                for(const auto& input : node.at("inputs"))
+                {
+                    const auto it = valueIDs.find(input.get<std::string>());
+                    if(it == valueIDs.end())
+                        break;
+                    inputIDs.push_back(it->second);
+                }
+
+                if(inputIDs.size() != node.at("inputs").size() || inputIDs.empty())
+                    continue;
+
+                const auto name = node.at("name").get<std::string>();
+                const auto type = node.contains("type") ? node["type"].get<std::string>() : std::string { "layers" };
+                debug_print("Node: " + name + " (" + type + ")", debug);
+
+                int valueID = -1;
+                if(type == "layers")
+                {
+                    int nodeInSize = 0;
+                    for(auto id : inputIDs)
+                        nodeInSize += graph->getValueSize(id);
+
+                    auto chain = parseJson<T>(getExpertJson(node, nodeInSize), debug);
+                    if(chain == nullptr || chain->layers.empty())
+                    {
+                        debug_print("Node " + name + " has no layers!", debug);
+                        return {};
+                    }
+
+                    std::vector<std::unique_ptr<Layer<T>>> layers;
+                    for(auto* layer : chain->layers)
+                        layers.emplace_back(layer);
+                    chain->layers.clear();
+
+                    valueID = graph->addLayersNode(inputIDs, std::move(layers));
+                }
+                else if(type == "add" || type == "multiply" || type == "concat")
+                {
+                    const auto nodeType = type == "add" ? GraphNodeType::Add : (type == "multiply" ? GraphNodeType::Multiply : GraphNodeType::Concat);
+                    valueID = graph->addMergeNode(nodeType, inputIDs);
+                    if(valueID < 0)
+                    {
+                        debug_print("The inputs of node " + name + " have different sizes!", debug);
+                        return {};
+                    }
+                }
+                else
+                {
+                    debug_print("Unknown node type: " + type, debug);
+                    return {};
+                }
+
+                valueIDs[name] = valueID;
+                lastNode = name;
+                added[i] = true;
+                numAdded++;
+                progress = true;
+            }
+
+            if(!progress)
+            {
+                debug_print("Graph has a cycle, or a node with a missing input!", debug);
+                return {};
+            }
+        }
+
+        if(parent.contains("outputs"))
+        {
+            for(const auto& output : parent.at("outputs"))
+            {
+                const auto it = valueIDs.find(output.get<std::string>());
+                if(it == valueIDs.end())
+                {
+                    debug_print("Unknown graph output: " + output.get<std::string>(), debug);
+                    return {};
+                }
+                graph->addOutput(it->second);
+            }
+        }
+        else
+        {
+            graph->addOutput(valueIDs.at(lastNode));
+        }
+
+        graph->compile(max_block_size);
+        return graph;
+    }
+} // namespace json_parser
+
+} // namespace RTNeural
+
+#endif // GRAPH_MODEL_H_INCLUDED
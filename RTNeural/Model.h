@@ -7,8 +7,14 @@
 #include "Layer.h"
 #include "activation/activation.h"
 #include "dense/dense.h"
+#include "embedding/embedding.h"
+#include "lstm/cifg_lstm.h"
 #include "lstm/lstm.h"
 #include "lstm/lstm.tpp"
+#include "lstm/lstm_dense.h"
+#include "lstm/small_signal_lstm.h"
+#include "lstm/stacked_lstm.h"
+#include "pcm/pcm.h"
 
 namespace RTNeural
 {
@@ -26,6 +32,7 @@ public:
     /** Constructs a sequential model for a given input size. */
     explicit Model(int in_size)
         : in_size(in_size)
+        , blockIns((size_t)in_size, (T)0)
     {
     }
 
@@ -87,6 +94,33 @@ public:
         return outs.back().data();
     }
 
+    /**
+     * Processes a block of samples, with input[num_samples][in_size] and output[num_samples][out_size].
+     *
+     * The samples can be int16_t, `PCM24`, int32_t, or floating-point, and are
+     * converted by the `PCMConverter` as each sample is passed to the first layer
+     * and read from the last layer, so there is no separate conversion pass.
+     */
+    template <typename InType, typename OutType>
+    void processBlock(const InType* input, OutType* output, int num_samples, PCMConverter<T>& converter) noexcept
+    {
+        const auto out_size = getOutSize();
+        for(int n = 0; n < num_samples; ++n)
+        {
+            converter.load(input + n * in_size, blockIns.data(), in_size);
+            forward(blockIns.data());
+            converter.store(getOutputs(), output + n * out_size, out_size);
+        }
+    }
+
+    /** Processes a block of samples, with the default conversion options (see above). */
+    template <typename InType, typename OutType>
+    void processBlock(const InType* input, OutType* output, int num_samples) noexcept
+    {
+        PCMConverter<T> converter;
+        processBlock(input, output, num_samples, converter);
+    }
+
     /** A vector storing the network layers in sequential order. */
     std::vector<Layer<T>*> layers;
 
@@ -95,6 +129,7 @@ private:
 
     const int in_size;
     std::vector<vec_type> outs;
+    vec_type blockIns;
 };
 
 } // namespace RTNeural
@@ -1,9 +1,14 @@
 #pragma once
 
+#include "combinators/combinators.h"
 #include "model_loader.h"
 
 #define MODELT_AVAILABLE (!RTNEURAL_USE_ACCELERATE)
 
+#ifndef RTNEURAL_FUSE_LAYERS
+#define RTNEURAL_FUSE_LAYERS 0
+#endif
+
 #if MODELT_AVAILABLE
 
 namespace RTNeural
@@ -56,6 +61,25 @@ namespace modelt_detail
         forEachInTuple(std::forward<Fn>(fn), std::forward<Tuple>(tuple), TupleIndexSequenceRange<start, num> {});
     }
 
+    // prefetches the first weights of a layer (if the layer supports it), before they're needed
+    template <typename Layer>
+    auto prefetch_weights(const Layer& layer, int) noexcept -> decltype(layer.prefetchWeights())
+    {
+        layer.prefetchWeights();
+    }
+
+    template <typename Layer>
+    void prefetch_weights(const Layer&, long) noexcept { }
+
+    template <size_t idx, typename Tuple>
+    std::enable_if_t<(idx < std::tuple_size<Tuple>::value), void> prefetch_layer(const Tuple& t) noexcept
+    {
+        prefetch_weights(std::get<idx>(t), 0);
+    }
+
+    template <size_t idx, typename Tuple>
+    std::enable_if_t<(idx >= std::tuple_size<Tuple>::value), void> prefetch_layer(const Tuple&) noexcept { }
+
     // unrolled loop for forward inferencing
     template <size_t idx, size_t Niter>
     struct forward_unroll
@@ -63,6 +87,7 @@ namespace modelt_detail
         template <typename T>
         static void call(T& t)
         {
+            prefetch_layer<idx + 1>(t);
             std::get<idx>(t).forward(std::get<idx - 1>(t).outs);
             forward_unroll<idx + 1, Niter - 1>::call(t);
         }
@@ -75,6 +100,101 @@ namespace modelt_detail
         static void call(T&) { }
     };
 
+    /** Pairs of adjacent layers that ModelT replaces with a single fused layer. */
+    template <typename First, typename Second>
+    struct fused_pair
+    {
+        static constexpr bool value = false;
+    };
+
+#if RTNEURAL_FUSE_LAYERS
+    template <typename T, int in_size, int hidden_size, int out_size>
+    struct fused_pair<LSTMLayerT<T, in_size, hidden_size, SampleRateCorrectionMode::None>, DenseT<T, hidden_size, out_size>>
+    {
+        static constexpr bool value = true;
+        using type = LSTMDenseT<T, in_size, hidden_size, out_size>;
+    };
+#endif
+
+    /** Builds the tuple of layers stored by ModelT, replacing any fused pairs (left to right). */
+    template <typename Done, typename... Layers>
+    struct fuse_layers;
+
+    template <bool fuse, typename Done, typename... Layers>
+    struct fuse_layers_step;
+
+    template <typename... Done>
+    struct fuse_layers<std::tuple<Done...>>
+    {
+        using type = std::tuple<Done...>;
+    };
+
+    template <typename... Done, typename Layer>
+    struct fuse_layers<std::tuple<Done...>, Layer>
+    {
+        using type = std::tuple<Done..., Layer>;
+    };
+
+    template <typename... Done, typename First, typename Second, typename... Rest>
+    struct fuse_layers<std::tuple<Done...>, First, Second, Rest...>
+    {
+        using type = typename fuse_layers_step<fused_pair<First, Second>::value, std::tuple<Done...>, First, Second, Rest...>::type;
+    };
+
+    template <typename... Done, typename First, typename Second, typename... Rest>
+    struct fuse_layers_step<true, std::tuple<Done...>, First, Second, Rest...>
+    {
+        using type = typename fuse_layers<std::tuple<Done..., typename fused_pair<First, Second>::type>, Rest...>::type;
+    };
+
+    template <typename... Done, typename First, typename Second, typename... Rest>
+    struct fuse_layers_step<false, std::tuple<Done...>, First, Second, Rest...>
+    {
+        using type = typename fuse_layers<std::tuple<Done..., First>, Second, Rest...>::type;
+    };
+
+    template <typename... Layers>
+    using fused_layers_t = typename fuse_layers<std::tuple<>, Layers...>::type;
+
+    /** Returns true if the layer at `Index` starts a fused pair. */
+    template <size_t Index, typename... Layers>
+    constexpr bool starts_fused_pair() noexcept
+    {
+        return fused_pair<std::tuple_element_t<Index, std::tuple<Layers...>>,
+            std::tuple_element_t<(Index + 1 < sizeof...(Layers) ? Index + 1 : Index), std::tuple<Layers...>>>::value
+            && Index + 1 < sizeof...(Layers);
+    }
+
+    template <typename... Layers, size_t... Ix>
+    constexpr size_t fused_index(size_t index, std::index_sequence<Ix...>) noexcept
+    {
+        const bool starts[] = { false, starts_fused_pair<Ix, Layers...>()... };
+
+        size_t fusedIndex = 0;
+        for(size_t i = 0; i < index; ++fusedIndex)
+        {
+            if(starts[i + 1])
+            {
+                if(i + 1 == index)
+                    return fusedIndex;
+                i += 2;
+            }
+            else
+            {
+                i += 1;
+            }
+        }
+
+        return fusedIndex;
+    }
+
+    /** Maps the index of a layer in the ModelT template arguments to its index in the (fused) layers tuple. */
+    template <typename... Layers>
+    constexpr size_t fused_index(size_t index) noexcept
+    {
+        return fused_index<Layers...>(index, std::index_sequence_for<Layers...> {});
+    }
+
     template <typename T, typename LayerType>
     void loadLayer(LayerType&, int&, const nlohmann::json&, const std::string&, int, bool debug)
     {
@@ -106,6 +226,48 @@ namespace modelt_detail
         }
     }
 
+    /** A dense layer with one-hot inputs is loaded from a regular dense entry. */
+    template <typename T, int in_size, int out_size, int one_hot_start, int one_hot_count>
+    void loadLayer(OneHotDenseT<T, in_size, out_size, one_hot_start, one_hot_count>& dense, int& json_stream_idx, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        using namespace json_parser;
+
+        debug_print("Layer: " + type + " (one-hot inputs)", debug);
+        debug_print("  Dims: " + std::to_string(layerDims), debug);
+        const auto& weights = l["weights"];
+
+        if(checkDense<T>(dense, type, layerDims, debug))
+            loadDense<T>(dense, weights);
+
+        if(!l.contains("activation"))
+        {
+            json_stream_idx++;
+        }
+        else
+        {
+            const auto activationType = l["activation"].get<std::string>();
+            if(activationType.empty())
+                json_stream_idx++;
+        }
+    }
+
+    template <typename T, int num_embeddings, int embedding_dim>
+    void loadLayer(EmbeddingT<T, num_embeddings, embedding_dim>& embedding, int& json_stream_idx, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        using namespace json_parser;
+
+        debug_print("Layer: " + type, debug);
+        debug_print("  Dims: " + std::to_string(layerDims), debug);
+        const auto& weights = l["weights"];
+
+        if(checkEmbedding(embedding, type, layerDims, weights, debug))
+            loadEmbedding<T>(embedding, weights);
+
+        json_stream_idx++;
+    }
+
     template <typename T, int in_size, int out_size, SampleRateCorrectionMode mode>
     void loadLayer(LSTMLayerT<T, in_size, out_size, mode>& lstm, int& json_stream_idx, const nlohmann::json& l,
         const std::string& type, int layerDims, bool debug)
@@ -116,16 +278,318 @@ namespace modelt_detail
         debug_print("  Dims: " + std::to_string(layerDims), debug);
         const auto& weights = l["weights"];
 
-        if(checkLSTM<T>(lstm, type, layerDims, debug))
+        if(checkLSTM<T>(lstm, l, type, layerDims, debug))
+            loadLSTM<T>(lstm, weights);
+
+        json_stream_idx++;
+    }
+
+    template <typename T, int in_size, int out_size, SampleRateCorrectionMode mode>
+    void loadLayer(CIFGLSTMLayerT<T, in_size, out_size, mode>& lstm, int& json_stream_idx, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        using namespace json_parser;
+
+        debug_print("Layer: " + type + " (cifg)", debug);
+        debug_print("  Dims: " + std::to_string(layerDims), debug);
+        const auto& weights = l["weights"];
+
+        if(checkCIFGLSTM<T>(lstm, l, type, layerDims, debug))
+            loadLSTM<T>(lstm, weights, 3);
+
+        json_stream_idx++;
+    }
+
+    template <typename T, int in_size, int out_size>
+    void loadLayer(SmallSignalLSTMT<T, in_size, out_size>& lstm, int& json_stream_idx, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        using namespace json_parser;
+
+        debug_print("Layer: " + type + " (small-signal)", debug);
+        debug_print("  Dims: " + std::to_string(layerDims), debug);
+        const auto& weights = l["weights"];
+
+        if(checkLSTM<T>(lstm, l, type, layerDims, debug))
+        {
             loadLSTM<T>(lstm, weights);
+            if(!lstm.linearize())
+                debug_print("  LSTM does not settle to a steady state, so it can't be linearized!", debug);
+        }
+
+        json_stream_idx++;
+    }
+
+    template <typename T, int in_size, typename... Layers>
+    void parseJson(const nlohmann::json& parent, std::tuple<Layers...>& layers, const bool debug = false, std::initializer_list<std::string> custom_layers = {});
+
+    template <typename T, typename... Layers>
+    void loadLayers(std::tuple<Layers...>& layers, const nlohmann::json& json_layers, int& json_stream_idx, const bool debug, std::initializer_list<std::string> custom_layers = {});
+
+    /** Loads the layers of a combinator from their json representation. */
+    template <typename T, int in_size, typename... Layers>
+    void loadSubLayers(std::tuple<Layers...>& layers, const nlohmann::json& json_layers, bool debug)
+    {
+        nlohmann::json parent;
+        parent["in_shape"] = { nullptr, nullptr, in_size };
+        parent["layers"] = json_layers;
+        parseJson<T, in_size>(parent, layers, debug);
+    }
+
+    template <typename T, typename LayerType>
+    void loadBranch(LayerType& layer, const nlohmann::json& json_layers, bool debug)
+    {
+        std::tuple<LayerType&> layers { layer };
+        loadSubLayers<T, LayerType::in_size>(layers, json_layers, debug);
+    }
+
+    template <typename T, typename... Layers>
+    void loadBranch(SequentialT<T, Layers...>& sequential, const nlohmann::json& json_layers, bool debug)
+    {
+        loadSubLayers<T, SequentialT<T, Layers...>::in_size>(sequential.layers, json_layers, debug);
+    }
+
+    /** Checks that a combinator layer has the given type and dimensions. */
+    template <typename LayerType>
+    bool checkCombinator(const LayerType& layer, const std::string& type, int layerDims, const bool debug)
+    {
+        if(type != layer.getName())
+        {
+            json_parser::debug_print("Wrong layer type! Expected: " + layer.getName(), debug);
+            return false;
+        }
+
+        if(layerDims != layer.out_size)
+        {
+            json_parser::debug_print("Wrong layer size! Expected: " + std::to_string(layer.out_size), debug);
+            return false;
+        }
+
+        return true;
+    }
+
+    template <typename T, typename... Layers>
+    void loadLayer(SequentialT<T, Layers...>& sequential, int& json_stream_idx, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        json_parser::debug_print("Layer: " + type, debug);
+
+        if(checkCombinator(sequential, type, layerDims, debug))
+            loadBranch<T>(sequential, l["layers"], debug);
 
         json_stream_idx++;
     }
 
+    template <typename T, typename... Layers>
+    void loadLayer(ResidualT<T, Layers...>& residual, int& json_stream_idx, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        json_parser::debug_print("Layer: " + type, debug);
+
+        if(checkCombinator(residual, type, layerDims, debug))
+            loadBranch<T>(residual.chain, l["layers"], debug);
+
+        json_stream_idx++;
+    }
+
+    template <typename T, ParallelMerge merge, typename... Branches>
+    void loadLayer(ParallelT<T, merge, Branches...>& parallel, int& json_stream_idx, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        json_parser::debug_print("Layer: " + type, debug);
+
+        const auto mergeType = l.contains("merge") ? l["merge"].get<std::string>() : std::string { "add" };
+        if(mergeType != (merge == ParallelMerge::Add ? "add" : "concat"))
+            json_parser::debug_print("Wrong merge type for parallel layer!", debug);
+        else if(checkCombinator(parallel, type, layerDims, debug))
+        {
+            const auto& json_branches = l["branches"];
+            forEachInTuple([&](auto& branch, size_t idx)
+                { loadBranch<T>(branch, json_branches.at(idx).at("layers"), debug); },
+                parallel.branches);
+        }
+
+        json_stream_idx++;
+    }
+
+    template <typename T, int in_size, int out_size, int top_k, MoEIdlePolicy idlePolicy, typename... Experts>
+    void loadLayer(MixtureOfExpertsT<T, in_size, out_size, top_k, idlePolicy, Experts...>& moe, int& json_stream_idx, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        using namespace json_parser;
+
+        debug_print("Layer: " + type, debug);
+        debug_print("  Dims: " + std::to_string(layerDims), debug);
+
+        if(checkMoE(moe, type, layerDims, l, debug))
+        {
+            loadDense<T>(moe.getGate(), l["weights"]);
+
+            const auto& experts = l["experts"];
+            moe.forEachExpert([&](auto& expert, size_t e)
+                {
+                    debug_print("  Expert " + std::to_string(e) + ":", debug);
+                    expert.parseJson(getExpertJson(experts.at(e), in_size), debug);
+                });
+        }
+
+        if(!l.contains("activation"))
+        {
+            json_stream_idx++;
+        }
+        else
+        {
+            const auto activationType = l["activation"].get<std::string>();
+            if(activationType.empty())
+                json_stream_idx++;
+        }
+    }
+
+    template <typename T, int size>
+    void loadLayer(SnakeActivationT<T, size>& snake, int& json_stream_idx, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        using namespace json_parser;
+
+        debug_print("Layer: " + type, debug);
+        debug_print("  Dims: " + std::to_string(layerDims), debug);
+        const auto& weights = l["weights"];
+
+        if(checkSnake<T>(snake, type, layerDims, weights, debug))
+            loadSnake<T>(snake, weights);
+
+        json_stream_idx++;
+    }
+
+    template <typename T, int factor, UpsamplingMode upsampling, typename... Layers>
+    void loadLayer(DecimatedT<T, factor, upsampling, Layers...>& decimated, int& json_stream_idx, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        json_parser::debug_print("Layer: " + type, debug);
+
+        if(json_parser::checkDecimated(decimated, type, layerDims, l, debug))
+            loadBranch<T>(decimated.chain, l["layers"], debug);
+
+        json_stream_idx++;
+    }
+
+    template <typename T, int size, typename ConditioningType>
+    void loadLayer(FiLMT<T, size, ConditioningType>& film, int& json_stream_idx, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        using namespace json_parser;
+
+        debug_print("Layer: " + type, debug);
+        debug_print("  Dims: " + std::to_string(layerDims), debug);
+
+        if(checkFiLM(film, type, layerDims, l, debug))
+        {
+            debug_print("  Conditioning:", debug);
+            film.getConditioning().parseJson(getExpertJson(l, film.num_controls), debug);
+            film.invalidateConditioning();
+        }
+
+        if(!l.contains("activation"))
+        {
+            json_stream_idx++;
+        }
+        else
+        {
+            const auto activationType = l["activation"].get<std::string>();
+            if(activationType.empty())
+                json_stream_idx++;
+        }
+    }
+
  
 
+    /** Most layers are loaded from a single json entry. */
+    template <typename T, typename LayerType>
+    void loadLayer(LayerType& layer, int& json_stream_idx, const nlohmann::json&, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        loadLayer<T>(layer, json_stream_idx, l, type, layerDims, debug);
+    }
+
+    /** A stacked LSTM is loaded from consecutive lstm entries. */
+    template <typename T, int in_size, int out_size, int num_layers>
+    void loadLayer(StackedLSTMT<T, in_size, out_size, num_layers>& lstm, int& json_stream_idx, const nlohmann::json& json_layers,
+        const nlohmann::json&, const std::string&, int, bool debug)
+    {
+        using namespace json_parser;
+
+        for(int layer = 0; layer < num_layers; ++layer)
+        {
+            if(json_stream_idx >= (int)json_layers.size())
+            {
+                debug_print("Too few lstm layers for stacked LSTM!", debug);
+                return;
+            }
+
+            const auto& l = json_layers.at(json_stream_idx);
+            const auto type = l["type"].get<std::string>();
+            const int layerDims = l["shape"].back().get<int>();
+
+            debug_print("Layer: " + type + " (stacked " + std::to_string(layer) + ")", debug);
+            debug_print("  Dims: " + std::to_string(layerDims), debug);
+
+            auto layerRef = lstm.getLayer(layer);
+            if(checkLSTM<T>(layerRef, l, type, layerDims, debug))
+                loadLSTM<T>(layerRef, l["weights"]);
+
+            json_stream_idx++;
+        }
+    }
+
+    /** An input table is loaded from the json entries of the layers that it wraps, and then tabulated. */
+    template <typename T, int num_points, typename... Layers>
+    void loadLayer(InputTableT<T, num_points, Layers...>& table, int& json_stream_idx, const nlohmann::json& json_layers,
+        const nlohmann::json&, const std::string&, int, bool debug)
+    {
+        json_parser::debug_print("Input table:", debug);
+        loadLayers<T>(table.chain.layers, json_layers, json_stream_idx, debug);
+
+        const auto maxError = table.tabulate();
+        json_parser::debug_print("  Input table max error: " + std::to_string(maxError), debug);
+    }
+
+    /** A fused LSTM + Dense layer is loaded from consecutive lstm and dense entries. */
+    template <typename T, int in_size, int hidden_size, int out_size>
+    void loadLayer(LSTMDenseT<T, in_size, hidden_size, out_size>& lstmDense, int& json_stream_idx, const nlohmann::json& json_layers,
+        const nlohmann::json& l, const std::string& type, int layerDims, bool debug)
+    {
+        using namespace json_parser;
+
+        debug_print("Layer: " + type + " (fused with dense)", debug);
+        debug_print("  Dims: " + std::to_string(layerDims), debug);
+
+        auto lstm = lstmDense.getLSTM();
+        if(checkLSTM<T>(lstm, l, type, layerDims, debug))
+            loadLSTM<T>(lstm, l["weights"]);
+
+        json_stream_idx++;
+        if(json_stream_idx >= (int)json_layers.size())
+        {
+            debug_print("Missing dense layer after lstm!", debug);
+            return;
+        }
+
+        const auto& dl = json_layers.at(json_stream_idx);
+        const auto denseType = dl["type"].get<std::string>();
+        const int denseDims = dl["shape"].back().get<int>();
+        debug_print("Layer: " + denseType + " (fused with lstm)", debug);
+        debug_print("  Dims: " + std::to_string(denseDims), debug);
+
+        auto dense = lstmDense.getDense();
+        if(checkDense<T>(dense, denseType, denseDims, debug))
+            loadDense<T>(dense, dl["weights"]);
+
+        if(!dl.contains("activation") || dl["activation"].get<std::string>().empty())
+            json_stream_idx++;
+    }
+
     template <typename T, int in_size, typename... Layers>
-    void parseJson(const nlohmann::json& parent, std::tuple<Layers...>& layers, const bool debug = false, std::initializer_list<std::string> custom_layers = {})
+    void parseJson(const nlohmann::json& parent, std::tuple<Layers...>& layers, const bool debug, std::initializer_list<std::string> custom_layers)
     {
         using namespace json_parser;
 
@@ -147,6 +611,15 @@ namespace modelt_detail
         }
 
         int json_stream_idx = 0;
+        loadLayers<T>(layers, json_layers, json_stream_idx, debug, custom_layers);
+    }
+
+    /** Loads a tuple of layers from consecutive json layers, starting at `json_stream_idx`. */
+    template <typename T, typename... Layers>
+    void loadLayers(std::tuple<Layers...>& layers, const nlohmann::json& json_layers, int& json_stream_idx, const bool debug, std::initializer_list<std::string> custom_layers)
+    {
+        using namespace json_parser;
+
         modelt_detail::forEachInTuple([&](auto& layer, size_t)
             {
                 if(json_stream_idx >= (int)json_layers.size())
@@ -188,7 +661,7 @@ namespace modelt_detail
                     return;
                 }
 
-                modelt_detail::loadLayer<T>(layer, json_stream_idx, l, type, layerDims, debug); },
+                modelt_detail::loadLayer<T>(layer, json_stream_idx, json_layers, l, type, layerDims, debug); },
             layers);
     }
 } // namespace modelt_detail
@@ -205,6 +678,10 @@ namespace modelt_detail
  *      DenseT<double, 8, 1>
  *  > model;
  *  ```
+ *
+ *  With `RTNEURAL_FUSE_LAYERS=1`, some adjacent layers are replaced with
+ *  a single fused layer, e.g. a `LSTMLayerT` followed by a `DenseT`
+ *  (see `LSTMDenseT`).
  */
 template <typename T, int in_size, int out_size, typename... Layers>
 class ModelT
@@ -219,23 +696,35 @@ public:
         for(int i = 0; i < v_in_size; ++i)
             v_ins[i] = v_type((T)0);
 #elif RTNEURAL_USE_EIGEN
-        auto& layer_outs = get<n_layers - 1>().outs;
+        auto& layer_outs = std::get<n_layers - 1>(layers).outs;
         new(&layer_outs) Eigen::Map<Eigen::Matrix<T, out_size, 1>, RTNeuralEigenAlignment>(outs);
 #endif
     }
 
-    /** Get a reference to the layer at index `Index`. */
+    /**
+     * Get a reference to the layer at index `Index`.
+     *
+     * If the layer has been fused with a neighbouring layer
+     * (see `LSTMDenseT`), this returns the fused layer.
+     */
     template <int Index>
     auto& get() noexcept
     {
-        return std::get<Index>(layers);
+        return std::get<modelt_detail::fused_index<Layers...>(Index)>(layers);
     }
 
     /** Get a reference to the layer at index `Index`. */
     template <int Index>
     const auto& get() const noexcept
     {
-        return std::get<Index>(layers);
+        return std::get<modelt_detail::fused_index<Layers...>(Index)>(layers);
+    }
+
+    /** Calls `fn(layer, index)` for each layer in the network. */
+    template <typename Fn>
+    void forEachLayer(Fn&& fn)
+    {
+        modelt_detail::forEachInTuple(std::forward<Fn>(fn), layers);
     }
 
     /** Resets the state of the network layers. */
@@ -259,15 +748,16 @@ public:
 #else // RTNEURAL_USE_STL
         std::copy(input, input + in_size, v_ins);
 #endif
+        modelt_detail::prefetch_layer<1>(layers);
         std::get<0>(layers).forward(v_ins);
         modelt_detail::forward_unroll<1, n_layers - 1>::call(layers);
 
 #if RTNEURAL_USE_XSIMD
         for(int i = 0; i < v_out_size; ++i)
-            xsimd::store_aligned(outs + i * v_size, get<n_layers - 1>().outs[i]);
+            xsimd::store_aligned(outs + i * v_size, std::get<n_layers - 1>(layers).outs[i]);
 #elif RTNEURAL_USE_EIGEN
 #else // RTNEURAL_USE_STL
-        auto& layer_outs = get<n_layers - 1>().outs;
+        auto& layer_outs = std::get<n_layers - 1>(layers).outs;
         std::copy(layer_outs, layer_outs + out_size, outs);
 #endif
         return outs[0];
@@ -286,15 +776,16 @@ public:
         v_ins[0] = input[0];
 #endif
 
+        modelt_detail::prefetch_layer<1>(layers);
         std::get<0>(layers).forward(v_ins);
         modelt_detail::forward_unroll<1, n_layers - 1>::call(layers);
 
 #if RTNEURAL_USE_XSIMD
         for(int i = 0; i < v_out_size; ++i)
-            xsimd::store_aligned(outs + i * v_size, get<n_layers - 1>().outs[i]);
+            xsimd::store_aligned(outs + i * v_size, std::get<n_layers - 1>(layers).outs[i]);
 #elif RTNEURAL_USE_EIGEN
 #else // RTNEURAL_USE_STL
-        auto& layer_outs = get<n_layers - 1>().outs;
+        auto& layer_outs = std::get<n_layers - 1>(layers).outs;
         std::copy(layer_outs, layer_outs + out_size, outs);
 #endif
         return outs[0];
@@ -306,6 +797,50 @@ public:
         return outs;
     }
 
+    /**
+     * Processes a block of samples, with input[num_samples][in_size] and output[num_samples][out_size].
+     *
+     * The samples can be int16_t, `PCM24`, int32_t, or floating-point. The
+     * `PCMConverter` writes each input sample straight into the input of the
+     * first layer, and reads each output sample straight from the last layer,
+     * so there is no separate conversion pass.
+     */
+    template <typename InType, typename OutType>
+    void processBlock(const InType* input, OutType* output, int num_samples, PCMConverter<T>& converter) noexcept
+    {
+        for(int n = 0; n < num_samples; ++n)
+        {
+#if RTNEURAL_USE_XSIMD || RTNEURAL_USE_EIGEN
+            T ins alignas(RTNEURAL_DEFAULT_ALIGNMENT)[in_size];
+            converter.load(input + n * in_size, ins, in_size);
+            forward(ins);
+            converter.store(outs, output + n * out_size, out_size);
+#else // RTNEURAL_USE_STL
+            converter.load(input + n * in_size, v_ins, in_size);
+            modelt_detail::prefetch_layer<1>(layers);
+            std::get<0>(layers).forward(v_ins);
+            modelt_detail::forward_unroll<1, n_layers - 1>::call(layers);
+            converter.store(std::get<n_layers - 1>(layers).outs, output + n * out_size, out_size);
+#endif
+        }
+
+#if !(RTNEURAL_USE_XSIMD || RTNEURAL_USE_EIGEN)
+        if(num_samples > 0)
+        {
+            auto& layer_outs = std::get<n_layers - 1>(layers).outs;
+            std::copy(layer_outs, layer_outs + out_size, outs); // keep getOutputs() up to date
+        }
+#endif
+    }
+
+    /** Processes a block of samples, with the default conversion options (see above). */
+    template <typename InType, typename OutType>
+    void processBlock(const InType* input, OutType* output, int num_samples) noexcept
+    {
+        PCMConverter<T> converter;
+        processBlock(input, output, num_samples, converter);
+    }
+
     /** Loads neural network model weights from a json stream. */
     void parseJson(const nlohmann::json& parent, const bool debug = false, std::initializer_list<std::string> custom_layers = {})
     {
@@ -339,8 +874,8 @@ private:
     T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
 #endif
 
-    std::tuple<Layers...> layers;
-    static constexpr size_t n_layers = sizeof...(Layers);
+    modelt_detail::fused_layers_t<Layers...> layers;
+    static constexpr size_t n_layers = std::tuple_size<decltype(layers)>::value;
 };
 
 #if RTNEURAL_USE_EIGEN || !RTNEURAL_USE_XSIMD
@@ -408,6 +943,7 @@ public:
             for(int i = 0; i < v_num_filters_in; ++i)
                 v_ins[feature_index * num_filters_in + i] = xsimd::load_aligned(load_arr + i * v_size);
         }
+        modelt_detail::prefetch_layer<1>(layers);
         std::get<0>(layers).forward(v_ins);
         modelt_detail::forward_unroll<1, n_layers - 1>::call(layers);
 
@@ -0,0 +1,220 @@
+#ifndef MULTI_HEAD_MODEL_H_INCLUDED
+#define MULTI_HEAD_MODEL_H_INCLUDED
+
+#include <algorithm>
+#include <array>
+#include <initializer_list>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "Model.h"
+
+namespace RTNeural
+{
+
+#ifndef DOXYGEN
+namespace multi_head_detail
+{
+    template <typename T>
+    int getInSize(const Model<T>& model) { return model.getInSize(); }
+
+    template <typename ModelType>
+    constexpr int getInSize(const ModelType&) { return ModelType::input_size; }
+
+    template <typename T>
+    int getOutSize(const Model<T>& model) { return model.getOutSize(); }
+
+    template <typename ModelType>
+    constexpr int getOutSize(const ModelType&) { return ModelType::output_size; }
+
+    template <typename Fn, typename Tuple, size_t... Ix>
+    void forEach(Fn&& fn, Tuple& tuple, std::index_sequence<Ix...>)
+    {
+        (void)std::initializer_list<int> { ((void)fn(std::get<Ix>(tuple), (int)Ix), 0)... };
+    }
+} // namespace multi_head_detail
+#endif // DOXYGEN
+
+/**
+ *  A model with a shared trunk, followed by several independent heads.
+ *
+ *  At each step, the trunk is run once, and each enabled head is run
+ *  on the outputs of the trunk. Heads can be enabled or disabled at runtime,
+ *  so that only the outputs that are needed cost any CPU. A head that is
+ *  re-enabled has skipped some of its inputs, so its state is reset.
+ *
+ *  With `processBlock()`, the trunk is run over a chunk of samples first,
+ *  and then each head is run over the whole chunk, so that the weights of
+ *  each model stay in the cache while that model is running.
+ *
+ *  The trunk and head types may be `Model<T>` or `ModelT<...>`. Dynamic models
+ *  must have their layers loaded before the wrapper is constructed. The wrapper
+ *  does not own the models.
+ *  ```
+ *  // model json: { "in_shape": ..., "layers": [ <trunk> ], "heads": [ { "layers": [ ... ] }, ... ] }
+ *  trunk.parseJson(modelJson);
+ *  left.parseJson(json_parser::getHeadJson(modelJson, 0, TrunkType::output_size));
+ *  right.parseJson(json_parser::getHeadJson(modelJson, 1, TrunkType::output_size));
+ *
+ *  MultiHeadModel<float, TrunkType, HeadType, HeadType> model { trunk, left, right };
+ *  float* outs[] = { leftBuffer, rightBuffer };
+ *  model.processBlock(input, outs, numSamples);
+ *  ```
+ */
+template <typename T, typename TrunkType, typename... HeadTypes>
+class MultiHeadModel
+{
+public:
+    static constexpr int num_heads = (int)sizeof...(HeadTypes);
+    static_assert(num_heads > 0, "A multi-head model must have at least one head!");
+
+    /**
+     * Constructs a multi-head model from a trunk and some heads.
+     *
+     * @param block_size    Number of samples the trunk is run over in
+     *                      `processBlock()` before running the heads.
+     */
+    MultiHeadModel(TrunkType& trunk, HeadTypes&... heads, int block_size = 32)
+        : in_size(multi_head_detail::getInSize(trunk))
+        , trunk_out_size(multi_head_detail::getOutSize(trunk))
+        , block_size(std::max(block_size, 1))
+        , trunk(trunk)
+        , heads(heads...)
+        , trunkOuts((size_t)this->block_size * (size_t)trunk_out_size, (T)0)
+    {
+        head_out_sizes = { multi_head_detail::getOutSize(heads)... };
+        enabled.fill(true);
+    }
+
+    /** Resets the state of the trunk and all of the heads. */
+    void reset()
+    {
+        trunk.reset();
+        multi_head_detail::forEach([](auto& head, int)
+            { head.reset(); },
+            heads, std::index_sequence_for<HeadTypes...> {});
+    }
+
+    /**
+     * Enables or disables a head. Disabled heads are not run, and their
+     * output buffers are left untouched. Re-enabling a head resets its state.
+     */
+    void setHeadEnabled(int head, bool shouldBeEnabled)
+    {
+        if(shouldBeEnabled && !enabled[(size_t)head])
+        {
+            multi_head_detail::forEach([head](auto& h, int idx)
+                {
+                    if(idx == head)
+                        h.reset();
+                },
+                heads, std::index_sequence_for<HeadTypes...> {});
+        }
+
+        enabled[(size_t)head] = shouldBeEnabled;
+    }
+
+    /** Returns true if the head is enabled. */
+    bool isHeadEnabled(int head) const noexcept { return enabled[(size_t)head]; }
+
+    /** Returns the number of outputs of a head. */
+    int getHeadOutSize(int head) const noexcept { return head_out_sizes[(size_t)head]; }
+
+    /** Performs forward propagation for one step of the trunk and the enabled heads. */
+    inline void forward(const T* input) noexcept
+    {
+        trunk.forward(input);
+        const auto* x = trunk.getOutputs();
+        multi_head_detail::forEach([this, x](auto& head, int idx)
+            {
+                if(enabled[(size_t)idx])
+                    head.forward(x);
+            },
+            heads, std::index_sequence_for<HeadTypes...> {});
+    }
+
+    /**
+     * Performs forward propagation for one step, and copies the outputs
+     * of each enabled head into `headOutputs[head]`.
+     */
+    inline void forward(const T* input, T* const* headOutputs) noexcept
+    {
+        forward(input);
+        multi_head_detail::forEach([this, headOutputs](auto& head, int idx)
+            {
+                if(enabled[(size_t)idx])
+                    std::copy(head.getOutputs(), head.getOutputs() + head_out_sizes[(size_t)idx], headOutputs[idx]);
+            },
+            heads, std::index_sequence_for<HeadTypes...> {});
+    }
+
+    /**
+     * Processes a block of samples.
+     *
+     * The input has size [numSamples][in_size], and the outputs
+     * of each enabled head are written to `headOutputs[head]`, which
+     * must have size [numSamples][head_out_size].
+     */
+    void processBlock(const T* input, T* const* headOutputs, int numSamples) noexcept
+    {
+        for(int start = 0; start < numSamples; start += block_size)
+        {
+            const auto n = std::min(block_size, numSamples - start);
+
+            for(int i = 0; i < n; ++i)
+            {
+                trunk.forward(input + (start + i) * in_size);
+                std::copy(trunk.getOutputs(), trunk.getOutputs() + trunk_out_size, trunkOuts.data() + i * trunk_out_size);
+            }
+
+            multi_head_detail::forEach([this, headOutputs, start, n](auto& head, int idx)
+                {
+                    if(!enabled[(size_t)idx])
+                        return;
+
+                    const auto out_size = head_out_sizes[(size_t)idx];
+                    auto* y = headOutputs[idx] + start * out_size;
+                    for(int i = 0; i < n; ++i)
+                    {
+                        head.forward(trunkOuts.data() + i * trunk_out_size);
+                        std::copy(head.getOutputs(), head.getOutputs() + out_size, y + i * out_size);
+                    }
+                },
+                heads, std::index_sequence_for<HeadTypes...> {});
+        }
+    }
+
+    /** Returns a pointer to the outputs of the trunk from the most recent step. */
+    inline const T* getTrunkOutputs() const noexcept { return trunk.getOutputs(); }
+
+    /** Returns a pointer to the outputs of a head from the most recent step it was run. */
+    inline const T* getHeadOutputs(int head) const noexcept
+    {
+        const T* outs = nullptr;
+        multi_head_detail::forEach([head, &outs](const auto& h, int idx)
+            {
+                if(idx == head)
+                    outs = h.getOutputs();
+            },
+            heads, std::index_sequence_for<HeadTypes...> {});
+        return outs;
+    }
+
+    const int in_size;
+    const int trunk_out_size;
+    const int block_size;
+
+private:
+    TrunkType& trunk;
+    std::tuple<HeadTypes&...> heads;
+
+    std::array<int, (size_t)num_heads> head_out_sizes;
+    std::array<bool, (size_t)num_heads> enabled;
+
+    std::vector<T> trunkOuts; // [block_size][trunk_out_size]
+};
+
+} // namespace RTNeural
+
+#endif // MULTI_HEAD_MODEL_H_INCLUDED
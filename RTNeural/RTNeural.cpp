@@ -5,3 +5,41 @@ template class RTNeural::Model<float>;
 template class RTNeural::Model<double>;
 template class RTNeural::Layer<float>;
 template class RTNeural::Layer<double>;
+template class RTNeural::BatchModel<float>;
+template class RTNeural::BatchModel<double>;
+template class RTNeural::CascadeModel<float, RTNeural::Model<float>, RTNeural::Model<float>>;
+template class RTNeural::CascadeModel<double, RTNeural::Model<double>, RTNeural::Model<double>>;
+template class RTNeural::MixtureOfExperts<float>;
+template class RTNeural::MixtureOfExperts<double>;
+template class RTNeural::FiLM<float>;
+template class RTNeural::FiLM<double>;
+template class RTNeural::Decimated<float>;
+template class RTNeural::Decimated<double>;
+#if !RTNEURAL_USE_EIGEN && !RTNEURAL_USE_XSIMD && !RTNEURAL_USE_ACCELERATE
+template class RTNeural::SmallSignalLSTM<float>;
+template class RTNeural::SmallSignalLSTM<double>;
+#endif
+template class RTNeural::InputTable<float>;
+template class RTNeural::InputTable<double>;
+template class RTNeural::Embedding<float>;
+template class RTNeural::Embedding<double>;
+template class RTNeural::OneHotDense<float>;
+template class RTNeural::OneHotDense<double>;
+template class RTNeural::PCMConverter<float>;
+template class RTNeural::PCMConverter<double>;
+template class RTNeural::CIFGLSTMLayer<float>;
+template class RTNeural::CIFGLSTMLayer<double>;
+template class RTNeural::SinActivation<float>;
+template class RTNeural::SinActivation<double>;
+template class RTNeural::CosActivation<float>;
+template class RTNeural::CosActivation<double>;
+template class RTNeural::SnakeActivation<float>;
+template class RTNeural::SnakeActivation<double>;
+template class RTNeural::SubRateModel<float, RTNeural::Model<float>>;
+template class RTNeural::SubRateModel<double, RTNeural::Model<double>>;
+template class RTNeural::MultiHeadModel<float, RTNeural::Model<float>, RTNeural::Model<float>, RTNeural::Model<float>>;
+template class RTNeural::MultiHeadModel<double, RTNeural::Model<double>, RTNeural::Model<double>, RTNeural::Model<double>>;
+template class RTNeural::FFT<float>;
+template class RTNeural::FFT<double>;
+template class RTNeural::SpectralFrontEnd<float>;
+template class RTNeural::SpectralFrontEnd<double>;
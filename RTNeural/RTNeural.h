@@ -16,6 +16,13 @@
 #endif
 
 // RTNeural includes:
+#include "BatchModel.h"
+#include "BoundedModel.h"
+#include "CascadeModel.h"
+#include "GraphModel.h"
 #include "Model.h"
 #include "ModelT.h"
+#include "MultiHeadModel.h"
+#include "SpectralFrontEnd.h"
+#include "SubRateModel.h"
 #include "model_loader.h"
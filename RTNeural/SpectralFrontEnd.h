@@ -0,0 +1,262 @@
+#ifndef SPECTRAL_FRONT_END_H_INCLUDED
+#define SPECTRAL_FRONT_END_H_INCLUDED
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+#include "spectral/fft.h"
+
+namespace RTNeural
+{
+
+/**
+ *  A streaming spectral front-end for frame-based models.
+ *
+ *  Audio samples are pushed into a history buffer, and every `hop_size`
+ *  samples the most recent `fft_size` samples are windowed (periodic Hann),
+ *  transformed with a real FFT, and reduced to a feature frame:
+ *  - the power spectrum (`fft_size / 2 + 1` features), or
+ *  - if `num_mels > 0`, the power in each band of a mel filterbank
+ *    (`num_mels` features, HTK mel scale, triangular filters).
+ *
+ *  The features can optionally be log-compressed, `log(x + 1e-10)`. The
+ *  filterbank is stored sparsely (each band only stores the weights of the
+ *  bins that it covers), and each frame is computed directly into a single
+ *  feature buffer, which is passed to the model's `forward()` method. All
+ *  memory is allocated in the constructor.
+ *
+ *  The model type may be `Model<T>` or `ModelT<...>`, or anything else with
+ *  a `forward(const T*)` method, with `getNumFeatures()` inputs.
+ *  ```
+ *  SpectralFrontEnd<float> frontEnd { 1024, 256, 64, sampleRate };
+ *  frontEnd.processBlock(buffer, numSamples, model, [&](auto& m)
+ *      { onNewFrame(m.getOutputs()); });
+ *  ```
+ */
+template <typename T>
+class SpectralFrontEnd
+{
+public:
+    /**
+     * Creates a spectral front-end.
+     * @param fft_size          The size of the FFT (a power of 2, of at least 4).
+     * @param hop_size          The number of samples between frames.
+     * @param num_mels          The number of mel bands, or 0 to output the power spectrum.
+     * @param sample_rate       The sample rate of the input (only used for the mel filterbank).
+     * @param log_compression   Whether the features should be log-compressed.
+     * @param f_min             The lowest frequency of the mel filterbank.
+     * @param f_max             The highest frequency of the mel filterbank (0 for Nyquist).
+     */
+    SpectralFrontEnd(int fft_size, int hop_size, int num_mels = 0, double sample_rate = 48000.0,
+        bool log_compression = true, double f_min = 0.0, double f_max = 0.0)
+        : fft_size(fft_size)
+        , hop_size(std::max(hop_size, 1))
+        , num_bins(fft_size / 2 + 1)
+        , num_mels(std::max(num_mels, 0))
+        , log_compression(log_compression)
+        , fft(fft_size)
+        , window((size_t)fft_size, (T)0)
+        , history((size_t)fft_size, (T)0)
+        , frame((size_t)fft_size, (T)0)
+        , power((size_t)num_bins, (T)0)
+        , features((size_t)(num_mels > 0 ? num_mels : num_bins), (T)0)
+    {
+        const auto pi = 3.14159265358979323846;
+        for(int n = 0; n < fft_size; ++n)
+            window[(size_t)n] = (T)(0.5 - 0.5 * std::cos(2.0 * pi * (double)n / (double)fft_size));
+
+        if(this->num_mels > 0)
+            createMelFilterbank(sample_rate, f_min, f_max > 0.0 ? f_max : 0.5 * sample_rate);
+
+        reset();
+    }
+
+    /** Returns the number of features in each frame. */
+    int getNumFeatures() const noexcept { return (int)features.size(); }
+
+    /** Clears the history of the front-end. */
+    void reset()
+    {
+        std::fill(history.begin(), history.end(), (T)0);
+        std::fill(features.begin(), features.end(), (T)0);
+        writePos = 0;
+        hopCounter = 0;
+    }
+
+    /** Pushes one sample into the front-end. Returns true if a new frame of features is ready. */
+    inline bool pushSample(T x) noexcept
+    {
+        history[(size_t)writePos] = x;
+        if(++writePos == fft_size)
+            writePos = 0;
+
+        if(++hopCounter < hop_size)
+            return false;
+
+        hopCounter = 0;
+        computeFrame();
+        return true;
+    }
+
+    /** Returns the most recent frame of features. */
+    const T* getFeatures() const noexcept { return features.data(); }
+
+    /**
+     * Pushes a block of samples into the front-end, and runs the model on each new frame.
+     * After each frame, `onFrame(model)` is called, so that the outputs of the model can be read.
+     * Returns the number of frames.
+     */
+    template <typename ModelType, typename FrameCallback>
+    int processBlock(const T* input, int num_samples, ModelType& model, FrameCallback&& onFrame) noexcept
+    {
+        int numFrames = 0;
+        for(int n = 0; n < num_samples; ++n)
+        {
+            if(!pushSample(input[n]))
+                continue;
+
+            model.forward(features.data());
+            onFrame(model);
+            numFrames++;
+        }
+
+        return numFrames;
+    }
+
+    /** Pushes a block of samples into the front-end, and runs the model on each new frame. Returns the number of frames. */
+    template <typename ModelType>
+    int processBlock(const T* input, int num_samples, ModelType& model) noexcept
+    {
+        return processBlock(input, num_samples, model, [](ModelType&) {});
+    }
+
+    /** Returns the weight of FFT bin `bin` in mel band `band`. */
+    T getMelWeight(int band, int bin) const noexcept
+    {
+        const auto& b = melBands[(size_t)band];
+        if(bin < b.firstBin || bin >= b.firstBin + b.numBins)
+            return (T)0;
+
+        return melWeights[(size_t)(b.weightsOffset + bin - b.firstBin)];
+    }
+
+    const int fft_size;
+    const int hop_size;
+    const int num_bins;
+    const int num_mels;
+    const bool log_compression;
+
+private:
+    void computeFrame() noexcept
+    {
+        // unwrap the history buffer (oldest sample first), and apply the window
+        const auto numOldest = fft_size - writePos;
+        for(int n = 0; n < numOldest; ++n)
+            frame[(size_t)n] = history[(size_t)(writePos + n)] * window[(size_t)n];
+        for(int n = numOldest; n < fft_size; ++n)
+            frame[(size_t)n] = history[(size_t)(n - numOldest)] * window[(size_t)n];
+
+        if(num_mels == 0)
+        {
+            fft.performPowerSpectrum(frame.data(), features.data());
+        }
+        else
+        {
+            fft.performPowerSpectrum(frame.data(), power.data());
+            for(size_t m = 0; m < melBands.size(); ++m)
+            {
+                const auto& band = melBands[m];
+                const auto* p = power.data() + band.firstBin;
+                const auto* w = melWeights.data() + band.weightsOffset;
+
+                T sum = (T)0;
+                for(int k = 0; k < band.numBins; ++k)
+                    sum += w[k] * p[k];
+                features[m] = sum;
+            }
+        }
+
+        if(log_compression)
+        {
+            for(auto& x : features)
+                x = std::log(x + (T)1.0e-10);
+        }
+    }
+
+    void createMelFilterbank(double sample_rate, double f_min, double f_max)
+    {
+        auto hzToMel = [](double hz)
+        { return 2595.0 * std::log10(1.0 + hz / 700.0); };
+        auto melToHz = [](double mel)
+        { return 700.0 * (std::pow(10.0, mel / 2595.0) - 1.0); };
+
+        // band m spans [edges[m], edges[m + 2]], and peaks at edges[m + 1]
+        const auto melMin = hzToMel(f_min);
+        const auto melMax = hzToMel(f_max);
+        std::vector<double> edges((size_t)num_mels + 2);
+        for(size_t i = 0; i < edges.size(); ++i)
+            edges[i] = melToHz(melMin + (melMax - melMin) * (double)i / (double)(num_mels + 1));
+
+        const auto binWidth = sample_rate / (double)fft_size;
+        melBands.resize((size_t)num_mels);
+        for(size_t m = 0; m < melBands.size(); ++m)
+        {
+            const auto lower = edges[m];
+            const auto centre = edges[m + 1];
+            const auto upper = edges[m + 2];
+
+            auto& band = melBands[m];
+            band.firstBin = num_bins;
+            band.weightsOffset = (int)melWeights.size();
+            for(int k = 0; k < num_bins; ++k)
+            {
+                const auto freq = (double)k * binWidth;
+                double weight = 0.0;
+                if(freq > lower && freq <= centre)
+                    weight = (freq - lower) / (centre - lower);
+                else if(freq > centre && freq < upper)
+                    weight = (upper - freq) / (upper - centre);
+
+                if(weight <= 0.0)
+                    continue;
+
+                // the filters are triangular, so the non-zero weights are contiguous
+                if(band.numBins == 0)
+                    band.firstBin = k;
+
+                melWeights.push_back((T)weight);
+                band.numBins++;
+            }
+
+            if(band.numBins == 0)
+                band.firstBin = 0;
+        }
+    }
+
+    struct MelBand
+    {
+        int firstBin = 0;
+        int numBins = 0;
+        int weightsOffset = 0;
+    };
+
+    FFT<T> fft;
+
+    std::vector<T> window;
+    std::vector<T> history;
+    std::vector<T> frame;
+    std::vector<T> power;
+    std::vector<T> features;
+
+    std::vector<MelBand> melBands;
+    std::vector<T> melWeights;
+
+    int writePos = 0;
+    int hopCounter = 0;
+};
+
+} // namespace RTNeural
+
+#endif // SPECTRAL_FRONT_END_H_INCLUDED
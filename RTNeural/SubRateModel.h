@@ -0,0 +1,279 @@
+#ifndef SUB_RATE_MODEL_H_INCLUDED
+#define SUB_RATE_MODEL_H_INCLUDED
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "ModelT.h"
+#include "multirate/resampling.h"
+
+namespace RTNeural
+{
+
+/** How the outputs of a SubRateModel are reconstructed at the audio rate. */
+enum class SubRateInterpolation
+{
+    Linear, // linear interpolation between the two most recent model steps (latency: factor - 1 samples)
+    Cubic, // Catmull-Rom interpolation between the model steps (latency: 2 * factor - 1 samples)
+};
+
+#ifndef DOXYGEN
+namespace sub_rate_detail
+{
+    /** Layers without sample rate correction don't need preparing. */
+    template <typename LayerType>
+    void prepareLayer(LayerType&, double) noexcept
+    {
+    }
+
+    template <typename T, int in_size, int out_size>
+    void prepareLayer(LSTMLayerT<T, in_size, out_size, SampleRateCorrectionMode::NoInterp>& lstm, double delaySamples)
+    {
+        lstm.prepare(std::max((int)std::round(delaySamples), 1));
+    }
+
+    template <typename T, int in_size, int out_size>
+    void prepareLayer(LSTMLayerT<T, in_size, out_size, SampleRateCorrectionMode::LinInterp>& lstm, double delaySamples)
+    {
+        lstm.prepare((T)std::max(delaySamples, 1.0));
+    }
+
+    template <typename T, int in_size, int out_size>
+    void prepareLayer(CIFGLSTMLayerT<T, in_size, out_size, SampleRateCorrectionMode::NoInterp>& lstm, double delaySamples)
+    {
+        lstm.prepare(std::max((int)std::round(delaySamples), 1));
+    }
+
+    template <typename T, int in_size, int out_size>
+    void prepareLayer(CIFGLSTMLayerT<T, in_size, out_size, SampleRateCorrectionMode::LinInterp>& lstm, double delaySamples)
+    {
+        lstm.prepare((T)std::max(delaySamples, 1.0));
+    }
+
+    // combinators can be nested, so they need to be declared before they are defined
+    template <typename T, typename... Layers>
+    void prepareLayer(SequentialT<T, Layers...>& sequential, double delaySamples);
+
+    template <typename T, typename... Layers>
+    void prepareLayer(ResidualT<T, Layers...>& residual, double delaySamples);
+
+    template <typename T, ParallelMerge merge, typename... Branches>
+    void prepareLayer(ParallelT<T, merge, Branches...>& parallel, double delaySamples);
+
+    template <typename T, int factor, UpsamplingMode upsampling, typename... Layers>
+    void prepareLayer(DecimatedT<T, factor, upsampling, Layers...>& decimated, double delaySamples);
+
+    template <typename T, typename... Layers>
+    void prepareLayer(SequentialT<T, Layers...>& sequential, double delaySamples)
+    {
+        combinators_detail::forEach([delaySamples](auto& layer, size_t)
+            { prepareLayer(layer, delaySamples); },
+            sequential.layers);
+    }
+
+    template <typename T, typename... Layers>
+    void prepareLayer(ResidualT<T, Layers...>& residual, double delaySamples)
+    {
+        prepareLayer(residual.chain, delaySamples);
+    }
+
+    template <typename T, ParallelMerge merge, typename... Branches>
+    void prepareLayer(ParallelT<T, merge, Branches...>& parallel, double delaySamples)
+    {
+        combinators_detail::forEach([delaySamples](auto& branch, size_t)
+            { prepareLayer(branch, delaySamples); },
+            parallel.branches);
+    }
+
+    /** A decimated stage runs at 1 / factor of the surrounding rate, so it needs a shorter delay. */
+    template <typename T, int factor, UpsamplingMode upsampling, typename... Layers>
+    void prepareLayer(DecimatedT<T, factor, upsampling, Layers...>& decimated, double delaySamples)
+    {
+        prepareLayer(decimated.chain, delaySamples / (double)factor);
+    }
+
+    /** Dynamic models have no sample rate correction. */
+    template <typename ModelType>
+    void prepareModel(ModelType&, double) noexcept
+    {
+    }
+
+#if MODELT_AVAILABLE
+    template <typename T, int in_size, int out_size, typename... Layers>
+    void prepareModel(ModelT<T, in_size, out_size, Layers...>& model, double delaySamples)
+    {
+        model.forEachLayer([delaySamples](auto& layer, size_t)
+            { prepareLayer(layer, delaySamples); });
+    }
+#endif
+} // namespace sub_rate_detail
+#endif // DOXYGEN
+
+/**
+ *  Runs a model at a fraction of the audio rate.
+ *
+ *  Useful for models that produce slowly varying control signals
+ *  (e.g. envelopes or gains). The input is averaged over blocks of
+ *  `factor` samples, the model is run once per block on the averaged
+ *  input, and the model outputs are interpolated back to the audio
+ *  rate. The cost of running the model is reduced by `factor`.
+ *
+ *  If the model is a `ModelT` containing `LSTMLayerT`s or `CIFGLSTMLayerT`s
+ *  with sample rate correction, `prepare()` configures their recurrent delay
+ *  so that the recurrence runs at the rate that the model was trained at.
+ *
+ *  The model type may be `Model<T>` or `ModelT<...>`, or anything else with
+ *  `reset()`, `forward(const T*)` and `getOutputs()` methods. The wrapper
+ *  does not own the model.
+ *  ```
+ *  const auto factor = SubRateModel<float, ModelType>::getFactorForRate(sampleRate, 2000.0);
+ *  SubRateModel<float, ModelType> subRate { model, in_size, out_size, factor, SubRateInterpolation::Cubic };
+ *  subRate.prepare(sampleRate, 2000.0);
+ *  for(int n = 0; n < numSamples; ++n)
+ *      gain[n] = subRate.forward(&input[n]);
+ *  ```
+ */
+template <typename T, typename ModelType>
+class SubRateModel
+{
+public:
+    /**
+     * Constructs a wrapper which runs the model once every `factor` samples.
+     */
+    SubRateModel(ModelType& model, int in_size, int out_size, int factor, SubRateInterpolation interpolation = SubRateInterpolation::Linear)
+        : in_size(in_size)
+        , out_size(out_size)
+        , factor(std::max(factor, 1))
+        , interpolation(interpolation)
+        , model(model)
+        , inputSum((size_t)in_size, (T)0)
+        , modelIns((size_t)in_size, (T)0)
+        , history((size_t)num_history * out_size, (T)0)
+        , coeffs((size_t)num_coeffs * out_size, (T)0)
+        , outs((size_t)out_size, (T)0)
+    {
+    }
+
+    /**
+     * Returns the largest decimation factor that still runs the
+     * model at (or above) the rate that it was trained at.
+     */
+    static int getFactorForRate(double hostSampleRate, double trainedSampleRate) noexcept
+    {
+        return std::max((int)std::floor(hostSampleRate / trainedSampleRate), 1);
+    }
+
+    /**
+     * Prepares the model to run at `hostSampleRate / factor`, correcting
+     * the recurrent delay of any sample-rate-corrected LSTM layers so that
+     * the recurrence matches `trainedSampleRate`. Also resets the state.
+     */
+    void prepare(double hostSampleRate, double trainedSampleRate)
+    {
+        const auto modelSampleRate = hostSampleRate / (double)factor;
+        sub_rate_detail::prepareModel(model, modelSampleRate / trainedSampleRate);
+        reset();
+    }
+
+    /** Resets the state of the model and the interpolator. */
+    void reset()
+    {
+        model.reset();
+        std::fill(inputSum.begin(), inputSum.end(), (T)0);
+        std::fill(history.begin(), history.end(), (T)0);
+        std::fill(coeffs.begin(), coeffs.end(), (T)0);
+        std::fill(outs.begin(), outs.end(), (T)0);
+        phase = 0;
+        numModelSteps = 0;
+    }
+
+    /** Performs forward propagation for one audio-rate sample. */
+    inline T forward(const T* input) noexcept
+    {
+        if(multirate_detail::pool(input, inputSum.data(), modelIns.data(), in_size, phase, factor))
+            stepModel();
+
+        // interpolate from the previous step towards the current one
+        const auto t = multirate_detail::interpolation_position<T>(phase, factor);
+        if(interpolation == SubRateInterpolation::Linear)
+        {
+            const auto* yPrevious = history.data() + (num_history - 2) * out_size;
+            multirate_detail::interpolate_linear(yPrevious, yPrevious + out_size, outs.data(), out_size, t);
+        }
+        else
+        {
+            const auto* c = coeffs.data();
+            for(int i = 0; i < out_size; ++i)
+                outs[(size_t)i] = c[i] + t * (c[out_size + i] + t * (c[2 * out_size + i] + t * c[3 * out_size + i]));
+        }
+
+        return outs[0];
+    }
+
+    /** Returns a pointer to the (interpolated) outputs. */
+    inline const T* getOutputs() const noexcept { return outs.data(); }
+
+    /** Returns the latency of the interpolated outputs, in audio-rate samples. */
+    int getLatencySamples() const noexcept
+    {
+        return (interpolation == SubRateInterpolation::Linear ? 1 : 2) * factor - 1;
+    }
+
+    /** Returns the number of times the model has been run since the last reset. */
+    size_t getNumModelSteps() const noexcept { return numModelSteps; }
+
+    const int in_size;
+    const int out_size;
+    const int factor;
+    const SubRateInterpolation interpolation;
+
+private:
+    /** Runs the model on the averaged input, and updates the interpolation polynomials. */
+    void stepModel() noexcept
+    {
+        model.forward(modelIns.data());
+        numModelSteps++;
+
+        // history is [y(n-3), y(n-2), y(n-1), y(n)]
+        std::copy(history.begin() + out_size, history.end(), history.begin());
+        const auto* modelOuts = model.getOutputs();
+        std::copy(modelOuts, modelOuts + out_size, history.end() - out_size);
+
+        // linear interpolation reads y(n-1) and y(n) directly from the history
+        if(interpolation == SubRateInterpolation::Linear)
+            return;
+
+        // Catmull-Rom spline from y1 to y2
+        const auto* y0 = history.data();
+        const auto* y1 = y0 + out_size;
+        const auto* y2 = y1 + out_size;
+        const auto* y3 = y2 + out_size;
+        auto* c = coeffs.data();
+        for(int i = 0; i < out_size; ++i)
+        {
+            c[i] = y1[i];
+            c[out_size + i] = (T)0.5 * (y2[i] - y0[i]);
+            c[2 * out_size + i] = y0[i] - (T)2.5 * y1[i] + (T)2 * y2[i] - (T)0.5 * y3[i];
+            c[3 * out_size + i] = (T)0.5 * (y3[i] - y0[i]) + (T)1.5 * (y1[i] - y2[i]);
+        }
+    }
+
+    static constexpr int num_history = 4;
+    static constexpr int num_coeffs = 4;
+
+    ModelType& model;
+
+    std::vector<T> inputSum;
+    std::vector<T> modelIns;
+    std::vector<T> history; // [num_history][out_size]
+    std::vector<T> coeffs; // [num_coeffs][out_size], for cubic interpolation
+    std::vector<T> outs;
+
+    int phase = 0;
+    size_t numModelSteps = 0;
+};
+
+} // namespace RTNeural
+
+#endif // SUB_RATE_MODEL_H_INCLUDED
@@ -39,7 +39,9 @@ private:
 
 
 #include "../common.h"
+#include <algorithm>
 #include <cmath>
+#include <vector>
 
 namespace RTNeural
 {
@@ -460,6 +462,237 @@ public:
     T outs[size];
     T alpha[size];
 };
+
+/** Dynamic implementation of a sine activation layer (using `sin_approx()`). */
+template <typename T>
+class SinActivation final : public Activation<T>
+{
+public:
+    /** Constructs a sine activation layer for a given size. */
+    explicit SinActivation(int size)
+        : Activation<T>(
+            size, [](T x)
+            { return sin_approx(x); },
+            "sin")
+    {
+    }
+
+    SinActivation(std::initializer_list<int> sizes)
+        : SinActivation(*sizes.begin())
+    {
+    }
+
+    /** Performs forward propagation for sine activation. */
+    inline void forward(const T* input, T* out) noexcept override
+    {
+        for(int i = 0; i < Layer<T>::out_size; ++i)
+            out[i] = sin_approx(input[i]);
+    }
+};
+
+/** Static implementation of a sine activation layer (using `sin_approx()`). */
+template <typename T, int size>
+class SinActivationT
+{
+public:
+    static constexpr auto in_size = size;
+    static constexpr auto out_size = size;
+
+    SinActivationT() = default;
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "sin"; }
+
+    /** Returns true since this layer is an activation layer. */
+    constexpr bool isActivation() const noexcept { return true; }
+
+    void reset() { }
+
+    /** Performs forward propagation for sine activation. */
+    inline void forward(const T (&ins)[size]) noexcept
+    {
+        for(int i = 0; i < size; ++i)
+            outs[i] = sin_approx(ins[i]);
+    }
+
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[size];
+};
+
+/** Dynamic implementation of a cosine activation layer (using `cos_approx()`). */
+template <typename T>
+class CosActivation final : public Activation<T>
+{
+public:
+    /** Constructs a cosine activation layer for a given size. */
+    explicit CosActivation(int size)
+        : Activation<T>(
+            size, [](T x)
+            { return cos_approx(x); },
+            "cos")
+    {
+    }
+
+    CosActivation(std::initializer_list<int> sizes)
+        : CosActivation(*sizes.begin())
+    {
+    }
+
+    /** Performs forward propagation for cosine activation. */
+    inline void forward(const T* input, T* out) noexcept override
+    {
+        for(int i = 0; i < Layer<T>::out_size; ++i)
+            out[i] = cos_approx(input[i]);
+    }
+};
+
+/** Static implementation of a cosine activation layer (using `cos_approx()`). */
+template <typename T, int size>
+class CosActivationT
+{
+public:
+    static constexpr auto in_size = size;
+    static constexpr auto out_size = size;
+
+    CosActivationT() = default;
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "cos"; }
+
+    /** Returns true since this layer is an activation layer. */
+    constexpr bool isActivation() const noexcept { return true; }
+
+    void reset() { }
+
+    /** Performs forward propagation for cosine activation. */
+    inline void forward(const T (&ins)[size]) noexcept
+    {
+        for(int i = 0; i < size; ++i)
+            outs[i] = cos_approx(ins[i]);
+    }
+
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[size];
+};
+
+#ifndef DOXYGEN
+namespace snake_detail
+{
+    /** Returns 1 / alpha, or 0 for alpha = 0 (where x + sin^2(alpha x) / alpha tends to x). */
+    template <typename T>
+    inline T inverse_alpha(T alpha) noexcept
+    {
+        return alpha == (T)0 ? (T)0 : (T)1 / alpha;
+    }
+} // namespace snake_detail
+#endif // DOXYGEN
+
+/**
+ * Dynamic implementation of a Snake activation layer,
+ * `x + sin^2(alpha x) / alpha`, with a learned alpha for each channel
+ * (using `sin_approx()`).
+ */
+template <typename T>
+class SnakeActivation final : public Activation<T>
+{
+public:
+    /** Constructs a Snake activation layer for a given size, with alpha = 1. */
+    explicit SnakeActivation(int size)
+        : Activation<T>(size, {}, "snake")
+        , alpha((size_t)size, (T)1)
+        , invAlpha((size_t)size, (T)1)
+    {
+    }
+
+    SnakeActivation(std::initializer_list<int> sizes)
+        : SnakeActivation(*sizes.begin())
+    {
+    }
+
+    /** Performs forward propagation for Snake activation. */
+    inline void forward(const T* input, T* out) noexcept override
+    {
+        for(int i = 0; i < Layer<T>::out_size; ++i)
+        {
+            const auto s = sin_approx(alpha[(size_t)i] * input[i]);
+            out[i] = input[i] + invAlpha[(size_t)i] * s * s;
+        }
+    }
+
+    /** Sets alpha for each channel (or one alpha for all channels). */
+    void setAlphaVals(const std::vector<T>& alphaVals)
+    {
+        if(alphaVals.size() == 1)
+            std::fill(alpha.begin(), alpha.end(), alphaVals[0]);
+        else
+            std::copy(alphaVals.begin(), alphaVals.begin() + Layer<T>::out_size, alpha.begin());
+
+        std::transform(alpha.begin(), alpha.end(), invAlpha.begin(), snake_detail::inverse_alpha<T>);
+    }
+
+    /** Returns alpha for a channel. */
+    T getAlpha(int channel) const noexcept { return alpha[(size_t)channel]; }
+
+private:
+    std::vector<T> alpha;
+    std::vector<T> invAlpha;
+};
+
+/**
+ * Static implementation of a Snake activation layer,
+ * `x + sin^2(alpha x) / alpha`, with a learned alpha for each channel
+ * (using `sin_approx()`).
+ */
+template <typename T, int size>
+class SnakeActivationT
+{
+public:
+    static constexpr auto in_size = size;
+    static constexpr auto out_size = size;
+
+    SnakeActivationT()
+    {
+        std::fill(std::begin(outs), std::end(outs), (T)0);
+        std::fill(std::begin(alpha), std::end(alpha), (T)1);
+        std::fill(std::begin(invAlpha), std::end(invAlpha), (T)1);
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "snake"; }
+
+    /** Returns false since this layer has weights even though it is an activation layer. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    void reset() { }
+
+    /** Performs forward propagation for Snake activation. */
+    inline void forward(const T (&ins)[size]) noexcept
+    {
+        for(int i = 0; i < size; ++i)
+        {
+            const auto s = sin_approx(alpha[i] * ins[i]);
+            outs[i] = ins[i] + invAlpha[i] * s * s;
+        }
+    }
+
+    /** Sets alpha for each channel (or one alpha for all channels). */
+    void setAlphaVals(const std::vector<T>& alphaVals)
+    {
+        if(alphaVals.size() == 1)
+            std::fill(std::begin(alpha), std::end(alpha), alphaVals[0]);
+        else
+            std::copy(alphaVals.begin(), alphaVals.begin() + size, std::begin(alpha));
+
+        std::transform(std::begin(alpha), std::end(alpha), std::begin(invAlpha), snake_detail::inverse_alpha<T>);
+    }
+
+    /** Returns alpha for a channel. */
+    T getAlpha(int channel) const noexcept { return alpha[channel]; }
+
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[size];
+
+private:
+    T alpha alignas(RTNEURAL_DEFAULT_ALIGNMENT)[size];
+    T invAlpha alignas(RTNEURAL_DEFAULT_ALIGNMENT)[size];
+};
 } // namespace RTNeural
 
 
@@ -0,0 +1,311 @@
+#ifndef BATCH_LAYERS_H_INCLUDED
+#define BATCH_LAYERS_H_INCLUDED
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "../Layer.h"
+#include "../common.h"
+
+namespace RTNeural
+{
+
+#ifndef DOXYGEN
+namespace batch_detail
+{
+    /**
+     * Row-major matrix multiply-accumulate: C[M x N] += A[M x K] * B[K x N].
+     *
+     * Four rows of C are updated together, so that each row of B is loaded
+     * once for every four rows of A. The columns are processed in blocks
+     * which are small enough for the four rows of C to stay in the L1 cache,
+     * and the inner loops run along contiguous rows, so that the compiler
+     * can vectorise them.
+     */
+    template <typename T>
+    void gemm_accumulate(const T* A, const T* B, T* C, int M, int N, int K) noexcept
+    {
+        constexpr int n_block = 512 / (int)sizeof(T);
+
+        for(int n0 = 0; n0 < N; n0 += n_block)
+        {
+            const auto n_size = std::min(n_block, N - n0);
+
+            int m = 0;
+            for(; m + 4 <= M; m += 4)
+            {
+                T* c0 = C + (m + 0) * N + n0;
+                T* c1 = C + (m + 1) * N + n0;
+                T* c2 = C + (m + 2) * N + n0;
+                T* c3 = C + (m + 3) * N + n0;
+                for(int k = 0; k < K; ++k)
+                {
+                    const auto a0 = A[(m + 0) * K + k];
+                    const auto a1 = A[(m + 1) * K + k];
+                    const auto a2 = A[(m + 2) * K + k];
+                    const auto a3 = A[(m + 3) * K + k];
+                    const T* b = B + k * N + n0;
+                    for(int j = 0; j < n_size; ++j)
+                    {
+                        c0[j] += a0 * b[j];
+                        c1[j] += a1 * b[j];
+                        c2[j] += a2 * b[j];
+                        c3[j] += a3 * b[j];
+                    }
+                }
+            }
+
+            // remaining rows
+            for(; m < M; ++m)
+            {
+                T* c = C + m * N + n0;
+                for(int k = 0; k < K; ++k)
+                {
+                    const auto a = A[m * K + k];
+                    const T* b = B + k * N + n0;
+                    for(int j = 0; j < n_size; ++j)
+                        c[j] += a * b[j];
+                }
+            }
+        }
+    }
+
+    /** Fills each of the M rows of C[M x N] with the vector `row`. */
+    template <typename T>
+    void broadcast_rows(const T* row, T* C, int M, int N) noexcept
+    {
+        for(int m = 0; m < M; ++m)
+            std::copy(row, row + N, C + m * N);
+    }
+} // namespace batch_detail
+#endif // DOXYGEN
+
+/**
+ * Virtual base class for a neural network layer that processes
+ * a batch of independent streams at once.
+ *
+ * Inputs and outputs are stored stream-major, i.e.
+ * input[batch_size][in_size] and output[batch_size][out_size].
+ * Streams with `active[b] == false` must leave their state untouched,
+ * which allows sequences of different lengths to be processed together.
+ */
+template <typename T>
+class BatchLayer
+{
+public:
+    BatchLayer(int in_size, int out_size, int max_batch_size)
+        : in_size(in_size)
+        , out_size(out_size)
+        , max_batch_size(max_batch_size)
+    {
+    }
+
+    virtual ~BatchLayer() = default;
+
+    /** Returns the name of this layer. */
+    virtual std::string getName() const noexcept { return ""; }
+
+    /** Resets the state of every stream in this layer. */
+    virtual void reset() { }
+
+    /** Implements the forward propagation step for a batch of streams. */
+    virtual void forward(const T* input, T* out, int batch_size, const bool* active) noexcept = 0;
+
+    const int in_size;
+    const int out_size;
+    const int max_batch_size;
+};
+
+/** Runs a stateless layer (e.g. an activation) on each stream of a batch. */
+template <typename T>
+class StatelessBatchLayer final : public BatchLayer<T>
+{
+public:
+    StatelessBatchLayer(Layer<T>* layer, int max_batch_size)
+        : BatchLayer<T>(layer->in_size, layer->out_size, max_batch_size)
+        , layer(layer)
+    {
+    }
+
+    ~StatelessBatchLayer() override { delete layer; }
+
+    std::string getName() const noexcept override { return layer->getName(); }
+
+    void forward(const T* input, T* out, int batch_size, const bool*) noexcept override
+    {
+        for(int b = 0; b < batch_size; ++b)
+            layer->forward(input + b * this->in_size, out + b * this->out_size);
+    }
+
+private:
+    Layer<T>* layer;
+};
+
+/** Fully-connected layer, processing a batch of streams as one matrix multiply. */
+template <typename T>
+class DenseBatch final : public BatchLayer<T>
+{
+public:
+    DenseBatch(int in_size, int out_size, int max_batch_size)
+        : BatchLayer<T>(in_size, out_size, max_batch_size)
+        , weights((size_t)in_size * out_size, (T)0)
+        , bias((size_t)out_size, (T)0)
+    {
+    }
+
+    std::string getName() const noexcept override { return "dense"; }
+
+    void forward(const T* input, T* out, int batch_size, const bool*) noexcept override
+    {
+        batch_detail::broadcast_rows(bias.data(), out, batch_size, this->out_size);
+        batch_detail::gemm_accumulate(input, weights.data(), out, batch_size, this->out_size, this->in_size);
+    }
+
+    /**
+     * Sets the layer weights from a given vector.
+     *
+     * The dimension of the weights vector must be
+     * weights[out_size][in_size]
+     */
+    void setWeights(const std::vector<std::vector<T>>& newWeights)
+    {
+        // stored transposed, as weights[in_size][out_size]
+        for(int i = 0; i < this->out_size; ++i)
+            for(int k = 0; k < this->in_size; ++k)
+                weights[(size_t)k * this->out_size + i] = newWeights[i][k];
+    }
+
+    /**
+     * Sets the layer bias from a given array of size
+     * bias[out_size]
+     */
+    void setBias(const T* b)
+    {
+        std::copy(b, b + this->out_size, bias.begin());
+    }
+
+private:
+    std::vector<T> weights;
+    std::vector<T> bias;
+};
+
+/**
+ * LSTM layer (tanh activation, sigmoid recurrent activation),
+ * processing a batch of independent streams.
+ *
+ * At each step, the input and recurrent projections for all the
+ * streams are computed as two matrix multiplies, so the weights
+ * are loaded once per step, rather than once per stream.
+ */
+template <typename T>
+class LSTMLayerBatch final : public BatchLayer<T>
+{
+public:
+    LSTMLayerBatch(int in_size, int out_size, int max_batch_size)
+        : BatchLayer<T>(in_size, out_size, max_batch_size)
+        , W((size_t)in_size * 4 * out_size, (T)0)
+        , U((size_t)out_size * 4 * out_size, (T)0)
+        , bias((size_t)4 * out_size, (T)0)
+        , gates((size_t)max_batch_size * 4 * out_size, (T)0)
+        , ht1((size_t)max_batch_size * out_size, (T)0)
+        , ct1((size_t)max_batch_size * out_size, (T)0)
+    {
+    }
+
+    std::string getName() const noexcept override { return "lstm"; }
+
+    /** Resets the state of every stream. */
+    void reset() override
+    {
+        std::fill(ht1.begin(), ht1.end(), (T)0);
+        std::fill(ct1.begin(), ct1.end(), (T)0);
+    }
+
+    /** Resets the state of a single stream. */
+    void reset(int stream)
+    {
+        std::fill(ht1.begin() + stream * this->out_size, ht1.begin() + (stream + 1) * this->out_size, (T)0);
+        std::fill(ct1.begin() + stream * this->out_size, ct1.begin() + (stream + 1) * this->out_size, (T)0);
+    }
+
+    void forward(const T* input, T* h, int batch_size, const bool* active) noexcept override
+    {
+        const auto H = this->out_size;
+        const auto G = 4 * H;
+
+        // gates[b] = bias + W^T x[b] + U^T h[b]
+        batch_detail::broadcast_rows(bias.data(), gates.data(), batch_size, G);
+        batch_detail::gemm_accumulate(input, W.data(), gates.data(), batch_size, G, this->in_size);
+        batch_detail::gemm_accumulate(ht1.data(), U.data(), gates.data(), batch_size, G, H);
+
+        for(int b = 0; b < batch_size; ++b)
+        {
+            T* hOut = h + b * H;
+            T* hState = ht1.data() + b * H;
+            if(active != nullptr && !active[b])
+            {
+                std::copy(hState, hState + H, hOut);
+                continue;
+            }
+
+            const T* g = gates.data() + b * G; // keras gate order: i, f, c, o
+            T* cState = ct1.data() + b * H;
+            for(int i = 0; i < H; ++i)
+            {
+                const auto it = sigmoid(g[i]);
+                const auto ft = sigmoid(g[i + H]);
+                const auto ctHat = std::tanh(g[i + 2 * H]);
+                const auto ot = sigmoid(g[i + 3 * H]);
+                cState[i] = ft * cState[i] + it * ctHat;
+                hOut[i] = ot * std::tanh(cState[i]);
+            }
+            std::copy(hOut, hOut + H, hState);
+        }
+    }
+
+    /**
+     * Sets the layer kernel weights.
+     *
+     * The weights vector must have size weights[in_size][4 * out_size]
+     */
+    void setWVals(const std::vector<std::vector<T>>& wVals)
+    {
+        for(int i = 0; i < this->in_size; ++i)
+            std::copy(wVals[i].begin(), wVals[i].begin() + 4 * this->out_size, W.begin() + (size_t)i * 4 * this->out_size);
+    }
+
+    /**
+     * Sets the layer recurrent weights.
+     *
+     * The weights vector must have size weights[out_size][4 * out_size]
+     */
+    void setUVals(const std::vector<std::vector<T>>& uVals)
+    {
+        for(int i = 0; i < this->out_size; ++i)
+            std::copy(uVals[i].begin(), uVals[i].begin() + 4 * this->out_size, U.begin() + (size_t)i * 4 * this->out_size);
+    }
+
+    /**
+     * Sets the layer bias.
+     *
+     * The bias vector must have size weights[4 * out_size]
+     */
+    void setBVals(const std::vector<T>& bVals)
+    {
+        std::copy(bVals.begin(), bVals.begin() + 4 * this->out_size, bias.begin());
+    }
+
+private:
+    std::vector<T> W; // kernel weights [in_size][4 * out_size]
+    std::vector<T> U; // recurrent weights [out_size][4 * out_size]
+    std::vector<T> bias; // [4 * out_size]
+
+    std::vector<T> gates; // [max_batch_size][4 * out_size]
+    std::vector<T> ht1; // [max_batch_size][out_size]
+    std::vector<T> ct1; // [max_batch_size][out_size]
+};
+
+} // namespace RTNeural
+
+#endif // BATCH_LAYERS_H_INCLUDED
@@ -0,0 +1,288 @@
+#ifndef COMBINATORS_H_INCLUDED
+#define COMBINATORS_H_INCLUDED
+
+#include <algorithm>
+#include <initializer_list>
+#include <string>
+#include <tuple>
+#include <utility>
+
+namespace RTNeural
+{
+
+#ifndef DOXYGEN
+namespace combinators_detail
+{
+    template <typename... Layers>
+    using first_t = std::tuple_element_t<0, std::tuple<Layers...>>;
+
+    template <typename... Layers>
+    using last_t = std::tuple_element_t<sizeof...(Layers) - 1, std::tuple<Layers...>>;
+
+    template <typename Fn, typename Tuple, size_t... Ix>
+    void forEach(Fn&& fn, Tuple& tuple, std::index_sequence<Ix...>)
+    {
+        (void)std::initializer_list<int> { ((void)fn(std::get<Ix>(tuple), Ix), 0)... };
+    }
+
+    template <typename Fn, typename... Layers>
+    void forEach(Fn&& fn, std::tuple<Layers...>& tuple)
+    {
+        forEach(std::forward<Fn>(fn), tuple, std::index_sequence_for<Layers...> {});
+    }
+
+    /** Runs each layer in a tuple on the outputs of the previous layer. */
+    template <size_t idx, size_t Niter>
+    struct chain_unroll
+    {
+        template <typename Tuple>
+        static void call(Tuple& t) noexcept
+        {
+            std::get<idx>(t).forward(std::get<idx - 1>(t).outs);
+            chain_unroll<idx + 1, Niter - 1>::call(t);
+        }
+    };
+
+    template <size_t idx>
+    struct chain_unroll<idx, 0>
+    {
+        template <typename Tuple>
+        static void call(Tuple&) noexcept { }
+    };
+
+    template <int... sizes>
+    struct sum_sizes
+    {
+        static constexpr int value = 0;
+    };
+
+    template <int size, int... sizes>
+    struct sum_sizes<size, sizes...>
+    {
+        static constexpr int value = size + sum_sizes<sizes...>::value;
+    };
+} // namespace combinators_detail
+#endif // DOXYGEN
+
+/**
+ * Static implementation of a sequential chain of layers, which can be
+ * used as a single layer (e.g. as a branch of a ParallelT).
+ *
+ * The outputs of the chain are the outputs of its last layer,
+ * so no copies are made.
+ */
+template <typename T, typename... Layers>
+class SequentialT
+{
+    using FirstLayer = combinators_detail::first_t<Layers...>;
+    using LastLayer = combinators_detail::last_t<Layers...>;
+    static constexpr size_t n_layers = sizeof...(Layers);
+
+public:
+    static constexpr auto in_size = FirstLayer::in_size;
+    static constexpr auto out_size = LastLayer::out_size;
+
+    SequentialT() = default;
+    SequentialT(const SequentialT& other)
+        : layers(other.layers)
+    {
+    }
+
+    SequentialT& operator=(const SequentialT& other)
+    {
+        layers = other.layers;
+        return *this;
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "sequential"; }
+
+    /** Returns false since a sequential chain is not an activation. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Resets the state of the layers in the chain. */
+    void reset()
+    {
+        combinators_detail::forEach([](auto& layer, size_t)
+            { layer.reset(); },
+            layers);
+    }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T (&ins)[in_size]) noexcept
+    {
+        std::get<0>(layers).forward(ins);
+        combinators_detail::chain_unroll<1, n_layers - 1>::call(layers);
+    }
+
+    /** Get a reference to the layer at index `Index`. */
+    template <int Index>
+    auto& get() noexcept
+    {
+        return std::get<Index>(layers);
+    }
+
+    /** The layers in the chain. */
+    std::tuple<Layers...> layers;
+
+    /** The outputs of the chain (i.e. the outputs of the last layer). */
+    T (&outs)[out_size] = std::get<n_layers - 1>(layers).outs;
+};
+
+/**
+ * Static implementation of a residual (skip) connection around a
+ * chain of layers: `outs = ins + layers(ins)`.
+ *
+ * The chain must have the same input and output size. The skip
+ * connection is added as the outputs are written, with no
+ * intermediate copies.
+ */
+template <typename T, typename... Layers>
+class ResidualT
+{
+    using ChainType = SequentialT<T, Layers...>;
+
+public:
+    static constexpr auto in_size = ChainType::in_size;
+    static constexpr auto out_size = ChainType::out_size;
+
+    static_assert(in_size == out_size, "The input and output sizes of a residual block must be the same!");
+
+    ResidualT()
+    {
+        for(int i = 0; i < out_size; ++i)
+            outs[i] = (T)0;
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "residual"; }
+
+    /** Returns false since a residual block is not an activation. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Resets the state of the layers in the block. */
+    void reset() { chain.reset(); }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T (&ins)[in_size]) noexcept
+    {
+        chain.forward(ins);
+        for(int i = 0; i < out_size; ++i)
+            outs[i] = ins[i] + chain.outs[i];
+    }
+
+    /** Get a reference to the layer at index `Index`. */
+    template <int Index>
+    auto& get() noexcept
+    {
+        return chain.template get<Index>();
+    }
+
+    /** The chain of layers inside the residual connection. */
+    ChainType chain;
+
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+};
+
+/** How the outputs of the branches of a ParallelT are merged. */
+enum class ParallelMerge
+{
+    Add,
+    Concat,
+};
+
+/**
+ * Static implementation of a set of parallel branches, which all
+ * process the same input. The outputs of the branches are either added
+ * together (in which case the branches must have the same output size),
+ * or concatenated. Each branch is a single layer, or a SequentialT.
+ * ```
+ * ParallelT<float, ParallelMerge::Add,
+ *     DenseT<float, 8, 4>,
+ *     SequentialT<float, DenseT<float, 8, 8>, TanhActivationT<float, 8>, DenseT<float, 8, 4>>
+ * > layer;
+ * ```
+ */
+template <typename T, ParallelMerge merge, typename... Branches>
+class ParallelT
+{
+    using FirstBranch = combinators_detail::first_t<Branches...>;
+
+public:
+    static constexpr auto in_size = FirstBranch::in_size;
+    static constexpr auto out_size = merge == ParallelMerge::Add ? FirstBranch::out_size : combinators_detail::sum_sizes<Branches::out_size...>::value;
+
+    ParallelT()
+    {
+        for(int i = 0; i < out_size; ++i)
+            outs[i] = (T)0;
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "parallel"; }
+
+    /** Returns false since a parallel block is not an activation. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Resets the state of every branch. */
+    void reset()
+    {
+        combinators_detail::forEach([](auto& branch, size_t)
+            { branch.reset(); },
+            branches);
+    }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T (&ins)[in_size]) noexcept
+    {
+        combinators_detail::forEach([&ins](auto& branch, size_t)
+            { branch.forward(ins); },
+            branches);
+
+        mergeOutputs(std::index_sequence_for<Branches...> {});
+    }
+
+    /** Get a reference to the branch at index `Index`. */
+    template <int Index>
+    auto& get() noexcept
+    {
+        return std::get<Index>(branches);
+    }
+
+    /** The parallel branches. */
+    std::tuple<Branches...> branches;
+
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+
+private:
+    template <size_t... Ix, ParallelMerge m = merge>
+    inline std::enable_if_t<m == ParallelMerge::Add, void>
+    mergeOutputs(std::index_sequence<Ix...>) noexcept
+    {
+        static_assert(combinators_detail::sum_sizes<(Branches::out_size != out_size)...>::value == 0,
+            "Branches must have the same output size to be added!");
+
+        for(int i = 0; i < out_size; ++i)
+        {
+            T sum = (T)0;
+            (void)std::initializer_list<int> { ((void)(sum += std::get<Ix>(branches).outs[i]), 0)... };
+            outs[i] = sum;
+        }
+    }
+
+    template <size_t... Ix, ParallelMerge m = merge>
+    inline std::enable_if_t<m == ParallelMerge::Concat, void>
+    mergeOutputs(std::index_sequence<Ix...>) noexcept
+    {
+        auto* out = outs;
+        (void)std::initializer_list<int> { ((void)(out = std::copy(std::get<Ix>(branches).outs, std::get<Ix>(branches).outs + std::tuple_element_t<Ix, std::tuple<Branches...>>::out_size, out)), 0)... };
+    }
+};
+
+/** Static implementation of parallel branches, with concatenated outputs. */
+template <typename T, typename... Branches>
+using ConcatT = ParallelT<T, ParallelMerge::Concat, Branches...>;
+
+} // namespace RTNeural
+
+#endif // COMBINATORS_H_INCLUDED
@@ -1,5 +1,41 @@
 #pragma once
 
+#include <cmath>
+#include <cstddef>
+#include <numeric>
+#include <type_traits>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+/**
+ * Set to 1 to use compensated summation for the float dot products
+ * in the Dense and LSTM layers (see `RTNeural::dot_product()`).
+ */
+#ifndef RTNEURAL_COMPENSATED_SUMS
+#define RTNEURAL_COMPENSATED_SUMS 0
+#endif
+
+/**
+ * Software prefetching of weights in the Dense and LSTM kernels (see
+ * `RTNeural::prefetch_distance()`). Set `RTNEURAL_PREFETCH=0` to disable it.
+ * Layers with less than `RTNEURAL_PREFETCH_MIN_BYTES` of weights are not
+ * prefetched, and the others prefetch about `RTNEURAL_PREFETCH_AHEAD_BYTES`
+ * ahead of the weights that they are reading.
+ */
+#ifndef RTNEURAL_PREFETCH
+#define RTNEURAL_PREFETCH 1
+#endif
+
+#ifndef RTNEURAL_PREFETCH_MIN_BYTES
+#define RTNEURAL_PREFETCH_MIN_BYTES (256 * 1024)
+#endif
+
+#ifndef RTNEURAL_PREFETCH_AHEAD_BYTES
+#define RTNEURAL_PREFETCH_AHEAD_BYTES 1024
+#endif
+
 namespace RTNeural
 {
 
@@ -42,6 +78,193 @@ static inline T tanh_approx(T x) noexcept
     auto denominator = (T)2027025 + x2 * ((T)945945 + x2 * ((T)51975 + x2 * ((T)630 + x2)));
     return numerator / denominator;
 }
+
+#ifndef DOXYGEN
+namespace sin_detail
+{
+    // Cody-Waite split of pi, so that the argument reduction (x - n * pi) stays accurate
+    constexpr double pi_hi = 3.140625; // exact with 8 significant bits
+    constexpr double pi_lo = 9.676535897932384626e-4;
+    constexpr double inv_pi = 0.318309886183790671538;
+
+    /** Odd polynomial approximation of sin(r) for r in [-pi/2, pi/2] (max. error 1.8e-11). */
+    template <typename T>
+    static inline T sin_poly(T r) noexcept
+    {
+        const auto r2 = r * r;
+        return r + r * r2 * ((T)-1.66666666064655010163e-1 + r2 * ((T)8.33333049562518501806e-3 + r2 * ((T)-1.98408040343600178502e-4 + r2 * ((T)2.75226186456203761507e-6 + r2 * (T)-2.38466908246434989773e-8))));
+    }
+
+    /**
+     * Returns sin(x), or cos(x) = -sin(x - pi/2) for `cosine`, from the reduced
+     * argument r = x - (k + phase) * pi. There are no branches (not even to
+     * clamp the input, since compilers don't vectorize floating-point compares
+     * by default), so loops over this function can be vectorized. The period
+     * index k must fit into an int, i.e. |x| < 1e9.
+     */
+    template <typename T, bool cosine>
+    static inline T sin_cos_approx(T x) noexcept
+    {
+        constexpr auto phase = cosine ? (T)0.5 : (T)0;
+
+        const auto q = x * (T)inv_pi - phase;
+        const auto k = (int)(q + std::copysign((T)0.5, q)); // nearest integer
+
+        const auto n = (T)k + phase;
+        const auto r = (x - n * (T)pi_hi) - n * (T)pi_lo;
+        const auto sign = (T)(1 - 2 * (k & 1)) * (cosine ? (T)-1 : (T)1); // (-1)^k, negated for cos
+        return sign * sin_poly<T>(r);
+    }
+} // namespace sin_detail
+#endif // DOXYGEN
+
+/**
+ * Approximation of std::sin(), from a polynomial over [-pi/2, pi/2] after
+ * range reduction. The error is about the rounding error of T for |x| < 1e4,
+ * and the input must be in the range |x| < 1e9.
+ */
+template <typename T>
+static inline T sin_approx(T x) noexcept
+{
+    return sin_detail::sin_cos_approx<T, false>(x);
+}
+
+/** Approximation of std::cos(), using the same polynomial as `sin_approx()`. */
+template <typename T>
+static inline T cos_approx(T x) noexcept
+{
+    return sin_detail::sin_cos_approx<T, true>(x);
+}
+
+/** Returns true if sums of type T use compensated summation (only float, when `RTNEURAL_COMPENSATED_SUMS` is set). */
+template <typename T>
+constexpr bool use_compensated_sums() noexcept
+{
+    return RTNEURAL_COMPENSATED_SUMS && std::is_same<T, float>::value;
+}
+
+/** Adds a value to a sum with Kahan compensation, where the compensated sum is `sum - comp`. */
+template <typename T>
+static inline void kahan_add(T& sum, T& comp, T value) noexcept
+{
+    const auto y = value - comp;
+    const auto t = sum + y;
+    comp = (t - sum) - y;
+    sum = t;
+}
+
+/**
+ * Dot product with compensated summation. The products are accumulated
+ * in several independent lanes, each with its own Kahan compensation, so
+ * that the loop can still be vectorized, and then the lanes are summed.
+ * This only works if the compiler keeps the order of the floating-point
+ * operations, so it should not be used with `-ffast-math`.
+ */
+template <typename T>
+static inline T compensated_dot_product(const T* a, const T* b, int n) noexcept
+{
+    constexpr int lanes = 8;
+    T sums[lanes] {};
+    T comps[lanes] {};
+
+    int k = 0;
+    for(; k + lanes <= n; k += lanes)
+    {
+        for(int l = 0; l < lanes; ++l)
+            kahan_add(sums[l], comps[l], a[k + l] * b[k + l]);
+    }
+
+    for(; k < n; ++k)
+        kahan_add(sums[0], comps[0], a[k] * b[k]);
+
+    T sum = (T)0;
+    T comp = (T)0;
+    for(int l = 0; l < lanes; ++l)
+    {
+        kahan_add(sum, comp, sums[l]);
+        kahan_add(sum, comp, -comps[l]);
+    }
+
+    return sum - comp;
+}
+
+/** Hints to the CPU that the cache line at `ptr` will be read soon. */
+static inline void prefetch(const void* ptr) noexcept
+{
+#if RTNEURAL_PREFETCH && (defined(__GNUC__) || defined(__clang__))
+    __builtin_prefetch(ptr, 0, 3);
+#elif RTNEURAL_PREFETCH && defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch(static_cast<const char*>(ptr), _MM_HINT_T0);
+#else
+    (void)ptr;
+#endif
+}
+
+/** Prefetches `num_bytes` of memory starting at `ptr`, one cache line at a time. */
+static inline void prefetch_bytes(const void* ptr, size_t num_bytes) noexcept
+{
+    constexpr size_t cache_line_bytes = 64;
+    for(size_t b = 0; b < num_bytes; b += cache_line_bytes)
+        prefetch(static_cast<const char*>(ptr) + b);
+}
+
+/**
+ * Returns how many rows ahead a kernel should prefetch, while reading
+ * the rows (of `row_bytes` each) of a weight matrix of `matrix_bytes`.
+ * Returns 0 for matrices that should not need prefetching, since they
+ * stay in the cache between samples. Otherwise, the distance covers
+ * about `RTNEURAL_PREFETCH_AHEAD_BYTES`, and at least one row, so that
+ * the prefetched rows arrive before the kernel reaches them.
+ */
+constexpr int prefetch_distance(size_t row_bytes, size_t matrix_bytes) noexcept
+{
+    return (!RTNEURAL_PREFETCH || matrix_bytes < (size_t)RTNEURAL_PREFETCH_MIN_BYTES || row_bytes == 0)
+        ? 0
+        : (int)((RTNEURAL_PREFETCH_AHEAD_BYTES + row_bytes - 1) / row_bytes);
+}
+
+/**
+ * Prefetches the row `distance` rows ahead of `row` in a matrix of `num_rows` rows.
+ * Past the end of the matrix, the first bytes of `next` are prefetched instead
+ * (e.g. the weights that the kernel uses after this matrix).
+ */
+template <typename T>
+static inline void prefetch_row(const T* mat, int row, int num_rows, int row_size, int distance,
+    const void* next = nullptr, size_t next_bytes = 0) noexcept
+{
+    const auto ahead = row + distance;
+    const auto row_bytes = (size_t)row_size * sizeof(T);
+    if(ahead < num_rows)
+        prefetch_bytes(mat + (size_t)ahead * (size_t)row_size, row_bytes);
+    else if(next != nullptr && (size_t)(ahead - num_rows) * row_bytes < next_bytes)
+        prefetch_bytes(static_cast<const char*>(next) + (size_t)(ahead - num_rows) * row_bytes, row_bytes);
+}
+
+/** Dot product, with compensated summation if `use_compensated_sums<T>()`. */
+template <typename T>
+static inline T dot_product(const T* a, const T* b, int n) noexcept
+{
+    if(use_compensated_sums<T>())
+        return compensated_dot_product(a, b, n);
+
+    return std::inner_product(a, a + n, b, (T)0);
+}
+
+/**
+ * Row-major matrix-vector product, `out[j] = dot(mat[j], vec)`, which prefetches
+ * `distance` rows ahead (and then into `next`) while it computes each row.
+ */
+template <typename T>
+static inline void mat_vec_prefetched(const T* mat, const T* vec, T* out, int num_rows, int row_size, int distance,
+    const void* next = nullptr, size_t next_bytes = 0) noexcept
+{
+    for(int j = 0; j < num_rows; ++j)
+    {
+        if(distance > 0)
+            prefetch_row(mat, j, num_rows, row_size, distance, next, next_bytes);
+        out[j] = dot_product(mat + (size_t)j * (size_t)row_size, vec, row_size);
+    }
+}
 } // namespace RTNeural
 
 #if RTNEURAL_USE_EIGEN
@@ -385,7 +608,7 @@ namespace RTNeural
 template <typename T>
 static inline T vMult(const T* arg1, const T* arg2, int dim) noexcept
 {
-    return std::inner_product(arg1, arg1 + dim, arg2, (T)0);
+    return dot_product(arg1, arg2, dim);
 }
 
 template <typename T>
@@ -6,6 +6,11 @@
 #include <vector>
 
 #include "../Layer.h"
+#include "../common.h"
+
+#ifndef RTNEURAL_DENSE_COLUMN_MAJOR
+#define RTNEURAL_DENSE_COLUMN_MAJOR 1
+#endif
 
 namespace RTNeural
 {
@@ -26,7 +31,7 @@ public:
 
     inline T forward(const T* input) noexcept
     {
-        return std::inner_product(weights, weights + in_size, input, (T)0) + bias;
+        return dot_product(weights, input, in_size) + bias;
     }
 
     void setWeights(const T* newWeights)
@@ -41,6 +46,8 @@ public:
 
     T getBias() const noexcept { return bias; }
 
+    void prefetchWeights() const noexcept { prefetch_bytes(weights, sizeof(T) * (size_t)in_size); }
+
 private:
     const int in_size;
     T bias;
@@ -60,6 +67,7 @@ public:
     /** Constructs a dense layer for a given input and output size. */
     Dense(int in_size, int out_size)
         : Layer<T>(in_size, out_size)
+        , prefetchRows(prefetch_distance(sizeof(T) * (size_t)in_size, sizeof(T) * (size_t)in_size * (size_t)out_size))
     {
         subLayers = new Dense1<T>*[out_size];
         for(int i = 0; i < out_size; ++i)
@@ -96,7 +104,13 @@ public:
     inline void forward(const T* input, T* out) noexcept override
     {
         for(int i = 0; i < Layer<T>::out_size; ++i)
+        {
+            // each row of weights is allocated separately, so the hardware prefetcher can't follow them
+            if(prefetchRows > 0 && i + prefetchRows < Layer<T>::out_size)
+                subLayers[i + prefetchRows]->prefetchWeights();
+
             out[i] = subLayers[i]->forward(input);
+        }
     }
 
     /**
@@ -144,12 +158,45 @@ public:
 
 private:
     Dense1<T>** subLayers;
+    int prefetchRows;
 };
 
 //====================================================
+#ifndef DOXYGEN
+namespace dense_detail
+{
+    /**
+     * Returns true if a DenseT layer of this shape should store its weights
+     * in column-major order. Computing each output as a dot product needs a
+     * horizontal reduction per output, which is slow when there are many
+     * outputs, so wider layers broadcast each input across the outputs instead.
+     * With only a few inputs, the compiler fully unrolls each dot product and
+     * vectorizes across the outputs anyway, and with only a few outputs it tends
+     * to vectorize the column-major loop across the inputs, so the row-major
+     * kernel is as fast or faster for those shapes.
+     */
+    constexpr bool use_column_major(int in_size, int out_size) noexcept
+    {
+        return RTNEURAL_DENSE_COLUMN_MAJOR && in_size >= 8 && out_size >= 32;
+    }
+} // namespace dense_detail
+#endif // DOXYGEN
+
 /**
  * Static implementation of a fully-connected (dense) layer,
  * with no activation.
+ *
+ * The weights layout is chosen at compile time from the layer shape.
+ * Small layers compute each output as a dot product over a row of
+ * weights. Larger layers (at least 8 inputs and 32 outputs, see
+ * `dense_detail::use_column_major()`) store the weights column-major,
+ * and accumulate each input (multiplied by a column of weights) into
+ * all of the outputs at once, which vectorizes without any horizontal
+ * reductions. To always use the row-major layout, define
+ * `RTNEURAL_DENSE_COLUMN_MAJOR=0`.
+ *
+ * For layers whose weights are too large to stay in the cache, the kernel
+ * prefetches the weights a few rows ahead (see `prefetch_distance()`).
  */
 template <typename T, int in_sizet, int out_sizet>
 class DenseT
@@ -160,6 +207,12 @@ public:
     static constexpr auto in_size = in_sizet;
     static constexpr auto out_size = out_sizet;
 
+    /** True if the weights are stored in column-major order. */
+    static constexpr bool column_major = dense_detail::use_column_major(in_sizet, out_sizet);
+
+    /** The number of rows (or columns, if column-major) of weights that the kernel prefetches ahead. */
+    static constexpr int prefetch_rows = prefetch_distance(sizeof(T) * (column_major ? out_sizet : in_sizet), sizeof(T) * weights_size);
+
     DenseT()
     {
         for(int i = 0; i < weights_size; ++i)
@@ -181,11 +234,63 @@ public:
     /** Reset is a no-op, since Dense does not have state. */
     void reset() { }
 
+    /** Prefetches the first weights used by `forward()`, if the layer is large enough to need prefetching. */
+    void prefetchWeights() const noexcept
+    {
+        if(prefetch_rows > 0)
+            prefetch_bytes(weights, std::min(sizeof(weights), (size_t)RTNEURAL_PREFETCH_AHEAD_BYTES));
+    }
+
     /** Performs forward propagation for this layer. */
     inline void forward(const T (&ins)[in_size]) noexcept
     {
-        for(int i = 0; i < out_size; ++i)
-            outs[i] = std::inner_product(ins, ins + in_size, &weights[i * in_size], (T)0) + bias[i];
+        if(column_major && use_compensated_sums<T>())
+        {
+            // each output has its own Kahan compensation, so this still vectorizes across the outputs
+            T sums alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+            T comps alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size] {};
+            std::copy(bias, bias + out_size, sums);
+            for(int k = 0; k < in_size; ++k)
+            {
+                if(prefetch_rows > 0)
+                    prefetch_row(weights, k, in_size, out_size, prefetch_rows);
+
+                const auto x = ins[k];
+                const auto* w = &weights[k * out_size];
+                for(int i = 0; i < out_size; ++i)
+                    kahan_add(sums[i], comps[i], w[i] * x);
+            }
+
+            for(int i = 0; i < out_size; ++i)
+                outs[i] = sums[i] - comps[i];
+        }
+        else if(column_major)
+        {
+            // accumulate into a local buffer, since `ins` might alias `outs`
+            T sums alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+            std::copy(bias, bias + out_size, sums);
+            for(int k = 0; k < in_size; ++k)
+            {
+                if(prefetch_rows > 0)
+                    prefetch_row(weights, k, in_size, out_size, prefetch_rows);
+
+                const auto x = ins[k];
+                const auto* w = &weights[k * out_size];
+                for(int i = 0; i < out_size; ++i)
+                    sums[i] += w[i] * x;
+            }
+            std::copy(sums, sums + out_size, outs);
+        }
+        else
+        {
+            for(int i = 0; i < out_size; ++i)
+            {
+                if(prefetch_rows > 0)
+                    prefetch_row(weights, i, out_size, in_size, prefetch_rows);
+
+                outs[i] = dot_product(ins, &weights[i * in_size], in_size) + bias[i];
+            }
+        }
     }
 
     /**
@@ -200,8 +305,7 @@ public:
         {
             for(int k = 0; k < in_size; ++k)
             {
-                auto idx = i * in_size + k;
-                weights[idx] = newWeights[i][k];
+                weights[weight_index(i, k)] = newWeights[i][k];
             }
         }
     }
@@ -218,8 +322,7 @@ public:
         {
             for(int k = 0; k < in_size; ++k)
             {
-                auto idx = i * in_size + k;
-                weights[idx] = newWeights[i][k];
+                weights[weight_index(i, k)] = newWeights[i][k];
             }
         }
     }
@@ -237,8 +340,13 @@ public:
     T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
 
 private:
-    T bias[out_size];
-    T weights[weights_size];
+    static constexpr int weight_index(int i, int k) noexcept
+    {
+        return column_major ? k * out_size + i : i * in_size + k;
+    }
+
+    T bias alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+    T weights alignas(RTNEURAL_DEFAULT_ALIGNMENT)[weights_size];
 };
 
 } // namespace RTNeural
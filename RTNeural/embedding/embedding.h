@@ -0,0 +1,444 @@
+#ifndef EMBEDDING_H_INCLUDED
+#define EMBEDDING_H_INCLUDED
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+#include "../Layer.h"
+#include "../dense/dense.h"
+
+namespace RTNeural
+{
+
+#ifndef DOXYGEN
+namespace embedding_detail
+{
+    /** Returns the index of a category stored as a float, rounded and clamped to [0, num_categories). */
+    template <typename T>
+    inline int category_index(T x, int num_categories) noexcept
+    {
+        if(!(x >= (T)0)) // also catches NaNs
+            return 0;
+
+        return std::min((int)(x + (T)0.5), num_categories - 1);
+    }
+
+    /**
+     * Finds the category selected by a block of one-hot inputs. Returns the index
+     * of the input that is 1, -1 if all of the inputs are 0, or -2 if the inputs
+     * are not one-hot (e.g. several inputs are set, or an input is not 0 or 1).
+     */
+    template <typename T>
+    inline int one_hot_category(const T* ins, int count) noexcept
+    {
+        int category = -1;
+        for(int i = 0; i < count; ++i)
+        {
+            if(ins[i] == (T)0)
+                continue;
+
+            if(ins[i] != (T)1 || category >= 0)
+                return -2;
+
+            category = i;
+        }
+
+        return category;
+    }
+
+    /** Computes `out = bias + sum_c(ins[c] * columns[c])`, for columns of `size` values. */
+    template <typename T>
+    inline void add_columns(const T* bias, const T* columns, const T* ins, int count, int size, T* out) noexcept
+    {
+        std::copy(bias, bias + size, out);
+        for(int c = 0; c < count; ++c)
+        {
+            if(ins[c] == (T)0)
+                continue;
+
+            const auto* column = columns + c * size;
+            for(int i = 0; i < size; ++i)
+                out[i] += ins[c] * column[i];
+        }
+    }
+} // namespace embedding_detail
+#endif // DOXYGEN
+
+/**
+ * Dynamic implementation of an embedding layer.
+ *
+ * The layer has a single input, which is the index of a category (e.g. an
+ * amp channel or cabinet), and outputs the row of the embedding table for that
+ * category. The index is rounded to the nearest integer, and clamped to the
+ * number of categories.
+ */
+template <typename T>
+class Embedding final : public Layer<T>
+{
+public:
+    /** Constructs an embedding layer for a given number of categories and embedding size. */
+    Embedding(int num_embeddings, int embedding_dim)
+        : Layer<T>(1, embedding_dim)
+        , num_embeddings(num_embeddings)
+        , weights((size_t)num_embeddings * (size_t)embedding_dim, (T)0)
+    {
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept override { return "embedding"; }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T* input, T* out) noexcept override
+    {
+        const auto* row = getRow(embedding_detail::category_index(input[0], num_embeddings));
+        std::copy(row, row + Layer<T>::out_size, out);
+    }
+
+    /**
+     * Sets the embedding table from a given vector.
+     *
+     * The dimension of the weights vector must be
+     * weights[num_embeddings][embedding_dim]
+     */
+    void setWeights(const std::vector<std::vector<T>>& newWeights)
+    {
+        for(int c = 0; c < num_embeddings; ++c)
+            std::copy(newWeights[(size_t)c].begin(), newWeights[(size_t)c].begin() + Layer<T>::out_size, weights.begin() + c * Layer<T>::out_size);
+    }
+
+    /** Returns the row of the embedding table for a category. */
+    const T* getRow(int category) const noexcept { return weights.data() + category * Layer<T>::out_size; }
+
+    /** Returns the weights value at the given indices. */
+    T getWeight(int category, int i) const noexcept { return getRow(category)[i]; }
+
+    const int num_embeddings;
+
+private:
+    std::vector<T> weights;
+};
+
+/**
+ * Dynamic implementation of a dense layer, where some of the inputs are a
+ * one-hot encoding of a category (e.g. an amp channel, fed to the model as
+ * a one-hot vector).
+ *
+ * The one-hot inputs only select a column of the weights, which is the same
+ * as adding a row of an embedding table to the bias. This layer keeps those
+ * columns in an embedding table, and only updates the bias when the category
+ * changes, so each sample only costs a dense layer over the other inputs.
+ * If the one-hot inputs are not actually one-hot (e.g. several categories
+ * are blended), the columns are accumulated for each sample instead, so the
+ * outputs always match a regular Dense layer.
+ *
+ * The json loader replaces a Dense layer with this layer when the model has
+ * one-hot inputs (see `json_parser::rewriteOneHotInputs()`).
+ */
+template <typename T>
+class OneHotDense final : public Layer<T>
+{
+public:
+    /**
+     * Constructs a dense layer, where inputs [one_hot_start, one_hot_start + one_hot_count) are one-hot.
+     * At least one of the inputs must not be one-hot.
+     */
+    OneHotDense(int in_size, int out_size, int one_hot_start, int one_hot_count)
+        : Layer<T>(in_size, out_size)
+        , one_hot_start(one_hot_start)
+        , one_hot_count(one_hot_count)
+        , dense(in_size - one_hot_count, out_size)
+        , columns(one_hot_count, out_size)
+        , bias((size_t)out_size, (T)0)
+        , activeBias((size_t)out_size, (T)0)
+        , denseIns((size_t)(in_size - one_hot_count), (T)0)
+    {
+        assert(one_hot_start >= 0 && one_hot_count > 0 && one_hot_start + one_hot_count <= in_size && one_hot_count < in_size);
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept override { return "dense"; }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T* input, T* out) noexcept override
+    {
+        const auto* oneHotIns = input + one_hot_start;
+        const auto newCategory = embedding_detail::one_hot_category(oneHotIns, one_hot_count);
+        if(newCategory != category || newCategory == -2)
+        {
+            category = newCategory;
+            if(category >= 0)
+            {
+                const auto* column = columns.getRow(category);
+                for(int i = 0; i < Layer<T>::out_size; ++i)
+                    activeBias[(size_t)i] = bias[(size_t)i] + column[i];
+            }
+            else
+            {
+                embedding_detail::add_columns(bias.data(), columns.getRow(0), oneHotIns, one_hot_count, Layer<T>::out_size, activeBias.data());
+            }
+
+            dense.setBias(activeBias.data());
+        }
+
+        std::copy(input, oneHotIns, denseIns.begin());
+        std::copy(oneHotIns + one_hot_count, input + Layer<T>::in_size, denseIns.begin() + one_hot_start);
+        dense.forward(denseIns.data(), out);
+    }
+
+    /**
+     * Sets the layer weights from a given vector.
+     *
+     * The dimension of the weights vector must be
+     * weights[out_size][in_size]
+     */
+    void setWeights(const std::vector<std::vector<T>>& newWeights)
+    {
+        std::vector<std::vector<T>> denseWeights((size_t)Layer<T>::out_size);
+        std::vector<std::vector<T>> columnWeights((size_t)one_hot_count, std::vector<T>((size_t)Layer<T>::out_size));
+        for(int i = 0; i < Layer<T>::out_size; ++i)
+        {
+            const auto& row = newWeights[(size_t)i];
+            denseWeights[(size_t)i].assign(row.begin(), row.begin() + one_hot_start);
+            denseWeights[(size_t)i].insert(denseWeights[(size_t)i].end(), row.begin() + one_hot_start + one_hot_count, row.begin() + Layer<T>::in_size);
+
+            for(int c = 0; c < one_hot_count; ++c)
+                columnWeights[(size_t)c][(size_t)i] = row[(size_t)(one_hot_start + c)];
+        }
+
+        dense.setWeights(denseWeights);
+        columns.setWeights(columnWeights);
+        category = -3; // refresh the bias on the next sample
+    }
+
+    /**
+     * Sets the layer bias from a given array of size
+     * bias[out_size]
+     */
+    void setBias(const T* b)
+    {
+        std::copy(b, b + Layer<T>::out_size, bias.begin());
+        category = -3;
+    }
+
+    /** Returns the weights value at the given indices (as for a regular Dense layer). */
+    T getWeight(int i, int k) const noexcept
+    {
+        if(k >= one_hot_start && k < one_hot_start + one_hot_count)
+            return columns.getWeight(k - one_hot_start, i);
+
+        return dense.getWeight(i, k < one_hot_start ? k : k - one_hot_count);
+    }
+
+    /** Returns the bias value at the given index. */
+    T getBias(int i) const noexcept { return bias[(size_t)i]; }
+
+    /** Returns the category selected by the current one-hot inputs (-1 if none, -2 if not one-hot). */
+    int getCategory() const noexcept { return category; }
+
+    const int one_hot_start;
+    const int one_hot_count;
+
+private:
+    Dense<T> dense;
+    Embedding<T> columns;
+
+    std::vector<T> bias;
+    std::vector<T> activeBias;
+    std::vector<T> denseIns;
+    int category = -3;
+};
+
+//====================================================
+/**
+ * Static implementation of an embedding layer.
+ *
+ * The layer has a single input, which is the index of a category, and
+ * outputs the row of the embedding table for that category. The index is
+ * rounded to the nearest integer, and clamped to the number of categories.
+ * The outputs are only copied when the category changes.
+ */
+template <typename T, int num_embeddingst, int embedding_dimt>
+class EmbeddingT
+{
+public:
+    static constexpr auto in_size = 1;
+    static constexpr auto out_size = embedding_dimt;
+    static constexpr auto num_embeddings = num_embeddingst;
+
+    EmbeddingT()
+    {
+        std::fill(std::begin(weights), std::end(weights), (T)0);
+        std::fill(std::begin(outs), std::end(outs), (T)0);
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "embedding"; }
+
+    /** Returns false since embedding is not an activation layer. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Reset is a no-op, since Embedding does not have state. */
+    void reset() { }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T (&ins)[in_size]) noexcept
+    {
+        const auto newCategory = embedding_detail::category_index(ins[0], num_embeddings);
+        if(newCategory == category)
+            return;
+
+        category = newCategory;
+        std::copy(getRow(category), getRow(category) + out_size, outs);
+    }
+
+    /**
+     * Sets the embedding table from a given vector.
+     *
+     * The dimension of the weights vector must be
+     * weights[num_embeddings][embedding_dim]
+     */
+    void setWeights(const std::vector<std::vector<T>>& newWeights)
+    {
+        for(int c = 0; c < num_embeddings; ++c)
+            std::copy(newWeights[(size_t)c].begin(), newWeights[(size_t)c].begin() + out_size, weights + c * out_size);
+
+        category = -1;
+    }
+
+    /** Returns the row of the embedding table for a category. */
+    const T* getRow(int c) const noexcept { return weights + c * out_size; }
+
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+
+private:
+    T weights alignas(RTNEURAL_DEFAULT_ALIGNMENT)[num_embeddings * out_size];
+    int category = -1;
+};
+
+/**
+ * Static implementation of a dense layer, where inputs
+ * [one_hot_start, one_hot_start + one_hot_count) are a one-hot encoding
+ * of a category. The one-hot columns of the weights are kept in an embedding
+ * table, and the bias is only updated when the category changes, so each
+ * sample only costs a `DenseT` over the other inputs (see `OneHotDense`).
+ * It is loaded from a regular "dense" json entry:
+ * ```
+ * ModelT<float, 5, 1,
+ *     OneHotDenseT<float, 5, 16, 1, 4>, // one audio input, and a one-hot amp channel
+ *     TanhActivationT<float, 16>,
+ *     LSTMLayerT<float, 16, 16>,
+ *     DenseT<float, 16, 1>
+ * > model;
+ * ```
+ */
+template <typename T, int in_sizet, int out_sizet, int one_hot_startt, int one_hot_countt>
+class OneHotDenseT
+{
+    static constexpr auto dense_in_size = in_sizet - one_hot_countt;
+
+public:
+    static constexpr auto in_size = in_sizet;
+    static constexpr auto out_size = out_sizet;
+    static constexpr auto one_hot_start = one_hot_startt;
+    static constexpr auto one_hot_count = one_hot_countt;
+
+    static_assert(one_hot_start >= 0 && one_hot_count > 0 && one_hot_start + one_hot_count <= in_size, "The one-hot inputs must be inside of the layer inputs!");
+    static_assert(dense_in_size > 0, "A layer with only one-hot inputs should be an EmbeddingT, with the category index as its input!");
+
+    OneHotDenseT()
+    {
+        std::fill(std::begin(columns), std::end(columns), (T)0);
+        std::fill(std::begin(bias), std::end(bias), (T)0);
+        std::fill(std::begin(activeBias), std::end(activeBias), (T)0);
+        std::fill(std::begin(outs), std::end(outs), (T)0);
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "dense"; }
+
+    /** Returns false since dense is not an activation layer. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Reset is a no-op, since Dense does not have state. */
+    void reset() { }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T (&ins)[in_size]) noexcept
+    {
+        const auto* oneHotIns = ins + one_hot_start;
+        const auto newCategory = embedding_detail::one_hot_category(oneHotIns, one_hot_count);
+        if(newCategory != category || newCategory == -2)
+        {
+            category = newCategory;
+            if(category >= 0)
+            {
+                const auto* column = columns + category * out_size;
+                for(int i = 0; i < out_size; ++i)
+                    activeBias[i] = bias[i] + column[i];
+            }
+            else
+            {
+                embedding_detail::add_columns(bias, columns, oneHotIns, one_hot_count, out_size, activeBias);
+            }
+
+            dense.setBias(activeBias);
+        }
+
+        T denseIns alignas(RTNEURAL_DEFAULT_ALIGNMENT)[dense_in_size];
+        std::copy(ins, oneHotIns, denseIns);
+        std::copy(oneHotIns + one_hot_count, ins + in_size, denseIns + one_hot_start);
+        dense.forward(denseIns);
+        std::copy(dense.outs, dense.outs + out_size, outs);
+    }
+
+    /**
+     * Sets the layer weights from a given vector.
+     *
+     * The dimension of the weights vector must be
+     * weights[out_size][in_size]
+     */
+    void setWeights(const std::vector<std::vector<T>>& newWeights)
+    {
+        std::vector<std::vector<T>> denseWeights((size_t)out_size);
+        for(int i = 0; i < out_size; ++i)
+        {
+            const auto& row = newWeights[(size_t)i];
+            denseWeights[(size_t)i].assign(row.begin(), row.begin() + one_hot_start);
+            denseWeights[(size_t)i].insert(denseWeights[(size_t)i].end(), row.begin() + one_hot_start + one_hot_count, row.begin() + in_size);
+
+            for(int c = 0; c < one_hot_count; ++c)
+                columns[c * out_size + i] = row[(size_t)(one_hot_start + c)];
+        }
+
+        dense.setWeights(denseWeights);
+        category = -3; // refresh the bias on the next sample
+    }
+
+    /**
+     * Sets the layer bias from a given array of size
+     * bias[out_size]
+     */
+    void setBias(const T* b)
+    {
+        std::copy(b, b + out_size, bias);
+        category = -3;
+    }
+
+    /** Returns the category selected by the current one-hot inputs (-1 if none, -2 if not one-hot). */
+    int getCategory() const noexcept { return category; }
+
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+
+private:
+    DenseT<T, dense_in_size, out_size> dense;
+
+    T columns alignas(RTNEURAL_DEFAULT_ALIGNMENT)[one_hot_count * out_size];
+    T bias alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+    T activeBias alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+    int category = -3;
+};
+
+} // namespace RTNeural
+
+#endif // EMBEDDING_H_INCLUDED
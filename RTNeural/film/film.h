@@ -0,0 +1,222 @@
+#ifndef FILM_H_INCLUDED
+#define FILM_H_INCLUDED
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "../Model.h"
+
+namespace RTNeural
+{
+
+/**
+ * Dynamic implementation of a FiLM (feature-wise linear modulation) layer.
+ *
+ * Each channel of the input is scaled and shifted, `out = gamma * in + beta`,
+ * where `gamma` and `beta` are computed from some control inputs (e.g. the
+ * values of the knobs on a plugin) by a small conditioning network. The
+ * conditioning network has `num_controls` inputs, and `2 * size` outputs:
+ * `[gamma_0, ..., gamma_(size-1), beta_0, ..., beta_(size-1)]`.
+ *
+ * The conditioning network is only run when the control inputs change (see
+ * `setConditioning()`), so the audio path only costs one multiply-add per
+ * channel. Until the conditioning has been set, the layer passes its input
+ * through unchanged.
+ */
+template <typename T>
+class FiLM final : public Layer<T>
+{
+public:
+    /** Constructs a FiLM layer, with an (empty) conditioning network. */
+    FiLM(int size, int num_controls)
+        : Layer<T>(size, size)
+        , num_controls(num_controls)
+        , conditioning(std::make_unique<Model<T>>(num_controls))
+        , gamma((size_t)size, (T)1)
+        , beta((size_t)size, (T)0)
+        , controls((size_t)num_controls, (T)0)
+    {
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept override { return "film"; }
+
+    /**
+     * Resets the state of the conditioning network.
+     * The current scale and shift are kept.
+     */
+    void reset() override { conditioning->reset(); }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T* input, T* out) noexcept override
+    {
+        for(int i = 0; i < Layer<T>::out_size; ++i)
+            out[i] = gamma[(size_t)i] * input[i] + beta[(size_t)i];
+    }
+
+    /**
+     * Sets the control inputs, of size controls[num_controls].
+     *
+     * If the controls have changed since the last call (or this is the first call),
+     * the conditioning network is run to compute the new scale and shift. Returns
+     * true if the conditioning network was run.
+     */
+    bool setConditioning(const T* newControls) noexcept
+    {
+        if(hasConditioning && std::equal(controls.begin(), controls.end(), newControls))
+            return false;
+
+        std::copy(newControls, newControls + num_controls, controls.begin());
+        hasConditioning = true;
+
+        conditioning->forward(controls.data());
+        const auto* conditioningOuts = conditioning->getOutputs();
+        std::copy(conditioningOuts, conditioningOuts + Layer<T>::out_size, gamma.begin());
+        std::copy(conditioningOuts + Layer<T>::out_size, conditioningOuts + 2 * Layer<T>::out_size, beta.begin());
+        return true;
+    }
+
+    /** Returns the conditioning network. */
+    Model<T>& getConditioning() noexcept { return *conditioning; }
+
+    /**
+     * Marks the current scale and shift as out of date (e.g. after the weights of
+     * the conditioning network have changed), so the next call to `setConditioning()`
+     * runs the conditioning network.
+     */
+    void invalidateConditioning() noexcept { hasConditioning = false; }
+
+    /** Replaces the conditioning network. */
+    void setConditioningNetwork(std::unique_ptr<Model<T>> network)
+    {
+        conditioning = std::move(network);
+        invalidateConditioning();
+    }
+
+    /** Returns the current per-channel scale. */
+    const T* getGamma() const noexcept { return gamma.data(); }
+
+    /** Returns the current per-channel shift. */
+    const T* getBeta() const noexcept { return beta.data(); }
+
+    const int num_controls;
+
+private:
+    std::unique_ptr<Model<T>> conditioning;
+
+    std::vector<T> gamma;
+    std::vector<T> beta;
+    std::vector<T> controls;
+    bool hasConditioning = false;
+};
+
+//====================================================
+/**
+ * Static implementation of a FiLM (feature-wise linear modulation) layer.
+ *
+ * Each channel of the input is scaled and shifted, `out = gamma * in + beta`,
+ * where `gamma` and `beta` are computed from some control inputs by a small
+ * conditioning network (typically a `ModelT`), with `2 * size` outputs:
+ * `[gamma_0, ..., gamma_(size-1), beta_0, ..., beta_(size-1)]`. The conditioning
+ * network is only run when the control inputs change (see `setConditioning()`).
+ * ```
+ * using Conditioning = ModelT<float, 3, 32, DenseT<float, 3, 16>, TanhActivationT<float, 16>, DenseT<float, 16, 32>>;
+ * ModelT<float, 1, 1,
+ *     DenseT<float, 1, 16>,
+ *     FiLMT<float, 16, Conditioning>,
+ *     TanhActivationT<float, 16>,
+ *     DenseT<float, 16, 1>
+ * > model;
+ * model.get<1>().setConditioning(knobs);
+ * ```
+ */
+template <typename T, int sizet, typename ConditioningType>
+class FiLMT
+{
+public:
+    static constexpr auto in_size = sizet;
+    static constexpr auto out_size = sizet;
+    static constexpr auto num_controls = ConditioningType::input_size;
+
+    static_assert(ConditioningType::output_size == 2 * sizet, "The FiLM conditioning network must have 2 * size outputs!");
+
+    FiLMT()
+    {
+        std::fill(std::begin(gamma), std::end(gamma), (T)1);
+        std::fill(std::begin(beta), std::end(beta), (T)0);
+        std::fill(std::begin(controls), std::end(controls), (T)0);
+        std::fill(std::begin(outs), std::end(outs), (T)0);
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "film"; }
+
+    /** Returns false since FiLM is not an activation. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /**
+     * Resets the state of the conditioning network.
+     * The current scale and shift are kept.
+     */
+    void reset() { conditioning.reset(); }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T (&ins)[in_size]) noexcept
+    {
+        for(int i = 0; i < out_size; ++i)
+            outs[i] = gamma[i] * ins[i] + beta[i];
+    }
+
+    /**
+     * Sets the control inputs, of size controls[num_controls].
+     *
+     * If the controls have changed since the last call (or this is the first call),
+     * the conditioning network is run to compute the new scale and shift. Returns
+     * true if the conditioning network was run.
+     */
+    bool setConditioning(const T* newControls) noexcept
+    {
+        if(hasConditioning && std::equal(std::begin(controls), std::end(controls), newControls))
+            return false;
+
+        std::copy(newControls, newControls + num_controls, controls);
+        hasConditioning = true;
+
+        conditioning.forward(controls);
+        const auto* conditioningOuts = conditioning.getOutputs();
+        std::copy(conditioningOuts, conditioningOuts + out_size, gamma);
+        std::copy(conditioningOuts + out_size, conditioningOuts + 2 * out_size, beta);
+        return true;
+    }
+
+    /** Returns the conditioning network. */
+    ConditioningType& getConditioning() noexcept { return conditioning; }
+
+    /**
+     * Marks the current scale and shift as out of date (e.g. after the weights of
+     * the conditioning network have changed), so the next call to `setConditioning()`
+     * runs the conditioning network.
+     */
+    void invalidateConditioning() noexcept { hasConditioning = false; }
+
+    /** Returns the current per-channel scale. */
+    const T* getGamma() const noexcept { return gamma; }
+
+    /** Returns the current per-channel shift. */
+    const T* getBeta() const noexcept { return beta; }
+
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+
+private:
+    ConditioningType conditioning;
+
+    T gamma alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+    T beta alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+    T controls alignas(RTNEURAL_DEFAULT_ALIGNMENT)[num_controls];
+    bool hasConditioning = false;
+};
+
+} // namespace RTNeural
+
+#endif // FILM_H_INCLUDED
@@ -0,0 +1,366 @@
+#ifndef CIFG_LSTM_H_INCLUDED
+#define CIFG_LSTM_H_INCLUDED
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include "lstm.h"
+
+namespace RTNeural
+{
+
+#ifndef DOXYGEN
+namespace cifg_detail
+{
+    /**
+     * Computes the new cell state and outputs of a CIFG LSTM from the gate
+     * pre-activations `gates[3 * size]`, ordered [input, candidate, output].
+     * The forget gate is (1 - input gate), so `c = c1 + i * (candidate - c1)`.
+     */
+    template <typename T, typename CellType, typename CellVecType, typename OutVecType>
+    inline void compute_outputs(T* gates, const CellType* c1, CellVecType& c, OutVecType& h, int size) noexcept
+    {
+        for(int k = 0; k < size; ++k)
+            gates[k] = lstm_detail::sigmoid_scalar(gates[k]);
+        for(int k = size; k < 2 * size; ++k)
+            gates[k] = std::tanh(gates[k]);
+        for(int k = 2 * size; k < 3 * size; ++k)
+            gates[k] = lstm_detail::sigmoid_scalar(gates[k]);
+
+        for(int i = 0; i < size; ++i)
+            c[i] = c1[i] + (CellType)gates[i] * ((CellType)gates[size + i] - c1[i]);
+
+        for(int i = 0; i < size; ++i)
+            h[i] = gates[2 * size + i] * std::tanh((T)c[i]);
+    }
+} // namespace cifg_detail
+#endif // DOXYGEN
+
+/**
+ * Dynamic implementation of a LSTM layer with a coupled input and forget
+ * gate (CIFG), where the forget gate is (1 - input gate). With one gate fewer,
+ * the layer has three quarters of the weights of a regular LSTM.
+ *
+ * The weights are in the same format as `LSTMLayer`, with the forget gate
+ * left out, i.e. the gates are ordered [input, candidate, output]. The weights
+ * of all three gates are stored in one matrix, so each sample only needs one
+ * kernel and one recurrent matrix-vector product.
+ *
+ * To ensure that the recurrent state is initialized to zero,
+ * please make sure to call `reset()` before your first call to
+ * the `forward()` method.
+ */
+template <typename T>
+class CIFGLSTMLayer final : public Layer<T>
+{
+public:
+    /** Constructs a CIFG LSTM layer for a given input and output size. */
+    CIFGLSTMLayer(int in_size, int out_size)
+        : Layer<T>(in_size, out_size)
+        , W((size_t)(3 * out_size * in_size), (T)0)
+        , U((size_t)(3 * out_size * out_size), (T)0)
+        , b((size_t)(3 * out_size), (T)0)
+        , gates((size_t)(3 * out_size), (T)0)
+        , kernelOuts((size_t)(3 * out_size), (T)0)
+        , ht1((size_t)out_size, (T)0)
+        , ct1((size_t)out_size, (CellType)0)
+        , recurrentPrefetchRows(prefetch_distance(sizeof(T) * (size_t)out_size, sizeof(T) * (W.size() + U.size())))
+        , kernelPrefetchRows(prefetch_distance(sizeof(T) * (size_t)in_size, sizeof(T) * (W.size() + U.size())))
+    {
+    }
+
+    /** Resets the state of the LSTM. */
+    void reset() override
+    {
+        std::fill(ht1.begin(), ht1.end(), (T)0);
+        std::fill(ct1.begin(), ct1.end(), (CellType)0);
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept override { return "cifg_lstm"; }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T* input, T* h) noexcept override
+    {
+        const auto out_size = Layer<T>::out_size;
+        const auto in_size = Layer<T>::in_size;
+
+        mat_vec_prefetched(U.data(), ht1.data(), gates.data(), 3 * out_size, out_size, recurrentPrefetchRows, W.data(), sizeof(T) * W.size());
+        mat_vec_prefetched(W.data(), input, kernelOuts.data(), 3 * out_size, in_size, kernelPrefetchRows);
+        for(int k = 0; k < 3 * out_size; ++k)
+            gates[(size_t)k] += kernelOuts[(size_t)k] + b[(size_t)k];
+
+        cifg_detail::compute_outputs(gates.data(), ct1.data(), ct1, h, out_size);
+        std::copy(h, h + out_size, ht1.begin());
+    }
+
+    /**
+     * Sets the layer kernel weights.
+     *
+     * The weights vector must have size weights[in_size][3 * out_size]
+     */
+    void setWVals(const std::vector<std::vector<T>>& wVals)
+    {
+        for(int i = 0; i < Layer<T>::in_size; ++i)
+            for(int k = 0; k < 3 * Layer<T>::out_size; ++k)
+                W[(size_t)(k * Layer<T>::in_size + i)] = wVals[(size_t)i][(size_t)k];
+    }
+
+    /**
+     * Sets the layer recurrent weights.
+     *
+     * The weights vector must have size weights[out_size][3 * out_size]
+     */
+    void setUVals(const std::vector<std::vector<T>>& uVals)
+    {
+        for(int i = 0; i < Layer<T>::out_size; ++i)
+            for(int k = 0; k < 3 * Layer<T>::out_size; ++k)
+                U[(size_t)(k * Layer<T>::out_size + i)] = uVals[(size_t)i][(size_t)k];
+    }
+
+    /**
+     * Sets the layer bias.
+     *
+     * The bias vector must have size weights[3 * out_size]
+     */
+    void setBVals(const std::vector<T>& bVals)
+    {
+        std::copy(bVals.begin(), bVals.begin() + 3 * Layer<T>::out_size, b.begin());
+    }
+
+    /** Returns the cell state of the LSTM. */
+    const lstm_cell_type<T>* getCellState() const noexcept { return ct1.data(); }
+
+private:
+    using CellType = lstm_cell_type<T>;
+
+    std::vector<T> W; // kernel weights [3 * out_size][in_size]
+    std::vector<T> U; // recurrent weights [3 * out_size][out_size]
+    std::vector<T> b;
+
+    std::vector<T> gates;
+    std::vector<T> kernelOuts;
+    std::vector<T> ht1;
+    std::vector<CellType> ct1;
+
+    const int recurrentPrefetchRows;
+    const int kernelPrefetchRows;
+};
+
+//====================================================
+/**
+ * Static implementation of a LSTM layer with a coupled input and forget
+ * gate (CIFG), where the forget gate is (1 - input gate).
+ *
+ * The weights are in the same format as `LSTMLayerT`, with the forget gate
+ * left out, i.e. the gates are ordered [input, candidate, output]. The weights
+ * of all three gates are stored in one matrix, so each sample only needs one
+ * kernel and one recurrent matrix-vector product. Sample rate correction
+ * works the same as for `LSTMLayerT`.
+ *
+ * To ensure that the recurrent state is initialized to zero,
+ * please make sure to call `reset()` before your first call to
+ * the `forward()` method.
+ */
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr = SampleRateCorrectionMode::None>
+class CIFGLSTMLayerT
+{
+    static constexpr auto gates_size = 3 * out_sizet;
+
+public:
+    static constexpr auto in_size = in_sizet;
+    static constexpr auto out_size = out_sizet;
+
+    CIFGLSTMLayerT()
+    {
+        std::fill(&W[0][0], &W[0][0] + gates_size * in_size, (T)0);
+        std::fill(&U[0][0], &U[0][0] + gates_size * out_size, (T)0);
+        std::fill(std::begin(b), std::end(b), (T)0);
+        std::fill(std::begin(gates), std::end(gates), (T)0);
+        std::fill(std::begin(kernel_outs), std::end(kernel_outs), (T)0);
+        reset();
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "cifg_lstm"; }
+
+    /** Returns false since LSTM is not an activation. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Prepares the LSTM to process with a given delay length. */
+    template <SampleRateCorrectionMode srCorr = sampleRateCorr>
+    std::enable_if_t<srCorr == SampleRateCorrectionMode::NoInterp, void>
+    prepare(int delaySamples)
+    {
+        delayWriteIdx = delaySamples - 1;
+        ct_delayed.resize(delayWriteIdx + 1, {});
+        outs_delayed.resize(delayWriteIdx + 1, {});
+
+        reset();
+    }
+
+    /** Prepares the LSTM to process with a given delay length. */
+    template <SampleRateCorrectionMode srCorr = sampleRateCorr>
+    std::enable_if_t<srCorr == SampleRateCorrectionMode::LinInterp, void>
+    prepare(T delaySamples)
+    {
+        const auto delayOffFactor = delaySamples - std::floor(delaySamples);
+        delayMult = (T)1 - delayOffFactor;
+        delayPlus1Mult = delayOffFactor;
+
+        delayWriteIdx = (int)std::ceil(delaySamples) - (int)std::ceil(delayOffFactor);
+        ct_delayed.resize(delayWriteIdx + 1, {});
+        outs_delayed.resize(delayWriteIdx + 1, {});
+
+        reset();
+    }
+
+    /** Resets the state of the LSTM. */
+    void reset()
+    {
+        for(auto& x : ct_delayed)
+            std::fill(x.begin(), x.end(), CellType {});
+
+        for(auto& x : outs_delayed)
+            std::fill(x.begin(), x.end(), T {});
+
+        std::fill(std::begin(ct), std::end(ct), (CellType)0);
+        std::fill(std::begin(outs), std::end(outs), (T)0);
+    }
+
+    /** Prefetches the first weights used by `forward()`, if the layer is large enough to need prefetching. */
+    void prefetchWeights() const noexcept
+    {
+        if(recurrent_prefetch_rows > 0)
+            prefetch_bytes(U, std::min(sizeof(U), (size_t)RTNEURAL_PREFETCH_AHEAD_BYTES));
+    }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T (&ins)[in_size]) noexcept
+    {
+        mat_vec_prefetched(&U[0][0], outs, gates, gates_size, out_size, recurrent_prefetch_rows, W, sizeof(W));
+
+        if(in_size == 1)
+        {
+            for(int k = 0; k < gates_size; ++k)
+                gates[k] += W[k][0] * ins[0] + b[k];
+        }
+        else
+        {
+            mat_vec_prefetched(&W[0][0], ins, kernel_outs, gates_size, in_size, kernel_prefetch_rows);
+            for(int k = 0; k < gates_size; ++k)
+                gates[k] += kernel_outs[k] + b[k];
+        }
+
+        computeOutputs();
+    }
+
+    /**
+     * Sets the layer kernel weights.
+     *
+     * The weights vector must have size weights[in_size][3 * out_size]
+     */
+    void setWVals(const std::vector<std::vector<T>>& wVals)
+    {
+        for(int i = 0; i < in_size; ++i)
+            for(int k = 0; k < gates_size; ++k)
+                W[k][i] = wVals[(size_t)i][(size_t)k];
+    }
+
+    /**
+     * Sets the layer recurrent weights.
+     *
+     * The weights vector must have size weights[out_size][3 * out_size]
+     */
+    void setUVals(const std::vector<std::vector<T>>& uVals)
+    {
+        for(int i = 0; i < out_size; ++i)
+            for(int k = 0; k < gates_size; ++k)
+                U[k][i] = uVals[(size_t)i][(size_t)k];
+    }
+
+    /**
+     * Sets the layer bias.
+     *
+     * The bias vector must have size weights[3 * out_size]
+     */
+    void setBVals(const std::vector<T>& bVals)
+    {
+        std::copy(bVals.begin(), bVals.begin() + gates_size, b);
+    }
+
+    /** Returns the cell state of the LSTM (the hidden state is `outs`). */
+    const lstm_cell_type<T>* getCellState() const noexcept { return ct; }
+
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+
+private:
+    using CellType = lstm_cell_type<T>;
+
+    template <SampleRateCorrectionMode srCorr = sampleRateCorr>
+    inline std::enable_if_t<srCorr == SampleRateCorrectionMode::None, void>
+    computeOutputs() noexcept
+    {
+        cifg_detail::compute_outputs(gates, ct, ct, outs, out_size);
+    }
+
+    template <SampleRateCorrectionMode srCorr = sampleRateCorr>
+    inline std::enable_if_t<srCorr != SampleRateCorrectionMode::None, void>
+    computeOutputs() noexcept
+    {
+        cifg_detail::compute_outputs(gates, ct, ct_delayed[delayWriteIdx], outs_delayed[delayWriteIdx], out_size);
+
+        processDelay(ct_delayed, ct, delayWriteIdx);
+        processDelay(outs_delayed, outs, delayWriteIdx);
+    }
+
+    template <typename U_, SampleRateCorrectionMode srCorr = sampleRateCorr>
+    inline std::enable_if_t<srCorr == SampleRateCorrectionMode::NoInterp, void>
+    processDelay(std::vector<std::array<U_, out_size>>& delayVec, U_ (&out)[out_size], int delayWriteIndex) noexcept
+    {
+        for(int i = 0; i < out_size; ++i)
+            out[i] = delayVec[0][i];
+
+        for(int j = 0; j < delayWriteIndex; ++j)
+            delayVec[j] = delayVec[j + 1];
+    }
+
+    template <typename U_, SampleRateCorrectionMode srCorr = sampleRateCorr>
+    inline std::enable_if_t<srCorr == SampleRateCorrectionMode::LinInterp, void>
+    processDelay(std::vector<std::array<U_, out_size>>& delayVec, U_ (&out)[out_size], int delayWriteIndex) noexcept
+    {
+        for(int i = 0; i < out_size; ++i)
+            out[i] = (U_)delayPlus1Mult * delayVec[0][i] + (U_)delayMult * delayVec[1][i];
+
+        for(int j = 0; j < delayWriteIndex; ++j)
+            delayVec[j] = delayVec[j + 1];
+    }
+
+    // the recurrent product prefetches the start of the kernel weights
+    static constexpr size_t weights_bytes = sizeof(T) * gates_size * (in_size + out_size);
+    static constexpr int recurrent_prefetch_rows = prefetch_distance(sizeof(T) * out_size, weights_bytes);
+    static constexpr int kernel_prefetch_rows = prefetch_distance(sizeof(T) * in_size, weights_bytes);
+
+    // weights of the [input, candidate, output] gates
+    T W alignas(RTNEURAL_DEFAULT_ALIGNMENT)[gates_size][in_size];
+    T U alignas(RTNEURAL_DEFAULT_ALIGNMENT)[gates_size][out_size];
+    T b alignas(RTNEURAL_DEFAULT_ALIGNMENT)[gates_size];
+
+    // intermediate vars
+    T gates alignas(RTNEURAL_DEFAULT_ALIGNMENT)[gates_size];
+    T kernel_outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[gates_size];
+    CellType ct alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+
+    // needed for delays when doing sample rate correction
+    std::vector<std::array<CellType, out_size>> ct_delayed;
+    std::vector<std::array<T, out_size>> outs_delayed;
+    int delayWriteIdx = 0;
+    T delayMult = (T)1;
+    T delayPlus1Mult = (T)0;
+};
+
+} // namespace RTNeural
+
+#endif // CIFG_LSTM_H_INCLUDED
@@ -6,9 +6,38 @@
 #include "../common.h"
 #include <vector>
 
+/**
+ * Set to 1 to keep the cell state of the LSTM layers in double precision,
+ * even for float layers (see `RTNeural::lstm_cell_type`).
+ */
+#ifndef RTNEURAL_LSTM_DOUBLE_CELL_STATE
+#define RTNEURAL_LSTM_DOUBLE_CELL_STATE 0
+#endif
+
 namespace RTNeural
 {
 
+/**
+ * The type used for the cell state of a LSTM layer. The cell state is a
+ * running sum which is carried from one sample to the next, so rounding
+ * errors in it build up over time. With `RTNEURAL_LSTM_DOUBLE_CELL_STATE`,
+ * only the cell state is kept in double, while the weights, gates, and
+ * outputs stay in the layer's type.
+ */
+template <typename T>
+using lstm_cell_type = typename std::conditional<RTNEURAL_LSTM_DOUBLE_CELL_STATE != 0, double, T>::type;
+
+#ifndef DOXYGEN
+namespace lstm_detail
+{
+    template <typename T>
+    static inline T sigmoid_scalar(T x) noexcept
+    {
+        return (T)1 / ((T)1 + std::exp(-x));
+    }
+} // namespace lstm_detail
+#endif // DOXYGEN
+
 /**
  * Dynamic implementation of a LSTM layer with tanh
  * activation and sigmoid recurrent activation.
@@ -39,12 +68,15 @@ public:
     {
         for(int i = 0; i < Layer<T>::out_size; ++i)
         {
+            if(prefetchRows > 0 && i + prefetchRows < Layer<T>::out_size)
+                prefetchRow(i + prefetchRows);
+
             fVec[i] = sigmoid(vMult(fWeights.W[i], input, Layer<T>::in_size) + vMult(fWeights.U[i], ht1, Layer<T>::out_size) + fWeights.b[i]);
             iVec[i] = sigmoid(vMult(iWeights.W[i], input, Layer<T>::in_size) + vMult(iWeights.U[i], ht1, Layer<T>::out_size) + iWeights.b[i]);
             oVec[i] = sigmoid(vMult(oWeights.W[i], input, Layer<T>::in_size) + vMult(oWeights.U[i], ht1, Layer<T>::out_size) + oWeights.b[i]);
             ctVec[i] = std::tanh(vMult(cWeights.W[i], input, Layer<T>::in_size) + vMult(cWeights.U[i], ht1, Layer<T>::out_size) + cWeights.b[i]);
-            cVec[i] = fVec[i] * ct1[i] + iVec[i] * ctVec[i];
-            h[i] = oVec[i] * std::tanh(cVec[i]);
+            cVec[i] = (CellType)fVec[i] * ct1[i] + (CellType)iVec[i] * (CellType)ctVec[i];
+            h[i] = oVec[i] * std::tanh((T)cVec[i]);
         }
 
         std::copy(cVec, cVec + Layer<T>::out_size, ct1);
@@ -72,9 +104,34 @@ public:
      */
     void setBVals(const std::vector<T>& bVals);
 
+    /** Returns the hidden state of the LSTM (the outputs from the last call to `forward()`). */
+    const T* getHiddenState() const noexcept { return ht1; }
+
+    /** Returns the cell state of the LSTM. */
+    const lstm_cell_type<T>* getCellState() const noexcept { return ct1; }
+
+    /** Sets the hidden and cell state of the LSTM, each of size [out_size]. */
+    void setState(const T* h, const lstm_cell_type<T>* c) noexcept
+    {
+        std::copy(h, h + Layer<T>::out_size, ht1);
+        std::copy(c, c + Layer<T>::out_size, ct1);
+    }
+
 protected:
+    using CellType = lstm_cell_type<T>;
+
+    /** Prefetches one row of each of the weight matrices (each row is allocated separately). */
+    void prefetchRow(int i) const noexcept
+    {
+        for(const auto* weights : { &fWeights, &iWeights, &oWeights, &cWeights })
+        {
+            prefetch_bytes(weights->W[i], sizeof(T) * (size_t)Layer<T>::in_size);
+            prefetch_bytes(weights->U[i], sizeof(T) * (size_t)Layer<T>::out_size);
+        }
+    }
+
     T* ht1;
-    T* ct1;
+    CellType* ct1;
 
     /** Struct to hold layer weights (used internally) */
     struct WeightSet
@@ -97,7 +154,9 @@ protected:
     T* iVec;
     T* oVec;
     T* ctVec;
-    T* cVec;
+    CellType* cVec;
+
+    int prefetchRows;
 };
 
 //====================================================
@@ -137,26 +196,33 @@ public:
     /** Resets the state of the LSTM. */
     void reset();
 
+    /** Prefetches the first weights used by `forward()`, if the layer is large enough to need prefetching. */
+    void prefetchWeights() const noexcept
+    {
+        if(recurrent_prefetch_rows > 0)
+            prefetch_bytes(Uf, std::min(sizeof(Uf), (size_t)RTNEURAL_PREFETCH_AHEAD_BYTES));
+    }
+
     /** Performs forward propagation for this layer. */
     template <int N = in_size>
     inline typename std::enable_if<(N > 1), void>::type
     forward(const T (&ins)[in_size]) noexcept
     {
         // compute ft
-        recurrent_mat_mul(outs, Uf, ft);
-        kernel_mat_mul(ins, Wf, kernel_outs);
+        recurrent_mat_mul(outs, Uf, ft, Wf, sizeof(Wf));
+        kernel_mat_mul(ins, Wf, kernel_outs, Ui, sizeof(Ui));
         for(int i = 0; i < out_size; ++i)
             ft[i] = sigmoid(ft[i] + bf[i] + kernel_outs[i]);
 
         // compute it
-        recurrent_mat_mul(outs, Ui, it);
-        kernel_mat_mul(ins, Wi, kernel_outs);
+        recurrent_mat_mul(outs, Ui, it, Wi, sizeof(Wi));
+        kernel_mat_mul(ins, Wi, kernel_outs, Uo, sizeof(Uo));
         for(int i = 0; i < out_size; ++i)
             it[i] = sigmoid(it[i] + bi[i] + kernel_outs[i]);
 
         // compute ot
-        recurrent_mat_mul(outs, Uo, ot);
-        kernel_mat_mul(ins, Wo, kernel_outs);
+        recurrent_mat_mul(outs, Uo, ot, Wo, sizeof(Wo));
+        kernel_mat_mul(ins, Wo, kernel_outs, Uc, sizeof(Uc));
         for(int i = 0; i < out_size; ++i)
             ot[i] = sigmoid(ot[i] + bo[i] + kernel_outs[i]);
 
@@ -169,17 +235,17 @@ public:
     forward(const T (&ins)[in_size]) noexcept
     {
         // compute ft
-        recurrent_mat_mul(outs, Uf, ft);
+        recurrent_mat_mul(outs, Uf, ft, Ui, sizeof(Ui));
         for(int i = 0; i < out_size; ++i)
             ft[i] = sigmoid(ft[i] + bf[i] + (Wf_1[i] * ins[0]));
 
         // compute it
-        recurrent_mat_mul(outs, Ui, it);
+        recurrent_mat_mul(outs, Ui, it, Uo, sizeof(Uo));
         for(int i = 0; i < out_size; ++i)
             it[i] = sigmoid(it[i] + bi[i] + (Wi_1[i] * ins[0]));
 
         // compute ot
-        recurrent_mat_mul(outs, Uo, ot);
+        recurrent_mat_mul(outs, Uo, ot, Uc, sizeof(Uc));
         for(int i = 0; i < out_size; ++i)
             ot[i] = sigmoid(ot[i] + bo[i] + (Wo_1[i] * ins[0]));
 
@@ -207,9 +273,27 @@ public:
      */
     void setBVals(const std::vector<T>& bVals);
 
+    /** Returns the cell state of the LSTM (the hidden state is `outs`). */
+    const lstm_cell_type<T>* getCellState() const noexcept { return ct; }
+
+    /**
+     * Sets the hidden and cell state of the LSTM, each of size [out_size].
+     * Only available without sample rate correction, since the delayed
+     * states would also need to be set.
+     */
+    template <SampleRateCorrectionMode srCorr = sampleRateCorr>
+    std::enable_if_t<srCorr == SampleRateCorrectionMode::None, void>
+    setState(const T* h, const lstm_cell_type<T>* c) noexcept
+    {
+        std::copy(h, h + out_size, outs);
+        std::copy(c, c + out_size, ct);
+    }
+
     T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
 
 private:
+    using CellType = lstm_cell_type<T>;
+
     template <SampleRateCorrectionMode srCorr = sampleRateCorr>
     inline std::enable_if_t<srCorr == SampleRateCorrectionMode::None, void>
     computeOutputs(const T (&ins)[in_size]) noexcept
@@ -227,38 +311,38 @@ private:
         processDelay(outs_delayed, outs, delayWriteIdx);
     }
 
-    template <typename VecType, int N = in_size>
+    template <typename CellVecType, typename VecType, int N = in_size>
     inline std::enable_if_t<(N > 1), void>
-    computeOutputsInternal(const T (&ins)[in_size], VecType& ctVec, VecType& outsVec) noexcept
+    computeOutputsInternal(const T (&ins)[in_size], CellVecType& ctVec, VecType& outsVec) noexcept
     {
         // compute ct
-        recurrent_mat_mul(outs, Uc, ht);
+        recurrent_mat_mul(outs, Uc, ht, Wc, sizeof(Wc));
         kernel_mat_mul(ins, Wc, kernel_outs);
         for(int i = 0; i < out_size; ++i)
-            ctVec[i] = it[i] * std::tanh(ht[i] + bc[i] + kernel_outs[i]) + ft[i] * ct[i];
+            ctVec[i] = (CellType)it[i] * (CellType)std::tanh(ht[i] + bc[i] + kernel_outs[i]) + (CellType)ft[i] * ct[i];
 
         // compute output
         for(int i = 0; i < out_size; ++i)
-            outsVec[i] = ot[i] * std::tanh(ctVec[i]);
+            outsVec[i] = ot[i] * std::tanh((T)ctVec[i]);
     }
 
-    template <typename VecType, int N = in_size>
+    template <typename CellVecType, typename VecType, int N = in_size>
     inline std::enable_if_t<N == 1, void>
-    computeOutputsInternal(const T (&ins)[in_size], VecType& ctVec, VecType& outsVec) noexcept
+    computeOutputsInternal(const T (&ins)[in_size], CellVecType& ctVec, VecType& outsVec) noexcept
     {
         // compute ct
         recurrent_mat_mul(outs, Uc, ht);
         for(int i = 0; i < out_size; ++i)
-            ctVec[i] = it[i] * std::tanh(ht[i] + bc[i] + (Wc_1[i] * ins[0])) + ft[i] * ct[i];
+            ctVec[i] = (CellType)it[i] * (CellType)std::tanh(ht[i] + bc[i] + (Wc_1[i] * ins[0])) + (CellType)ft[i] * ct[i];
 
         // compute output
         for(int i = 0; i < out_size; ++i)
-            outsVec[i] = ot[i] * std::tanh(ctVec[i]);
+            outsVec[i] = ot[i] * std::tanh((T)ctVec[i]);
     }
 
-    template <SampleRateCorrectionMode srCorr = sampleRateCorr>
+    template <typename U, SampleRateCorrectionMode srCorr = sampleRateCorr>
     inline std::enable_if_t<srCorr == SampleRateCorrectionMode::NoInterp, void>
-    processDelay(std::vector<std::array<T, out_size>>& delayVec, T (&out)[out_size], int delayWriteIndex) noexcept
+    processDelay(std::vector<std::array<U, out_size>>& delayVec, U (&out)[out_size], int delayWriteIndex) noexcept
     {
         for(int i = 0; i < out_size; ++i)
             out[i] = delayVec[0][i];
@@ -270,12 +354,12 @@ private:
         }
     }
 
-    template <SampleRateCorrectionMode srCorr = sampleRateCorr>
+    template <typename U, SampleRateCorrectionMode srCorr = sampleRateCorr>
     inline std::enable_if_t<srCorr == SampleRateCorrectionMode::LinInterp, void>
-    processDelay(std::vector<std::array<T, out_size>>& delayVec, T (&out)[out_size], int delayWriteIndex) noexcept
+    processDelay(std::vector<std::array<U, out_size>>& delayVec, U (&out)[out_size], int delayWriteIndex) noexcept
     {
         for(int i = 0; i < out_size; ++i)
-            out[i] = delayPlus1Mult * delayVec[0][i] + delayMult * delayVec[1][i];
+            out[i] = (U)delayPlus1Mult * delayVec[0][i] + (U)delayMult * delayVec[1][i];
 
         for(int j = 0; j < delayWriteIndex; ++j)
         {
@@ -284,16 +368,21 @@ private:
         }
     }
 
-    static inline void recurrent_mat_mul(const T (&vec)[out_size], const T (&mat)[out_size][out_size], T (&out)[out_size]) noexcept
+    // the weights of each gate are stored separately, so each matrix product also prefetches the start of the next one
+    static constexpr size_t weights_bytes = sizeof(T) * 4 * out_size * (in_size + out_size);
+    static constexpr int recurrent_prefetch_rows = prefetch_distance(sizeof(T) * out_size, weights_bytes);
+    static constexpr int kernel_prefetch_rows = prefetch_distance(sizeof(T) * in_size, weights_bytes);
+
+    static inline void recurrent_mat_mul(const T (&vec)[out_size], const T (&mat)[out_size][out_size], T (&out)[out_size],
+        const void* next = nullptr, size_t next_bytes = 0) noexcept
     {
-        for(int j = 0; j < out_size; ++j)
-            out[j] = std::inner_product(mat[j], mat[j] + out_size, vec, (T)0);
+        mat_vec_prefetched(&mat[0][0], vec, out, out_size, out_size, recurrent_prefetch_rows, next, next_bytes);
     }
 
-    static inline void kernel_mat_mul(const T (&vec)[in_size], const T (&mat)[out_size][in_size], T (&out)[out_size]) noexcept
+    static inline void kernel_mat_mul(const T (&vec)[in_size], const T (&mat)[out_size][in_size], T (&out)[out_size],
+        const void* next = nullptr, size_t next_bytes = 0) noexcept
     {
-        for(int j = 0; j < out_size; ++j)
-            out[j] = std::inner_product(mat[j], mat[j] + in_size, vec, (T)0);
+        mat_vec_prefetched(&mat[0][0], vec, out, out_size, in_size, kernel_prefetch_rows, next, next_bytes);
     }
 
     // kernel weights
@@ -326,10 +415,10 @@ private:
     T it alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
     T ot alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
     T ht alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
-    T ct alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+    CellType ct alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
 
     // needed for delays when doing sample rate correction
-    std::vector<std::array<T, out_size>> ct_delayed;
+    std::vector<std::array<CellType, out_size>> ct_delayed;
     std::vector<std::array<T, out_size>> outs_delayed;
     int delayWriteIdx = 0;
     T delayMult = (T)1;
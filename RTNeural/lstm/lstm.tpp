@@ -12,15 +12,16 @@ LSTMLayer<T>::LSTMLayer(int in_size, int out_size)
     , iWeights(in_size, out_size)
     , oWeights(in_size, out_size)
     , cWeights(in_size, out_size)
+    , prefetchRows(prefetch_distance(sizeof(T) * (size_t)(in_size + out_size), sizeof(T) * 4 * (size_t)out_size * (size_t)(in_size + out_size)))
 {
     ht1 = new T[out_size];
-    ct1 = new T[out_size];
+    ct1 = new CellType[out_size];
 
     fVec = new T[out_size];
     iVec = new T[out_size];
     oVec = new T[out_size];
     ctVec = new T[out_size];
-    cVec = new T[out_size];
+    cVec = new CellType[out_size];
 }
 
 template <typename T>
@@ -60,7 +61,7 @@ template <typename T>
 void LSTMLayer<T>::reset()
 {
     std::fill(ht1, ht1 + Layer<T>::out_size, (T)0);
-    std::fill(ct1, ct1 + Layer<T>::out_size, (T)0);
+    std::fill(ct1, ct1 + Layer<T>::out_size, (CellType)0);
 }
 
 template <typename T>
@@ -218,7 +219,7 @@ void LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr>::reset()
     if(sampleRateCorr != SampleRateCorrectionMode::None)
     {
         for(auto& x : ct_delayed)
-            std::fill(x.begin(), x.end(), T {});
+            std::fill(x.begin(), x.end(), CellType {});
 
         for(auto& x : outs_delayed)
             std::fill(x.begin(), x.end(), T {});
@@ -227,7 +228,7 @@ void LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr>::reset()
     // reset output state
     for(int i = 0; i < out_size; ++i)
     {
-        ct[i] = (T)0;
+        ct[i] = (CellType)0;
         outs[i] = (T)0;
     }
 }
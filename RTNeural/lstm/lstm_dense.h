@@ -0,0 +1,201 @@
+#ifndef LSTM_DENSE_H_INCLUDED
+#define LSTM_DENSE_H_INCLUDED
+
+#include "stacked_lstm.h"
+
+namespace RTNeural
+{
+
+/**
+ * Static implementation of a LSTM layer followed by a Dense
+ * output layer, fused into a single layer.
+ *
+ * The Dense outputs are accumulated as each hidden unit of the LSTM
+ * is computed, so the hidden state is never re-read by a separate
+ * layer. The LSTM weights are packed in the same way as `StackedLSTMT`.
+ *
+ * This layer has the weight-setting methods of both `LSTMLayerT` and
+ * `DenseT`, and its `outs` are the outputs of the Dense layer. In a
+ * `ModelT`, it is loaded from consecutive lstm and dense json entries.
+ * The gate sums are added up in a different order than in `LSTMLayerT`
+ * (see `StackedLSTMT`), so the outputs can differ by rounding errors.
+ *
+ * With `RTNEURAL_FUSE_LAYERS=1`, `ModelT` uses this layer in place of any
+ * `LSTMLayerT<T, in, hidden>` (without sample rate correction) that
+ * is directly followed by a `DenseT<T, hidden, out>`. In that case,
+ * `ModelT::get<Index>()` returns this layer for both indices.
+ */
+template <typename T, int in_sizet, int hidden_sizet, int out_sizet>
+class LSTMDenseT
+{
+public:
+    static constexpr auto in_size = in_sizet;
+    static constexpr auto hidden_size = hidden_sizet;
+    static constexpr auto out_size = out_sizet;
+
+    /** The LSTM part of the layer, which can be loaded like a LSTMLayerT. */
+    struct LSTMRef
+    {
+        void setWVals(const std::vector<std::vector<T>>& wVals) { layer.setWVals(wVals); }
+        void setUVals(const std::vector<std::vector<T>>& uVals) { layer.setUVals(uVals); }
+        void setBVals(const std::vector<T>& bVals) { layer.setBVals(bVals); }
+
+        LSTMDenseT& layer;
+        static constexpr auto in_size = in_sizet;
+        static constexpr auto out_size = hidden_sizet;
+    };
+
+    /** The Dense part of the layer, which can be loaded like a DenseT. */
+    struct DenseRef
+    {
+        void setWeights(const std::vector<std::vector<T>>& newWeights) { layer.setWeights(newWeights); }
+        void setBias(const T* b) { layer.setBias(b); }
+
+        LSTMDenseT& layer;
+        static constexpr auto in_size = hidden_sizet;
+        static constexpr auto out_size = out_sizet;
+    };
+
+    LSTMDenseT()
+    {
+        std::fill(std::begin(lstmWeights), std::end(lstmWeights), (T)0);
+        std::fill(std::begin(lstmBias), std::end(lstmBias), (T)0);
+        std::fill(std::begin(denseWeights), std::end(denseWeights), (T)0);
+        std::fill(std::begin(denseBias), std::end(denseBias), (T)0);
+        reset();
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "lstm_dense"; }
+
+    /** Returns false since LSTM is not an activation. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Resets the state of the LSTM. */
+    void reset()
+    {
+        std::fill(std::begin(state), std::end(state), (T)0);
+        std::fill(std::begin(ct), std::end(ct), (lstm_cell_type<T>)0);
+        std::fill(std::begin(outs), std::end(outs), (T)0);
+    }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T (&ins)[in_size]) noexcept
+    {
+        std::copy(ins, ins + in_size, state);
+        std::copy(denseBias, denseBias + out_size, outs);
+
+        lstm_detail::forward_panel<T, in_size + hidden_size, hidden_size>(state, lstmWeights, lstmBias, ct,
+            [this](int j, T h) noexcept
+            {
+                const auto* w = denseWeights + j * out_size;
+                for(int i = 0; i < out_size; ++i)
+                    outs[i] += w[i] * h;
+            },
+            denseWeights, sizeof(denseWeights));
+    }
+
+    /** Prefetches the first weights used by `forward()`, if the layer is large enough to need prefetching. */
+    void prefetchWeights() const noexcept
+    {
+        lstm_detail::prefetch_panel<T, in_size + hidden_size, hidden_size>(lstmWeights);
+    }
+
+    /** Returns the LSTM part of the layer. */
+    LSTMRef getLSTM() noexcept { return { *this }; }
+
+    /** Returns the Dense part of the layer. */
+    DenseRef getDense() noexcept { return { *this }; }
+
+    /** Returns the hidden state of the LSTM. */
+    const T* getHiddenState() const noexcept { return state + in_size; }
+
+    /** Returns the cell state of the LSTM. */
+    const lstm_cell_type<T>* getCellState() const noexcept { return ct; }
+
+    /**
+     * Sets the LSTM kernel weights.
+     *
+     * The weights vector must have size weights[in_size][4 * hidden_size]
+     */
+    void setWVals(const std::vector<std::vector<T>>& wVals)
+    {
+        for(int k = 0; k < in_size; ++k)
+            lstm_detail::set_panel_row<T, hidden_size>(lstmWeights, k, wVals[(size_t)k]);
+    }
+
+    /**
+     * Sets the LSTM recurrent weights.
+     *
+     * The weights vector must have size weights[hidden_size][4 * hidden_size]
+     */
+    void setUVals(const std::vector<std::vector<T>>& uVals)
+    {
+        for(int k = 0; k < hidden_size; ++k)
+            lstm_detail::set_panel_row<T, hidden_size>(lstmWeights, in_size + k, uVals[(size_t)k]);
+    }
+
+    /**
+     * Sets the LSTM bias.
+     *
+     * The bias vector must have size weights[4 * hidden_size]
+     */
+    void setBVals(const std::vector<T>& bVals)
+    {
+        std::copy(bVals.begin(), bVals.begin() + 4 * hidden_size, lstmBias);
+    }
+
+    /**
+     * Sets the Dense layer weights from a given vector.
+     *
+     * The dimension of the weights vector must be
+     * weights[out_size][hidden_size]
+     */
+    void setWeights(const std::vector<std::vector<T>>& newWeights)
+    {
+        for(int i = 0; i < out_size; ++i)
+            for(int j = 0; j < hidden_size; ++j)
+                denseWeights[j * out_size + i] = newWeights[(size_t)i][(size_t)j];
+    }
+
+    /**
+     * Sets the Dense layer weights from a given array.
+     *
+     * The dimension of the weights array must be
+     * weights[out_size][hidden_size]
+     */
+    void setWeights(T** newWeights)
+    {
+        for(int i = 0; i < out_size; ++i)
+            for(int j = 0; j < hidden_size; ++j)
+                denseWeights[j * out_size + i] = newWeights[i][j];
+    }
+
+    /**
+     * Sets the Dense layer bias from a given array of size
+     * bias[out_size]
+     */
+    void setBias(const T* b)
+    {
+        std::copy(b, b + out_size, denseBias);
+    }
+
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+
+private:
+    // LSTM weight panel: [in_size + hidden_size][4 * hidden_size]
+    T lstmWeights alignas(RTNEURAL_DEFAULT_ALIGNMENT)[(in_size + hidden_size) * 4 * hidden_size];
+    T lstmBias alignas(RTNEURAL_DEFAULT_ALIGNMENT)[4 * hidden_size];
+
+    // Dense weights, transposed: [hidden_size][out_size]
+    T denseWeights alignas(RTNEURAL_DEFAULT_ALIGNMENT)[hidden_size * out_size];
+    T denseBias alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+
+    // [ins, h]
+    T state alignas(RTNEURAL_DEFAULT_ALIGNMENT)[in_size + hidden_size];
+    lstm_cell_type<T> ct alignas(RTNEURAL_DEFAULT_ALIGNMENT)[hidden_size];
+};
+
+} // namespace RTNeural
+
+#endif // LSTM_DENSE_H_INCLUDED
@@ -0,0 +1,482 @@
+#ifndef SMALL_SIGNAL_LSTM_H_INCLUDED
+#define SMALL_SIGNAL_LSTM_H_INCLUDED
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "lstm.h"
+
+namespace RTNeural
+{
+
+#ifndef DOXYGEN
+namespace small_signal_detail
+{
+    /**
+     * A linear state-space approximation of a LSTM, around the state that the
+     * LSTM settles to for a zero input, along with the logic for switching
+     * between the approximation and the full LSTM.
+     *
+     * With the deviations from the steady state `dh = h - h*` and `dc = c - c*`,
+     * the linearized LSTM is:
+     * ```
+     * dc' = A_c [x, dh] + f* dc
+     * dh' = A_h [x, dh] + o* (1 - tanh(c*)^2) f* dc
+     * ```
+     * which costs half the multiplies of the full LSTM, and no activations.
+     */
+    template <typename T>
+    class SmallSignalModel
+    {
+    public:
+        using CellType = lstm_cell_type<T>;
+
+        /**
+         * Computes the steady state and the linearized model, from the LSTM weights
+         * (in the same layout as `LSTMLayer::setWVals()`, etc.). Returns false if the
+         * LSTM does not settle to a steady state, in which case the full LSTM is always used.
+         */
+        bool linearize(const std::vector<std::vector<T>>& W, const std::vector<std::vector<T>>& U, const std::vector<T>& b, int in_size, int out_size)
+        {
+            const auto H = (size_t)out_size;
+            const auto cols = (size_t)(in_size + out_size);
+            linearized = false;
+            linear = false;
+            quietSamples = 0;
+
+            // run the LSTM (in double) with a zero input, until the state stops changing
+            std::vector<double> h(H, 0.0), c(H, 0.0), z(4 * H);
+            auto compute_gates = [&]
+            {
+                for(size_t k = 0; k < 4 * H; ++k)
+                {
+                    z[k] = (double)b[k];
+                    for(size_t j = 0; j < H; ++j)
+                        z[k] += (double)U[j][k] * h[j];
+                }
+            };
+            auto sigmoid = [](double x) { return 1.0 / (1.0 + std::exp(-x)); };
+
+            bool settled = false;
+            for(int n = 0; n < max_settling_steps && !settled; ++n)
+            {
+                compute_gates();
+                double change = 0.0;
+                for(size_t k = 0; k < H; ++k)
+                {
+                    const auto cNew = sigmoid(z[H + k]) * c[k] + sigmoid(z[k]) * std::tanh(z[2 * H + k]);
+                    const auto hNew = sigmoid(z[3 * H + k]) * std::tanh(cNew);
+                    change = std::max(change, std::max(std::abs(cNew - c[k]), std::abs(hNew - h[k])));
+                    c[k] = cNew;
+                    h[k] = hNew;
+                }
+                settled = change < 1.0e-12;
+            }
+
+            if(!settled)
+                return false;
+
+            // the derivatives of the LSTM outputs with respect to its inputs and state
+            compute_gates();
+            A.assign(2 * H * cols, (T)0);
+            fDiag.resize(H);
+            hcDiag.resize(H);
+            hStar.resize(H);
+            cStar.resize(H);
+            for(size_t k = 0; k < H; ++k)
+            {
+                const auto i = sigmoid(z[k]);
+                const auto f = sigmoid(z[H + k]);
+                const auto g = std::tanh(z[2 * H + k]);
+                const auto o = sigmoid(z[3 * H + k]);
+                const auto tc = std::tanh(c[k]);
+
+                const auto dc_dzi = g * i * (1.0 - i);
+                const auto dc_dzf = c[k] * f * (1.0 - f);
+                const auto dc_dzc = i * (1.0 - g * g);
+                const auto dh_dzo = tc * o * (1.0 - o);
+                const auto dh_dc = o * (1.0 - tc * tc);
+
+                auto set_column = [&](size_t col, const std::vector<T>& w)
+                {
+                    const auto dc = dc_dzi * (double)w[k] + dc_dzf * (double)w[H + k] + dc_dzc * (double)w[2 * H + k];
+                    A[k * cols + col] = (T)dc;
+                    A[(H + k) * cols + col] = (T)(dh_dzo * (double)w[3 * H + k] + dh_dc * dc);
+                };
+
+                for(size_t j = 0; j < (size_t)in_size; ++j)
+                    set_column(j, W[j]);
+                for(size_t j = 0; j < H; ++j)
+                    set_column((size_t)in_size + j, U[j]);
+
+                fDiag[k] = (T)f;
+                hcDiag[k] = (T)(dh_dc * f);
+                hStar[k] = (T)h[k];
+                cStar[k] = (T)c[k];
+            }
+
+            v.assign(cols, (T)0);
+            dh.assign(H, (T)0);
+            dc.assign(H, (T)0);
+            newDh.assign(H, (T)0);
+            handoverC.assign(H, (CellType)0);
+            linearized = true;
+            return true;
+        }
+
+        void reset() noexcept
+        {
+            linear = false;
+            quietSamples = 0;
+        }
+
+        /**
+         * Processes one sample, with the linear model if the signal is small enough,
+         * or otherwise with the full LSTM, by calling `forwardFull()`, which should
+         * run the LSTM and write its hidden state to `outs`.
+         */
+        template <typename LSTMType, typename ForwardFull>
+        inline void forward(const T* x, T* outs, LSTMType& lstm, ForwardFull&& forwardFull) noexcept
+        {
+            const auto H = (int)hStar.size();
+            const auto inputLevel = linearized ? input_level(x) : (T)0;
+
+            if(linear)
+            {
+                if(inputLevel <= inputThreshold * hysteresis && deviation <= stateThreshold * hysteresis)
+                {
+                    forward_linear(x, outs);
+                    return;
+                }
+
+                // hand the current state of the linear model over to the full LSTM
+                for(int k = 0; k < H; ++k)
+                {
+                    newDh[(size_t)k] = hStar[(size_t)k] + dh[(size_t)k];
+                    handoverC[(size_t)k] = (CellType)(cStar[(size_t)k] + dc[(size_t)k]);
+                }
+                lstm.setState(newDh.data(), handoverC.data());
+                linear = false;
+                quietSamples = 0;
+            }
+
+            forwardFull();
+            if(!linearized)
+                return;
+
+            const T* h = outs;
+            if(inputLevel < inputThreshold && state_deviation(h, lstm.getCellState()) < stateThreshold)
+            {
+                if(++quietSamples >= holdSamples)
+                {
+                    const auto* c = lstm.getCellState();
+                    for(int k = 0; k < H; ++k)
+                    {
+                        dh[(size_t)k] = h[k] - hStar[(size_t)k];
+                        dc[(size_t)k] = (T)c[k] - cStar[(size_t)k];
+                    }
+                    deviation = state_deviation(h, c);
+                    linear = true;
+                }
+            }
+            else
+            {
+                quietSamples = 0;
+            }
+        }
+
+        bool linearized = false;
+        bool linear = false;
+
+        T inputThreshold = (T)1.0e-3;
+        T stateThreshold = (T)1.0e-2;
+        T hysteresis = (T)2;
+        int holdSamples = 64;
+
+        std::vector<T> hStar;
+        std::vector<T> cStar;
+
+    private:
+        static constexpr int max_settling_steps = 100000;
+
+        inline T input_level(const T* x) const noexcept
+        {
+            const auto in_size = (int)(v.size() - hStar.size());
+            T level = (T)0;
+            for(int i = 0; i < in_size; ++i)
+                level = std::max(level, std::abs(x[i]));
+            return level;
+        }
+
+        inline T state_deviation(const T* h, const CellType* c) const noexcept
+        {
+            T dev = (T)0;
+            for(size_t k = 0; k < hStar.size(); ++k)
+                dev = std::max(dev, std::max(std::abs(h[k] - hStar[k]), std::abs((T)c[k] - cStar[k])));
+            return dev;
+        }
+
+        inline void forward_linear(const T* x, T* outs) noexcept
+        {
+            const auto H = hStar.size();
+            const auto in_size = v.size() - H;
+            const auto cols = (int)v.size();
+
+            std::copy(x, x + in_size, v.begin());
+            std::copy(dh.begin(), dh.end(), v.begin() + (std::ptrdiff_t)in_size);
+
+            deviation = (T)0;
+            for(size_t k = 0; k < H; ++k)
+            {
+                newDh[k] = dot_product(&A[(H + k) * v.size()], v.data(), cols) + hcDiag[k] * dc[k];
+                dc[k] = dot_product(&A[k * v.size()], v.data(), cols) + fDiag[k] * dc[k];
+                deviation = std::max(deviation, std::max(std::abs(newDh[k]), std::abs(dc[k])));
+            }
+
+            std::swap(dh, newDh);
+            for(size_t k = 0; k < H; ++k)
+                outs[k] = hStar[k] + dh[k];
+        }
+
+        // [2 * out_size][in_size + out_size]: the rows for dc, then the rows for dh
+        std::vector<T> A;
+        std::vector<T> fDiag;
+        std::vector<T> hcDiag;
+
+        std::vector<T> v;
+        std::vector<T> dh;
+        std::vector<T> dc;
+        std::vector<T> newDh;
+        std::vector<CellType> handoverC;
+        T deviation = (T)0;
+        int quietSamples = 0;
+    };
+} // namespace small_signal_detail
+#endif // DOXYGEN
+
+/**
+ * Dynamic implementation of a LSTM layer, which switches to a linearized
+ * (small-signal) model of the LSTM for quiet inputs.
+ *
+ * After the weights are set, `linearize()` finds the state that the LSTM
+ * settles to for a zero input, and linearizes the LSTM around that state.
+ * When the input level and the deviation of the LSTM state from the steady
+ * state have stayed below their thresholds for a number of samples, the
+ * layer evaluates the (much cheaper) linear model. As soon as the input
+ * level or the state deviation grows past the thresholds times the hysteresis
+ * factor, the layer hands the state of the linear model over to the full
+ * LSTM, and goes back to using the full LSTM.
+ */
+template <typename T>
+class SmallSignalLSTM final : public Layer<T>
+{
+public:
+    /** Constructs a small-signal LSTM layer for a given input and output size. */
+    SmallSignalLSTM(int in_size, int out_size)
+        : Layer<T>(in_size, out_size)
+        , lstm(in_size, out_size)
+        , wVals((size_t)in_size, std::vector<T>(4 * (size_t)out_size, (T)0))
+        , uVals((size_t)out_size, std::vector<T>(4 * (size_t)out_size, (T)0))
+        , bVals(4 * (size_t)out_size, (T)0)
+    {
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept override { return "lstm"; }
+
+    /** Resets the state of the LSTM, and switches back to the full LSTM. */
+    void reset() override
+    {
+        lstm.reset();
+        model.reset();
+    }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T* input, T* h) noexcept override
+    {
+        model.forward(input, h, lstm, [this, input, h]() noexcept
+            { lstm.forward(input, h); });
+    }
+
+    /** Sets the layer kernel weights (see `LSTMLayer::setWVals()`). */
+    void setWVals(const std::vector<std::vector<T>>& newWVals)
+    {
+        lstm.setWVals(newWVals);
+        for(size_t i = 0; i < wVals.size(); ++i)
+            std::copy(newWVals[i].begin(), newWVals[i].begin() + (std::ptrdiff_t)wVals[i].size(), wVals[i].begin());
+    }
+
+    /** Sets the layer recurrent weights (see `LSTMLayer::setUVals()`). */
+    void setUVals(const std::vector<std::vector<T>>& newUVals)
+    {
+        lstm.setUVals(newUVals);
+        for(size_t i = 0; i < uVals.size(); ++i)
+            std::copy(newUVals[i].begin(), newUVals[i].begin() + (std::ptrdiff_t)uVals[i].size(), uVals[i].begin());
+    }
+
+    /** Sets the layer bias (see `LSTMLayer::setBVals()`). */
+    void setBVals(const std::vector<T>& newBVals)
+    {
+        lstm.setBVals(newBVals);
+        std::copy(newBVals.begin(), newBVals.begin() + (std::ptrdiff_t)bVals.size(), bVals.begin());
+    }
+
+    /**
+     * Linearizes the LSTM around its steady state. This should be called
+     * (outside of the audio thread) after the weights have been set.
+     * Returns false if the LSTM does not settle to a steady state, in which
+     * case the layer always uses the full LSTM.
+     */
+    bool linearize()
+    {
+        return model.linearize(wVals, uVals, bVals, Layer<T>::in_size, Layer<T>::out_size);
+    }
+
+    /**
+     * Sets the thresholds for switching to the linear model: the input level
+     * (the largest absolute input), and the largest deviation of the LSTM state
+     * from the steady state. The layer switches back to the full LSTM when either
+     * of them grows past its threshold times `hysteresis`. The layer only switches
+     * to the linear model once the signal has stayed quiet for `holdSamples` samples.
+     */
+    void setThresholds(T inputThreshold, T stateThreshold, T hysteresis = (T)2, int holdSamples = 64)
+    {
+        model.inputThreshold = inputThreshold;
+        model.stateThreshold = stateThreshold;
+        model.hysteresis = std::max(hysteresis, (T)1);
+        model.holdSamples = std::max(holdSamples, 1);
+    }
+
+    /** Returns true if the LSTM has been linearized. */
+    bool isLinearized() const noexcept { return model.linearized; }
+
+    /** Returns true if the layer is currently using the linear model. */
+    bool isLinear() const noexcept { return model.linear; }
+
+    /** Returns the steady state of the LSTM hidden state, for a zero input. */
+    const T* getSteadyState() const noexcept { return model.hStar.data(); }
+
+    /** Returns the full LSTM. */
+    LSTMLayer<T>& getLSTM() noexcept { return lstm; }
+
+private:
+    LSTMLayer<T> lstm;
+    small_signal_detail::SmallSignalModel<T> model;
+
+    std::vector<std::vector<T>> wVals;
+    std::vector<std::vector<T>> uVals;
+    std::vector<T> bVals;
+};
+
+//====================================================
+/**
+ * Static implementation of a LSTM layer, which switches to a linearized
+ * (small-signal) model of the LSTM for quiet inputs (see `SmallSignalLSTM`).
+ *
+ * This layer can be used in a `ModelT` in place of a `LSTMLayerT`, and is
+ * loaded from the same json, in which case `ModelT::parseJson()` also
+ * linearizes the LSTM.
+ */
+template <typename T, int in_sizet, int out_sizet>
+class SmallSignalLSTMT
+{
+public:
+    static constexpr auto in_size = in_sizet;
+    static constexpr auto out_size = out_sizet;
+
+    SmallSignalLSTMT()
+        : wVals((size_t)in_size, std::vector<T>(4 * (size_t)out_size, (T)0))
+        , uVals((size_t)out_size, std::vector<T>(4 * (size_t)out_size, (T)0))
+        , bVals(4 * (size_t)out_size, (T)0)
+    {
+        reset();
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "lstm"; }
+
+    /** Returns false since LSTM is not an activation. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Resets the state of the LSTM, and switches back to the full LSTM. */
+    void reset()
+    {
+        lstm.reset();
+        model.reset();
+        std::fill(std::begin(outs), std::end(outs), (T)0);
+    }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T (&ins)[in_size]) noexcept
+    {
+        model.forward(ins, outs, lstm, [this, &ins]() noexcept
+            {
+                lstm.forward(ins);
+                std::copy(std::begin(lstm.outs), std::end(lstm.outs), outs); });
+    }
+
+    /** Sets the layer kernel weights (see `LSTMLayerT::setWVals()`). */
+    void setWVals(const std::vector<std::vector<T>>& newWVals)
+    {
+        lstm.setWVals(newWVals);
+        for(size_t i = 0; i < wVals.size(); ++i)
+            std::copy(newWVals[i].begin(), newWVals[i].begin() + (std::ptrdiff_t)wVals[i].size(), wVals[i].begin());
+    }
+
+    /** Sets the layer recurrent weights (see `LSTMLayerT::setUVals()`). */
+    void setUVals(const std::vector<std::vector<T>>& newUVals)
+    {
+        lstm.setUVals(newUVals);
+        for(size_t i = 0; i < uVals.size(); ++i)
+            std::copy(newUVals[i].begin(), newUVals[i].begin() + (std::ptrdiff_t)uVals[i].size(), uVals[i].begin());
+    }
+
+    /** Sets the layer bias (see `LSTMLayerT::setBVals()`). */
+    void setBVals(const std::vector<T>& newBVals)
+    {
+        lstm.setBVals(newBVals);
+        std::copy(newBVals.begin(), newBVals.begin() + (std::ptrdiff_t)bVals.size(), bVals.begin());
+    }
+
+    /** Linearizes the LSTM around its steady state (see `SmallSignalLSTM::linearize()`). */
+    bool linearize()
+    {
+        return model.linearize(wVals, uVals, bVals, in_size, out_size);
+    }
+
+    /** Sets the thresholds for switching to the linear model (see `SmallSignalLSTM::setThresholds()`). */
+    void setThresholds(T inputThreshold, T stateThreshold, T hysteresis = (T)2, int holdSamples = 64)
+    {
+        model.inputThreshold = inputThreshold;
+        model.stateThreshold = stateThreshold;
+        model.hysteresis = std::max(hysteresis, (T)1);
+        model.holdSamples = std::max(holdSamples, 1);
+    }
+
+    /** Returns true if the LSTM has been linearized. */
+    bool isLinearized() const noexcept { return model.linearized; }
+
+    /** Returns true if the layer is currently using the linear model. */
+    bool isLinear() const noexcept { return model.linear; }
+
+    /** Returns the steady state of the LSTM hidden state, for a zero input. */
+    const T* getSteadyState() const noexcept { return model.hStar.data(); }
+
+    /** Returns the full LSTM. */
+    LSTMLayerT<T, in_size, out_size>& getLSTM() noexcept { return lstm; }
+
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+
+private:
+    LSTMLayerT<T, in_size, out_size> lstm;
+    small_signal_detail::SmallSignalModel<T> model;
+
+    std::vector<std::vector<T>> wVals;
+    std::vector<std::vector<T>> uVals;
+    std::vector<T> bVals;
+};
+
+} // namespace RTNeural
+
+#endif // SMALL_SIGNAL_LSTM_H_INCLUDED
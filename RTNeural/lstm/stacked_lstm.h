@@ -0,0 +1,268 @@
+#ifndef STACKED_LSTM_H_INCLUDED
+#define STACKED_LSTM_H_INCLUDED
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "lstm.h"
+
+namespace RTNeural
+{
+
+#ifndef DOXYGEN
+namespace lstm_detail
+{
+    /** Prefetches the start of a packed weight panel, if `forward_panel()` would prefetch it. */
+    template <typename T, int K, int out_size>
+    static inline void prefetch_panel(const T* w) noexcept
+    {
+        constexpr auto panel_bytes = sizeof(T) * K * 4 * out_size;
+        if(prefetch_distance(sizeof(T) * 4 * out_size, panel_bytes) > 0)
+            prefetch_bytes(w, std::min(panel_bytes, (size_t)RTNEURAL_PREFETCH_AHEAD_BYTES));
+    }
+
+    /**
+     * Computes one step of a LSTM layer, with a packed weight panel of size
+     * [K][4 * out_size] (gates i, f, c, o), where `v = [ins, h]` has size K,
+     * and `h` is the last out_size elements of `v`. The new hidden state is
+     * written back into `v`, and `fn(j, h_j)` is called as each hidden unit
+     * is computed. For large panels, the rows of the panel are prefetched
+     * ahead, followed by the start of `next` (the weights used after this panel).
+     *
+     * Like `LSTMLayerT`, the gate sums are compensated if `use_compensated_sums<T>()`
+     * (with one compensation term per gate), and the cell state `c` has the type
+     * `lstm_cell_type<T>`.
+     */
+    template <typename T, int K, int out_size, typename CellType, typename Fn>
+    static inline void forward_panel(T* v, const T* w, const T* b, CellType* c, Fn&& fn,
+        const void* next = nullptr, size_t next_bytes = 0) noexcept
+    {
+        constexpr auto prefetch_rows = prefetch_distance(sizeof(T) * 4 * out_size, sizeof(T) * K * 4 * out_size);
+
+        T z alignas(RTNEURAL_DEFAULT_ALIGNMENT)[4 * out_size];
+        std::copy(b, b + 4 * out_size, z);
+        if(use_compensated_sums<T>())
+        {
+            T comp alignas(RTNEURAL_DEFAULT_ALIGNMENT)[4 * out_size] {};
+            for(int k = 0; k < K; ++k)
+            {
+                if(prefetch_rows > 0)
+                    prefetch_row(w, k, K, 4 * out_size, prefetch_rows, next, next_bytes);
+
+                const auto vk = v[k];
+                const auto* wk = w + k * 4 * out_size;
+                for(int r = 0; r < 4 * out_size; ++r)
+                    kahan_add(z[r], comp[r], wk[r] * vk);
+            }
+
+            for(int r = 0; r < 4 * out_size; ++r)
+                z[r] -= comp[r];
+        }
+        else
+        {
+            for(int k = 0; k < K; ++k)
+            {
+                if(prefetch_rows > 0)
+                    prefetch_row(w, k, K, 4 * out_size, prefetch_rows, next, next_bytes);
+
+                const auto vk = v[k];
+                const auto* wk = w + k * 4 * out_size;
+                for(int r = 0; r < 4 * out_size; ++r)
+                    z[r] += wk[r] * vk;
+            }
+        }
+
+        auto* h = v + K - out_size;
+        for(int j = 0; j < out_size; ++j)
+        {
+            c[j] = (CellType)sigmoid_scalar(z[out_size + j]) * c[j] + (CellType)sigmoid_scalar(z[j]) * (CellType)std::tanh(z[2 * out_size + j]);
+            h[j] = sigmoid_scalar(z[3 * out_size + j]) * std::tanh((T)c[j]);
+            fn(j, h[j]);
+        }
+    }
+
+    /** Writes one row of a keras-style weight matrix ([4 * out_size], gates i, f, c, o) into a weight panel. */
+    template <typename T, int out_size>
+    static inline void set_panel_row(T* panel, int k, const std::vector<T>& row) noexcept
+    {
+        std::copy(row.begin(), row.begin() + 4 * out_size, panel + k * 4 * out_size);
+    }
+} // namespace lstm_detail
+#endif // DOXYGEN
+
+/**
+ * Static implementation of a stack of LSTM layers with the same
+ * hidden size, fused into a single layer.
+ *
+ * The outputs of each layer are written directly into the inputs
+ * of the next layer: the hidden states of all layers are stored in
+ * one contiguous buffer, `[ins, h_0, h_1, ..., h_(n-1)]`, so that
+ * layer `l` reads its input and its recurrent state as one vector
+ * (`[h_(l-1), h_l]`). For each layer, the kernel and recurrent weights
+ * are packed into one contiguous panel, so all four gates of a layer are
+ * computed in a single pass over its weights (broadcasting each input
+ * against a row of the panel), and the stacked weights are streamed
+ * through the cache in the order that they are used.
+ *
+ * The weights of each layer have the same format as `LSTMLayerT`.
+ * The gate sums start from the bias and add the inputs and the recurrent
+ * state in one pass, whereas `LSTMLayerT` sums `U h`, `W x` and `b`
+ * separately, so the outputs can differ from `LSTMLayerT` by rounding
+ * errors. Sample rate correction is not supported.
+ * ```
+ * // equivalent to LSTMLayerT<float, 1, 24>, LSTMLayerT<float, 24, 24>
+ * StackedLSTMT<float, 1, 24, 2> lstm;
+ * ```
+ */
+template <typename T, int in_sizet, int out_sizet, int num_layerst>
+class StackedLSTMT
+{
+    static_assert(num_layerst > 0, "A stacked LSTM must have at least one layer!");
+
+public:
+    static constexpr auto in_size = in_sizet;
+    static constexpr auto out_size = out_sizet;
+    static constexpr auto num_layers = num_layerst;
+
+    /** A single layer of the stack, which can be loaded like a LSTMLayerT. */
+    struct LayerRef
+    {
+        void setWVals(const std::vector<std::vector<T>>& wVals) { stack.setWVals(layer, wVals); }
+        void setUVals(const std::vector<std::vector<T>>& uVals) { stack.setUVals(layer, uVals); }
+        void setBVals(const std::vector<T>& bVals) { stack.setBVals(layer, bVals); }
+
+        StackedLSTMT& stack;
+        const int layer;
+        const int in_size;
+        static constexpr auto out_size = out_sizet;
+    };
+
+    StackedLSTMT()
+    {
+        std::fill(std::begin(weights), std::end(weights), (T)0);
+        std::fill(std::begin(bias), std::end(bias), (T)0);
+        reset();
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "stacked_lstm"; }
+
+    /** Returns false since LSTM is not an activation. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Resets the state of every layer in the stack. */
+    void reset()
+    {
+        std::fill(std::begin(state), std::end(state), (T)0);
+        std::fill(std::begin(ct), std::end(ct), (lstm_cell_type<T>)0);
+        std::fill(std::begin(outs), std::end(outs), (T)0);
+    }
+
+    /** Prefetches the first weights used by `forward()`, if the layer is large enough to need prefetching. */
+    void prefetchWeights() const noexcept
+    {
+        lstm_detail::prefetch_panel<T, in_size + out_size, out_size>(weights);
+    }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T (&ins)[in_size]) noexcept
+    {
+        std::copy(ins, ins + in_size, state);
+
+        lstm_detail::forward_panel<T, in_size + out_size, out_size>(state, weights, bias, ct, [](int, T) {},
+            next_panel(0), next_panel_bytes(0));
+        for(int l = 1; l < num_layers; ++l)
+        {
+            lstm_detail::forward_panel<T, 2 * out_size, out_size>(state + in_size + (l - 1) * out_size,
+                weights + layer_weights_offset(l),
+                bias + l * 4 * out_size,
+                ct + l * out_size,
+                [](int, T) {},
+                next_panel(l), next_panel_bytes(l));
+        }
+
+        const auto* h = state + in_size + (num_layers - 1) * out_size;
+        std::copy(h, h + out_size, outs);
+    }
+
+    /** Returns a view of a single layer in the stack. */
+    LayerRef getLayer(int layer) noexcept
+    {
+        return { *this, layer, layer_in_size(layer) };
+    }
+
+    /**
+     * Sets the kernel weights for a layer.
+     *
+     * The weights vector must have size weights[layer_in_size][4 * out_size]
+     */
+    void setWVals(int layer, const std::vector<std::vector<T>>& wVals)
+    {
+        for(int k = 0; k < layer_in_size(layer); ++k)
+            lstm_detail::set_panel_row<T, out_size>(weights + layer_weights_offset(layer), k, wVals[(size_t)k]);
+    }
+
+    /**
+     * Sets the recurrent weights for a layer.
+     *
+     * The weights vector must have size weights[out_size][4 * out_size]
+     */
+    void setUVals(int layer, const std::vector<std::vector<T>>& uVals)
+    {
+        for(int k = 0; k < out_size; ++k)
+            lstm_detail::set_panel_row<T, out_size>(weights + layer_weights_offset(layer), layer_in_size(layer) + k, uVals[(size_t)k]);
+    }
+
+    /**
+     * Sets the bias for a layer.
+     *
+     * The bias vector must have size weights[4 * out_size]
+     */
+    void setBVals(int layer, const std::vector<T>& bVals)
+    {
+        std::copy(bVals.begin(), bVals.begin() + 4 * out_size, bias + layer * 4 * out_size);
+    }
+
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+
+private:
+    static constexpr int layer_in_size(int layer) noexcept
+    {
+        return layer == 0 ? in_size : out_size;
+    }
+
+    static constexpr int layer_weights_offset(int layer) noexcept
+    {
+        return layer == 0 ? 0 : 4 * out_size * (in_size + out_size) + (layer - 1) * 4 * out_size * 2 * out_size;
+    }
+
+    /** The panel to prefetch once a layer's own panel has been prefetched. */
+    const T* next_panel(int layer) const noexcept
+    {
+        return layer + 1 < num_layers ? weights + layer_weights_offset(layer + 1) : nullptr;
+    }
+
+    static constexpr size_t next_panel_bytes(int layer) noexcept
+    {
+        return layer + 1 < num_layers ? sizeof(T) * 4 * out_size * 2 * out_size : 0;
+    }
+
+    static constexpr auto num_weights = layer_weights_offset(num_layers);
+
+    // weight panels for each layer: [layer_in_size + out_size][4 * out_size]
+    T weights alignas(RTNEURAL_DEFAULT_ALIGNMENT)[num_weights];
+
+    // biases for each layer: [4 * out_size]
+    T bias alignas(RTNEURAL_DEFAULT_ALIGNMENT)[num_layers * 4 * out_size];
+
+    // [ins, h_0, ..., h_(n-1)]
+    T state alignas(RTNEURAL_DEFAULT_ALIGNMENT)[in_size + num_layers * out_size];
+
+    // cell states for each layer
+    lstm_cell_type<T> ct alignas(RTNEURAL_DEFAULT_ALIGNMENT)[num_layers * out_size];
+};
+
+} // namespace RTNeural
+
+#endif // STACKED_LSTM_H_INCLUDED
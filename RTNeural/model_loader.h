@@ -2,7 +2,12 @@
 
 #include "../modules/json/json.hpp"
 #include "Model.h"
+#include "film/film.h"
+#include "moe/moe.h"
+#include "multirate/decimated.h"
+#include "table/input_table.h"
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -73,14 +78,92 @@ namespace json_parser
 
 
 
-    /** Loads weights for a LSTMLayer (or LSTMLayerT) from a json representation of the layer weights. */
+    /** Loads weights for an Embedding (or EmbeddingT) layer from a json representation of the layer weights. */
+    template <typename T, typename EmbeddingType>
+    void loadEmbedding(EmbeddingType& embedding, const nlohmann::json& weights)
+    {
+        embedding.setWeights(weights.at(0).get<std::vector<std::vector<T>>>());
+    }
+
+    /** Creates an Embedding layer from a json representation of the layer weights. */
+    template <typename T>
+    std::unique_ptr<Embedding<T>> createEmbedding(int out_size, const nlohmann::json& weights)
+    {
+        auto embedding = std::make_unique<Embedding<T>>((int)weights.at(0).size(), out_size);
+        loadEmbedding<T>(*embedding.get(), weights);
+        return embedding;
+    }
+
+    /** Checks that an EmbeddingT layer has the given dimensions. */
+    template <typename EmbeddingType>
+    bool checkEmbedding(const EmbeddingType& embedding, const std::string& type, int layerDims, const nlohmann::json& weights, const bool debug)
+    {
+        if(type != "embedding")
+        {
+            debug_print("Wrong layer type! Expected: Embedding", debug);
+            return false;
+        }
+
+        if(layerDims != embedding.out_size)
+        {
+            debug_print("Wrong layer size! Expected: " + std::to_string(embedding.out_size), debug);
+            return false;
+        }
+
+        if((int)weights.at(0).size() != embedding.num_embeddings)
+        {
+            debug_print("Wrong number of embeddings! Expected: " + std::to_string(embedding.num_embeddings), debug);
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * Replaces the first layer of a model with a `OneHotDense` layer, if it is
+     * a Dense layer, and inputs [start, start + count) of the model are one-hot.
+     * At least one input must not be one-hot (otherwise the model should use an
+     * Embedding layer). Returns true if the layer was replaced.
+     */
+    template <typename T>
+    bool rewriteOneHotInputs(Model<T>& model, int start, int count)
+    {
+        if(model.layers.empty() || count <= 0 || start < 0 || start + count > model.getInSize() || count >= model.getInSize())
+            return false;
+
+        const auto* dense = dynamic_cast<const Dense<T>*>(model.layers.front());
+        if(dense == nullptr)
+            return false;
+
+        std::vector<std::vector<T>> weights((size_t)dense->out_size, std::vector<T>((size_t)dense->in_size));
+        std::vector<T> bias((size_t)dense->out_size);
+        for(int i = 0; i < dense->out_size; ++i)
+        {
+            for(int k = 0; k < dense->in_size; ++k)
+                weights[(size_t)i][(size_t)k] = dense->getWeight(i, k);
+            bias[(size_t)i] = dense->getBias(i);
+        }
+
+        auto* oneHotDense = new OneHotDense<T>(dense->in_size, dense->out_size, start, count);
+        oneHotDense->setWeights(weights);
+        oneHotDense->setBias(bias.data());
+
+        delete model.layers.front();
+        model.layers.front() = oneHotDense;
+        return true;
+    }
+
+    /**
+     * Loads weights for a LSTMLayer (or LSTMLayerT) from a json representation of the layer weights.
+     * CIFG LSTMs are loaded with `numGates = 3`, since they have no forget gate weights.
+     */
     template <typename T, typename LSTMType>
-    void loadLSTM(LSTMType& lstm, const nlohmann::json& weights)
+    void loadLSTM(LSTMType& lstm, const nlohmann::json& weights, int numGates = 4)
     {
         // load kernel weights
         std::vector<std::vector<T>> kernelWeights(lstm.in_size);
         for(auto& w : kernelWeights)
-            w.resize(4 * lstm.out_size, (T)0);
+            w.resize(numGates * lstm.out_size, (T)0);
 
         auto layerWeights = weights.at(0);
         for(size_t i = 0; i < layerWeights.size(); ++i)
@@ -95,7 +178,7 @@ namespace json_parser
         // load recurrent weights
         std::vector<std::vector<T>> recurrentWeights(lstm.out_size);
         for(auto& w : recurrentWeights)
-            w.resize(4 * lstm.out_size, (T)0);
+            w.resize(numGates * lstm.out_size, (T)0);
 
         auto layerWeights2 = weights.at(1);
         for(size_t i = 0; i < layerWeights2.size(); ++i)
@@ -140,6 +223,47 @@ namespace json_parser
         return true;
     }
 
+    /** Returns true if a json lstm layer is a CIFG LSTM, i.e. it has the attribute `"cifg": true`. */
+    inline bool isCIFG(const nlohmann::json& l)
+    {
+        return l.contains("cifg") && l["cifg"].get<bool>();
+    }
+
+    /** Checks that a regular LSTM layer has the given dimensions, and that the json layer is not a CIFG LSTM. */
+    template <typename T, typename LSTMType>
+    bool checkLSTM(const LSTMType& lstm, const nlohmann::json& l, const std::string& type, int layerDims, const bool debug)
+    {
+        if(isCIFG(l))
+        {
+            debug_print("Wrong layer type! Expected: LSTM, but the layer is a CIFG LSTM", debug);
+            return false;
+        }
+
+        return checkLSTM<T>(lstm, type, layerDims, debug);
+    }
+
+    /** Creates a CIFGLSTMLayer from a json representation of the layer weights. */
+    template <typename T>
+    std::unique_ptr<CIFGLSTMLayer<T>> createCIFGLSTM(int in_size, int out_size, const nlohmann::json& weights)
+    {
+        auto lstm = std::make_unique<CIFGLSTMLayer<T>>(in_size, out_size);
+        loadLSTM<T>(*lstm.get(), weights, 3);
+        return lstm;
+    }
+
+    /** Checks that a CIFGLSTMLayer (or CIFGLSTMLayerT) has the given dimensions, and that the json layer is a CIFG LSTM. */
+    template <typename T, typename LSTMType>
+    bool checkCIFGLSTM(const LSTMType& lstm, const nlohmann::json& l, const std::string& type, int layerDims, const bool debug)
+    {
+        if(type != "lstm" || !isCIFG(l))
+        {
+            debug_print("Wrong layer type! Expected: LSTM with \"cifg\": true", debug);
+            return false;
+        }
+
+        return checkLSTM<T>(lstm, type, layerDims, debug);
+    }
+
 
  
 
@@ -163,6 +287,12 @@ namespace json_parser
         if(activationType == "elu")
             return std::make_unique<ELuActivation<T>>(dims);
 
+        if(activationType == "sin")
+            return std::make_unique<SinActivation<T>>(dims);
+
+        if(activationType == "cos")
+            return std::make_unique<CosActivation<T>>(dims);
+
         return {};
     }
 
@@ -185,6 +315,212 @@ namespace json_parser
         return true;
     }
 
+    /**
+     * Returns the alpha values of a Snake layer, from the first entry of the
+     * layer weights. Alpha may be nested (e.g. with shape [1, channels, 1] when
+     * exported from PyTorch), and is flattened.
+     */
+    template <typename T>
+    std::vector<T> getSnakeAlpha(const nlohmann::json& weights)
+    {
+        std::vector<T> alpha;
+        std::function<void(const nlohmann::json&)> flatten = [&](const nlohmann::json& w)
+        {
+            if(w.is_array())
+            {
+                for(const auto& x : w)
+                    flatten(x);
+            }
+            else
+            {
+                alpha.push_back(w.get<T>());
+            }
+        };
+
+        flatten(weights.at(0));
+        return alpha;
+    }
+
+    /** Loads the alpha values for a SnakeActivation (or SnakeActivationT) from a json representation of the layer weights. */
+    template <typename T, typename SnakeType>
+    void loadSnake(SnakeType& snake, const nlohmann::json& weights)
+    {
+        snake.setAlphaVals(getSnakeAlpha<T>(weights));
+    }
+
+    /** Creates a SnakeActivation from a json representation of the layer weights. */
+    template <typename T>
+    std::unique_ptr<SnakeActivation<T>> createSnake(int dims, const nlohmann::json& weights)
+    {
+        auto snake = std::make_unique<SnakeActivation<T>>(dims);
+        loadSnake<T>(*snake.get(), weights);
+        return snake;
+    }
+
+    /** Checks that a SnakeActivation (or SnakeActivationT) has the given dimensions, and one alpha per channel (or one alpha in total). */
+    template <typename T, typename SnakeType>
+    bool checkSnake(const SnakeType& snake, const std::string& type, int layerDims, const nlohmann::json& weights, const bool debug)
+    {
+        if(type != "snake")
+        {
+            debug_print("Wrong layer type! Expected: Snake", debug);
+            return false;
+        }
+
+        if(layerDims != snake.out_size)
+        {
+            debug_print("Wrong layer size! Expected: " + std::to_string(snake.out_size), debug);
+            return false;
+        }
+
+        const auto numAlpha = (int)getSnakeAlpha<T>(weights).size();
+        if(numAlpha != 1 && numAlpha != snake.out_size)
+        {
+            debug_print("Wrong number of Snake alpha values! Expected: " + std::to_string(snake.out_size), debug);
+            return false;
+        }
+
+        return true;
+    }
+
+    /** Returns the idle expert policy from a json representation of a mixture-of-experts layer. */
+    inline MoEIdlePolicy getMoEIdlePolicy(const nlohmann::json& l)
+    {
+        const auto policy = l.contains("idle_policy") ? l["idle_policy"].get<std::string>() : std::string {};
+        if(policy == "reset")
+            return MoEIdlePolicy::Reset;
+
+        if(policy == "catch_up")
+            return MoEIdlePolicy::CatchUp;
+
+        return MoEIdlePolicy::Freeze;
+    }
+
+    /** Returns a json model representation for an expert from a mixture-of-experts layer. */
+    inline nlohmann::json getExpertJson(const nlohmann::json& expert, int in_size)
+    {
+        nlohmann::json expertJson;
+        expertJson["in_shape"] = { nullptr, nullptr, in_size };
+        expertJson["layers"] = expert.at("layers");
+        return expertJson;
+    }
+
+    /**
+     * Returns a json model representation for one head of a multi-head model,
+     * stored in the model json as `"heads": [ { "layers": [ ... ] }, ... ]`.
+     * The trunk of the model can be loaded from the same json as a regular model.
+     */
+    inline nlohmann::json getHeadJson(const nlohmann::json& parent, int head, int trunk_out_size)
+    {
+        return getExpertJson(parent.at("heads").at((size_t)head), trunk_out_size);
+    }
+
+    /**
+     * Creates a MixtureOfExperts layer from a json representation of the layer.
+     * Returns nullptr if the layer has no experts, or if top_k is out of range.
+     */
+    template <typename T>
+    std::unique_ptr<MixtureOfExperts<T>> createMoE(int in_size, int out_size, const nlohmann::json& l, const bool debug);
+
+    /** Checks that a MixtureOfExpertsT layer matches the json representation of the layer. */
+    template <typename MoEType>
+    bool checkMoE(const MoEType& moe, const std::string& type, int layerDims, const nlohmann::json& l, const bool debug)
+    {
+        if(type != "moe")
+        {
+            debug_print("Wrong layer type! Expected: MoE", debug);
+            return false;
+        }
+
+        if(layerDims != moe.out_size)
+        {
+            debug_print("Wrong layer size! Expected: " + std::to_string(moe.out_size), debug);
+            return false;
+        }
+
+        if((int)l.at("experts").size() != moe.num_experts)
+        {
+            debug_print("Wrong number of experts! Expected: " + std::to_string(moe.num_experts), debug);
+            return false;
+        }
+
+        if(l.contains("top_k") && l["top_k"].get<int>() != moe.top_k)
+            debug_print("MoE top_k does not match the model file! Using: " + std::to_string(moe.top_k), debug);
+
+        return true;
+    }
+
+    /** Creates a FiLM layer from a json representation of the layer. */
+    template <typename T>
+    std::unique_ptr<FiLM<T>> createFiLM(int size, const nlohmann::json& l, const bool debug);
+
+    /** Checks that a FiLMT layer matches the json representation of the layer. */
+    template <typename FiLMType>
+    bool checkFiLM(const FiLMType& film, const std::string& type, int layerDims, const nlohmann::json& l, const bool debug)
+    {
+        if(type != "film")
+        {
+            debug_print("Wrong layer type! Expected: FiLM", debug);
+            return false;
+        }
+
+        if(layerDims != film.out_size)
+        {
+            debug_print("Wrong layer size! Expected: " + std::to_string(film.out_size), debug);
+            return false;
+        }
+
+        if(l.at("num_controls").get<int>() != film.num_controls)
+        {
+            debug_print("Wrong number of controls! Expected: " + std::to_string(film.num_controls), debug);
+            return false;
+        }
+
+        return true;
+    }
+
+    /** Returns the upsampling mode of a decimated layer (defaults to linear). */
+    inline UpsamplingMode getUpsamplingMode(const nlohmann::json& l)
+    {
+        const auto mode = l.contains("upsampling") ? l["upsampling"].get<std::string>() : std::string {};
+        if(mode == "hold")
+            return UpsamplingMode::Hold;
+
+        return UpsamplingMode::Linear;
+    }
+
+    /** Creates a Decimated layer from a json representation of the layer. */
+    template <typename T>
+    std::unique_ptr<Decimated<T>> createDecimated(int in_size, int out_size, const nlohmann::json& l, const bool debug);
+
+    /** Checks that a DecimatedT layer matches the json representation of the layer. */
+    template <typename DecimatedType>
+    bool checkDecimated(const DecimatedType& decimated, const std::string& type, int layerDims, const nlohmann::json& l, const bool debug)
+    {
+        if(type != "decimated")
+        {
+            debug_print("Wrong layer type! Expected: Decimated", debug);
+            return false;
+        }
+
+        if(layerDims != decimated.out_size)
+        {
+            debug_print("Wrong layer size! Expected: " + std::to_string(decimated.out_size), debug);
+            return false;
+        }
+
+        if(l.at("factor").get<int>() != decimated.factor)
+        {
+            debug_print("Wrong decimation factor! Expected: " + std::to_string(decimated.factor), debug);
+            return false;
+        }
+
+        if(getUpsamplingMode(l) != decimated.upsampling)
+            debug_print("Decimated upsampling mode does not match the model file!", debug);
+
+        return true;
+    }
+
     /** Creates a neural network model from a json stream. */
     template <typename T>
     std::unique_ptr<Model<T>> parseJson(const nlohmann::json& parent, const bool debug = false)
@@ -236,18 +572,62 @@ namespace json_parser
                 add_activation(model, l);
             }
            
+            else if(type == "lstm" && isCIFG(l))
+            {
+                debug_print("  cifg: true", debug);
+                auto lstm = createCIFGLSTM<T>(model->getNextInSize(), layerDims, weights);
+                model->addLayer(lstm.release());
+            }
             else if(type == "lstm")
             {
                 auto lstm = createLSTM<T>(model->getNextInSize(), layerDims, weights);
                 model->addLayer(lstm.release());
             }
           
+            else if(type == "moe")
+            {
+                auto moe = createMoE<T>(model->getNextInSize(), layerDims, l, debug);
+                if(moe == nullptr)
+                    return {};
+
+                model->addLayer(moe.release());
+                add_activation(model, l);
+            }
+            else if(type == "film")
+            {
+                auto film = createFiLM<T>(layerDims, l, debug);
+                model->addLayer(film.release());
+                add_activation(model, l);
+            }
+            else if(type == "decimated")
+            {
+                auto decimated = createDecimated<T>(model->getNextInSize(), layerDims, l, debug);
+                model->addLayer(decimated.release());
+            }
+            else if(type == "embedding")
+            {
+                auto embedding = createEmbedding<T>(layerDims, weights);
+                model->addLayer(embedding.release());
+            }
+            else if(type == "snake")
+            {
+                auto snake = createSnake<T>(layerDims, weights);
+                model->addLayer(snake.release());
+            }
             else if(type == "activation")
             {
                 add_activation(model, l);
             }
         }
 
+        // models with categorical inputs can list their one-hot inputs as `"one_hot_inputs": { "start": 1, "count": 4 }`
+        if(parent.contains("one_hot_inputs"))
+        {
+            const auto& oneHot = parent["one_hot_inputs"];
+            if(rewriteOneHotInputs(*model, oneHot.at("start").get<int>(), oneHot.at("count").get<int>()))
+                debug_print("Replaced the one-hot inputs of the first layer with an embedding", debug);
+        }
+
         return std::move(model);
     }
 
@@ -260,5 +640,78 @@ namespace json_parser
         return parseJson<T>(parent, debug);
     }
 
+    /**
+     * Creates a neural network model from a json stream, and replaces the
+     * stateless layers at the start of the model with a lookup table
+     * (see `tabulateInputPrefix()`).
+     */
+    template <typename T>
+    std::unique_ptr<Model<T>> parseJson(const nlohmann::json& parent, const InputTableOptions<T>& tableOptions, const bool debug = false)
+    {
+        auto model = tabulateInputPrefix(parseJson<T>(parent, debug), tableOptions);
+        if(model != nullptr && !model->layers.empty() && model->layers.front()->getName() == "input_table")
+        {
+            const auto* table = static_cast<const InputTable<T>*>(model->layers.front());
+            debug_print("Replaced " + std::to_string(table->getNumLayers()) + " layers with an input table (max error: "
+                    + std::to_string(table->getMaxError()) + ")",
+                debug);
+        }
+
+        return model;
+    }
+
+    /** Creates a neural network model from a json stream, with an input table (see above). */
+    template <typename T>
+    std::unique_ptr<Model<T>> parseJson(std::ifstream& jsonStream, const InputTableOptions<T>& tableOptions, const bool debug = false)
+    {
+        nlohmann::json parent;
+        jsonStream >> parent;
+        return parseJson<T>(parent, tableOptions, debug);
+    }
+
+    template <typename T>
+    std::unique_ptr<MixtureOfExperts<T>> createMoE(int in_size, int out_size, const nlohmann::json& l, const bool debug)
+    {
+        const auto& experts = l.at("experts");
+        const auto topK = l.contains("top_k") ? l["top_k"].get<int>() : 1;
+        if(experts.empty() || topK < 1 || topK > (int)experts.size())
+        {
+            debug_print("Invalid MoE layer! Expected at least one expert, and 1 <= top_k <= " + std::to_string(experts.size()), debug);
+            return {};
+        }
+
+        auto moe = std::make_unique<MixtureOfExperts<T>>(in_size, out_size, (int)experts.size(), topK, getMoEIdlePolicy(l));
+        loadDense<T>(moe->getGate(), l.at("weights"));
+
+        for(int e = 0; e < moe->num_experts; ++e)
+        {
+            debug_print("  Expert " + std::to_string(e) + ":", debug);
+            moe->setExpert(e, parseJson<T>(getExpertJson(experts.at((size_t)e), in_size), debug));
+        }
+
+        return moe;
+    }
+
+    template <typename T>
+    std::unique_ptr<FiLM<T>> createFiLM(int size, const nlohmann::json& l, const bool debug)
+    {
+        const auto numControls = l.at("num_controls").get<int>();
+        auto film = std::make_unique<FiLM<T>>(size, numControls);
+
+        debug_print("  Conditioning:", debug);
+        film->setConditioningNetwork(parseJson<T>(getExpertJson(l, numControls), debug));
+        return film;
+    }
+
+    template <typename T>
+    std::unique_ptr<Decimated<T>> createDecimated(int in_size, int out_size, const nlohmann::json& l, const bool debug)
+    {
+        auto decimated = std::make_unique<Decimated<T>>(in_size, out_size, l.at("factor").get<int>(), getUpsamplingMode(l));
+
+        debug_print("  Decimated by " + std::to_string(decimated->factor) + ":", debug);
+        decimated->setNetwork(parseJson<T>(getExpertJson(l, in_size), debug));
+        return decimated;
+    }
+
 } // namespace json_parser
 } // namespace RTNeural
@@ -0,0 +1,310 @@
+#ifndef MOE_H_INCLUDED
+#define MOE_H_INCLUDED
+
+#include <cassert>
+#include <cmath>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include "../Model.h"
+
+namespace RTNeural
+{
+
+/** What to do with the state of recurrent experts that were not selected for a given step. */
+enum class MoEIdlePolicy
+{
+    Freeze, // idle experts keep their state until they are selected again
+    Reset, // experts are reset when they are selected after being idle
+    CatchUp, // at each step, one idle expert (in round-robin order) is also stepped with the current input
+};
+
+#ifndef DOXYGEN
+namespace moe_detail
+{
+    /**
+     * Finds the indices of the `k` largest gate logits, and computes the
+     * mixing weights as a softmax over the selected logits.
+     */
+    template <typename T>
+    void select_top_k(const T* logits, int num_experts, int k, int* indices, T* weights, bool* selected) noexcept
+    {
+        std::fill(selected, selected + num_experts, false);
+        for(int j = 0; j < k; ++j)
+        {
+            int best = -1;
+            for(int e = 0; e < num_experts; ++e)
+                if(!selected[e] && (best < 0 || logits[e] > logits[best]))
+                    best = e;
+
+            indices[j] = best;
+            selected[best] = true;
+        }
+
+        // the first index is the largest logit
+        const auto maxLogit = logits[indices[0]];
+        T sum = (T)0;
+        for(int j = 0; j < k; ++j)
+        {
+            weights[j] = std::exp(logits[indices[j]] - maxLogit);
+            sum += weights[j];
+        }
+
+        for(int j = 0; j < k; ++j)
+            weights[j] /= sum;
+    }
+
+    /** Returns the next idle expert after `start` (in round-robin order), or -1 if every expert is selected. */
+    inline int next_idle_expert(const bool* selected, int num_experts, int start) noexcept
+    {
+        for(int i = 0; i < num_experts; ++i)
+        {
+            const auto e = (start + i) % num_experts;
+            if(!selected[e])
+                return e;
+        }
+
+        return -1;
+    }
+} // namespace moe_detail
+#endif // DOXYGEN
+
+/**
+ * Dynamic implementation of a mixture-of-experts layer.
+ *
+ * A gating Dense layer computes a logit for each expert, and only the
+ * experts with the `top_k` largest logits are evaluated. Their outputs
+ * are mixed, weighted by a softmax over the selected logits. Each expert
+ * is a sequential sub-network, with the same input and output size as
+ * this layer.
+ */
+template <typename T>
+class MixtureOfExperts final : public Layer<T>
+{
+public:
+    /**
+     * Constructs a mixture-of-experts layer, with (empty) expert models.
+     * There must be at least one expert, and 1 <= top_k <= num_experts.
+     */
+    MixtureOfExperts(int in_size, int out_size, int num_experts, int top_k, MoEIdlePolicy idlePolicy = MoEIdlePolicy::Freeze)
+        : Layer<T>(in_size, out_size)
+        , num_experts(num_experts)
+        , top_k(top_k)
+        , idlePolicy(idlePolicy)
+        , gate(in_size, num_experts)
+        , logits((size_t)num_experts, (T)0)
+        , indices((size_t)num_experts, 0)
+        , weights((size_t)num_experts, (T)0)
+        , selected(new bool[(size_t)num_experts])
+        , wasActive(new bool[(size_t)num_experts])
+    {
+        assert(num_experts > 0 && top_k >= 1 && top_k <= num_experts);
+
+        for(int e = 0; e < num_experts; ++e)
+            experts.push_back(std::make_unique<Model<T>>(in_size));
+
+        std::fill(wasActive.get(), wasActive.get() + num_experts, true);
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept override { return "moe"; }
+
+    /** Resets the state of every expert. */
+    void reset() override
+    {
+        for(auto& expert : experts)
+            expert->reset();
+
+        std::fill(wasActive.get(), wasActive.get() + num_experts, true);
+        catchUpIdx = 0;
+    }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T* input, T* out) noexcept override
+    {
+        gate.forward(input, logits.data());
+        moe_detail::select_top_k(logits.data(), num_experts, top_k, indices.data(), weights.data(), selected.get());
+
+        std::fill(out, out + Layer<T>::out_size, (T)0);
+        for(int j = 0; j < top_k; ++j)
+        {
+            auto& expert = *experts[(size_t)indices[(size_t)j]];
+            if(idlePolicy == MoEIdlePolicy::Reset && !wasActive[indices[(size_t)j]])
+                expert.reset();
+
+            expert.forward(input);
+            const auto* expertOuts = expert.getOutputs();
+            for(int i = 0; i < Layer<T>::out_size; ++i)
+                out[i] += weights[(size_t)j] * expertOuts[i];
+        }
+
+        if(idlePolicy == MoEIdlePolicy::CatchUp)
+        {
+            const auto idle = moe_detail::next_idle_expert(selected.get(), num_experts, catchUpIdx);
+            if(idle >= 0)
+            {
+                experts[(size_t)idle]->forward(input);
+                catchUpIdx = (idle + 1) % num_experts;
+            }
+        }
+
+        std::copy(selected.get(), selected.get() + num_experts, wasActive.get());
+    }
+
+    /** Returns the gating layer. */
+    Dense<T>& getGate() noexcept { return gate; }
+
+    /** Returns the expert at a given index. */
+    Model<T>& getExpert(int index) noexcept { return *experts[(size_t)index]; }
+
+    /** Replaces the expert at a given index. */
+    void setExpert(int index, std::unique_ptr<Model<T>> expert) { experts[(size_t)index] = std::move(expert); }
+
+    /** Returns the indices of the experts selected for the most recent step. */
+    const int* getSelectedExperts() const noexcept { return indices.data(); }
+
+    const int num_experts;
+    const int top_k;
+    const MoEIdlePolicy idlePolicy;
+
+private:
+    Dense<T> gate;
+    std::vector<std::unique_ptr<Model<T>>> experts;
+
+    std::vector<T> logits;
+    std::vector<int> indices;
+    std::vector<T> weights;
+    std::unique_ptr<bool[]> selected;
+    std::unique_ptr<bool[]> wasActive;
+    int catchUpIdx = 0;
+};
+
+//====================================================
+/**
+ * Static implementation of a mixture-of-experts layer.
+ *
+ * A gating Dense layer computes a logit for each expert, and only the
+ * experts with the `top_k` largest logits are evaluated. Their outputs
+ * are mixed, weighted by a softmax over the selected logits. Each expert
+ * is a sub-network (typically a `ModelT`), with the same input and output
+ * size as this layer:
+ * ```
+ * using Expert = ModelT<float, 1, 1, LSTMLayerT<float, 1, 16>, DenseT<float, 16, 1>>;
+ * ModelT<float, 1, 1,
+ *     MixtureOfExpertsT<float, 1, 1, 2, MoEIdlePolicy::Freeze, Expert, Expert, Expert, Expert>
+ * > model;
+ * ```
+ */
+template <typename T, int in_sizet, int out_sizet, int top_kt, MoEIdlePolicy idlePolicy, typename... Experts>
+class MixtureOfExpertsT
+{
+public:
+    static constexpr auto in_size = in_sizet;
+    static constexpr auto out_size = out_sizet;
+    static constexpr auto num_experts = (int)sizeof...(Experts);
+    static constexpr auto top_k = top_kt < num_experts ? top_kt : num_experts;
+
+    static_assert(num_experts > 0, "A mixture of experts must have at least one expert!");
+    static_assert(top_kt > 0, "A mixture of experts must evaluate at least one expert!");
+
+    MixtureOfExpertsT()
+    {
+        for(int i = 0; i < out_size; ++i)
+            outs[i] = (T)0;
+
+        std::fill(std::begin(wasActive), std::end(wasActive), true);
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "moe"; }
+
+    /** Returns false since a mixture-of-experts is not an activation. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Resets the state of every expert. */
+    void reset()
+    {
+        forEachExpert([](auto& expert, size_t)
+            { expert.reset(); });
+
+        std::fill(std::begin(wasActive), std::end(wasActive), true);
+        catchUpIdx = 0;
+    }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T (&ins)[in_size]) noexcept
+    {
+        gate.forward(ins);
+        moe_detail::select_top_k(gate.outs, num_experts, top_k, indices, weights, selected);
+
+        for(int i = 0; i < out_size; ++i)
+            outs[i] = (T)0;
+
+        const auto idle = idlePolicy == MoEIdlePolicy::CatchUp ? moe_detail::next_idle_expert(selected, num_experts, catchUpIdx) : -1;
+        forEachExpert([this, &ins, idle](auto& expert, size_t e)
+            {
+                if((int)e == idle)
+                {
+                    expert.forward(ins);
+                    return;
+                }
+
+                if(!selected[e])
+                    return;
+
+                if(idlePolicy == MoEIdlePolicy::Reset && !wasActive[e])
+                    expert.reset();
+
+                const auto weight = weights[std::find(indices, indices + top_k, (int)e) - indices];
+                expert.forward(ins);
+                const auto* expertOuts = expert.getOutputs();
+                for(int i = 0; i < out_size; ++i)
+                    outs[i] += weight * expertOuts[i];
+            });
+
+        if(idle >= 0)
+            catchUpIdx = (idle + 1) % num_experts;
+
+        std::copy(std::begin(selected), std::end(selected), std::begin(wasActive));
+    }
+
+    /** Returns the gating layer. */
+    DenseT<T, in_size, num_experts>& getGate() noexcept { return gate; }
+
+    /** Returns the expert at a given index. */
+    template <int Index>
+    auto& getExpert() noexcept { return std::get<Index>(experts); }
+
+    /** Calls `fn(expert, index)` for each expert. */
+    template <typename Fn>
+    void forEachExpert(Fn&& fn)
+    {
+        forEachExpertImpl(std::forward<Fn>(fn), std::make_index_sequence<num_experts> {});
+    }
+
+    /** Returns the indices of the experts selected for the most recent step. */
+    const int* getSelectedExperts() const noexcept { return indices; }
+
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+
+private:
+    template <typename Fn, size_t... Ix>
+    void forEachExpertImpl(Fn&& fn, std::index_sequence<Ix...>)
+    {
+        (void)std::initializer_list<int> { ((void)fn(std::get<Ix>(experts), Ix), 0)... };
+    }
+
+    DenseT<T, in_size, num_experts> gate;
+    std::tuple<Experts...> experts;
+
+    int indices[num_experts] {};
+    T weights[num_experts] {};
+    bool selected[num_experts] {};
+    bool wasActive[num_experts] {};
+    int catchUpIdx = 0;
+};
+
+} // namespace RTNeural
+
+#endif // MOE_H_INCLUDED
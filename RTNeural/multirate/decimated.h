@@ -0,0 +1,206 @@
+#ifndef DECIMATED_H_INCLUDED
+#define DECIMATED_H_INCLUDED
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "../Model.h"
+#include "../combinators/combinators.h"
+#include "resampling.h"
+
+namespace RTNeural
+{
+
+/** How the outputs of a decimated stage are reconstructed at the outer rate. */
+enum class UpsamplingMode
+{
+    Hold, // each output is held until the stage runs again
+    Linear, // linear interpolation between the two most recent outputs (adds factor - 1 samples of latency)
+};
+
+#ifndef DOXYGEN
+namespace decimated_detail
+{
+    /** Upsamples the outputs of the stage, at a given phase of the current block. */
+    template <typename T>
+    inline void upsample(const T* previous, const T* current, T* outs, int size, int phase, int factor, UpsamplingMode mode) noexcept
+    {
+        if(mode == UpsamplingMode::Hold)
+        {
+            std::copy(current, current + size, outs);
+            return;
+        }
+
+        multirate_detail::interpolate_linear(previous, current, outs, size, multirate_detail::interpolation_position<T>(phase, factor));
+    }
+} // namespace decimated_detail
+#endif // DOXYGEN
+
+/**
+ * Dynamic implementation of a decimated stage: a sequential sub-network
+ * which runs at `1 / factor` of the rate of the surrounding model.
+ *
+ * The input is average-pooled over blocks of `factor` samples, the
+ * sub-network is run once per block, and its outputs are upsampled back
+ * to the outer rate (see `UpsamplingMode`). Decimated stages can be nested
+ * to build encoder/decoder (or U-Net) style models, where the inner layers
+ * run at 1/2, 1/4, 1/8, ... of the audio rate.
+ */
+template <typename T>
+class Decimated final : public Layer<T>
+{
+public:
+    /** Constructs a decimated stage, with an (empty) sub-network. */
+    Decimated(int in_size, int out_size, int factor, UpsamplingMode upsampling = UpsamplingMode::Linear)
+        : Layer<T>(in_size, out_size)
+        , factor(std::max(factor, 1))
+        , upsampling(upsampling)
+        , network(std::make_unique<Model<T>>(in_size))
+        , inputSum((size_t)in_size, (T)0)
+        , pooled((size_t)in_size, (T)0)
+        , previous((size_t)out_size, (T)0)
+        , current((size_t)out_size, (T)0)
+    {
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept override { return "decimated"; }
+
+    /** Resets the state of the sub-network, and the resampling state. */
+    void reset() override
+    {
+        network->reset();
+        std::fill(inputSum.begin(), inputSum.end(), (T)0);
+        std::fill(previous.begin(), previous.end(), (T)0);
+        std::fill(current.begin(), current.end(), (T)0);
+        phase = 0;
+    }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T* input, T* out) noexcept override
+    {
+        if(multirate_detail::pool(input, inputSum.data(), pooled.data(), Layer<T>::in_size, phase, factor))
+        {
+            network->forward(pooled.data());
+            std::swap(previous, current);
+            std::copy(network->getOutputs(), network->getOutputs() + Layer<T>::out_size, current.begin());
+        }
+
+        decimated_detail::upsample(previous.data(), current.data(), out, Layer<T>::out_size, phase, factor, upsampling);
+    }
+
+    /** Returns the sub-network. */
+    Model<T>& getNetwork() noexcept { return *network; }
+
+    /** Replaces the sub-network. */
+    void setNetwork(std::unique_ptr<Model<T>> newNetwork) { network = std::move(newNetwork); }
+
+    const int factor;
+    const UpsamplingMode upsampling;
+
+private:
+    std::unique_ptr<Model<T>> network;
+
+    std::vector<T> inputSum;
+    std::vector<T> pooled;
+    std::vector<T> previous;
+    std::vector<T> current;
+    int phase = 0;
+};
+
+//====================================================
+/**
+ * Static implementation of a decimated stage: a chain of layers which
+ * runs at `1 / factor` of the rate of the surrounding model.
+ *
+ * The input is average-pooled over blocks of `factor` samples, the
+ * chain is run once per block, and its outputs are upsampled back
+ * to the outer rate (see `UpsamplingMode`). Decimated stages can be nested,
+ * and combined with `ResidualT` for skip connections, to build
+ * encoder/decoder (or U-Net) style models:
+ * ```
+ * ModelT<float, 1, 1,
+ *     DenseT<float, 1, 16>,
+ *     TanhActivationT<float, 16>,
+ *     ResidualT<float, DecimatedT<float, 2, UpsamplingMode::Linear, // runs at 1/2 rate
+ *         DenseT<float, 16, 16>,
+ *         TanhActivationT<float, 16>,
+ *         ResidualT<float, DecimatedT<float, 4, UpsamplingMode::Linear, // runs at 1/8 rate
+ *             LSTMLayerT<float, 16, 16>>>>>,
+ *     DenseT<float, 16, 1>
+ * > model;
+ * ```
+ */
+template <typename T, int factort, UpsamplingMode upsamplingt, typename... Layers>
+class DecimatedT
+{
+    using ChainType = SequentialT<T, Layers...>;
+
+public:
+    static constexpr auto in_size = ChainType::in_size;
+    static constexpr auto out_size = ChainType::out_size;
+    static constexpr auto factor = factort;
+    static constexpr auto upsampling = upsamplingt;
+
+    static_assert(factort > 0, "The decimation factor must be at least 1!");
+
+    DecimatedT()
+    {
+        std::fill(std::begin(pooled), std::end(pooled), (T)0);
+        std::fill(std::begin(outs), std::end(outs), (T)0);
+        reset();
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "decimated"; }
+
+    /** Returns false since a decimated stage is not an activation. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Resets the state of the layers in the stage, and the resampling state. */
+    void reset()
+    {
+        chain.reset();
+        std::fill(std::begin(inputSum), std::end(inputSum), (T)0);
+        std::fill(std::begin(previous), std::end(previous), (T)0);
+        std::fill(std::begin(current), std::end(current), (T)0);
+        phase = 0;
+    }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T (&ins)[in_size]) noexcept
+    {
+        if(multirate_detail::pool(ins, inputSum, pooled, in_size, phase, factor))
+        {
+            chain.forward(pooled);
+            std::copy(std::begin(current), std::end(current), previous);
+            std::copy(chain.outs, chain.outs + out_size, current);
+        }
+
+        decimated_detail::upsample(previous, current, outs, out_size, phase, factor, upsampling);
+    }
+
+    /** Get a reference to the layer at index `Index`. */
+    template <int Index>
+    auto& get() noexcept
+    {
+        return chain.template get<Index>();
+    }
+
+    /** The chain of layers inside the stage. */
+    ChainType chain;
+
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+
+private:
+    T inputSum alignas(RTNEURAL_DEFAULT_ALIGNMENT)[in_size];
+    T pooled alignas(RTNEURAL_DEFAULT_ALIGNMENT)[in_size];
+    T previous alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+    T current alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+    int phase = 0;
+};
+
+} // namespace RTNeural
+
+#endif // DECIMATED_H_INCLUDED
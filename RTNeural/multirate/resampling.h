@@ -0,0 +1,54 @@
+#ifndef RESAMPLING_H_INCLUDED
+#define RESAMPLING_H_INCLUDED
+
+namespace RTNeural
+{
+
+#ifndef DOXYGEN
+/**
+ * Shared helpers for running part of a model at `1 / factor` of the outer
+ * rate: the inputs are average-pooled over blocks of `factor` samples, and
+ * the outputs are interpolated back to the outer rate.
+ */
+namespace multirate_detail
+{
+    /** Average-pools the input over `factor` samples. Returns true when a block is complete. */
+    template <typename T>
+    inline bool pool(const T* ins, T* inputSum, T* pooled, int size, int& phase, int factor) noexcept
+    {
+        for(int i = 0; i < size; ++i)
+            inputSum[i] += ins[i];
+
+        if(++phase < factor)
+            return false;
+
+        const auto invFactor = (T)1 / (T)factor;
+        for(int i = 0; i < size; ++i)
+        {
+            pooled[i] = inputSum[i] * invFactor;
+            inputSum[i] = (T)0;
+        }
+        phase = 0;
+        return true;
+    }
+
+    /** Returns the interpolation position in (0, 1] for a given phase of the current block. */
+    template <typename T>
+    inline T interpolation_position(int phase, int factor) noexcept
+    {
+        return (T)(phase + 1) / (T)factor;
+    }
+
+    /** Linearly interpolates from the previous outputs to the current outputs, at position `t`. */
+    template <typename T>
+    inline void interpolate_linear(const T* previous, const T* current, T* outs, int size, T t) noexcept
+    {
+        for(int i = 0; i < size; ++i)
+            outs[i] = previous[i] + t * (current[i] - previous[i]);
+    }
+} // namespace multirate_detail
+#endif // DOXYGEN
+
+} // namespace RTNeural
+
+#endif // RESAMPLING_H_INCLUDED
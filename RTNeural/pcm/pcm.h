@@ -0,0 +1,209 @@
+#ifndef PCM_H_INCLUDED
+#define PCM_H_INCLUDED
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace RTNeural
+{
+
+/** A packed 24-bit little-endian PCM sample, as stored in 24-bit audio buffers. */
+struct PCM24
+{
+    uint8_t bytes[3];
+};
+
+static_assert(sizeof(PCM24) == 3, "PCM24 must be packed!");
+
+#ifndef DOXYGEN
+namespace pcm_detail
+{
+    /** Describes how a PCM sample type maps to the [-1, 1) range. Floating-point samples are passed through. */
+    template <typename S>
+    struct PCMTraits
+    {
+        static constexpr bool is_integer = false;
+    };
+
+    template <>
+    struct PCMTraits<int16_t>
+    {
+        static constexpr bool is_integer = true;
+        static constexpr double full_scale = 32768.0;
+        static constexpr int32_t min_int = -32768;
+        static constexpr int32_t max_int = 32767;
+
+        static inline int32_t to_int(int16_t x) noexcept { return (int32_t)x; }
+        static inline int16_t from_int(int32_t x) noexcept { return (int16_t)x; }
+    };
+
+    template <>
+    struct PCMTraits<PCM24>
+    {
+        static constexpr bool is_integer = true;
+        static constexpr double full_scale = 8388608.0;
+        static constexpr int32_t min_int = -8388608;
+        static constexpr int32_t max_int = 8388607;
+
+        static inline int32_t to_int(PCM24 x) noexcept
+        {
+            const auto u = (uint32_t)x.bytes[0] | ((uint32_t)x.bytes[1] << 8) | ((uint32_t)x.bytes[2] << 16);
+            return (int32_t)(u << 8) >> 8; // sign-extend from 24 bits
+        }
+
+        static inline PCM24 from_int(int32_t x) noexcept
+        {
+            const auto u = (uint32_t)x;
+            return { { (uint8_t)u, (uint8_t)(u >> 8), (uint8_t)(u >> 16) } };
+        }
+    };
+
+    template <>
+    struct PCMTraits<int32_t>
+    {
+        static constexpr bool is_integer = true;
+        static constexpr double full_scale = 2147483648.0;
+        static constexpr int32_t min_int = std::numeric_limits<int32_t>::min();
+        static constexpr int32_t max_int = std::numeric_limits<int32_t>::max();
+
+        static inline int32_t to_int(int32_t x) noexcept { return x; }
+        static inline int32_t from_int(int32_t x) noexcept { return x; }
+    };
+
+    /**
+     * The largest value of type T which converts to an integer sample without
+     * overflowing (float can't represent INT32_MAX, so this is 2^31 - 128).
+     */
+    template <typename T, typename Traits>
+    constexpr T max_value() noexcept
+    {
+        return (double)(T)Traits::max_int > (double)Traits::max_int
+            ? (T)(Traits::full_scale * (1.0 - 0.5 * (double)std::numeric_limits<T>::epsilon()))
+            : (T)Traits::max_int;
+    }
+} // namespace pcm_detail
+#endif // DOXYGEN
+
+/** Options for converting PCM samples at the boundary of a model (see `PCMConverter`). */
+template <typename T>
+struct PCMOptions
+{
+    T inputGain = (T)1; // applied to the inputs, after scaling integer samples to [-1, 1)
+    T outputGain = (T)1; // applied to the outputs, before scaling to integer samples
+    bool saturate = true; // clip integer outputs to the full-scale range, with NaN as 0 (otherwise they must already be in range)
+    bool dither = false; // add TPDF dither to integer outputs
+};
+
+/**
+ * Converts between PCM samples (int16_t, packed 24-bit `PCM24`, int32_t,
+ * or float/double with a gain) and the values used by a model.
+ *
+ * The model block entry points (`Model::processBlock()` and
+ * `ModelT::processBlock()`) call the converter for each sample as it is
+ * loaded into the first layer, and stored from the last layer, so the
+ * input and output buffers are only read and written once. The converter
+ * keeps the state of the dither noise between blocks.
+ */
+template <typename T>
+class PCMConverter
+{
+public:
+    explicit PCMConverter(const PCMOptions<T>& options = {})
+    {
+        setOptions(options);
+    }
+
+    /** Changes the conversion options. */
+    void setOptions(const PCMOptions<T>& newOptions) noexcept { options = newOptions; }
+
+    /** Returns the conversion options. */
+    const PCMOptions<T>& getOptions() const noexcept { return options; }
+
+    /** Restarts the dither noise from a given seed (which must not be zero). */
+    void setDitherSeed(uint32_t seed) noexcept { ditherState = seed != 0 ? seed : 1; }
+
+    /** Converts `n` PCM samples to model inputs. */
+    template <typename S>
+    inline void load(const S* in, T* out, int n) const noexcept
+    {
+        loadSamples(in, out, n, std::integral_constant<bool, pcm_detail::PCMTraits<S>::is_integer> {});
+    }
+
+    /** Converts `n` model outputs to PCM samples. */
+    template <typename S>
+    inline void store(const T* in, S* out, int n) noexcept
+    {
+        storeSamples(in, out, n, std::integral_constant<bool, pcm_detail::PCMTraits<S>::is_integer> {});
+    }
+
+private:
+    template <typename S>
+    inline void loadSamples(const S* in, T* out, int n, std::true_type) const noexcept
+    {
+        using Traits = pcm_detail::PCMTraits<S>;
+        const auto scale = options.inputGain * (T)(1.0 / Traits::full_scale);
+        for(int i = 0; i < n; ++i)
+            out[i] = (T)Traits::to_int(in[i]) * scale;
+    }
+
+    template <typename S>
+    inline void loadSamples(const S* in, T* out, int n, std::false_type) const noexcept
+    {
+        for(int i = 0; i < n; ++i)
+            out[i] = (T)in[i] * options.inputGain;
+    }
+
+    template <typename S>
+    inline void storeSamples(const T* in, S* out, int n, std::true_type) noexcept
+    {
+        using Traits = pcm_detail::PCMTraits<S>;
+        const auto scale = options.outputGain * (T)Traits::full_scale;
+        const auto minValue = (T)Traits::min_int;
+        constexpr auto maxValue = pcm_detail::max_value<T, Traits>();
+
+        for(int i = 0; i < n; ++i)
+        {
+            auto x = in[i] * scale;
+            if(options.dither)
+                x += tpdf();
+
+            // NaN fails every comparison, so it would pass through the clamp into the int32 conversion
+            if(options.saturate)
+                x = x == x ? std::min(std::max(x, minValue), maxValue) : (T)0;
+
+            // round half away from zero
+            out[i] = Traits::from_int((int32_t)(x + (x < (T)0 ? (T)-0.5 : (T)0.5)));
+        }
+    }
+
+    template <typename S>
+    inline void storeSamples(const T* in, S* out, int n, std::false_type) const noexcept
+    {
+        for(int i = 0; i < n; ++i)
+            out[i] = (S)(in[i] * options.outputGain);
+    }
+
+    /** Triangular noise in (-1, 1), i.e. +/- 1 LSB. */
+    inline T tpdf() noexcept
+    {
+        return uniform() - uniform();
+    }
+
+    /** Uniform noise in [0, 1), from a xorshift generator. */
+    inline T uniform() noexcept
+    {
+        ditherState ^= ditherState << 13;
+        ditherState ^= ditherState >> 17;
+        ditherState ^= ditherState << 5;
+        return (T)(ditherState >> 8) * (T)(1.0 / 16777216.0);
+    }
+
+    PCMOptions<T> options;
+    uint32_t ditherState = 0x9e3779b9u;
+};
+
+} // namespace RTNeural
+
+#endif // PCM_H_INCLUDED
@@ -0,0 +1,170 @@
+#ifndef FFT_H_INCLUDED
+#define FFT_H_INCLUDED
+
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+namespace RTNeural
+{
+
+/**
+ * A self-contained radix-2 FFT for real signals.
+ *
+ * A real signal of `size` samples is transformed as a complex signal of
+ * `size / 2` samples (even samples in the real part, odd samples in the
+ * imaginary part), followed by a post-processing pass to separate the
+ * spectrum. The real and imaginary parts are kept in separate arrays,
+ * and the twiddle factors for each stage are stored contiguously, so that
+ * the butterfly loops can be vectorized by the compiler. The same code is
+ * used with every backend (there are no Eigen or xsimd FFT kernels).
+ *
+ * All memory is allocated in the constructor.
+ */
+template <typename T>
+class FFT
+{
+public:
+    /** Creates an FFT for signals of `size` samples. The size must be a power of 2, of at least 4. */
+    explicit FFT(int size)
+        : size(size)
+        , half(size / 2)
+        , bitReverse((size_t)half, 0)
+        , twiddleRe((size_t)half, (T)0)
+        , twiddleIm((size_t)half, (T)0)
+        , realTwiddleRe((size_t)half + 1, (T)0)
+        , realTwiddleIm((size_t)half + 1, (T)0)
+        , workRe((size_t)half, (T)0)
+        , workIm((size_t)half, (T)0)
+    {
+        assert(size >= 4 && (size & (size - 1)) == 0);
+
+        int numBits = 0;
+        while((1 << numBits) < half)
+            numBits++;
+
+        for(int n = 0; n < half; ++n)
+        {
+            int reversed = 0;
+            for(int b = 0; b < numBits; ++b)
+                reversed |= ((n >> b) & 1) << (numBits - 1 - b);
+            bitReverse[(size_t)n] = reversed;
+        }
+
+        // twiddles for the stage with butterflies of span h: exp(-i * pi * k / h), k < h
+        const auto pi = 3.14159265358979323846;
+        size_t idx = 0;
+        for(int h = 1; h < half; h *= 2)
+        {
+            for(int k = 0; k < h; ++k, ++idx)
+            {
+                twiddleRe[idx] = (T)std::cos(pi * (double)k / (double)h);
+                twiddleIm[idx] = (T)-std::sin(pi * (double)k / (double)h);
+            }
+        }
+
+        for(int k = 0; k <= half; ++k)
+        {
+            realTwiddleRe[(size_t)k] = (T)std::cos(2.0 * pi * (double)k / (double)size);
+            realTwiddleIm[(size_t)k] = (T)-std::sin(2.0 * pi * (double)k / (double)size);
+        }
+    }
+
+    /** Returns the size of the FFT. */
+    int getSize() const noexcept { return size; }
+
+    /** Returns the number of bins in the spectrum of a real signal: `size / 2 + 1`. */
+    int getNumBins() const noexcept { return half + 1; }
+
+    /**
+     * Computes the spectrum of a real signal of `size` samples.
+     * The real and imaginary parts of the `size / 2 + 1` bins are written to `outRe` and `outIm`.
+     */
+    void performRealForward(const T* input, T* outRe, T* outIm) noexcept
+    {
+        performComplexForward(input);
+        for(int k = 0; k <= half; ++k)
+            getRealBin(k, outRe[k], outIm[k]);
+    }
+
+    /** Computes the power spectrum `|X[k]|^2` of a real signal of `size` samples, with `size / 2 + 1` bins. */
+    void performPowerSpectrum(const T* input, T* power) noexcept
+    {
+        performComplexForward(input);
+        for(int k = 0; k <= half; ++k)
+        {
+            T re, im;
+            getRealBin(k, re, im);
+            power[k] = re * re + im * im;
+        }
+    }
+
+private:
+    /** Packs the real input into the (bit-reversed) work buffers, and performs the complex FFT in place. */
+    void performComplexForward(const T* input) noexcept
+    {
+        for(int n = 0; n < half; ++n)
+        {
+            const auto j = (size_t)bitReverse[(size_t)n];
+            workRe[j] = input[2 * n];
+            workIm[j] = input[2 * n + 1];
+        }
+
+        const auto* wRe = twiddleRe.data();
+        const auto* wIm = twiddleIm.data();
+        for(int h = 1; h < half; h *= 2)
+        {
+            for(int start = 0; start < half; start += 2 * h)
+            {
+                auto* aRe = workRe.data() + start;
+                auto* aIm = workIm.data() + start;
+                auto* bRe = aRe + h;
+                auto* bIm = aIm + h;
+                for(int k = 0; k < h; ++k)
+                {
+                    const auto tRe = bRe[k] * wRe[k] - bIm[k] * wIm[k];
+                    const auto tIm = bRe[k] * wIm[k] + bIm[k] * wRe[k];
+                    bRe[k] = aRe[k] - tRe;
+                    bIm[k] = aIm[k] - tIm;
+                    aRe[k] += tRe;
+                    aIm[k] += tIm;
+                }
+            }
+
+            wRe += h;
+            wIm += h;
+        }
+    }
+
+    /** Separates the spectra of the even and odd samples from the complex FFT, and combines them into bin k. */
+    inline void getRealBin(int k, T& re, T& im) const noexcept
+    {
+        const auto k1 = (size_t)(k == half ? 0 : k);
+        const auto k2 = (size_t)(k == 0 ? 0 : half - k);
+
+        const auto evenRe = (T)0.5 * (workRe[k1] + workRe[k2]);
+        const auto evenIm = (T)0.5 * (workIm[k1] - workIm[k2]);
+        const auto oddRe = (T)0.5 * (workIm[k1] + workIm[k2]);
+        const auto oddIm = (T)-0.5 * (workRe[k1] - workRe[k2]);
+
+        const auto wRe = realTwiddleRe[(size_t)k];
+        const auto wIm = realTwiddleIm[(size_t)k];
+        re = evenRe + wRe * oddRe - wIm * oddIm;
+        im = evenIm + wRe * oddIm + wIm * oddRe;
+    }
+
+    const int size;
+    const int half;
+
+    std::vector<int> bitReverse;
+    std::vector<T> twiddleRe;
+    std::vector<T> twiddleIm;
+    std::vector<T> realTwiddleRe;
+    std::vector<T> realTwiddleIm;
+    std::vector<T> workRe;
+    std::vector<T> workIm;
+};
+
+} // namespace RTNeural
+
+#endif // FFT_H_INCLUDED
@@ -0,0 +1,300 @@
+#ifndef INPUT_TABLE_H_INCLUDED
+#define INPUT_TABLE_H_INCLUDED
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "../Model.h"
+#include "../combinators/combinators.h"
+
+namespace RTNeural
+{
+
+/** Options for replacing the stateless input prefix of a model with a lookup table (see `InputTable`). */
+template <typename T>
+struct InputTableOptions
+{
+    T minInput = (T)-1; // the range of inputs covered by the table
+    T maxInput = (T)1;
+    int numPoints = 2048; // the number of points in the table
+};
+
+#ifndef DOXYGEN
+namespace input_table_detail
+{
+    /**
+     * Fills a table of `num_points` rows of `size` outputs, with `eval(x, out)`
+     * evaluated at evenly spaced inputs from `min_input` to `max_input`. Returns
+     * the largest interpolation error at the midpoints between the table points.
+     */
+    template <typename T, typename Eval>
+    T build(T* values, int num_points, int size, T min_input, T max_input, Eval&& eval)
+    {
+        const auto step = (max_input - min_input) / (T)(num_points - 1);
+        for(int i = 0; i < num_points; ++i)
+            eval(min_input + (T)i * step, values + i * size);
+
+        T max_error = (T)0;
+        std::vector<T> midpoint((size_t)size);
+        for(int i = 0; i < num_points - 1; ++i)
+        {
+            eval(min_input + ((T)i + (T)0.5) * step, midpoint.data());
+            for(int j = 0; j < size; ++j)
+            {
+                const auto interpolated = (T)0.5 * (values[i * size + j] + values[(i + 1) * size + j]);
+                max_error = std::max(max_error, std::abs(interpolated - midpoint[(size_t)j]));
+            }
+        }
+
+        return max_error;
+    }
+
+    /** Interpolates the outputs for an input from the table. Returns false if the input is outside of the table. */
+    template <typename T>
+    inline bool lookup(const T* values, int num_points, int size, T min_input, T inv_step, T x, T* out) noexcept
+    {
+        const auto pos = (x - min_input) * inv_step;
+        if(!(pos >= (T)0 && pos < (T)(num_points - 1))) // also catches NaNs
+            return false;
+
+        const auto idx = (int)pos;
+        const auto frac = pos - (T)idx;
+        const auto* v0 = values + idx * size;
+        const auto* v1 = v0 + size;
+        for(int j = 0; j < size; ++j)
+            out[j] = v0[j] + frac * (v1[j] - v0[j]);
+
+        return true;
+    }
+} // namespace input_table_detail
+#endif // DOXYGEN
+
+/**
+ * Dynamic implementation of an input table: a stateless chain of layers
+ * with a single input (e.g. a Dense layer followed by an activation), which
+ * is replaced by a lookup table, with linear interpolation between the
+ * table points. Inputs outside of the range of the table are computed
+ * with the original layers.
+ *
+ * For a dynamic model, `tabulateInputPrefix()` replaces the stateless
+ * layers at the start of the model with an input table.
+ */
+template <typename T>
+class InputTable final : public Layer<T>
+{
+public:
+    /** Constructs an input table from a chain of stateless layers, with a single input. */
+    InputTable(std::vector<std::unique_ptr<Layer<T>>> prefixLayers, const InputTableOptions<T>& options = {})
+        : Layer<T>(1, prefixLayers.back()->out_size)
+        , layers(std::move(prefixLayers))
+        , minInput(options.minInput)
+        , numPoints(std::max(options.numPoints, 2))
+        , invStep((T)(numPoints - 1) / (options.maxInput - options.minInput))
+        , values((size_t)numPoints * (size_t)Layer<T>::out_size)
+    {
+        for(auto& l : layers)
+            outs.emplace_back((size_t)l->out_size, (T)0);
+
+        maxError = input_table_detail::build(values.data(), numPoints, Layer<T>::out_size, options.minInput, options.maxInput,
+            [this](T x, T* out)
+            {
+                forwardLayers(&x);
+                std::copy(outs.back().begin(), outs.back().end(), out);
+            });
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept override { return "input_table"; }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T* input, T* out) noexcept override
+    {
+        if(input_table_detail::lookup(values.data(), numPoints, Layer<T>::out_size, minInput, invStep, input[0], out))
+            return;
+
+        forwardLayers(input);
+        std::copy(outs.back().begin(), outs.back().end(), out);
+    }
+
+    /** Returns the largest interpolation error of the table (measured between the table points). */
+    T getMaxError() const noexcept { return maxError; }
+
+    /** Returns the number of layers that were replaced by the table. */
+    int getNumLayers() const noexcept { return (int)layers.size(); }
+
+    /** Returns one of the layers that were replaced by the table. */
+    const Layer<T>& getLayer(int index) const noexcept { return *layers[(size_t)index]; }
+
+private:
+    inline void forwardLayers(const T* input) noexcept
+    {
+        layers[0]->forward(input, outs[0].data());
+        for(size_t i = 1; i < layers.size(); ++i)
+            layers[i]->forward(outs[i - 1].data(), outs[i].data());
+    }
+
+    std::vector<std::unique_ptr<Layer<T>>> layers;
+    std::vector<std::vector<T>> outs;
+
+    const T minInput;
+    const int numPoints;
+    const T invStep;
+    std::vector<T> values;
+    T maxError = (T)0;
+};
+
+/** Returns true if a layer of a dynamic model is stateless (i.e. a dense or activation layer). */
+template <typename T>
+bool isStatelessLayer(const Layer<T>* layer)
+{
+    return dynamic_cast<const Dense<T>*>(layer) != nullptr || dynamic_cast<const Activation<T>*>(layer) != nullptr;
+}
+
+/**
+ * Replaces the stateless layers at the start of a model with a single
+ * `InputTable`, if the model has a single input, and the stateless layers
+ * include at least one activation (a Dense layer on its own is no cheaper
+ * as a table). Returns the (possibly unchanged) model.
+ */
+template <typename T>
+std::unique_ptr<Model<T>> tabulateInputPrefix(std::unique_ptr<Model<T>> model, const InputTableOptions<T>& options = {})
+{
+    if(model == nullptr || model->layers.empty() || model->getInSize() != 1)
+        return model;
+
+    size_t prefixLength = 0;
+    bool hasActivation = false;
+    while(prefixLength < model->layers.size() && isStatelessLayer(model->layers[prefixLength]))
+    {
+        hasActivation |= dynamic_cast<const Activation<T>*>(model->layers[prefixLength]) != nullptr;
+        prefixLength++;
+    }
+
+    if(!hasActivation)
+        return model;
+
+    std::vector<std::unique_ptr<Layer<T>>> prefix;
+    for(size_t i = 0; i < prefixLength; ++i)
+        prefix.emplace_back(model->layers[i]);
+
+    auto tabulated = std::make_unique<Model<T>>(1);
+    tabulated->addLayer(new InputTable<T>(std::move(prefix), options));
+    for(size_t i = prefixLength; i < model->layers.size(); ++i)
+        tabulated->addLayer(model->layers[i]);
+
+    model->layers.clear(); // the layers now belong to the tabulated model
+    return tabulated;
+}
+
+//====================================================
+/**
+ * Static implementation of an input table: a stateless chain of layers
+ * with a single input, which is replaced by a lookup table with `num_points`
+ * points, with linear interpolation between the table points. Inputs outside
+ * of the range of the table are computed with the original layers.
+ *
+ * This layer wraps the first few layers of a `ModelT`, and is loaded from
+ * the same json as the layers that it wraps, after which `ModelT::parseJson()`
+ * builds the table:
+ * ```
+ * ModelT<float, 1, 1,
+ *     InputTableT<float, 2048,
+ *         DenseT<float, 1, 8>,
+ *         TanhActivationT<float, 8>>,
+ *     LSTMLayerT<float, 8, 8>,
+ *     DenseT<float, 8, 1>
+ * > model;
+ * ```
+ * The range of the table can be changed with `setRange()` before loading the
+ * model, or by calling `tabulate()` again.
+ */
+template <typename T, int num_pointst, typename... Layers>
+class InputTableT
+{
+    using ChainType = SequentialT<T, Layers...>;
+
+public:
+    static constexpr auto in_size = ChainType::in_size;
+    static constexpr auto out_size = ChainType::out_size;
+    static constexpr auto num_points = num_pointst;
+
+    static_assert(in_size == 1, "An input table must have a single input!");
+    static_assert(num_points > 1, "An input table must have at least two points!");
+
+    InputTableT()
+    {
+        std::fill(std::begin(values), std::end(values), (T)0);
+        std::fill(std::begin(outs), std::end(outs), (T)0);
+        setRange((T)-1, (T)1);
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "input_table"; }
+
+    /** Returns false since an input table is not an activation. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Reset is a no-op, since the layers in the table do not have state. */
+    void reset() { }
+
+    /** Sets the range of inputs covered by the table (which is used the next time that the table is built). */
+    void setRange(T newMinInput, T newMaxInput)
+    {
+        minInput = newMinInput;
+        maxInput = newMaxInput;
+    }
+
+    /** Builds the table from the current weights of the layers. Returns the largest interpolation error. */
+    T tabulate()
+    {
+        invStep = (T)(num_points - 1) / (maxInput - minInput);
+        maxError = input_table_detail::build(values, num_points, out_size, minInput, maxInput,
+            [this](T x, T* out)
+            {
+                const T ins[] = { x };
+                chain.forward(ins);
+                std::copy(chain.outs, chain.outs + out_size, out);
+            });
+        return maxError;
+    }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T (&ins)[in_size]) noexcept
+    {
+        if(input_table_detail::lookup(values, num_points, out_size, minInput, invStep, ins[0], outs))
+            return;
+
+        chain.forward(ins);
+        std::copy(chain.outs, chain.outs + out_size, outs);
+    }
+
+    /** Returns the largest interpolation error of the table (measured between the table points). */
+    T getMaxError() const noexcept { return maxError; }
+
+    /** Get a reference to the layer at index `Index`. */
+    template <int Index>
+    auto& get() noexcept
+    {
+        return chain.template get<Index>();
+    }
+
+    /** The layers which are replaced by the table. */
+    ChainType chain;
+
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+
+private:
+    T values alignas(RTNEURAL_DEFAULT_ALIGNMENT)[num_points * out_size];
+
+    T minInput;
+    T maxInput;
+    T invStep = std::numeric_limits<T>::quiet_NaN(); // until the table is built, every input is computed by the layers
+    T maxError = (T)0;
+};
+
+} // namespace RTNeural
+
+#endif // INPUT_TABLE_H_INCLUDED
@@ -0,0 +1,143 @@
+#include "bench_report.hpp"
+#include <RTNeural.h>
+#include <chrono>
+#include <random>
+
+namespace
+{
+using clock_t = std::chrono::high_resolution_clock;
+using second_t = std::chrono::duration<double>;
+
+template <typename T>
+std::vector<T> generate_streams(size_t n_samples, int in_size, int n_streams)
+{
+    std::default_random_engine generator;
+    std::uniform_real_distribution<T> distribution((T)-1, (T)1);
+
+    std::vector<T> signal(n_samples * (size_t)in_size * (size_t)n_streams);
+    for(auto& x : signal)
+        x = distribution(generator);
+
+    return signal;
+}
+
+/** Sets random weights for a LSTMLayer or LSTMLayerBatch. */
+template <typename T, typename LSTMType>
+void randomise_lstm(LSTMType& lstm)
+{
+    std::default_random_engine generator;
+    std::uniform_real_distribution<T> distribution((T)-0.5, (T)0.5);
+
+    std::vector<std::vector<T>> kernelWeights((size_t)lstm.in_size, std::vector<T>(4 * (size_t)lstm.out_size));
+    for(auto& w : kernelWeights)
+        for(auto& x : w)
+            x = distribution(generator);
+    lstm.setWVals(kernelWeights);
+
+    std::vector<std::vector<T>> recurrentWeights((size_t)lstm.out_size, std::vector<T>(4 * (size_t)lstm.out_size));
+    for(auto& w : recurrentWeights)
+        for(auto& x : w)
+            x = distribution(generator);
+    lstm.setUVals(recurrentWeights);
+
+    std::vector<T> bias(4 * (size_t)lstm.out_size);
+    for(auto& x : bias)
+        x = distribution(generator);
+    lstm.setBVals(bias);
+}
+
+/** Processes each stream separately, with a regular LSTM layer. */
+template <typename T>
+double run_per_stream(RTNeural::LSTMLayer<T>& lstm, const std::vector<T>& signal, size_t n_samples, int n_streams)
+{
+    std::vector<T> out((size_t)lstm.out_size);
+    const auto in_size = (size_t)lstm.in_size;
+
+    auto start = clock_t::now();
+    for(int s = 0; s < n_streams; ++s)
+    {
+        lstm.reset();
+        const auto* stream = signal.data() + (size_t)s * n_samples * in_size;
+        for(size_t n = 0; n < n_samples; ++n)
+            lstm.forward(stream + n * in_size, out.data());
+    }
+    return std::chrono::duration_cast<second_t>(clock_t::now() - start).count();
+}
+
+/** Processes all the streams together, with a batch LSTM layer. */
+template <typename T>
+double run_batch(RTNeural::LSTMLayerBatch<T>& lstm, const std::vector<T>& signal, size_t n_samples, int n_streams)
+{
+    std::vector<T> ins((size_t)lstm.in_size * n_streams);
+    std::vector<T> out((size_t)lstm.out_size * n_streams);
+    const auto in_size = (size_t)lstm.in_size;
+
+    auto start = clock_t::now();
+    lstm.reset();
+    for(size_t n = 0; n < n_samples; ++n)
+    {
+        for(int s = 0; s < n_streams; ++s)
+        {
+            const auto* x = signal.data() + ((size_t)s * n_samples + n) * in_size;
+            std::copy(x, x + in_size, ins.begin() + (size_t)s * in_size);
+        }
+        lstm.forward(ins.data(), out.data(), n_streams, nullptr);
+    }
+    return std::chrono::duration_cast<second_t>(clock_t::now() - start).count();
+}
+
+template <typename T>
+void bench_lstm(int in_size, int hidden_size, double length_seconds, const std::vector<int>& batch_sizes, std::vector<bench_report::Result>& results)
+{
+    const auto precision = std::is_same<T, float>::value ? "float" : "double";
+    const auto name = "lstm_" + std::to_string(in_size) + "x" + std::to_string(hidden_size);
+    const auto n_samples = static_cast<size_t>(bench_report::audio_sample_rate * length_seconds);
+    const auto max_batch = *std::max_element(batch_sizes.begin(), batch_sizes.end());
+    const auto signal = generate_streams<T>(n_samples, in_size, max_batch);
+
+    RTNeural::LSTMLayer<T> lstm(in_size, hidden_size);
+    randomise_lstm<T>(lstm);
+    for(auto batch_size : batch_sizes)
+    {
+        RTNeural::LSTMLayerBatch<T> lstmBatch(in_size, hidden_size, batch_size);
+        randomise_lstm<T>(lstmBatch);
+
+        const auto total_samples = n_samples * (size_t)batch_size;
+        results.push_back({ name, "stream x" + std::to_string(batch_size), precision, total_samples, run_per_stream(lstm, signal, n_samples, batch_size) });
+        results.push_back({ name, "batch x" + std::to_string(batch_size), precision, total_samples, run_batch(lstmBatch, signal, n_samples, batch_size) });
+    }
+}
+
+void help()
+{
+    std::cout << "RTNeural batch processing benchmarks:" << std::endl;
+    std::cout << "Usage: rtneural_batch_bench <length> <in_size> <hidden_size> [--json <file>]" << std::endl;
+    std::cout << "    Compares processing independent streams one at a time, against processing them as a batch." << std::endl;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if(argc != 4 && argc != 6)
+    {
+        help();
+        return 1;
+    }
+
+    const auto length_seconds = std::atof(argv[1]);
+    const auto in_size = std::atoi(argv[2]);
+    const auto hidden_size = std::atoi(argv[3]);
+    const std::string json_file = argc == 6 ? argv[5] : "";
+
+    const std::vector<int> batch_sizes { 1, 4, 16, 64 };
+    std::vector<bench_report::Result> results;
+    bench_lstm<float>(in_size, hidden_size, length_seconds, batch_sizes, results);
+    bench_lstm<double>(in_size, hidden_size, length_seconds, batch_sizes, results);
+
+    bench_report::print_table(results);
+
+    if(!json_file.empty() && !bench_report::write_json(json_file, "batch", results))
+        return 1;
+
+    return 0;
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "../modules/json/json.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * Common result type and reporting utilities for the benchmarks.
+ *
+ * Each benchmark produces a list of results, which can be printed
+ * as a table for humans, or written to a json file for scripts.
+ */
+namespace bench_report
+{
+
+constexpr double audio_sample_rate = 48000.0;
+
+struct Result
+{
+    std::string name; // model or layer name
+    std::string impl; // e.g. "dynamic", "templated"
+    std::string precision; // "float" or "double"
+    size_t n_samples = 0;
+    double seconds = 0.0;
+
+    // additional per-benchmark metrics (e.g. hardware counters)
+    std::map<std::string, double> extra {};
+
+    double samples_per_second() const noexcept { return seconds > 0.0 ? (double)n_samples / seconds : 0.0; }
+    double ns_per_sample() const noexcept { return n_samples > 0 ? seconds * 1.0e9 / (double)n_samples : 0.0; }
+    double instances_per_core() const noexcept { return samples_per_second() / audio_sample_rate; }
+};
+
+inline void print_table(const std::vector<Result>& results, std::ostream& os = std::cout)
+{
+    std::vector<std::string> extra_keys;
+    for(const auto& r : results)
+        for(const auto& e : r.extra)
+            if(std::find(extra_keys.begin(), extra_keys.end(), e.first) == extra_keys.end())
+                extra_keys.push_back(e.first);
+
+    size_t name_width = 5;
+    size_t impl_width = 12;
+    for(const auto& r : results)
+    {
+        name_width = std::max(name_width, r.name.size() + 1);
+        impl_width = std::max(impl_width, r.impl.size() + 1);
+    }
+
+    os << std::left << std::setw((int)name_width) << "name"
+       << std::setw((int)impl_width) << "impl"
+       << std::setw(10) << "precision"
+       << std::right << std::setw(16) << "samples/sec"
+       << std::setw(14) << "ns/sample"
+       << std::setw(16) << "instances@48k";
+    for(const auto& key : extra_keys)
+        os << std::setw(std::max(14, (int)key.size() + 2)) << key;
+    os << std::endl;
+
+    for(const auto& r : results)
+    {
+        os << std::left << std::setw((int)name_width) << r.name
+           << std::setw((int)impl_width) << r.impl
+           << std::setw(10) << r.precision
+           << std::right << std::fixed;
+
+        if(r.n_samples > 0)
+        {
+            os << std::setprecision(0) << std::setw(16) << r.samples_per_second()
+               << std::setprecision(2) << std::setw(14) << r.ns_per_sample()
+               << std::setprecision(1) << std::setw(16) << r.instances_per_core();
+        }
+        else // not a throughput benchmark
+        {
+            os << std::setw(16) << "-" << std::setw(14) << "-" << std::setw(16) << "-";
+        }
+
+        for(const auto& key : extra_keys)
+        {
+            const auto width = std::max(14, (int)key.size() + 2);
+            auto iter = r.extra.find(key);
+            if(iter == r.extra.end())
+                os << std::setw(width) << "-";
+            else
+                os << std::setprecision(3) << std::setw(width) << iter->second;
+        }
+        os << std::defaultfloat << std::endl;
+    }
+}
+
+inline nlohmann::json to_json(const std::vector<Result>& results)
+{
+    auto json_results = nlohmann::json::array();
+    for(const auto& r : results)
+    {
+        nlohmann::json jr;
+        jr["name"] = r.name;
+        jr["impl"] = r.impl;
+        jr["precision"] = r.precision;
+        jr["n_samples"] = r.n_samples;
+        jr["seconds"] = r.seconds;
+        if(r.n_samples > 0)
+        {
+            jr["samples_per_second"] = r.samples_per_second();
+            jr["ns_per_sample"] = r.ns_per_sample();
+            jr["instances_per_core_48k"] = r.instances_per_core();
+        }
+        for(const auto& e : r.extra)
+            jr[e.first] = e.second;
+        json_results.push_back(jr);
+    }
+
+    return nlohmann::json { { "benchmark", "" }, { "results", json_results } };
+}
+
+/** Writes the results to a json file, returns false if the file could not be opened. */
+inline bool write_json(const std::string& file, const std::string& benchmark_name, const std::vector<Result>& results)
+{
+    std::ofstream stream(file);
+    if(!stream.is_open())
+    {
+        std::cout << "Unable to open output file: " << file << std::endl;
+        return false;
+    }
+
+    auto json = to_json(results);
+    json["benchmark"] = benchmark_name;
+    stream << json.dump(4) << std::endl;
+    return true;
+}
+
+} // namespace bench_report
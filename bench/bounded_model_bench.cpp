@@ -0,0 +1,142 @@
+#include "bench_report.hpp"
+#include <RTNeural.h>
+#include <chrono>
+#include <random>
+
+namespace
+{
+using clock_t = std::chrono::high_resolution_clock;
+using second_t = std::chrono::duration<double>;
+
+template <typename T>
+using BoundedModelType = RTNeural::BoundedModel<T, 64, 4>;
+
+template <typename T, int hidden_size>
+using StaticModelType = RTNeural::ModelT<T, 1, 1,
+    RTNeural::LSTMLayerT<T, 1, hidden_size>,
+    RTNeural::DenseT<T, hidden_size, 1>>;
+
+nlohmann::json random_matrix(std::default_random_engine& generator, int rows, int cols)
+{
+    std::uniform_real_distribution<double> distribution(-0.5, 0.5);
+    auto matrix = nlohmann::json::array();
+    for(int i = 0; i < rows; ++i)
+    {
+        auto row = nlohmann::json::array();
+        for(int j = 0; j < cols; ++j)
+            row.push_back(distribution(generator));
+        matrix.push_back(row);
+    }
+    return matrix;
+}
+
+/** LSTM(1 -> hidden_size) -> Dense(hidden_size -> 1) */
+nlohmann::json model_json(int hidden_size)
+{
+    std::default_random_engine generator;
+
+    nlohmann::json lstm;
+    lstm["type"] = "lstm";
+    lstm["activation"] = "";
+    lstm["shape"] = { nullptr, nullptr, hidden_size };
+    lstm["weights"] = { random_matrix(generator, 1, 4 * hidden_size),
+        random_matrix(generator, hidden_size, 4 * hidden_size),
+        random_matrix(generator, 1, 4 * hidden_size)[0] };
+
+    nlohmann::json dense;
+    dense["type"] = "dense";
+    dense["activation"] = "";
+    dense["shape"] = { nullptr, nullptr, 1 };
+    dense["weights"] = { random_matrix(generator, hidden_size, 1), random_matrix(generator, 1, 1)[0] };
+
+    nlohmann::json model;
+    model["in_shape"] = { nullptr, nullptr, 1 };
+    model["layers"] = { lstm, dense };
+    return model;
+}
+
+template <typename T>
+std::vector<T> generate_signal(size_t n_samples)
+{
+    std::default_random_engine generator;
+    std::uniform_real_distribution<T> distribution((T)-1, (T)1);
+
+    std::vector<T> signal(n_samples);
+    for(auto& x : signal)
+        x = distribution(generator);
+
+    return signal;
+}
+
+template <typename ModelType, typename T>
+double time_model(ModelType& model, const std::vector<T>& signal)
+{
+    model.reset();
+
+    auto start = clock_t::now();
+    for(const auto& x : signal)
+        model.forward(&x);
+    return std::chrono::duration_cast<second_t>(clock_t::now() - start).count();
+}
+
+template <typename T, int hidden_size>
+void bench_size(const std::vector<T>& signal, std::vector<bench_report::Result>& results)
+{
+    const auto precision = std::is_same<T, float>::value ? "float" : "double";
+    const auto name = "lstm" + std::to_string(hidden_size) + " -> dense";
+    const auto modelJson = model_json(hidden_size);
+
+    auto dynamicModel = RTNeural::json_parser::parseJson<T>(modelJson);
+    results.push_back({ name, "Model", precision, signal.size(), time_model(*dynamicModel, signal) });
+
+    auto boundedModel = std::make_unique<BoundedModelType<T>>();
+    boundedModel->parseJson(modelJson);
+    results.push_back({ name, "BoundedModel<64, 4>", precision, signal.size(), time_model(*boundedModel, signal) });
+
+    auto staticModel = std::make_unique<StaticModelType<T, hidden_size>>();
+    staticModel->parseJson(modelJson);
+    results.push_back({ name, "ModelT", precision, signal.size(), time_model(*staticModel, signal) });
+}
+
+template <typename T>
+void bench_all(double length_seconds, std::vector<bench_report::Result>& results)
+{
+    const auto signal = generate_signal<T>(static_cast<size_t>(bench_report::audio_sample_rate * length_seconds));
+
+    bench_size<T, 8>(signal, results);
+    bench_size<T, 16>(signal, results);
+    bench_size<T, 24>(signal, results);
+    bench_size<T, 32>(signal, results);
+    bench_size<T, 64>(signal, results);
+}
+
+void help()
+{
+    std::cout << "RTNeural bounded model benchmarks:" << std::endl;
+    std::cout << "Usage: rtneural_bounded_model_bench <length> [--json <file>]" << std::endl;
+    std::cout << "    Compares Model, BoundedModel, and ModelT for LSTM models of several sizes." << std::endl;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if(argc != 2 && argc != 4)
+    {
+        help();
+        return 1;
+    }
+
+    const auto length_seconds = std::atof(argv[1]);
+    const std::string json_file = argc == 4 ? argv[3] : "";
+
+    std::vector<bench_report::Result> results;
+    bench_all<float>(length_seconds, results);
+    bench_all<double>(length_seconds, results);
+
+    bench_report::print_table(results);
+
+    if(!json_file.empty() && !bench_report::write_json(json_file, "bounded_model", results))
+        return 1;
+
+    return 0;
+}
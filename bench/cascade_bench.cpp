@@ -0,0 +1,237 @@
+#include "bench_report.hpp"
+#include <RTNeural.h>
+#include <chrono>
+#include <random>
+
+namespace
+{
+using clock_t = std::chrono::high_resolution_clock;
+using second_t = std::chrono::duration<double>;
+using T = float;
+
+constexpr int num_classes = 4;
+constexpr int in_size = num_classes;
+
+/**
+ * A synthetic classification task: each frame contains noisy evidence for
+ * the current class, and the class changes every 20-200 frames. A single
+ * frame is often ambiguous, so a model that integrates evidence over time
+ * does better than a model that only sees the current frame.
+ */
+struct Dataset
+{
+    std::vector<std::vector<T>> frames;
+    std::vector<int> labels;
+};
+
+Dataset make_dataset(int num_frames, T noise_level)
+{
+    std::default_random_engine generator;
+    std::uniform_int_distribution<int> class_dist(0, num_classes - 1);
+    std::uniform_int_distribution<int> length_dist(20, 200);
+    std::normal_distribution<T> noise((T)0, noise_level);
+
+    Dataset data;
+    while((int)data.frames.size() < num_frames)
+    {
+        const auto label = class_dist(generator);
+        const auto length = std::min(length_dist(generator), num_frames - (int)data.frames.size());
+        for(int n = 0; n < length; ++n)
+        {
+            std::vector<T> frame((size_t)in_size);
+            for(int k = 0; k < in_size; ++k)
+                frame[(size_t)k] = (k == label ? (T)1 : (T)0) + noise(generator);
+
+            data.frames.push_back(std::move(frame));
+            data.labels.push_back(label);
+        }
+    }
+
+    return data;
+}
+
+/** Small model: Dense -> Softmax, classifying each frame on its own. */
+std::unique_ptr<RTNeural::Model<T>> make_small_model()
+{
+    constexpr T gain = (T)4;
+
+    auto model = std::make_unique<RTNeural::Model<T>>(in_size);
+    auto* dense = new RTNeural::Dense<T>(in_size, num_classes);
+    std::vector<std::vector<T>> weights((size_t)num_classes, std::vector<T>((size_t)in_size, (T)0));
+    for(int k = 0; k < num_classes; ++k)
+        weights[(size_t)k][(size_t)k] = gain;
+    dense->setWeights(weights);
+    std::vector<T> bias((size_t)num_classes, (T)0);
+    dense->setBias(bias.data());
+
+    model->addLayer(dense);
+    model->addLayer(new RTNeural::SoftmaxActivation<T>(num_classes));
+    return model;
+}
+
+/**
+ * Large model: LSTM -> Dense -> Softmax. The first `num_classes` LSTM units are
+ * set up as leaky integrators of the evidence for each class, and the remaining
+ * units have random weights, standing in for the rest of a larger network.
+ */
+std::unique_ptr<RTNeural::Model<T>> make_large_model(int hidden_size)
+{
+    constexpr T gate_bias = (T)2;
+    constexpr T gain = (T)6;
+
+    std::default_random_engine generator;
+    std::uniform_real_distribution<T> distribution((T)-0.1, (T)0.1);
+
+    // keras gate order: i, f, c, o
+    std::vector<std::vector<T>> kernel((size_t)in_size, std::vector<T>(4 * (size_t)hidden_size, (T)0));
+    std::vector<std::vector<T>> recurrent((size_t)hidden_size, std::vector<T>(4 * (size_t)hidden_size, (T)0));
+    std::vector<T> bias(4 * (size_t)hidden_size, (T)0);
+    for(int j = 0; j < 4 * hidden_size; ++j)
+    {
+        const auto unit = j % hidden_size;
+        if(unit < num_classes)
+            continue;
+
+        for(auto& w : kernel)
+            w[(size_t)j] = distribution(generator);
+        for(auto& u : recurrent)
+            u[(size_t)j] = distribution(generator);
+        bias[(size_t)j] = distribution(generator);
+    }
+
+    for(int k = 0; k < num_classes; ++k)
+    {
+        bias[(size_t)k] = gate_bias; // input gate
+        bias[(size_t)(hidden_size + k)] = gate_bias; // forget gate
+        bias[(size_t)(3 * hidden_size + k)] = gate_bias; // output gate
+        kernel[(size_t)k][(size_t)(2 * hidden_size + k)] = (T)1; // candidate
+    }
+
+    auto* lstm = new RTNeural::LSTMLayer<T>(in_size, hidden_size);
+    lstm->setWVals(kernel);
+    lstm->setUVals(recurrent);
+    lstm->setBVals(bias);
+
+    auto* dense = new RTNeural::Dense<T>(hidden_size, num_classes);
+    std::vector<std::vector<T>> weights((size_t)num_classes, std::vector<T>((size_t)hidden_size, (T)0));
+    for(int k = 0; k < num_classes; ++k)
+        weights[(size_t)k][(size_t)k] = gain;
+    dense->setWeights(weights);
+    std::vector<T> denseBias((size_t)num_classes, (T)0);
+    dense->setBias(denseBias.data());
+
+    auto model = std::make_unique<RTNeural::Model<T>>(in_size);
+    model->addLayer(lstm);
+    model->addLayer(dense);
+    model->addLayer(new RTNeural::SoftmaxActivation<T>(num_classes));
+    return model;
+}
+
+int argmax(const T* outs)
+{
+    return (int)(std::max_element(outs, outs + num_classes) - outs);
+}
+
+/** Runs a single model over the dataset, and measures the accuracy and time. */
+bench_report::Result run_model(RTNeural::Model<T>& model, const std::string& impl, const Dataset& data)
+{
+    size_t correct = 0;
+    model.reset();
+
+    auto start = clock_t::now();
+    for(size_t n = 0; n < data.frames.size(); ++n)
+    {
+        model.forward(data.frames[n].data());
+        correct += argmax(model.getOutputs()) == data.labels[n];
+    }
+    const auto duration = std::chrono::duration_cast<second_t>(clock_t::now() - start).count();
+
+    bench_report::Result result { "cascade", impl, "float", data.frames.size(), duration };
+    result.extra["accuracy"] = (double)correct / (double)data.frames.size();
+    result.extra["escalation_rate"] = impl == "large" ? 1.0 : 0.0;
+    return result;
+}
+
+/** Runs the cascade over the dataset, and measures the accuracy, escalation rate and time. */
+template <typename CascadeType>
+bench_report::Result run_cascade(CascadeType& cascade, const Dataset& data)
+{
+    size_t correct = 0;
+    cascade.reset();
+
+    auto start = clock_t::now();
+    for(size_t n = 0; n < data.frames.size(); ++n)
+        correct += argmax(cascade.forward(data.frames[n].data())) == data.labels[n];
+    const auto duration = std::chrono::duration_cast<second_t>(clock_t::now() - start).count();
+
+    std::ostringstream impl;
+    impl << "cascade@" << cascade.getThreshold() << "/h" << cascade.history_length;
+
+    bench_report::Result result { "cascade", impl.str(), "float", data.frames.size(), duration };
+    result.extra["accuracy"] = (double)correct / (double)data.frames.size();
+    result.extra["escalation_rate"] = cascade.getEscalationRate();
+    result.extra["large_steps/frame"] = (double)cascade.getNumLargeModelSteps() / (double)data.frames.size();
+    return result;
+}
+
+void help()
+{
+    std::cout << "RTNeural cascade benchmarks:" << std::endl;
+    std::cout << "Usage: rtneural_cascade_bench [--frames <n>] [--hidden <n>] [--history <n>] [--json <file>]" << std::endl;
+    std::cout << "    Runs a synthetic classification task with a small (Dense) model, a large (LSTM) model," << std::endl;
+    std::cout << "    and a cascade of the two at several confidence thresholds, and reports the accuracy," << std::endl;
+    std::cout << "    escalation rate, and processing time for each. The cascade is run with history lengths" << std::endl;
+    std::cout << "    of 0, 8, and 32 steps for catching up the state of the large model, or with --history <n>." << std::endl;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    int num_frames = 48000;
+    int hidden_size = 64;
+    std::vector<int> history_lengths { 0, 8, 32 };
+    std::string json_file;
+
+    for(int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if(arg == "--frames" && i + 1 < argc)
+            num_frames = std::max(1, std::atoi(argv[++i]));
+        else if(arg == "--hidden" && i + 1 < argc)
+            hidden_size = std::max(num_classes, std::atoi(argv[++i]));
+        else if(arg == "--history" && i + 1 < argc)
+            history_lengths = { std::max(0, std::atoi(argv[++i])) };
+        else if(arg == "--json" && i + 1 < argc)
+            json_file = argv[++i];
+        else
+        {
+            help();
+            return 1;
+        }
+    }
+
+    const auto data = make_dataset(num_frames, (T)0.6);
+    auto smallModel = make_small_model();
+    auto largeModel = make_large_model(hidden_size);
+
+    std::vector<bench_report::Result> results;
+    results.push_back(run_model(*smallModel, "small", data));
+    results.push_back(run_model(*largeModel, "large", data));
+
+    for(auto history_length : history_lengths)
+    {
+        RTNeural::CascadeModel<T, RTNeural::Model<T>, RTNeural::Model<T>> cascade { *smallModel, *largeModel, in_size, num_classes, (T)0, history_length };
+        for(auto threshold : { 0.5f, 0.7f, 0.8f, 0.9f, 0.95f, 0.99f })
+        {
+            cascade.setThreshold(threshold);
+            results.push_back(run_cascade(cascade, data));
+        }
+    }
+
+    bench_report::print_table(results);
+
+    if(!json_file.empty() && !bench_report::write_json(json_file, "cascade", results))
+        return 1;
+
+    return 0;
+}
@@ -0,0 +1,142 @@
+#include "bench_report.hpp"
+#include "perf_counters.hpp"
+#include <RTNeural.h>
+#include <chrono>
+#include <random>
+
+namespace
+{
+using clock_t = std::chrono::high_resolution_clock;
+using second_t = std::chrono::duration<double>;
+
+nlohmann::json random_matrix(std::default_random_engine& generator, int rows, int cols)
+{
+    std::uniform_real_distribution<double> distribution(-0.5, 0.5);
+    auto matrix = nlohmann::json::array();
+    for(int i = 0; i < rows; ++i)
+    {
+        auto row = nlohmann::json::array();
+        for(int j = 0; j < cols; ++j)
+            row.push_back(distribution(generator));
+        matrix.push_back(row);
+    }
+    return matrix;
+}
+
+/** Creates a model json with a single LSTM layer, which is a CIFG LSTM (with 3 gates) for `cifg`. */
+nlohmann::json lstm_model_json(int in_size, int hidden_size, bool cifg)
+{
+    std::default_random_engine generator;
+    const auto num_gates = cifg ? 3 : 4;
+
+    nlohmann::json lstm;
+    lstm["type"] = "lstm";
+    lstm["activation"] = "";
+    lstm["shape"] = { nullptr, nullptr, hidden_size };
+    lstm["cifg"] = cifg;
+    lstm["weights"] = { random_matrix(generator, in_size, num_gates * hidden_size),
+        random_matrix(generator, hidden_size, num_gates * hidden_size),
+        random_matrix(generator, 1, num_gates * hidden_size)[0] };
+
+    nlohmann::json model;
+    model["in_shape"] = { nullptr, nullptr, in_size };
+    model["layers"] = { lstm };
+    return model;
+}
+
+template <typename T>
+std::vector<T> generate_signal(size_t n_samples, int in_size)
+{
+    std::default_random_engine generator;
+    std::uniform_real_distribution<T> distribution((T)-1, (T)1);
+
+    std::vector<T> signal(n_samples * (size_t)in_size);
+    for(auto& x : signal)
+        x = distribution(generator);
+
+    return signal;
+}
+
+PerfCounters& get_counters()
+{
+    static PerfCounters counters;
+    return counters;
+}
+
+template <typename ModelType, typename T>
+double time_model(const nlohmann::json& modelJson, const std::vector<T>& signal)
+{
+    auto model = std::make_unique<ModelType>();
+    model->parseJson(modelJson);
+    model->reset();
+
+    get_counters().start();
+    auto start = clock_t::now();
+    for(size_t i = 0; i < signal.size(); i += (size_t)ModelType::input_size)
+        model->forward(&signal[i]);
+    const auto duration = std::chrono::duration_cast<second_t>(clock_t::now() - start).count();
+    get_counters().stop();
+    return duration;
+}
+
+template <typename T, int in_size, int hidden_size>
+void bench_cifg(double length_seconds, std::vector<bench_report::Result>& results)
+{
+    using namespace RTNeural;
+    using LSTMModel = ModelT<T, in_size, hidden_size, LSTMLayerT<T, in_size, hidden_size>>;
+    using CIFGModel = ModelT<T, in_size, hidden_size, CIFGLSTMLayerT<T, in_size, hidden_size>>;
+
+    const auto n_samples = static_cast<size_t>(bench_report::audio_sample_rate * length_seconds);
+    const auto signal = generate_signal<T>(n_samples, in_size);
+    const auto precision = std::is_same<T, float>::value ? "float" : "double";
+    const auto name = "lstm" + std::to_string(in_size) + "x" + std::to_string(hidden_size);
+
+    const auto lstmDuration = time_model<LSTMModel>(lstm_model_json(in_size, hidden_size, false), signal);
+    results.push_back({ name, "lstm", precision, n_samples, lstmDuration, get_counters().readPerSample(n_samples) });
+
+    const auto cifgDuration = time_model<CIFGModel>(lstm_model_json(in_size, hidden_size, true), signal);
+    results.push_back({ name, "cifg", precision, n_samples, cifgDuration, get_counters().readPerSample(n_samples) });
+}
+
+template <typename T>
+void bench_all(double length_seconds, std::vector<bench_report::Result>& results)
+{
+    bench_cifg<T, 4, 4>(length_seconds, results);
+    bench_cifg<T, 16, 16>(length_seconds, results);
+    bench_cifg<T, 1, 24>(length_seconds, results);
+    bench_cifg<T, 1, 64>(length_seconds, results);
+}
+
+void help()
+{
+    std::cout << "RTNeural CIFG LSTM benchmarks:" << std::endl;
+    std::cout << "Usage: rtneural_cifg_lstm_bench <length> [--json <file>]" << std::endl;
+    std::cout << "    Compares LSTMLayerT against CIFGLSTMLayerT (with a coupled input and forget gate)." << std::endl;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if(argc != 2 && argc != 4)
+    {
+        help();
+        return 1;
+    }
+
+    const auto length_seconds = std::atof(argv[1]);
+    const std::string json_file = argc == 4 ? argv[3] : "";
+
+    if(!get_counters().available())
+        std::cout << "Hardware performance counters are not available!" << std::endl;
+
+    std::vector<bench_report::Result> results;
+    bench_all<float>(length_seconds, results);
+    bench_all<double>(length_seconds, results);
+
+    bench_report::print_table(results);
+
+    if(!json_file.empty() && !bench_report::write_json(json_file, "cifg_lstm", results))
+        return 1;
+
+    return 0;
+}
@@ -0,0 +1,144 @@
+#include "bench_report.hpp"
+#include <RTNeural.h>
+#include <chrono>
+#include <numeric>
+#include <random>
+
+namespace
+{
+using clock_t = std::chrono::high_resolution_clock;
+using second_t = std::chrono::duration<double>;
+
+/** The row-major DenseT kernel, for comparison. */
+template <typename T, int in_size, int out_sizet>
+struct RowMajorDense
+{
+    static constexpr auto out_size = out_sizet;
+
+    void setWeights(const std::vector<std::vector<T>>& newWeights)
+    {
+        for(int i = 0; i < out_size; ++i)
+            std::copy(newWeights[(size_t)i].begin(), newWeights[(size_t)i].end(), weights + i * in_size);
+    }
+
+    void setBias(const T* b) { std::copy(b, b + out_size, bias); }
+
+    inline void forward(const T (&ins)[in_size]) noexcept
+    {
+        for(int i = 0; i < out_size; ++i)
+            outs[i] = std::inner_product(ins, ins + in_size, &weights[i * in_size], (T)0) + bias[i];
+    }
+
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+    T bias alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+    T weights alignas(RTNEURAL_DEFAULT_ALIGNMENT)[in_size * out_size];
+};
+
+template <typename T>
+std::vector<std::vector<T>> random_matrix(std::default_random_engine& generator, int rows, int cols)
+{
+    std::uniform_real_distribution<T> distribution((T)-1, (T)1);
+    std::vector<std::vector<T>> matrix((size_t)rows, std::vector<T>((size_t)cols));
+    for(auto& row : matrix)
+        for(auto& x : row)
+            x = distribution(generator);
+    return matrix;
+}
+
+template <typename LayerType, typename T, int in_size>
+double time_layer(LayerType& layer, const std::vector<T>& signal)
+{
+    T ins alignas(RTNEURAL_DEFAULT_ALIGNMENT)[in_size];
+    T sum = (T)0;
+
+    auto start = clock_t::now();
+    T feedback = (T)0;
+    for(size_t n = 0; n + in_size <= signal.size(); ++n)
+    {
+        // feed back the outputs, so that none of them can be skipped
+        for(int k = 0; k < in_size; ++k)
+            ins[k] = signal[n + (size_t)k] + feedback;
+        layer.forward(ins);
+        feedback = std::accumulate(layer.outs, layer.outs + LayerType::out_size, (T)0) * (T)1.0e-6;
+        sum += feedback;
+    }
+    auto duration = std::chrono::duration_cast<second_t>(clock_t::now() - start).count();
+
+    if(sum == (T)12345)
+        std::cout << sum << std::endl;
+
+    return duration;
+}
+
+template <typename T, int in_size, int out_size>
+void bench_shape(const std::vector<T>& signal, std::vector<bench_report::Result>& results)
+{
+    const auto precision = std::is_same<T, float>::value ? "float" : "double";
+    const auto name = "dense " + std::to_string(in_size) + "x" + std::to_string(out_size);
+
+    std::default_random_engine generator;
+    const auto weights = random_matrix<T>(generator, out_size, in_size);
+    auto bias = random_matrix<T>(generator, 1, out_size)[0];
+
+    auto rowMajor = std::make_unique<RowMajorDense<T, in_size, out_size>>();
+    rowMajor->setWeights(weights);
+    rowMajor->setBias(bias.data());
+    results.push_back({ name, "row-major", precision, signal.size(), time_layer<RowMajorDense<T, in_size, out_size>, T, in_size>(*rowMajor, signal) });
+
+    using DenseType = RTNeural::DenseT<T, in_size, out_size>;
+    auto dense = std::make_unique<DenseType>();
+    dense->setWeights(weights);
+    dense->setBias(bias.data());
+    const auto impl = std::string { "DenseT (" } + (DenseType::column_major ? "column-major" : "row-major") + ")";
+    results.push_back({ name, impl, precision, signal.size(), time_layer<DenseType, T, in_size>(*dense, signal) });
+}
+
+template <typename T>
+void bench_all(double length_seconds, std::vector<bench_report::Result>& results)
+{
+    std::default_random_engine generator;
+    std::uniform_real_distribution<T> distribution((T)-1, (T)1);
+    std::vector<T> signal(static_cast<size_t>(bench_report::audio_sample_rate * length_seconds));
+    for(auto& x : signal)
+        x = distribution(generator);
+
+    bench_shape<T, 2, 32>(signal, results);
+    bench_shape<T, 4, 64>(signal, results);
+    bench_shape<T, 8, 128>(signal, results);
+    bench_shape<T, 16, 32>(signal, results);
+    bench_shape<T, 32, 32>(signal, results);
+    bench_shape<T, 8, 16>(signal, results);
+    bench_shape<T, 32, 1>(signal, results);
+}
+
+void help()
+{
+    std::cout << "RTNeural Dense layout benchmarks:" << std::endl;
+    std::cout << "Usage: rtneural_dense_layout_bench <length> [--json <file>]" << std::endl;
+    std::cout << "    Compares the row-major Dense kernel against the layout" << std::endl;
+    std::cout << "    that DenseT chooses for several layer shapes." << std::endl;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if(argc != 2 && argc != 4)
+    {
+        help();
+        return 1;
+    }
+
+    const auto length_seconds = std::atof(argv[1]);
+    const std::string json_file = argc == 4 ? argv[3] : "";
+
+    std::vector<bench_report::Result> results;
+    bench_all<float>(length_seconds, results);
+    bench_all<double>(length_seconds, results);
+
+    bench_report::print_table(results);
+
+    if(!json_file.empty() && !bench_report::write_json(json_file, "dense_layout", results))
+        return 1;
+
+    return 0;
+}
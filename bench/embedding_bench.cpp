@@ -0,0 +1,106 @@
+#include "bench_report.hpp"
+#include <RTNeural.h>
+#include <chrono>
+#include <random>
+
+namespace
+{
+using clock_t = std::chrono::high_resolution_clock;
+using second_t = std::chrono::duration<double>;
+
+template <typename T>
+std::vector<std::vector<T>> random_matrix(int rows, int cols)
+{
+    std::default_random_engine generator;
+    std::uniform_real_distribution<T> distribution((T)-0.5, (T)0.5);
+    std::vector<std::vector<T>> matrix((size_t)rows, std::vector<T>((size_t)cols));
+    for(auto& row : matrix)
+        for(auto& x : row)
+            x = distribution(generator);
+    return matrix;
+}
+
+/** Times a layer with one audio input and a one-hot category, which changes every `block_size` samples. */
+template <typename LayerType, typename T>
+double time_layer(LayerType& layer, size_t n_samples, int num_categories)
+{
+    constexpr size_t block_size = 512;
+    T ins alignas(RTNEURAL_DEFAULT_ALIGNMENT)[LayerType::in_size] {};
+
+    layer.reset();
+    auto start = clock_t::now();
+    for(size_t n = 0; n < n_samples; ++n)
+    {
+        if(n % block_size == 0)
+        {
+            std::fill(ins + 1, ins + LayerType::in_size, (T)0);
+            ins[1 + (int)((n / block_size) % (size_t)num_categories)] = (T)1;
+        }
+
+        ins[0] = (T)(n % 100) * (T)0.01;
+        layer.forward(ins);
+    }
+    return std::chrono::duration_cast<second_t>(clock_t::now() - start).count();
+}
+
+template <typename T, int num_categories, int hidden_size>
+void bench_size(double length_seconds, std::vector<bench_report::Result>& results)
+{
+    constexpr int in_size = 1 + num_categories;
+    const auto precision = std::is_same<T, float>::value ? "float" : "double";
+    const auto n_samples = static_cast<size_t>(bench_report::audio_sample_rate * length_seconds);
+    const auto name = "dense" + std::to_string(in_size) + "x" + std::to_string(hidden_size) + " (" + std::to_string(num_categories) + " one-hot)";
+
+    const auto weights = random_matrix<T>(hidden_size, in_size);
+    auto bias = random_matrix<T>(1, hidden_size)[0];
+
+    RTNeural::DenseT<T, in_size, hidden_size> dense;
+    dense.setWeights(weights);
+    dense.setBias(bias.data());
+    results.push_back({ name, "DenseT", precision, n_samples, time_layer<decltype(dense), T>(dense, n_samples, num_categories) });
+
+    RTNeural::OneHotDenseT<T, in_size, hidden_size, 1, num_categories> oneHotDense;
+    oneHotDense.setWeights(weights);
+    oneHotDense.setBias(bias.data());
+    results.push_back({ name, "OneHotDenseT", precision, n_samples, time_layer<decltype(oneHotDense), T>(oneHotDense, n_samples, num_categories) });
+}
+
+template <typename T>
+void bench_all(double length_seconds, std::vector<bench_report::Result>& results)
+{
+    bench_size<T, 4, 16>(length_seconds, results);
+    bench_size<T, 16, 16>(length_seconds, results);
+    bench_size<T, 16, 64>(length_seconds, results);
+    bench_size<T, 64, 64>(length_seconds, results);
+}
+
+void help()
+{
+    std::cout << "RTNeural embedding benchmarks:" << std::endl;
+    std::cout << "Usage: rtneural_embedding_bench <length> [--json <file>]" << std::endl;
+    std::cout << "    Compares a dense layer with a one-hot category input against OneHotDenseT." << std::endl;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if(argc != 2 && argc != 4)
+    {
+        help();
+        return 1;
+    }
+
+    const auto length_seconds = std::atof(argv[1]);
+    const std::string json_file = argc == 4 ? argv[3] : "";
+
+    std::vector<bench_report::Result> results;
+    bench_all<float>(length_seconds, results);
+    bench_all<double>(length_seconds, results);
+
+    bench_report::print_table(results);
+
+    if(!json_file.empty() && !bench_report::write_json(json_file, "embedding", results))
+        return 1;
+
+    return 0;
+}
@@ -0,0 +1,206 @@
+#include "bench_report.hpp"
+#include <RTNeural.h>
+#include <chrono>
+#include <random>
+
+namespace
+{
+using clock_t = std::chrono::high_resolution_clock;
+using second_t = std::chrono::duration<double>;
+
+constexpr int hidden_size = 32;
+constexpr int num_controls = 3;
+constexpr int conditioning_size = 16;
+constexpr int block_size = 256;
+
+/** The controls are concatenated to the audio input. */
+template <typename T>
+using ConcatModelType = RTNeural::ModelT<T, 1 + num_controls, 1,
+    RTNeural::LSTMLayerT<T, 1 + num_controls, hidden_size>,
+    RTNeural::DenseT<T, hidden_size, 1>>;
+
+template <typename T>
+using ConditioningType = RTNeural::ModelT<T, num_controls, 2 * hidden_size,
+    RTNeural::DenseT<T, num_controls, conditioning_size>,
+    RTNeural::TanhActivationT<T, conditioning_size>,
+    RTNeural::DenseT<T, conditioning_size, 2 * hidden_size>>;
+
+/** The controls modulate the LSTM outputs with a FiLM layer. */
+template <typename T>
+using FiLMModelType = RTNeural::ModelT<T, 1, 1,
+    RTNeural::LSTMLayerT<T, 1, hidden_size>,
+    RTNeural::FiLMT<T, hidden_size, ConditioningType<T>>,
+    RTNeural::DenseT<T, hidden_size, 1>>;
+
+nlohmann::json random_matrix(std::default_random_engine& generator, int rows, int cols)
+{
+    std::uniform_real_distribution<double> distribution(-0.5, 0.5);
+    auto matrix = nlohmann::json::array();
+    for(int i = 0; i < rows; ++i)
+    {
+        auto row = nlohmann::json::array();
+        for(int j = 0; j < cols; ++j)
+            row.push_back(distribution(generator));
+        matrix.push_back(row);
+    }
+    return matrix;
+}
+
+nlohmann::json dense_json(std::default_random_engine& generator, int in_size, int out_size, const std::string& activation)
+{
+    nlohmann::json dense;
+    dense["type"] = "dense";
+    dense["activation"] = activation;
+    dense["shape"] = { nullptr, nullptr, out_size };
+    dense["weights"] = { random_matrix(generator, in_size, out_size), random_matrix(generator, 1, out_size)[0] };
+    return dense;
+}
+
+nlohmann::json lstm_json(std::default_random_engine& generator, int in_size, int out_size)
+{
+    nlohmann::json lstm;
+    lstm["type"] = "lstm";
+    lstm["activation"] = "";
+    lstm["shape"] = { nullptr, nullptr, out_size };
+    lstm["weights"] = { random_matrix(generator, in_size, 4 * out_size),
+        random_matrix(generator, out_size, 4 * out_size),
+        random_matrix(generator, 1, 4 * out_size)[0] };
+    return lstm;
+}
+
+nlohmann::json concat_model_json()
+{
+    std::default_random_engine generator;
+
+    nlohmann::json model;
+    model["in_shape"] = { nullptr, nullptr, 1 + num_controls };
+    model["layers"] = { lstm_json(generator, 1 + num_controls, hidden_size), dense_json(generator, hidden_size, 1, "") };
+    return model;
+}
+
+nlohmann::json film_model_json()
+{
+    std::default_random_engine generator;
+
+    nlohmann::json film;
+    film["type"] = "film";
+    film["activation"] = "";
+    film["shape"] = { nullptr, nullptr, hidden_size };
+    film["num_controls"] = num_controls;
+    film["weights"] = nlohmann::json::array();
+    film["layers"] = { dense_json(generator, num_controls, conditioning_size, "tanh"),
+        dense_json(generator, conditioning_size, 2 * hidden_size, "") };
+
+    nlohmann::json model;
+    model["in_shape"] = { nullptr, nullptr, 1 };
+    model["layers"] = { lstm_json(generator, 1, hidden_size), film, dense_json(generator, hidden_size, 1, "") };
+    return model;
+}
+
+template <typename T>
+std::vector<T> generate_signal(size_t n_samples)
+{
+    std::default_random_engine generator;
+    std::uniform_real_distribution<T> distribution((T)-1, (T)1);
+
+    std::vector<T> signal(n_samples);
+    for(auto& x : signal)
+        x = distribution(generator);
+
+    return signal;
+}
+
+/** Returns the control values for a block, which change every `change_interval` blocks. */
+template <typename T>
+void get_controls(size_t block, size_t change_interval, T* controls)
+{
+    const auto step = (T)(block / change_interval);
+    for(int c = 0; c < num_controls; ++c)
+        controls[c] = std::sin(step * (T)0.1 + (T)c);
+}
+
+template <typename T>
+double time_concat(const std::vector<T>& signal, size_t change_interval)
+{
+    auto model = std::make_unique<ConcatModelType<T>>();
+    model->parseJson(concat_model_json());
+    model->reset();
+
+    T ins[1 + num_controls];
+    auto start = clock_t::now();
+    for(size_t n = 0; n < signal.size(); ++n)
+    {
+        if(n % block_size == 0)
+            get_controls(n / block_size, change_interval, ins + 1);
+
+        ins[0] = signal[n];
+        model->forward(ins);
+    }
+    return std::chrono::duration_cast<second_t>(clock_t::now() - start).count();
+}
+
+template <typename T>
+double time_film(const std::vector<T>& signal, size_t change_interval)
+{
+    auto model = std::make_unique<FiLMModelType<T>>();
+    model->parseJson(film_model_json());
+    model->reset();
+
+    T controls[num_controls];
+    auto start = clock_t::now();
+    for(size_t n = 0; n < signal.size(); ++n)
+    {
+        if(n % block_size == 0)
+        {
+            get_controls(n / block_size, change_interval, controls);
+            model->template get<1>().setConditioning(controls);
+        }
+
+        model->forward(&signal[n]);
+    }
+    return std::chrono::duration_cast<second_t>(clock_t::now() - start).count();
+}
+
+template <typename T>
+void bench_all(double length_seconds, std::vector<bench_report::Result>& results)
+{
+    const auto precision = std::is_same<T, float>::value ? "float" : "double";
+    const auto name = "lstm" + std::to_string(hidden_size) + " " + std::to_string(num_controls) + " controls";
+    const auto signal = generate_signal<T>(static_cast<size_t>(bench_report::audio_sample_rate * length_seconds));
+
+    results.push_back({ name, "concat", precision, signal.size(), time_concat(signal, 1) });
+    results.push_back({ name, "FiLM (controls change every block)", precision, signal.size(), time_film(signal, 1) });
+    results.push_back({ name, "FiLM (controls change every 16 blocks)", precision, signal.size(), time_film(signal, 16) });
+}
+
+void help()
+{
+    std::cout << "RTNeural FiLM benchmarks:" << std::endl;
+    std::cout << "Usage: rtneural_film_bench <length> [--json <file>]" << std::endl;
+    std::cout << "    Compares concatenating control inputs to the audio input" << std::endl;
+    std::cout << "    against conditioning the model with a FiLM layer." << std::endl;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if(argc != 2 && argc != 4)
+    {
+        help();
+        return 1;
+    }
+
+    const auto length_seconds = std::atof(argv[1]);
+    const std::string json_file = argc == 4 ? argv[3] : "";
+
+    std::vector<bench_report::Result> results;
+    bench_all<float>(length_seconds, results);
+    bench_all<double>(length_seconds, results);
+
+    bench_report::print_table(results);
+
+    if(!json_file.empty() && !bench_report::write_json(json_file, "film", results))
+        return 1;
+
+    return 0;
+}
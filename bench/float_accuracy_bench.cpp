@@ -0,0 +1,135 @@
+#include "bench_report.hpp"
+#include <RTNeural.h>
+#include <chrono>
+#include <random>
+
+namespace
+{
+using clock_t = std::chrono::high_resolution_clock;
+using second_t = std::chrono::duration<double>;
+
+template <typename T>
+std::vector<T> generate_signal(size_t n_samples)
+{
+    std::default_random_engine generator;
+    std::uniform_real_distribution<T> distribution((T)-1, (T)1);
+
+    std::vector<T> signal(n_samples);
+    for(auto& x : signal)
+        x = distribution(generator);
+
+    return signal;
+}
+
+/** Times one dot product (of a vector of the given size) per sample. */
+template <typename T, typename DotProduct>
+double time_dot_product(const std::vector<T>& signal, int size, DotProduct&& dot_product)
+{
+    const auto weights = generate_signal<T>((size_t)size);
+    std::vector<T> ins((size_t)size, (T)0);
+
+    T sum = (T)0;
+    auto start = clock_t::now();
+    for(const auto& x : signal)
+    {
+        std::rotate(ins.begin(), ins.begin() + 1, ins.end());
+        ins.back() = x;
+        sum += dot_product(weights.data(), ins.data(), size);
+    }
+    const auto duration = std::chrono::duration_cast<second_t>(clock_t::now() - start).count();
+
+    volatile T result = sum; // keep the sums from being optimized away
+    (void)result;
+    return duration;
+}
+
+template <typename T, int hidden_size>
+double time_lstm(const std::vector<T>& signal)
+{
+    std::default_random_engine generator;
+    std::uniform_real_distribution<T> distribution((T)-0.4, (T)0.4);
+    auto random_matrix = [&](int rows, int cols)
+    {
+        std::vector<std::vector<T>> matrix((size_t)rows, std::vector<T>((size_t)cols));
+        for(auto& row : matrix)
+            for(auto& x : row)
+                x = distribution(generator);
+        return matrix;
+    };
+
+    RTNeural::ModelT<T, 1, 1, RTNeural::LSTMLayerT<T, 1, hidden_size>, RTNeural::DenseT<T, hidden_size, 1>> model;
+    auto& lstm = model.template get<0>();
+    lstm.setWVals(random_matrix(1, 4 * hidden_size));
+    lstm.setUVals(random_matrix(hidden_size, 4 * hidden_size));
+    lstm.setBVals(random_matrix(1, 4 * hidden_size)[0]);
+    model.template get<1>().setWeights(random_matrix(1, hidden_size));
+    model.reset();
+
+    auto start = clock_t::now();
+    for(const auto& x : signal)
+        model.forward(&x);
+    return std::chrono::duration_cast<second_t>(clock_t::now() - start).count();
+}
+
+template <typename T>
+std::string config_name()
+{
+    std::string name = "ModelT";
+    if(RTNeural::use_compensated_sums<T>())
+        name += ", compensated sums";
+    if(!std::is_same<RTNeural::lstm_cell_type<T>, T>::value)
+        name += ", double cell state";
+    return name;
+}
+
+template <typename T>
+void bench_all(double length_seconds, std::vector<bench_report::Result>& results)
+{
+    const auto precision = std::is_same<T, float>::value ? "float" : "double";
+    const auto signal = generate_signal<T>(static_cast<size_t>(bench_report::audio_sample_rate * length_seconds));
+
+    for(int size : { 8, 16, 32, 64 })
+    {
+        const auto name = "dot product " + std::to_string(size);
+        results.push_back({ name, "inner_product", precision, signal.size(), time_dot_product(signal, size, [](const T* a, const T* b, int n)
+                                                                                  { return std::inner_product(a, a + n, b, (T)0); }) });
+        results.push_back({ name, "compensated", precision, signal.size(), time_dot_product(signal, size, [](const T* a, const T* b, int n)
+                                                                               { return RTNeural::compensated_dot_product(a, b, n); }) });
+    }
+
+    results.push_back({ "lstm16 -> dense", config_name<T>(), precision, signal.size(), time_lstm<T, 16>(signal) });
+    results.push_back({ "lstm32 -> dense", config_name<T>(), precision, signal.size(), time_lstm<T, 32>(signal) });
+}
+
+void help()
+{
+    std::cout << "RTNeural float accuracy benchmarks:" << std::endl;
+    std::cout << "Usage: rtneural_float_accuracy_bench <length> [--json <file>]" << std::endl;
+    std::cout << "    Compares plain and compensated dot products, and times LSTM models" << std::endl;
+    std::cout << "    with the summation and cell state options that the benchmark was built with" << std::endl;
+    std::cout << "    (RTNEURAL_COMPENSATED_SUMS, RTNEURAL_LSTM_DOUBLE_CELL_STATE)." << std::endl;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if(argc != 2 && argc != 4)
+    {
+        help();
+        return 1;
+    }
+
+    const auto length_seconds = std::atof(argv[1]);
+    const std::string json_file = argc == 4 ? argv[3] : "";
+
+    std::vector<bench_report::Result> results;
+    bench_all<float>(length_seconds, results);
+    bench_all<double>(length_seconds, results);
+
+    bench_report::print_table(results);
+
+    if(!json_file.empty() && !bench_report::write_json(json_file, "float_accuracy", results))
+        return 1;
+
+    return 0;
+}
@@ -0,0 +1,191 @@
+#include "bench_report.hpp"
+#include <RTNeural.h>
+#include <chrono>
+#include <random>
+
+namespace
+{
+using clock_t = std::chrono::high_resolution_clock;
+using second_t = std::chrono::duration<double>;
+
+constexpr int block_size = 256;
+
+nlohmann::json random_matrix(std::default_random_engine& generator, int rows, int cols)
+{
+    std::uniform_real_distribution<double> distribution(-0.5, 0.5);
+    auto matrix = nlohmann::json::array();
+    for(int i = 0; i < rows; ++i)
+    {
+        auto row = nlohmann::json::array();
+        for(int j = 0; j < cols; ++j)
+            row.push_back(distribution(generator));
+        matrix.push_back(row);
+    }
+    return matrix;
+}
+
+/** LSTM(1 -> hidden_size) -> Dense(hidden_size -> 1) */
+nlohmann::json branch_layers(std::default_random_engine& generator, int hidden_size)
+{
+    nlohmann::json lstm;
+    lstm["type"] = "lstm";
+    lstm["activation"] = "";
+    lstm["shape"] = { nullptr, nullptr, hidden_size };
+    lstm["weights"] = { random_matrix(generator, 1, 4 * hidden_size),
+        random_matrix(generator, hidden_size, 4 * hidden_size),
+        random_matrix(generator, 1, 4 * hidden_size)[0] };
+
+    nlohmann::json dense;
+    dense["type"] = "dense";
+    dense["activation"] = "";
+    dense["shape"] = { nullptr, nullptr, 1 };
+    dense["weights"] = { random_matrix(generator, hidden_size, 1), random_matrix(generator, 1, 1)[0] };
+
+    return { lstm, dense };
+}
+
+/** num_branches parallel LSTM branches from the input, summed. */
+nlohmann::json graph_json(int num_branches, int hidden_size)
+{
+    std::default_random_engine generator;
+
+    nlohmann::json graph;
+    graph["in_shape"] = { nullptr, nullptr, 1 };
+    graph["nodes"] = nlohmann::json::array();
+
+    nlohmann::json sum;
+    sum["name"] = "sum";
+    sum["type"] = "add";
+    sum["inputs"] = nlohmann::json::array();
+
+    for(int b = 0; b < num_branches; ++b)
+    {
+        nlohmann::json branch;
+        branch["name"] = "branch" + std::to_string(b);
+        branch["inputs"] = nlohmann::json::array({ "input" });
+        branch["layers"] = branch_layers(generator, hidden_size);
+        graph["nodes"].push_back(branch);
+        sum["inputs"].push_back(branch["name"]);
+    }
+
+    graph["nodes"].push_back(sum);
+    return graph;
+}
+
+template <typename T>
+std::vector<T> generate_signal(size_t n_samples)
+{
+    std::default_random_engine generator;
+    std::uniform_real_distribution<T> distribution((T)-1, (T)1);
+
+    std::vector<T> signal(n_samples);
+    for(auto& x : signal)
+        x = distribution(generator);
+
+    return signal;
+}
+
+/** Runs each branch as a separate Model, and sums the outputs. */
+template <typename T>
+double time_separate_models(const nlohmann::json& graphJson, const std::vector<T>& signal)
+{
+    std::vector<std::unique_ptr<RTNeural::Model<T>>> branches;
+    for(const auto& node : graphJson.at("nodes"))
+    {
+        if(node.contains("layers"))
+        {
+            branches.push_back(RTNeural::json_parser::parseJson<T>(RTNeural::json_parser::getExpertJson(node, 1)));
+            branches.back()->reset();
+        }
+    }
+
+    auto start = clock_t::now();
+    for(const auto& x : signal)
+    {
+        T y = (T)0;
+        for(auto& branch : branches)
+            y += branch->forward(&x);
+    }
+    return std::chrono::duration_cast<second_t>(clock_t::now() - start).count();
+}
+
+template <typename T>
+double time_graph_forward(const nlohmann::json& graphJson, const std::vector<T>& signal)
+{
+    auto graph = RTNeural::json_parser::parseGraphJson<T>(graphJson);
+    graph->reset();
+
+    auto start = clock_t::now();
+    for(const auto& x : signal)
+        graph->forward(&x);
+    return std::chrono::duration_cast<second_t>(clock_t::now() - start).count();
+}
+
+template <typename T>
+double time_graph_block(const nlohmann::json& graphJson, const std::vector<T>& signal, int num_threads)
+{
+    auto graph = RTNeural::json_parser::parseGraphJson<T>(graphJson, block_size);
+    graph->setNumThreads(num_threads);
+    graph->reset();
+
+    std::vector<T> output(signal.size());
+    auto start = clock_t::now();
+    for(size_t n = 0; n < signal.size(); n += block_size)
+    {
+        const auto num_samples = (int)std::min(signal.size() - n, (size_t)block_size);
+        graph->processBlock(signal.data() + n, output.data() + n, num_samples);
+    }
+    return std::chrono::duration_cast<second_t>(clock_t::now() - start).count();
+}
+
+template <typename T>
+void bench_all(double length_seconds, std::vector<bench_report::Result>& results)
+{
+    const auto precision = std::is_same<T, float>::value ? "float" : "double";
+    const auto signal = generate_signal<T>(static_cast<size_t>(bench_report::audio_sample_rate * length_seconds));
+
+    const int configs[][2] = { { 2, 16 }, { 4, 32 }, { 4, 64 } };
+    for(const auto& config : configs)
+    {
+        const auto name = std::to_string(config[0]) + "x lstm" + std::to_string(config[1]) + " -> add";
+        const auto graphJson = graph_json(config[0], config[1]);
+
+        results.push_back({ name, "separate Models", precision, signal.size(), time_separate_models(graphJson, signal) });
+        results.push_back({ name, "GraphModel forward", precision, signal.size(), time_graph_forward(graphJson, signal) });
+        results.push_back({ name, "GraphModel block", precision, signal.size(), time_graph_block(graphJson, signal, 1) });
+        results.push_back({ name, "GraphModel block (" + std::to_string(config[0]) + " threads)", precision, signal.size(),
+            time_graph_block(graphJson, signal, config[0]) });
+    }
+}
+
+void help()
+{
+    std::cout << "RTNeural graph model benchmarks:" << std::endl;
+    std::cout << "Usage: rtneural_graph_model_bench <length> [--json <file>]" << std::endl;
+    std::cout << "    Compares separate Models, and a GraphModel processed per sample, per block," << std::endl;
+    std::cout << "    and per block with a worker thread for each branch." << std::endl;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if(argc != 2 && argc != 4)
+    {
+        help();
+        return 1;
+    }
+
+    const auto length_seconds = std::atof(argv[1]);
+    const std::string json_file = argc == 4 ? argv[3] : "";
+
+    std::vector<bench_report::Result> results;
+    bench_all<float>(length_seconds, results);
+    bench_all<double>(length_seconds, results);
+
+    bench_report::print_table(results);
+
+    if(!json_file.empty() && !bench_report::write_json(json_file, "graph_model", results))
+        return 1;
+
+    return 0;
+}
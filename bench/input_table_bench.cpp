@@ -0,0 +1,174 @@
+#include "bench_report.hpp"
+#include <RTNeural.h>
+#include <chrono>
+#include <random>
+
+namespace
+{
+using clock_t = std::chrono::high_resolution_clock;
+using second_t = std::chrono::duration<double>;
+
+constexpr int hidden_size = 16;
+constexpr int num_points = 2048;
+
+template <typename T>
+std::vector<T> generate_signal(size_t n_samples)
+{
+    std::default_random_engine generator;
+    std::uniform_real_distribution<T> distribution((T)-1, (T)1);
+
+    std::vector<T> signal(n_samples);
+    for(auto& x : signal)
+        x = distribution(generator);
+
+    return signal;
+}
+
+template <typename T>
+std::vector<std::vector<T>> random_matrix(std::default_random_engine& generator, int rows, int cols)
+{
+    std::uniform_real_distribution<T> distribution((T)-0.5, (T)0.5);
+    std::vector<std::vector<T>> matrix((size_t)rows, std::vector<T>((size_t)cols));
+    for(auto& row : matrix)
+        for(auto& x : row)
+            x = distribution(generator);
+    return matrix;
+}
+
+/** Random weights for a model: dense (1 -> prefix_size) -> tanh -> lstm -> dense (-> 1). */
+template <typename T>
+struct Weights
+{
+    explicit Weights(int prefix_size)
+    {
+        std::default_random_engine generator;
+        prefixWeights = random_matrix<T>(generator, prefix_size, 1);
+        prefixBias = random_matrix<T>(generator, 1, prefix_size)[0];
+        W = random_matrix<T>(generator, prefix_size, 4 * hidden_size);
+        U = random_matrix<T>(generator, hidden_size, 4 * hidden_size);
+        b = random_matrix<T>(generator, 1, 4 * hidden_size)[0];
+        outWeights = random_matrix<T>(generator, 1, hidden_size);
+    }
+
+    template <typename DenseType, typename LSTMType, typename OutType>
+    void set(DenseType& dense, LSTMType& lstm, OutType& out)
+    {
+        dense.setWeights(prefixWeights);
+        dense.setBias(prefixBias.data());
+        lstm.setWVals(W);
+        lstm.setUVals(U);
+        lstm.setBVals(b);
+        out.setWeights(outWeights);
+    }
+
+    std::vector<std::vector<T>> prefixWeights;
+    std::vector<T> prefixBias;
+    std::vector<std::vector<T>> W;
+    std::vector<std::vector<T>> U;
+    std::vector<T> b;
+    std::vector<std::vector<T>> outWeights;
+};
+
+template <typename ModelType, typename T>
+double time_model(ModelType& model, const std::vector<T>& signal)
+{
+    model.reset();
+    auto start = clock_t::now();
+    for(const auto& x : signal)
+    {
+        const T ins[] = { x };
+        model.forward(ins);
+    }
+    return std::chrono::duration_cast<second_t>(clock_t::now() - start).count();
+}
+
+template <typename T, int prefix_size>
+void bench_size(const std::vector<T>& signal, std::vector<bench_report::Result>& results)
+{
+    const auto precision = std::is_same<T, float>::value ? "float" : "double";
+    const auto name = "dense1x" + std::to_string(prefix_size) + " -> tanh -> lstm" + std::to_string(hidden_size);
+    Weights<T> weights(prefix_size);
+
+    // dynamic models
+    auto model = std::make_unique<RTNeural::Model<T>>(1);
+    auto* dense = new RTNeural::Dense<T>(1, prefix_size);
+    auto* lstm = new RTNeural::LSTMLayer<T>(prefix_size, hidden_size);
+    auto* out = new RTNeural::Dense<T>(hidden_size, 1);
+    weights.set(*dense, *lstm, *out);
+    model->addLayer(dense);
+    model->addLayer(new RTNeural::TanhActivation<T>(prefix_size));
+    model->addLayer(lstm);
+    model->addLayer(out);
+    results.push_back({ name, "Model", precision, signal.size(), time_model(*model, signal) });
+
+    model = RTNeural::tabulateInputPrefix(std::move(model), RTNeural::InputTableOptions<T> { (T)-1, (T)1, num_points });
+    results.push_back({ name, "Model (input table)", precision, signal.size(), time_model(*model, signal) });
+
+    // static models
+    RTNeural::ModelT<T, 1, 1,
+        RTNeural::DenseT<T, 1, prefix_size>,
+        RTNeural::TanhActivationT<T, prefix_size>,
+        RTNeural::LSTMLayerT<T, prefix_size, hidden_size>,
+        RTNeural::DenseT<T, hidden_size, 1>>
+        modelT;
+    weights.set(modelT.template get<0>(), modelT.template get<2>(), modelT.template get<3>());
+    results.push_back({ name, "ModelT", precision, signal.size(), time_model(modelT, signal) });
+
+    RTNeural::ModelT<T, 1, 1,
+        RTNeural::InputTableT<T, num_points,
+            RTNeural::DenseT<T, 1, prefix_size>,
+            RTNeural::TanhActivationT<T, prefix_size>>,
+        RTNeural::LSTMLayerT<T, prefix_size, hidden_size>,
+        RTNeural::DenseT<T, hidden_size, 1>>
+        tableModelT;
+    auto& table = tableModelT.template get<0>();
+    weights.set(table.template get<0>(), tableModelT.template get<1>(), tableModelT.template get<2>());
+    table.tabulate();
+    results.push_back({ name, "ModelT (input table)", precision, signal.size(), time_model(tableModelT, signal) });
+
+    // the prefix on its own
+    const auto prefixName = "dense1x" + std::to_string(prefix_size) + " -> tanh";
+    results.push_back({ prefixName, "SequentialT", precision, signal.size(), time_model(table.chain, signal) });
+    results.push_back({ prefixName, "InputTableT", precision, signal.size(), time_model(table, signal) });
+}
+
+template <typename T>
+void bench_all(double length_seconds, std::vector<bench_report::Result>& results)
+{
+    const auto signal = generate_signal<T>(static_cast<size_t>(bench_report::audio_sample_rate * length_seconds));
+    bench_size<T, 8>(signal, results);
+    bench_size<T, 16>(signal, results);
+    bench_size<T, 32>(signal, results);
+}
+
+void help()
+{
+    std::cout << "RTNeural input table benchmarks:" << std::endl;
+    std::cout << "Usage: rtneural_input_table_bench <length> [--json <file>]" << std::endl;
+    std::cout << "    Compares models with a dense -> tanh prefix, computed directly" << std::endl;
+    std::cout << "    and with an input table (" << num_points << " points)." << std::endl;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if(argc != 2 && argc != 4)
+    {
+        help();
+        return 1;
+    }
+
+    const auto length_seconds = std::atof(argv[1]);
+    const std::string json_file = argc == 4 ? argv[3] : "";
+
+    std::vector<bench_report::Result> results;
+    bench_all<float>(length_seconds, results);
+    bench_all<double>(length_seconds, results);
+
+    bench_report::print_table(results);
+
+    if(!json_file.empty() && !bench_report::write_json(json_file, "input_table", results))
+        return 1;
+
+    return 0;
+}
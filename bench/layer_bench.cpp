@@ -1,5 +1,6 @@
 #include "bench_utils.hpp"
 #include "layer_creator.hpp"
+#include "perf_counters.hpp"
 #include "templated_bench.hpp"
 #include <RTNeural.h>
 #include <iostream>
@@ -15,6 +16,12 @@ void help()
         << std::endl;
 }
 
+void print_counters(const PerfCounters& counters, size_t n_samples)
+{
+    for(const auto& value : counters.readPerSample(n_samples))
+        std::cout << "    " << value.first << ": " << value.second << std::endl;
+}
+
 int main(int argc, char* argv[])
 {
     if(argc < 4 || argc > 5)
@@ -54,26 +61,34 @@ int main(int argc, char* argv[])
     using clock_t = std::chrono::high_resolution_clock;
     using second_t = std::chrono::duration<double>;
 
+    PerfCounters counters;
+    if(!counters.available())
+        std::cout << "Hardware performance counters are not available!" << std::endl;
+
     double nonTemplatedDur = 0.0;
     {
+        counters.start();
         auto start = clock_t::now();
         for(size_t i = 0; i < n_samples; ++i)
             layer->forward(signal[i].data(), output.data());
         nonTemplatedDur = std::chrono::duration_cast<second_t>(clock_t::now() - start).count();
+        counters.stop();
 
         std::cout << "Processed " << length_seconds << " seconds of signal in "
                   << nonTemplatedDur << " seconds" << std::endl;
         std::cout << length_seconds / nonTemplatedDur << "x real-time" << std::endl;
+        print_counters(counters, n_samples);
     }
 
 #if MODELT_AVAILABLE
     std::cout << "Testing templated implementation..." << std::endl;
     double templatedDur = 0.0;
     {
-        templatedDur = runTemplatedBench(signal, n_samples, layer_type, in_size, out_size);
+        templatedDur = runTemplatedBench(signal, n_samples, layer_type, in_size, out_size, counters);
         std::cout << "Processed " << length_seconds << " seconds of signal in "
                   << templatedDur << " seconds" << std::endl;
         std::cout << length_seconds / templatedDur << "x real-time" << std::endl;
+        print_counters(counters, n_samples);
     }
 
     std::cout << "Templated layer is " << nonTemplatedDur / templatedDur << "x faster!" << std::endl;
@@ -0,0 +1,336 @@
+#include "bench_report.hpp"
+#include "model_zoo.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <random>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+//====================================================
+// Allocation tracking: replace the global allocation functions
+// so that we can count allocations made while loading a model.
+namespace alloc_tracker
+{
+std::atomic<bool> enabled { false };
+std::atomic<size_t> count { 0 };
+std::atomic<size_t> bytes { 0 };
+
+void reset() noexcept
+{
+    count = 0;
+    bytes = 0;
+}
+
+void record(std::size_t size) noexcept
+{
+    if(enabled.load(std::memory_order_relaxed))
+    {
+        count.fetch_add(1, std::memory_order_relaxed);
+        bytes.fetch_add(size, std::memory_order_relaxed);
+    }
+}
+} // namespace alloc_tracker
+
+void* operator new(std::size_t size)
+{
+    alloc_tracker::record(size);
+    if(auto* ptr = std::malloc(size == 0 ? 1 : size))
+        return ptr;
+    throw std::bad_alloc {};
+}
+
+void* operator new(std::size_t size, std::align_val_t align)
+{
+    alloc_tracker::record(size);
+    const auto alignment = std::max((std::size_t)align, sizeof(void*));
+    void* ptr = nullptr;
+    if(posix_memalign(&ptr, alignment, size == 0 ? 1 : size) == 0)
+        return ptr;
+    throw std::bad_alloc {};
+}
+
+// GCC doesn't see that the replaced operator new uses malloc, so it warns
+// about every (inlined) delete of memory from operator new.
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+
+//====================================================
+namespace
+{
+/**
+ * Resident memory measurements, from /proc/self/status.
+ * Writing "5" to /proc/self/clear_refs resets the peak RSS (Linux 4.0+),
+ * so that we can measure the peak for each load separately.
+ */
+namespace rss
+{
+    double read_status_mb(const std::string& key)
+    {
+#if defined(__linux__)
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while(std::getline(status, line))
+        {
+            if(line.compare(0, key.size(), key) != 0)
+                continue;
+
+            std::istringstream value(line.substr(key.size() + 1));
+            double kb = 0.0;
+            value >> kb;
+            return kb / 1024.0;
+        }
+#endif
+        return -1.0;
+    }
+
+    bool reset_peak()
+    {
+#if defined(__linux__)
+        std::ofstream clear_refs("/proc/self/clear_refs");
+        if(!clear_refs.is_open())
+            return false;
+
+        clear_refs << "5";
+        clear_refs.flush();
+        return clear_refs.good();
+#else
+        return false;
+#endif
+    }
+
+    double current_mb() { return read_status_mb("VmRSS"); }
+    double peak_mb() { return read_status_mb("VmHWM"); }
+} // namespace rss
+
+/**
+ * Writes a synthetic LSTM model with the given hidden size and random weights.
+ * The file size grows with the square of the hidden size (roughly 85 MB at 1024).
+ */
+void write_synthetic_model(const fs::path& file, int hidden_size)
+{
+    std::default_random_engine generator;
+    std::uniform_real_distribution<double> distribution(-0.1, 0.1);
+
+    std::ofstream stream(file);
+    stream.precision(17);
+
+    auto write_matrix = [&](int rows, int cols)
+    {
+        stream << "[";
+        for(int i = 0; i < rows; ++i)
+        {
+            stream << (i == 0 ? "[" : ",[");
+            for(int j = 0; j < cols; ++j)
+                stream << (j == 0 ? "" : ",") << distribution(generator);
+            stream << "]";
+        }
+        stream << "]";
+    };
+
+    auto write_vector = [&](int size)
+    {
+        stream << "[";
+        for(int i = 0; i < size; ++i)
+            stream << (i == 0 ? "" : ",") << distribution(generator);
+        stream << "]";
+    };
+
+    stream << R"({"in_shape": [null, null, 1], "layers": [)";
+    stream << R"({"type": "lstm", "activation": "", "shape": [null, null, )" << hidden_size << R"(], "weights": [)";
+    write_matrix(1, 4 * hidden_size);
+    stream << ",";
+    write_matrix(hidden_size, 4 * hidden_size);
+    stream << ",";
+    write_vector(4 * hidden_size);
+    stream << "]},";
+    stream << R"({"type": "dense", "activation": "", "shape": [null, null, 1], "weights": [)";
+    write_matrix(hidden_size, 1);
+    stream << ",";
+    write_vector(1);
+    stream << "]}]}";
+}
+
+#if MODELT_AVAILABLE
+template <typename T, int hidden_size>
+using SyntheticModelT = RTNeural::ModelT<T, 1, 1,
+    RTNeural::LSTMLayerT<T, 1, hidden_size>,
+    RTNeural::DenseT<T, hidden_size, 1>>;
+
+/** Calls `fn` with a (null) pointer tag of the templated model type for a synthetic model. */
+template <typename T, typename Fn>
+bool with_synthetic_model(int hidden_size, Fn&& fn)
+{
+    if(hidden_size == 384)
+        fn((SyntheticModelT<T, 384>*)nullptr);
+    else if(hidden_size == 768)
+        fn((SyntheticModelT<T, 768>*)nullptr);
+    else if(hidden_size == 1536)
+        fn((SyntheticModelT<T, 1536>*)nullptr);
+    else
+        return false;
+
+    return true;
+}
+#endif
+
+/**
+ * Runs the loader `n_repeats` times, and collects the load time and memory usage.
+ * Note that the peak RSS is measured relative to the RSS before loading, so memory
+ * that the allocator has kept around from previous loads will not be counted.
+ */
+template <typename LoadFn>
+bench_report::Result measure_load(const fs::path& model_path, const std::string& impl, const std::string& precision, int n_repeats, LoadFn&& load)
+{
+    using clock_t = std::chrono::high_resolution_clock;
+    using second_t = std::chrono::duration<double>;
+
+    const auto can_reset_peak = rss::reset_peak();
+    const auto start_rss = rss::current_mb();
+
+    alloc_tracker::reset();
+    alloc_tracker::enabled = true;
+    auto start = clock_t::now();
+    for(int i = 0; i < n_repeats; ++i)
+        load();
+    const auto duration = std::chrono::duration_cast<second_t>(clock_t::now() - start).count() / (double)n_repeats;
+    alloc_tracker::enabled = false;
+
+    bench_report::Result result { model_path.filename().string(), impl, precision, 0, duration };
+    result.extra["file_mb"] = (double)fs::file_size(model_path) / (1024.0 * 1024.0);
+    result.extra["load_ms"] = duration * 1000.0;
+    result.extra["allocations"] = (double)alloc_tracker::count / (double)n_repeats;
+    result.extra["alloc_mb"] = (double)alloc_tracker::bytes / (double)n_repeats / (1024.0 * 1024.0);
+    if(can_reset_peak)
+        result.extra["peak_rss_delta_mb"] = rss::peak_mb() - start_rss;
+
+    return result;
+}
+
+template <typename T>
+void bench_load(const fs::path& model_path, int n_repeats, int synthetic_hidden_size, std::vector<bench_report::Result>& results)
+{
+    const auto precision = std::is_same<T, float>::value ? "float" : "double";
+
+    results.push_back(measure_load(model_path, "dynamic", precision, n_repeats, [&]
+        {
+            std::ifstream jsonStream(model_path, std::ifstream::binary);
+            auto model = RTNeural::json_parser::parseJson<T>(jsonStream);
+        }));
+
+#if MODELT_AVAILABLE
+    auto load_templated = [&](auto* model_type_tag)
+    {
+        using ModelType = std::remove_pointer_t<decltype(model_type_tag)>;
+        auto model = std::make_unique<ModelType>(); // heap allocate, since large models may not fit on the stack
+        results.push_back(measure_load(model_path, "templated", precision, n_repeats, [&]
+            {
+                std::ifstream jsonStream(model_path, std::ifstream::binary);
+                model->parseJson(jsonStream);
+            }));
+    };
+
+    if(synthetic_hidden_size > 0)
+        with_synthetic_model<T>(synthetic_hidden_size, load_templated);
+    else
+        model_zoo::with_templated_model<T>(model_path.filename().string(), load_templated);
+#endif
+}
+
+void help()
+{
+    std::cout << "RTNeural model loading benchmarks:" << std::endl;
+    std::cout << "Usage: rtneural_load_bench [--repeats <n>] [--models <dir>] [--large] [--json <file>]" << std::endl;
+    std::cout << "    Measures the load time, peak memory and allocations for every model in the \"models\" directory," << std::endl;
+    std::cout << "    along with any directories passed with --models, and for synthetic LSTM models of ~12 and ~50 MB." << std::endl;
+    std::cout << "    Pass --large to also test a ~200 MB synthetic model." << std::endl;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    int n_repeats = 10;
+    std::vector<fs::path> model_dirs { "models" };
+    std::vector<int> synthetic_hidden_sizes { 384, 768 };
+    std::string json_file;
+
+    for(int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if(arg == "--repeats" && i + 1 < argc)
+            n_repeats = std::max(1, std::atoi(argv[++i]));
+        else if(arg == "--models" && i + 1 < argc)
+            model_dirs.emplace_back(argv[++i]);
+        else if(arg == "--large")
+            synthetic_hidden_sizes.push_back(1536);
+        else if(arg == "--json" && i + 1 < argc)
+            json_file = argv[++i];
+        else
+        {
+            help();
+            return 1;
+        }
+    }
+
+    if(!rss::reset_peak())
+        std::cout << "Unable to reset the peak RSS, so peak memory usage will not be reported!" << std::endl;
+
+    std::vector<bench_report::Result> results;
+    for(const auto& model_path : model_zoo::find_model_files(model_dirs))
+    {
+        try
+        {
+            nlohmann::json model_json;
+            std::ifstream jsonStream(model_path, std::ifstream::binary);
+            jsonStream >> model_json;
+
+            std::string reason;
+            if(!model_zoo::is_supported_model(model_json, reason))
+            {
+                std::cout << "Skipping " << model_path.string() << " (" << reason << ")" << std::endl;
+                continue;
+            }
+
+            std::cout << "Loading " << model_path.string() << "..." << std::endl;
+            bench_load<float>(model_path, n_repeats, 0, results);
+            bench_load<double>(model_path, n_repeats, 0, results);
+        }
+        catch(const std::exception& e)
+        {
+            std::cout << "Skipping " << model_path.string() << " (" << e.what() << ")" << std::endl;
+        }
+    }
+
+    for(auto hidden_size : synthetic_hidden_sizes)
+    {
+        const auto model_path = fs::temp_directory_path() / ("rtneural_synthetic_lstm_" + std::to_string(hidden_size) + ".json");
+        std::cout << "Generating synthetic model " << model_path.string() << "..." << std::endl;
+        write_synthetic_model(model_path, hidden_size);
+
+        std::cout << "Loading " << model_path.string() << "..." << std::endl;
+        bench_load<float>(model_path, 1, hidden_size, results);
+        bench_load<double>(model_path, 1, hidden_size, results);
+
+        fs::remove(model_path);
+    }
+
+    std::cout << std::endl;
+    bench_report::print_table(results);
+
+    if(!json_file.empty() && !bench_report::write_json(json_file, "model_load", results))
+        return 1;
+
+    return 0;
+}
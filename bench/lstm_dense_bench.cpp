@@ -0,0 +1,143 @@
+#include "bench_report.hpp"
+#include <RTNeural.h>
+#include <chrono>
+#include <random>
+
+namespace
+{
+using clock_t = std::chrono::high_resolution_clock;
+using second_t = std::chrono::duration<double>;
+
+nlohmann::json random_matrix(std::default_random_engine& generator, int rows, int cols)
+{
+    std::uniform_real_distribution<double> distribution(-0.5, 0.5);
+    auto matrix = nlohmann::json::array();
+    for(int i = 0; i < rows; ++i)
+    {
+        auto row = nlohmann::json::array();
+        for(int j = 0; j < cols; ++j)
+            row.push_back(distribution(generator));
+        matrix.push_back(row);
+    }
+    return matrix;
+}
+
+/** Returns the json layers for LSTM(1 -> hidden_size) -> Dense(hidden_size -> 1). */
+nlohmann::json lstm_dense_layers(int hidden_size)
+{
+    std::default_random_engine generator;
+
+    nlohmann::json lstm;
+    lstm["type"] = "lstm";
+    lstm["activation"] = "";
+    lstm["shape"] = { nullptr, nullptr, hidden_size };
+    lstm["weights"] = { random_matrix(generator, 1, 4 * hidden_size),
+        random_matrix(generator, hidden_size, 4 * hidden_size),
+        random_matrix(generator, 1, 4 * hidden_size)[0] };
+
+    nlohmann::json dense;
+    dense["type"] = "dense";
+    dense["activation"] = "";
+    dense["shape"] = { nullptr, nullptr, 1 };
+    dense["weights"] = { random_matrix(generator, hidden_size, 1), random_matrix(generator, 1, 1)[0] };
+
+    return { lstm, dense };
+}
+
+template <typename T>
+std::vector<T> generate_signal(size_t n_samples)
+{
+    std::default_random_engine generator;
+    std::uniform_real_distribution<T> distribution((T)-1, (T)1);
+
+    std::vector<T> signal(n_samples);
+    for(auto& x : signal)
+        x = distribution(generator);
+
+    return signal;
+}
+
+template <typename ModelType, typename T>
+double time_model(const nlohmann::json& modelJson, const std::vector<T>& signal)
+{
+    auto model = std::make_unique<ModelType>();
+    model->parseJson(modelJson);
+    model->reset();
+
+    auto start = clock_t::now();
+    for(const auto& x : signal)
+        model->forward(&x);
+    return std::chrono::duration_cast<second_t>(clock_t::now() - start).count();
+}
+
+template <typename T, int hidden_size>
+void bench_lstm_dense(const std::vector<T>& signal, std::vector<bench_report::Result>& results)
+{
+    using namespace RTNeural;
+
+    // layers inside a SequentialT are not fused, even with RTNEURAL_FUSE_LAYERS
+    using SeparateModel = ModelT<T, 1, 1, SequentialT<T, LSTMLayerT<T, 1, hidden_size>, DenseT<T, hidden_size, 1>>>;
+    using FusedModel = ModelT<T, 1, 1, LSTMDenseT<T, 1, hidden_size, 1>>;
+
+    const auto precision = std::is_same<T, float>::value ? "float" : "double";
+    const auto name = "lstm" + std::to_string(hidden_size) + "_dense";
+    const auto layers = lstm_dense_layers(hidden_size);
+
+    nlohmann::json fusedJson;
+    fusedJson["in_shape"] = { nullptr, nullptr, 1 };
+    fusedJson["layers"] = layers;
+
+    nlohmann::json sequential;
+    sequential["type"] = "sequential";
+    sequential["shape"] = { nullptr, nullptr, 1 };
+    sequential["layers"] = layers;
+
+    nlohmann::json separateJson;
+    separateJson["in_shape"] = { nullptr, nullptr, 1 };
+    separateJson["layers"] = { sequential };
+
+    results.push_back({ name, "separate", precision, signal.size(), time_model<SeparateModel>(separateJson, signal) });
+    results.push_back({ name, "fused", precision, signal.size(), time_model<FusedModel>(fusedJson, signal) });
+}
+
+template <typename T>
+void bench_all(double length_seconds, std::vector<bench_report::Result>& results)
+{
+    const auto signal = generate_signal<T>(static_cast<size_t>(bench_report::audio_sample_rate * length_seconds));
+
+    bench_lstm_dense<T, 8>(signal, results);
+    bench_lstm_dense<T, 16>(signal, results);
+    bench_lstm_dense<T, 32>(signal, results);
+    bench_lstm_dense<T, 64>(signal, results);
+}
+
+void help()
+{
+    std::cout << "RTNeural LSTM + Dense fusion benchmarks:" << std::endl;
+    std::cout << "Usage: rtneural_lstm_dense_bench <length> [--json <file>]" << std::endl;
+    std::cout << "    Compares a LSTMLayerT -> DenseT model against the fused LSTMDenseT layer." << std::endl;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if(argc != 2 && argc != 4)
+    {
+        help();
+        return 1;
+    }
+
+    const auto length_seconds = std::atof(argv[1]);
+    const std::string json_file = argc == 4 ? argv[3] : "";
+
+    std::vector<bench_report::Result> results;
+    bench_all<float>(length_seconds, results);
+    bench_all<double>(length_seconds, results);
+
+    bench_report::print_table(results);
+
+    if(!json_file.empty() && !bench_report::write_json(json_file, "lstm_dense", results))
+        return 1;
+
+    return 0;
+}
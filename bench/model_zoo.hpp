@@ -0,0 +1,126 @@
+#pragma once
+
+#include <RTNeural.h>
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/** Utilities shared by the benchmarks that run over a directory of json models. */
+namespace model_zoo
+{
+namespace fs = std::filesystem;
+
+/** Layer types that the dynamic json loader knows how to build. */
+const std::vector<std::string> supported_layers { "dense", "time-distributed-dense", "lstm", "activation" };
+const std::vector<std::string> supported_activations { "", "tanh", "relu", "sigmoid", "softmax", "elu" };
+
+/** Returns true if the dynamic json loader can build this model, otherwise fills in the reason. */
+inline bool is_supported_model(const nlohmann::json& model_json, std::string& reason)
+{
+    if(!model_json.contains("layers") || !model_json.contains("in_shape"))
+    {
+        reason = "not a sequential model";
+        return false;
+    }
+
+    for(const auto& l : model_json.at("layers"))
+    {
+        const auto type = l.at("type").get<std::string>();
+        if(std::find(supported_layers.begin(), supported_layers.end(), type) == supported_layers.end())
+        {
+            reason = "unsupported layer type: " + type;
+            return false;
+        }
+
+        const auto activation = l.contains("activation") ? l.at("activation").get<std::string>() : std::string {};
+        if(std::find(supported_activations.begin(), supported_activations.end(), activation) == supported_activations.end())
+        {
+            reason = "unsupported activation: " + activation;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/** Returns the input size of a model from its "in_shape". */
+inline int get_input_size(const nlohmann::json& model_json)
+{
+    const auto& shape = model_json.at("in_shape");
+    return shape.size() == 4 ? shape[2].get<int>() * shape[3].get<int>() : shape.back().get<int>();
+}
+
+/** Returns a sorted list of all the json files in the given directories. */
+inline std::vector<fs::path> find_model_files(const std::vector<fs::path>& model_dirs)
+{
+    std::vector<fs::path> model_files;
+    for(const auto& dir : model_dirs)
+    {
+        if(!fs::is_directory(dir))
+        {
+            std::cout << "Model directory not found: " << dir << std::endl;
+            continue;
+        }
+
+        for(const auto& entry : fs::directory_iterator(dir))
+            if(entry.is_regular_file() && entry.path().extension() == ".json")
+                model_files.push_back(entry.path());
+    }
+
+    std::sort(model_files.begin(), model_files.end());
+    return model_files;
+}
+
+#if MODELT_AVAILABLE
+/**
+ * Compile-time model definitions for the models that ship with RTNeural.
+ * Models that are not listed here are only benchmarked with the dynamic API.
+ */
+template <typename T>
+using DenseModelT = RTNeural::ModelT<T, 1, 1,
+    RTNeural::DenseT<T, 1, 8>,
+    RTNeural::TanhActivationT<T, 8>,
+    RTNeural::DenseT<T, 8, 8>,
+    RTNeural::ReLuActivationT<T, 8>,
+    RTNeural::DenseT<T, 8, 8>,
+    RTNeural::ELuActivationT<T, 8>,
+    RTNeural::DenseT<T, 8, 8>,
+    RTNeural::SoftmaxActivationT<T, 8>,
+    RTNeural::DenseT<T, 8, 1>>;
+
+template <typename T>
+using LSTMModelT = RTNeural::ModelT<T, 1, 1,
+    RTNeural::DenseT<T, 1, 8>,
+    RTNeural::TanhActivationT<T, 8>,
+    RTNeural::LSTMLayerT<T, 8, 8>,
+    RTNeural::DenseT<T, 8, 1>>;
+
+template <typename T>
+using LSTM1DModelT = RTNeural::ModelT<T, 1, 1,
+    RTNeural::LSTMLayerT<T, 1, 8>,
+    RTNeural::DenseT<T, 8, 1>>;
+
+/**
+ * Calls `fn` with a (null) pointer tag of the templated model
+ * type for the given model file name, if one is available.
+ * Returns false if there is no templated model for this file.
+ */
+template <typename T, typename Fn>
+bool with_templated_model(const std::string& model_name, Fn&& fn)
+{
+    if(model_name == "dense.json")
+        fn((DenseModelT<T>*)nullptr);
+    else if(model_name == "lstm.json")
+        fn((LSTMModelT<T>*)nullptr);
+    else if(model_name == "lstm_1d.json")
+        fn((LSTM1DModelT<T>*)nullptr);
+    else
+        return false;
+
+    return true;
+}
+#endif // MODELT_AVAILABLE
+
+} // namespace model_zoo
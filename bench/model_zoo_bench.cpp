@@ -0,0 +1,153 @@
+#include "bench_report.hpp"
+#include "model_zoo.hpp"
+#include "perf_counters.hpp"
+#include <RTNeural.h>
+#include <chrono>
+#include <random>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+template <typename T>
+std::vector<T> generate_flat_signal(size_t n_samples, int in_size)
+{
+    std::default_random_engine generator;
+    std::uniform_real_distribution<T> distribution((T)-1, (T)1);
+
+    std::vector<T> signal(n_samples * (size_t)in_size);
+    for(auto& x : signal)
+        x = distribution(generator);
+
+    return signal;
+}
+
+PerfCounters& get_counters()
+{
+    static PerfCounters counters;
+    return counters;
+}
+
+template <typename ModelType, typename T>
+double time_model(ModelType& model, const std::vector<T>& signal, size_t n_samples, int in_size)
+{
+    using clock_t = std::chrono::high_resolution_clock;
+    using second_t = std::chrono::duration<double>;
+
+    alignas(RTNEURAL_DEFAULT_ALIGNMENT) T input[64] {};
+    model.reset();
+
+    get_counters().start();
+    auto start = clock_t::now();
+    for(size_t i = 0; i < n_samples; ++i)
+    {
+        std::copy(&signal[i * (size_t)in_size], &signal[(i + 1) * (size_t)in_size], input);
+        model.forward(input);
+    }
+    const auto duration = std::chrono::duration_cast<second_t>(clock_t::now() - start).count();
+    get_counters().stop();
+    return duration;
+}
+
+template <typename T>
+void bench_model(const fs::path& model_path, const nlohmann::json& model_json, int in_size, double length_seconds, std::vector<bench_report::Result>& results)
+{
+    const auto precision = std::is_same<T, float>::value ? "float" : "double";
+    const auto n_samples = static_cast<size_t>(bench_report::audio_sample_rate * length_seconds);
+    const auto signal = generate_flat_signal<T>(n_samples, in_size);
+    const auto name = model_path.filename().string();
+
+    {
+        auto model = RTNeural::json_parser::parseJson<T>(model_json);
+        const auto duration = time_model(*model, signal, n_samples, in_size);
+        results.push_back({ name, "dynamic", precision, n_samples, duration, get_counters().readPerSample(n_samples) });
+    }
+
+#if MODELT_AVAILABLE
+    model_zoo::with_templated_model<T>(name, [&](auto* model_type_tag)
+        {
+            using ModelType = std::remove_pointer_t<decltype(model_type_tag)>;
+            auto model = std::make_unique<ModelType>(); // heap allocate, since large models may not fit on the stack
+            model->parseJson(model_json);
+            const auto duration = time_model(*model, signal, n_samples, in_size);
+            results.push_back({ name, "templated", precision, n_samples, duration, get_counters().readPerSample(n_samples) }); });
+#endif
+}
+
+void help()
+{
+    std::cout << "RTNeural model zoo benchmarks:" << std::endl;
+    std::cout << "Usage: rtneural_model_zoo_bench [--length <seconds>] [--models <dir>] [--json <file>]" << std::endl;
+    std::cout << "    Benchmarks every model in the \"models\" directory, along with any directories passed with --models." << std::endl;
+    std::cout << "    Results are printed as a table, and optionally written to a json file." << std::endl;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    double length_seconds = 5.0;
+    std::vector<fs::path> model_dirs { "models" };
+    std::string json_file;
+
+    for(int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if(arg == "--length" && i + 1 < argc)
+            length_seconds = std::atof(argv[++i]);
+        else if(arg == "--models" && i + 1 < argc)
+            model_dirs.emplace_back(argv[++i]);
+        else if(arg == "--json" && i + 1 < argc)
+            json_file = argv[++i];
+        else
+        {
+            help();
+            return 1;
+        }
+    }
+
+    if(!get_counters().available())
+        std::cout << "Hardware performance counters are not available!" << std::endl;
+
+    const auto model_files = model_zoo::find_model_files(model_dirs);
+
+    std::vector<bench_report::Result> results;
+    for(const auto& model_path : model_files)
+    {
+        nlohmann::json model_json;
+        try
+        {
+            std::ifstream jsonStream(model_path, std::ifstream::binary);
+            jsonStream >> model_json;
+
+            std::string reason;
+            if(!model_zoo::is_supported_model(model_json, reason))
+            {
+                std::cout << "Skipping " << model_path.string() << " (" << reason << ")" << std::endl;
+                continue;
+            }
+
+            const auto in_size = model_zoo::get_input_size(model_json);
+            if(in_size > 64)
+            {
+                std::cout << "Skipping " << model_path.string() << " (input size too large)" << std::endl;
+                continue;
+            }
+
+            std::cout << "Benchmarking " << model_path.string() << "..." << std::endl;
+            bench_model<float>(model_path, model_json, in_size, length_seconds, results);
+            bench_model<double>(model_path, model_json, in_size, length_seconds, results);
+        }
+        catch(const std::exception& e)
+        {
+            std::cout << "Skipping " << model_path.string() << " (" << e.what() << ")" << std::endl;
+        }
+    }
+
+    std::cout << std::endl;
+    bench_report::print_table(results);
+
+    if(!json_file.empty() && !bench_report::write_json(json_file, "model_zoo", results))
+        return 1;
+
+    return 0;
+}
@@ -0,0 +1,164 @@
+#include "bench_report.hpp"
+#include <RTNeural.h>
+#include <chrono>
+#include <random>
+
+namespace
+{
+using clock_t = std::chrono::high_resolution_clock;
+using second_t = std::chrono::duration<double>;
+
+constexpr int num_experts = 8;
+constexpr int hidden_size = 32;
+
+nlohmann::json random_matrix(std::default_random_engine& generator, int rows, int cols)
+{
+    std::uniform_real_distribution<double> distribution(-0.5, 0.5);
+    auto matrix = nlohmann::json::array();
+    for(int i = 0; i < rows; ++i)
+    {
+        auto row = nlohmann::json::array();
+        for(int j = 0; j < cols; ++j)
+            row.push_back(distribution(generator));
+        matrix.push_back(row);
+    }
+    return matrix;
+}
+
+/** Creates a model json with a single MoE layer, with LSTM -> Dense experts. */
+nlohmann::json moe_model_json(int top_k, const std::string& idle_policy)
+{
+    std::default_random_engine generator;
+
+    nlohmann::json layer;
+    layer["type"] = "moe";
+    layer["activation"] = "";
+    layer["shape"] = { nullptr, nullptr, 1 };
+    layer["top_k"] = top_k;
+    layer["idle_policy"] = idle_policy;
+    layer["weights"] = { random_matrix(generator, 1, num_experts), random_matrix(generator, 1, num_experts)[0] };
+
+    layer["experts"] = nlohmann::json::array();
+    for(int e = 0; e < num_experts; ++e)
+    {
+        nlohmann::json lstm;
+        lstm["type"] = "lstm";
+        lstm["activation"] = "";
+        lstm["shape"] = { nullptr, nullptr, hidden_size };
+        lstm["weights"] = { random_matrix(generator, 1, 4 * hidden_size),
+            random_matrix(generator, hidden_size, 4 * hidden_size),
+            random_matrix(generator, 1, 4 * hidden_size)[0] };
+
+        nlohmann::json dense;
+        dense["type"] = "dense";
+        dense["activation"] = "";
+        dense["shape"] = { nullptr, nullptr, 1 };
+        dense["weights"] = { random_matrix(generator, hidden_size, 1), random_matrix(generator, 1, 1)[0] };
+
+        layer["experts"].push_back({ { "layers", { lstm, dense } } });
+    }
+
+    nlohmann::json model;
+    model["in_shape"] = { nullptr, nullptr, 1 };
+    model["layers"] = { layer };
+    return model;
+}
+
+template <typename T>
+std::vector<T> generate_signal(size_t n_samples)
+{
+    std::default_random_engine generator;
+    std::uniform_real_distribution<T> distribution((T)-1, (T)1);
+
+    std::vector<T> signal(n_samples);
+    for(auto& x : signal)
+        x = distribution(generator);
+
+    return signal;
+}
+
+template <typename ModelType, typename T>
+double time_model(ModelType& model, const std::vector<T>& signal)
+{
+    model.reset();
+    auto start = clock_t::now();
+    for(const auto& x : signal)
+        model.forward(&x);
+    return std::chrono::duration_cast<second_t>(clock_t::now() - start).count();
+}
+
+template <typename T>
+using Expert = RTNeural::ModelT<T, 1, 1,
+    RTNeural::LSTMLayerT<T, 1, hidden_size>,
+    RTNeural::DenseT<T, hidden_size, 1>>;
+
+template <size_t, typename ExpertType>
+using expert_t = ExpertType;
+
+template <typename T, int top_k, RTNeural::MoEIdlePolicy policy, size_t... Ix>
+auto moe_model_type(std::index_sequence<Ix...>) -> RTNeural::ModelT<T, 1, 1,
+    RTNeural::MixtureOfExpertsT<T, 1, 1, top_k, policy, expert_t<Ix, Expert<T>>...>>;
+
+template <typename T, int top_k, RTNeural::MoEIdlePolicy policy>
+using MoEModelT = decltype(moe_model_type<T, top_k, policy>(std::make_index_sequence<num_experts> {}));
+
+template <typename T, int top_k, RTNeural::MoEIdlePolicy policy>
+void bench_moe(const std::string& policy_name, const std::vector<T>& signal, std::vector<bench_report::Result>& results)
+{
+    const auto precision = std::is_same<T, float>::value ? "float" : "double";
+    const auto name = "moe_" + std::to_string(num_experts) + "x_lstm" + std::to_string(hidden_size);
+    const auto impl = (top_k == num_experts ? std::string("dense") : "k=" + std::to_string(top_k)) + " " + policy_name;
+    const auto modelJson = moe_model_json(top_k, policy_name);
+
+    auto model = RTNeural::json_parser::parseJson<T>(modelJson);
+    results.push_back({ name, "dynamic " + impl, precision, signal.size(), time_model(*model, signal) });
+
+    auto modelT = std::make_unique<MoEModelT<T, top_k, policy>>();
+    modelT->parseJson(modelJson);
+    results.push_back({ name, "templated " + impl, precision, signal.size(), time_model(*modelT, signal) });
+}
+
+template <typename T>
+void bench_all(double length_seconds, std::vector<bench_report::Result>& results)
+{
+    using Policy = RTNeural::MoEIdlePolicy;
+    const auto signal = generate_signal<T>(static_cast<size_t>(bench_report::audio_sample_rate * length_seconds));
+
+    bench_moe<T, num_experts, Policy::Freeze>("freeze", signal, results);
+    bench_moe<T, 1, Policy::Freeze>("freeze", signal, results);
+    bench_moe<T, 2, Policy::Freeze>("freeze", signal, results);
+    bench_moe<T, 1, Policy::CatchUp>("catch_up", signal, results);
+    bench_moe<T, 2, Policy::CatchUp>("catch_up", signal, results);
+}
+
+void help()
+{
+    std::cout << "RTNeural mixture-of-experts benchmarks:" << std::endl;
+    std::cout << "Usage: rtneural_moe_bench <length> [--json <file>]" << std::endl;
+    std::cout << "    Compares evaluating the top-1 and top-2 experts against evaluating every expert," << std::endl;
+    std::cout << "    for a mixture of " << num_experts << " LSTM experts." << std::endl;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if(argc != 2 && argc != 4)
+    {
+        help();
+        return 1;
+    }
+
+    const auto length_seconds = std::atof(argv[1]);
+    const std::string json_file = argc == 4 ? argv[3] : "";
+
+    std::vector<bench_report::Result> results;
+    bench_all<float>(length_seconds, results);
+    bench_all<double>(length_seconds, results);
+
+    bench_report::print_table(results);
+
+    if(!json_file.empty() && !bench_report::write_json(json_file, "moe", results))
+        return 1;
+
+    return 0;
+}
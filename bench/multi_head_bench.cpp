@@ -0,0 +1,209 @@
+#include "bench_report.hpp"
+#include <RTNeural.h>
+#include <chrono>
+#include <random>
+
+namespace
+{
+using clock_t = std::chrono::high_resolution_clock;
+using second_t = std::chrono::duration<double>;
+
+constexpr int hidden_size = 32;
+constexpr int head_size = 8;
+constexpr int num_heads = 4;
+constexpr int block_size = 256;
+
+template <typename T>
+using TrunkType = RTNeural::ModelT<T, 1, hidden_size,
+    RTNeural::LSTMLayerT<T, 1, hidden_size>>;
+
+template <typename T>
+using HeadType = RTNeural::ModelT<T, hidden_size, 1,
+    RTNeural::DenseT<T, hidden_size, head_size>,
+    RTNeural::TanhActivationT<T, head_size>,
+    RTNeural::DenseT<T, head_size, 1>>;
+
+/** The trunk and one head, as a single model. */
+template <typename T>
+using FullModelType = RTNeural::ModelT<T, 1, 1,
+    RTNeural::LSTMLayerT<T, 1, hidden_size>,
+    RTNeural::DenseT<T, hidden_size, head_size>,
+    RTNeural::TanhActivationT<T, head_size>,
+    RTNeural::DenseT<T, head_size, 1>>;
+
+template <typename T>
+using MultiHeadType = RTNeural::MultiHeadModel<T, TrunkType<T>, HeadType<T>, HeadType<T>, HeadType<T>, HeadType<T>>;
+
+nlohmann::json random_matrix(std::default_random_engine& generator, int rows, int cols)
+{
+    std::uniform_real_distribution<double> distribution(-0.5, 0.5);
+    auto matrix = nlohmann::json::array();
+    for(int i = 0; i < rows; ++i)
+    {
+        auto row = nlohmann::json::array();
+        for(int j = 0; j < cols; ++j)
+            row.push_back(distribution(generator));
+        matrix.push_back(row);
+    }
+    return matrix;
+}
+
+nlohmann::json dense_json(std::default_random_engine& generator, int in_size, int out_size, const std::string& activation)
+{
+    nlohmann::json dense;
+    dense["type"] = "dense";
+    dense["activation"] = activation;
+    dense["shape"] = { nullptr, nullptr, out_size };
+    dense["weights"] = { random_matrix(generator, in_size, out_size), random_matrix(generator, 1, out_size)[0] };
+    return dense;
+}
+
+nlohmann::json multi_head_json()
+{
+    std::default_random_engine generator;
+
+    nlohmann::json lstm;
+    lstm["type"] = "lstm";
+    lstm["activation"] = "";
+    lstm["shape"] = { nullptr, nullptr, hidden_size };
+    lstm["weights"] = { random_matrix(generator, 1, 4 * hidden_size),
+        random_matrix(generator, hidden_size, 4 * hidden_size),
+        random_matrix(generator, 1, 4 * hidden_size)[0] };
+
+    nlohmann::json model;
+    model["in_shape"] = { nullptr, nullptr, 1 };
+    model["layers"] = { lstm };
+    model["heads"] = nlohmann::json::array();
+    for(int h = 0; h < num_heads; ++h)
+    {
+        nlohmann::json head;
+        head["layers"] = { dense_json(generator, hidden_size, head_size, "tanh"), dense_json(generator, head_size, 1, "") };
+        model["heads"].push_back(head);
+    }
+    return model;
+}
+
+template <typename T>
+std::vector<T> generate_signal(size_t n_samples)
+{
+    std::default_random_engine generator;
+    std::uniform_real_distribution<T> distribution((T)-1, (T)1);
+
+    std::vector<T> signal(n_samples);
+    for(auto& x : signal)
+        x = distribution(generator);
+
+    return signal;
+}
+
+template <typename T>
+double time_separate_models(const nlohmann::json& modelJson, const std::vector<T>& signal, std::vector<std::vector<T>>& outs)
+{
+    std::vector<std::unique_ptr<FullModelType<T>>> models;
+    for(int h = 0; h < num_heads; ++h)
+    {
+        auto fullJson = modelJson;
+        for(const auto& l : modelJson["heads"][(size_t)h]["layers"])
+            fullJson["layers"].push_back(l);
+
+        models.push_back(std::make_unique<FullModelType<T>>());
+        models.back()->parseJson(fullJson);
+        models.back()->reset();
+    }
+
+    auto start = clock_t::now();
+    for(int h = 0; h < num_heads; ++h)
+        for(size_t n = 0; n < signal.size(); ++n)
+            outs[(size_t)h][n] = models[(size_t)h]->forward(&signal[n]);
+    return std::chrono::duration_cast<second_t>(clock_t::now() - start).count();
+}
+
+template <typename T>
+double time_multi_head(MultiHeadType<T>& model, const std::vector<T>& signal, std::vector<std::vector<T>>& outs, bool use_blocks)
+{
+    model.reset();
+    T* headOuts[num_heads];
+    auto start = clock_t::now();
+    for(size_t n = 0; n < signal.size(); n += block_size)
+    {
+        const auto num_samples = (int)std::min((size_t)block_size, signal.size() - n);
+        for(int h = 0; h < num_heads; ++h)
+            headOuts[h] = outs[(size_t)h].data() + n;
+
+        if(use_blocks)
+        {
+            model.processBlock(&signal[n], headOuts, num_samples);
+            continue;
+        }
+
+        for(int i = 0; i < num_samples; ++i)
+        {
+            model.forward(&signal[n + (size_t)i]);
+            for(int h = 0; h < num_heads; ++h)
+                headOuts[h][i] = model.getHeadOutputs(h)[0];
+        }
+    }
+    return std::chrono::duration_cast<second_t>(clock_t::now() - start).count();
+}
+
+template <typename T>
+void bench_all(double length_seconds, std::vector<bench_report::Result>& results)
+{
+    const auto precision = std::is_same<T, float>::value ? "float" : "double";
+    const auto name = "lstm" + std::to_string(hidden_size) + " x" + std::to_string(num_heads) + " heads";
+    const auto signal = generate_signal<T>(static_cast<size_t>(bench_report::audio_sample_rate * length_seconds));
+    const auto modelJson = multi_head_json();
+
+    std::vector<std::vector<T>> outs(num_heads, std::vector<T>(signal.size()));
+    results.push_back({ name, "separate models", precision, signal.size(), time_separate_models(modelJson, signal, outs) });
+
+    using namespace RTNeural::json_parser;
+    auto trunk = std::make_unique<TrunkType<T>>();
+    trunk->parseJson(modelJson);
+    std::vector<std::unique_ptr<HeadType<T>>> heads;
+    for(int h = 0; h < num_heads; ++h)
+    {
+        heads.push_back(std::make_unique<HeadType<T>>());
+        heads.back()->parseJson(getHeadJson(modelJson, h, hidden_size));
+    }
+
+    MultiHeadType<T> model { *trunk, *heads[0], *heads[1], *heads[2], *heads[3] };
+    results.push_back({ name, "multi-head", precision, signal.size(), time_multi_head(model, signal, outs, false) });
+    results.push_back({ name, "multi-head (blocks)", precision, signal.size(), time_multi_head(model, signal, outs, true) });
+
+    for(int h = num_heads / 2; h < num_heads; ++h)
+        model.setHeadEnabled(h, false);
+    results.push_back({ name, "multi-head (blocks, 2 heads on)", precision, signal.size(), time_multi_head(model, signal, outs, true) });
+}
+
+void help()
+{
+    std::cout << "RTNeural multi-head benchmarks:" << std::endl;
+    std::cout << "Usage: rtneural_multi_head_bench <length> [--json <file>]" << std::endl;
+    std::cout << "    Compares running one full model per output against a" << std::endl;
+    std::cout << "    multi-head model that shares the trunk between the outputs." << std::endl;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if(argc != 2 && argc != 4)
+    {
+        help();
+        return 1;
+    }
+
+    const auto length_seconds = std::atof(argv[1]);
+    const std::string json_file = argc == 4 ? argv[3] : "";
+
+    std::vector<bench_report::Result> results;
+    bench_all<float>(length_seconds, results);
+    bench_all<double>(length_seconds, results);
+
+    bench_report::print_table(results);
+
+    if(!json_file.empty() && !bench_report::write_json(json_file, "multi_head", results))
+        return 1;
+
+    return 0;
+}
@@ -0,0 +1,182 @@
+#include "bench_report.hpp"
+#include <RTNeural.h>
+#include <chrono>
+#include <random>
+
+namespace
+{
+using clock_t = std::chrono::high_resolution_clock;
+using second_t = std::chrono::duration<double>;
+
+constexpr int hidden_size = 32;
+
+/** Dense(1 -> hidden, tanh) -> LSTM(hidden -> hidden) -> Dense(hidden -> 1), all at the audio rate. */
+template <typename T>
+using FullRateModelType = RTNeural::ModelT<T, 1, 1,
+    RTNeural::DenseT<T, 1, hidden_size>,
+    RTNeural::TanhActivationT<T, hidden_size>,
+    RTNeural::LSTMLayerT<T, hidden_size, hidden_size>,
+    RTNeural::DenseT<T, hidden_size, 1>>;
+
+/** The same model, with the LSTM running at 1 / factor of the audio rate. */
+template <typename T, int factor>
+using DecimatedModelType = RTNeural::ModelT<T, 1, 1,
+    RTNeural::DenseT<T, 1, hidden_size>,
+    RTNeural::TanhActivationT<T, hidden_size>,
+    RTNeural::DecimatedT<T, factor, RTNeural::UpsamplingMode::Linear,
+        RTNeural::LSTMLayerT<T, hidden_size, hidden_size>>,
+    RTNeural::DenseT<T, hidden_size, 1>>;
+
+/** An encoder/decoder model, with a dense stage at 1/2 rate around the LSTM at 1/8 rate. */
+template <typename T>
+using NestedModelType = RTNeural::ModelT<T, 1, 1,
+    RTNeural::DenseT<T, 1, hidden_size>,
+    RTNeural::TanhActivationT<T, hidden_size>,
+    RTNeural::DecimatedT<T, 2, RTNeural::UpsamplingMode::Linear,
+        RTNeural::DenseT<T, hidden_size, hidden_size>,
+        RTNeural::TanhActivationT<T, hidden_size>,
+        RTNeural::DecimatedT<T, 4, RTNeural::UpsamplingMode::Linear,
+            RTNeural::LSTMLayerT<T, hidden_size, hidden_size>>>,
+    RTNeural::DenseT<T, hidden_size, 1>>;
+
+nlohmann::json random_matrix(std::default_random_engine& generator, int rows, int cols)
+{
+    std::uniform_real_distribution<double> distribution(-0.5, 0.5);
+    auto matrix = nlohmann::json::array();
+    for(int i = 0; i < rows; ++i)
+    {
+        auto row = nlohmann::json::array();
+        for(int j = 0; j < cols; ++j)
+            row.push_back(distribution(generator));
+        matrix.push_back(row);
+    }
+    return matrix;
+}
+
+nlohmann::json dense_json(std::default_random_engine& generator, int in_size, int out_size, const std::string& activation)
+{
+    nlohmann::json dense;
+    dense["type"] = "dense";
+    dense["activation"] = activation;
+    dense["shape"] = { nullptr, nullptr, out_size };
+    dense["weights"] = { random_matrix(generator, in_size, out_size), random_matrix(generator, 1, out_size)[0] };
+    return dense;
+}
+
+nlohmann::json lstm_json(std::default_random_engine& generator, int in_size, int out_size)
+{
+    nlohmann::json lstm;
+    lstm["type"] = "lstm";
+    lstm["activation"] = "";
+    lstm["shape"] = { nullptr, nullptr, out_size };
+    lstm["weights"] = { random_matrix(generator, in_size, 4 * out_size),
+        random_matrix(generator, out_size, 4 * out_size),
+        random_matrix(generator, 1, 4 * out_size)[0] };
+    return lstm;
+}
+
+nlohmann::json decimated_json(int factor, const nlohmann::json& layers)
+{
+    nlohmann::json decimated;
+    decimated["type"] = "decimated";
+    decimated["factor"] = factor;
+    decimated["upsampling"] = "linear";
+    decimated["shape"] = { nullptr, nullptr, hidden_size };
+    decimated["weights"] = nlohmann::json::array();
+    decimated["layers"] = layers;
+    return decimated;
+}
+
+nlohmann::json model_json(const std::vector<int>& factors)
+{
+    std::default_random_engine generator;
+
+    const auto input = dense_json(generator, 1, hidden_size, "tanh");
+    auto stage = nlohmann::json::array({ lstm_json(generator, hidden_size, hidden_size) });
+    for(auto factor = factors.rbegin(); factor != factors.rend(); ++factor)
+    {
+        if(factor != factors.rbegin())
+            stage.insert(stage.begin(), dense_json(generator, hidden_size, hidden_size, "tanh"));
+        stage = nlohmann::json::array({ decimated_json(*factor, stage) });
+    }
+
+    nlohmann::json model;
+    model["in_shape"] = { nullptr, nullptr, 1 };
+    model["layers"] = nlohmann::json::array({ input });
+    for(const auto& layer : stage)
+        model["layers"].push_back(layer);
+    model["layers"].push_back(dense_json(generator, hidden_size, 1, ""));
+    return model;
+}
+
+template <typename T>
+std::vector<T> generate_signal(size_t n_samples)
+{
+    std::default_random_engine generator;
+    std::uniform_real_distribution<T> distribution((T)-1, (T)1);
+
+    std::vector<T> signal(n_samples);
+    for(auto& x : signal)
+        x = distribution(generator);
+
+    return signal;
+}
+
+template <typename ModelType, typename T>
+double time_model(const std::vector<T>& signal, const std::vector<int>& factors)
+{
+    auto model = std::make_unique<ModelType>();
+    model->parseJson(model_json(factors));
+    model->reset();
+
+    auto start = clock_t::now();
+    for(const auto& x : signal)
+        model->forward(&x);
+    return std::chrono::duration_cast<second_t>(clock_t::now() - start).count();
+}
+
+template <typename T>
+void bench_all(double length_seconds, std::vector<bench_report::Result>& results)
+{
+    const auto precision = std::is_same<T, float>::value ? "float" : "double";
+    const auto name = "dense -> lstm" + std::to_string(hidden_size) + " -> dense";
+    const auto signal = generate_signal<T>(static_cast<size_t>(bench_report::audio_sample_rate * length_seconds));
+
+    results.push_back({ name, "full rate", precision, signal.size(), time_model<FullRateModelType<T>>(signal, {}) });
+    results.push_back({ name, "lstm at 1/2 rate", precision, signal.size(), time_model<DecimatedModelType<T, 2>>(signal, { 2 }) });
+    results.push_back({ name, "lstm at 1/4 rate", precision, signal.size(), time_model<DecimatedModelType<T, 4>>(signal, { 4 }) });
+    results.push_back({ name, "lstm at 1/8 rate", precision, signal.size(), time_model<DecimatedModelType<T, 8>>(signal, { 8 }) });
+    results.push_back({ name, "dense at 1/2, lstm at 1/8 rate", precision, signal.size(), time_model<NestedModelType<T>>(signal, { 2, 4 }) });
+}
+
+void help()
+{
+    std::cout << "RTNeural multi-rate benchmarks:" << std::endl;
+    std::cout << "Usage: rtneural_multirate_bench <length> [--json <file>]" << std::endl;
+    std::cout << "    Compares running an LSTM at the audio rate against" << std::endl;
+    std::cout << "    running it in decimated stages at 1/2, 1/4, and 1/8 rate." << std::endl;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if(argc != 2 && argc != 4)
+    {
+        help();
+        return 1;
+    }
+
+    const auto length_seconds = std::atof(argv[1]);
+    const std::string json_file = argc == 4 ? argv[3] : "";
+
+    std::vector<bench_report::Result> results;
+    bench_all<float>(length_seconds, results);
+    bench_all<double>(length_seconds, results);
+
+    bench_report::print_table(results);
+
+    if(!json_file.empty() && !bench_report::write_json(json_file, "multirate", results))
+        return 1;
+
+    return 0;
+}
@@ -0,0 +1,149 @@
+#include "bench_report.hpp"
+#include <RTNeural.h>
+#include <chrono>
+#include <random>
+
+namespace
+{
+using clock_t = std::chrono::high_resolution_clock;
+using second_t = std::chrono::duration<double>;
+
+constexpr int block_size = 512;
+
+std::vector<int16_t> generate_signal(size_t n_samples)
+{
+    std::default_random_engine generator;
+    std::uniform_int_distribution<int> distribution(-16384, 16383);
+
+    std::vector<int16_t> signal(n_samples);
+    for(auto& x : signal)
+        x = (int16_t)distribution(generator);
+
+    return signal;
+}
+
+template <typename T, typename LayerType>
+void set_random_weights(LayerType& layer)
+{
+    std::default_random_engine generator;
+    std::uniform_real_distribution<T> distribution((T)-0.5, (T)0.5);
+    std::vector<std::vector<T>> weights((size_t)layer.out_size, std::vector<T>((size_t)layer.in_size));
+    for(auto& row : weights)
+        for(auto& x : row)
+            x = distribution(generator);
+    layer.setWeights(weights);
+}
+
+/** Converts each block to floating-point, runs the model, and converts the outputs back, in separate passes. */
+template <typename ModelType, typename T>
+double time_separate(ModelType& model, const std::vector<int16_t>& signal, RTNeural::PCMConverter<T>& converter)
+{
+    std::vector<int16_t> output(signal.size());
+    std::vector<T> buffer(block_size);
+
+    model.reset();
+    auto start = clock_t::now();
+    for(size_t i = 0; i < signal.size(); i += block_size)
+    {
+        const auto n = (int)std::min((size_t)block_size, signal.size() - i);
+        converter.load(signal.data() + i, buffer.data(), n);
+        for(int k = 0; k < n; ++k)
+            buffer[(size_t)k] = model.forward(&buffer[(size_t)k]);
+        converter.store(buffer.data(), output.data() + i, n);
+    }
+    return std::chrono::duration_cast<second_t>(clock_t::now() - start).count();
+}
+
+/** Runs the model with the fused block entry point. */
+template <typename ModelType, typename T>
+double time_fused(ModelType& model, const std::vector<int16_t>& signal, RTNeural::PCMConverter<T>& converter)
+{
+    std::vector<int16_t> output(signal.size());
+
+    model.reset();
+    auto start = clock_t::now();
+    for(size_t i = 0; i < signal.size(); i += block_size)
+    {
+        const auto n = (int)std::min((size_t)block_size, signal.size() - i);
+        model.processBlock(signal.data() + i, output.data() + i, n, converter);
+    }
+    return std::chrono::duration_cast<second_t>(clock_t::now() - start).count();
+}
+
+template <typename ModelType, typename T>
+void bench_model(const std::string& name, ModelType& model, const std::vector<int16_t>& signal, std::vector<bench_report::Result>& results)
+{
+    const auto precision = std::is_same<T, float>::value ? "float" : "double";
+    for(bool dither : { false, true })
+    {
+        RTNeural::PCMOptions<T> options;
+        options.dither = dither;
+        RTNeural::PCMConverter<T> converter(options);
+
+        const auto label = name + (dither ? " (dither)" : "");
+        results.push_back({ label, "separate passes", precision, signal.size(), time_separate(model, signal, converter) });
+        results.push_back({ label, "processBlock", precision, signal.size(), time_fused(model, signal, converter) });
+    }
+}
+
+template <typename T>
+void bench_all(const std::vector<int16_t>& signal, std::vector<bench_report::Result>& results)
+{
+    // a model which is so small that the conversions matter
+    RTNeural::ModelT<T, 1, 1,
+        RTNeural::DenseT<T, 1, 4>,
+        RTNeural::TanhActivationT<T, 4>,
+        RTNeural::DenseT<T, 4, 1>>
+        denseModel;
+    set_random_weights<T>(denseModel.template get<0>());
+    set_random_weights<T>(denseModel.template get<2>());
+    bench_model<decltype(denseModel), T>("dense4 (ModelT)", denseModel, signal, results);
+
+    RTNeural::ModelT<T, 1, 1,
+        RTNeural::LSTMLayerT<T, 1, 16>,
+        RTNeural::DenseT<T, 16, 1>>
+        lstmModel;
+    bench_model<decltype(lstmModel), T>("lstm16 (ModelT)", lstmModel, signal, results);
+
+    RTNeural::Model<T> dynamicModel(1);
+    auto* dense = new RTNeural::Dense<T>(1, 4);
+    auto* outDense = new RTNeural::Dense<T>(4, 1);
+    set_random_weights<T>(*dense);
+    set_random_weights<T>(*outDense);
+    dynamicModel.addLayer(dense);
+    dynamicModel.addLayer(new RTNeural::TanhActivation<T>(4));
+    dynamicModel.addLayer(outDense);
+    bench_model<decltype(dynamicModel), T>("dense4 (Model)", dynamicModel, signal, results);
+}
+
+void help()
+{
+    std::cout << "RTNeural PCM block processing benchmarks:" << std::endl;
+    std::cout << "Usage: rtneural_pcm_bench <length> [--json <file>]" << std::endl;
+    std::cout << "    Compares converting int16 blocks in separate passes against processBlock()." << std::endl;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if(argc != 2 && argc != 4)
+    {
+        help();
+        return 1;
+    }
+
+    const auto length_seconds = std::atof(argv[1]);
+    const std::string json_file = argc == 4 ? argv[3] : "";
+    const auto signal = generate_signal(static_cast<size_t>(bench_report::audio_sample_rate * length_seconds));
+
+    std::vector<bench_report::Result> results;
+    bench_all<float>(signal, results);
+    bench_all<double>(signal, results);
+
+    bench_report::print_table(results);
+
+    if(!json_file.empty() && !bench_report::write_json(json_file, "pcm", results))
+        return 1;
+
+    return 0;
+}
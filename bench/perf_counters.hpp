@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <asm/unistd.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Hardware performance counters for the benchmarks, using Linux perf_event_open.
+ *
+ * On other platforms, or when the kernel does not allow access to the counters
+ * (e.g. /proc/sys/kernel/perf_event_paranoid is too high, or running in a VM
+ * without a virtual PMU), the counters silently report nothing.
+ *
+ * There is no portable event for floating-point assists (i.e. denormal handling),
+ * so that counter is only enabled when a raw event code is provided in the
+ * RTNEURAL_PERF_FP_ASSIST_EVENT environment variable (e.g. "0x1eca" for
+ * FP_ASSIST.ANY on Intel Skylake).
+ */
+class PerfCounters
+{
+public:
+    PerfCounters()
+    {
+#if defined(__linux__)
+        addCounter("cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        addCounter("instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        addCounter("branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+        addCounter("l1d_misses", PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+        addCounter("llc_misses", PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+
+        if(const auto* fp_assist_event = std::getenv("RTNEURAL_PERF_FP_ASSIST_EVENT"))
+            addCounter("fp_assists", PERF_TYPE_RAW, std::strtoull(fp_assist_event, nullptr, 0));
+#endif
+    }
+
+    ~PerfCounters()
+    {
+#if defined(__linux__)
+        for(auto& c : counters)
+            close(c.fd);
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    /** Returns true if at least one hardware counter is available. */
+    bool available() const noexcept { return !counters.empty(); }
+
+    /** Resets and starts all the counters. */
+    void start() noexcept
+    {
+#if defined(__linux__)
+        for(auto& c : counters)
+        {
+            ioctl(c.fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(c.fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    /** Stops all the counters. */
+    void stop() noexcept
+    {
+#if defined(__linux__)
+        for(auto& c : counters)
+            ioctl(c.fd, PERF_EVENT_IOC_DISABLE, 0);
+#endif
+    }
+
+    /**
+     * Returns the counter values since the last call to start(),
+     * scaled to account for counter multiplexing.
+     */
+    std::map<std::string, double> read() const
+    {
+        std::map<std::string, double> values;
+#if defined(__linux__)
+        for(const auto& c : counters)
+        {
+            uint64_t data[3] {}; // value, time enabled, time running
+            if(::read(c.fd, data, sizeof(data)) != (ssize_t)sizeof(data) || data[2] == 0)
+                continue;
+
+            values[c.name] = (double)data[0] * ((double)data[1] / (double)data[2]);
+        }
+#endif
+        return values;
+    }
+
+    /**
+     * Returns the counter values divided by the number of processed samples,
+     * along with the instructions-per-cycle, in the form used by bench_report::Result::extra.
+     */
+    std::map<std::string, double> readPerSample(size_t n_samples) const
+    {
+        const auto values = read();
+        std::map<std::string, double> per_sample;
+        for(const auto& v : values)
+            per_sample[v.first + "/sample"] = v.second / (double)n_samples;
+
+        const auto cycles = values.find("cycles");
+        const auto instructions = values.find("instructions");
+        if(cycles != values.end() && instructions != values.end() && cycles->second > 0.0)
+            per_sample["IPC"] = instructions->second / cycles->second;
+
+        return per_sample;
+    }
+
+private:
+#if defined(__linux__)
+    void addCounter(const std::string& name, uint32_t type, uint64_t config)
+    {
+        perf_event_attr attr {};
+        attr.size = sizeof(perf_event_attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        const auto fd = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+        if(fd < 0)
+            return; // counter not available on this machine
+
+        counters.push_back({ name, fd });
+    }
+#endif
+
+    struct Counter
+    {
+        std::string name;
+        int fd;
+    };
+    std::vector<Counter> counters; // always empty on other platforms
+};
@@ -0,0 +1,163 @@
+#include "bench_report.hpp"
+#include <RTNeural.h>
+#include <chrono>
+#include <random>
+
+namespace
+{
+using clock_t = std::chrono::high_resolution_clock;
+using second_t = std::chrono::duration<double>;
+
+constexpr int num_channels = 16;
+
+template <typename T>
+std::vector<T> generate_signal(size_t n_samples)
+{
+    std::default_random_engine generator;
+    std::uniform_real_distribution<T> distribution((T)-10, (T)10);
+
+    std::vector<T> signal(n_samples * num_channels);
+    for(auto& x : signal)
+        x = distribution(generator);
+
+    return signal;
+}
+
+/** Runs `process(ins, outs)` for each frame, and returns the time and the max. error against `reference(channel, x)`. */
+template <typename T, typename ProcessFunc, typename RefFunc>
+std::pair<double, double> run(const std::vector<T>& signal, ProcessFunc&& process, RefFunc&& reference)
+{
+    const auto n_frames = signal.size() / num_channels;
+    std::vector<T> output(signal.size());
+
+    auto start = clock_t::now();
+    for(size_t n = 0; n < n_frames; ++n)
+        process(&signal[n * num_channels], &output[n * num_channels]);
+    const auto seconds = std::chrono::duration_cast<second_t>(clock_t::now() - start).count();
+
+    double maxError = 0.0;
+    for(size_t i = 0; i < signal.size(); ++i)
+        maxError = std::max(maxError, std::abs((double)output[i] - reference((int)(i % num_channels), (double)signal[i])));
+
+    return { seconds, maxError };
+}
+
+template <typename T, typename ProcessFunc, typename RefFunc>
+void bench_function(const std::string& name, const std::string& impl, const std::vector<T>& signal,
+    ProcessFunc&& process, RefFunc&& reference, std::vector<bench_report::Result>& results)
+{
+    const auto precision = std::is_same<T, float>::value ? "float" : "double";
+    const auto result = run(signal, process, reference);
+
+    bench_report::Result r { name, impl, precision, signal.size() / num_channels, result.first };
+    r.extra["log10_max_error"] = std::log10(std::max(result.second, 1.0e-300)); // the table has a fixed precision
+    results.push_back(r);
+}
+
+/** Copies a frame into the (aligned) input of a static layer, runs the layer, and copies the outputs. */
+template <typename LayerType, typename T>
+void forward_layer(LayerType& layer, const T* ins, T* outs)
+{
+    T layerIns alignas(RTNEURAL_DEFAULT_ALIGNMENT)[num_channels];
+    std::copy(ins, ins + num_channels, layerIns);
+    layer.forward(layerIns);
+    std::copy(layer.outs, layer.outs + num_channels, outs);
+}
+
+template <typename T>
+void bench_all(const std::vector<T>& signal, std::vector<bench_report::Result>& results)
+{
+    auto refSin = [](int, double x)
+    { return std::sin(x); };
+    auto refCos = [](int, double x)
+    { return std::cos(x); };
+
+    bench_function<T>(
+        "sin", "std::sin", signal, [](const T* ins, T* outs)
+        {
+            for(int i = 0; i < num_channels; ++i)
+                outs[i] = std::sin(ins[i]); },
+        refSin, results);
+    RTNeural::SinActivationT<T, num_channels> sinLayer;
+    bench_function<T>(
+        "sin", "SinActivationT", signal, [&sinLayer](const T* ins, T* outs)
+        { forward_layer(sinLayer, ins, outs); },
+        refSin, results);
+
+    bench_function<T>(
+        "cos", "std::cos", signal, [](const T* ins, T* outs)
+        {
+            for(int i = 0; i < num_channels; ++i)
+                outs[i] = std::cos(ins[i]); },
+        refCos, results);
+    RTNeural::CosActivationT<T, num_channels> cosLayer;
+    bench_function<T>(
+        "cos", "CosActivationT", signal, [&cosLayer](const T* ins, T* outs)
+        { forward_layer(cosLayer, ins, outs); },
+        refCos, results);
+
+    std::vector<T> alpha(num_channels);
+    for(int i = 0; i < num_channels; ++i)
+        alpha[(size_t)i] = (T)0.25 * (T)(i + 1);
+
+    auto refSnake = [&alpha](int i, double x)
+    {
+        const auto s = std::sin((double)alpha[(size_t)i] * x);
+        return x + s * s / (double)alpha[(size_t)i];
+    };
+
+    bench_function<T>(
+        "snake", "std::sin", signal, [&alpha](const T* ins, T* outs)
+        {
+            for(int i = 0; i < num_channels; ++i)
+            {
+                const auto s = std::sin(alpha[(size_t)i] * ins[i]);
+                outs[i] = ins[i] + s * s / alpha[(size_t)i];
+            } },
+        refSnake, results);
+    RTNeural::SnakeActivationT<T, num_channels> snakeLayer;
+    snakeLayer.setAlphaVals(alpha);
+    bench_function<T>(
+        "snake", "SnakeActivationT", signal, [&snakeLayer](const T* ins, T* outs)
+        { forward_layer(snakeLayer, ins, outs); },
+        refSnake, results);
+    RTNeural::SnakeActivation<T> dynamicSnakeLayer(num_channels);
+    dynamicSnakeLayer.setAlphaVals(alpha);
+    bench_function<T>(
+        "snake", "SnakeActivation", signal, [&dynamicSnakeLayer](const T* ins, T* outs)
+        { dynamicSnakeLayer.forward(ins, outs); },
+        refSnake, results);
+}
+
+void help()
+{
+    std::cout << "RTNeural periodic activation benchmarks:" << std::endl;
+    std::cout << "Usage: rtneural_periodic_bench <length> [--json <file>]" << std::endl;
+    std::cout << "    Compares the speed and accuracy of std::sin/std::cos against the sin, cos, and Snake activation layers" << std::endl;
+    std::cout << "    (each sample has " << num_channels << " channels)." << std::endl;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if(argc != 2 && argc != 4)
+    {
+        help();
+        return 1;
+    }
+
+    const auto length_seconds = std::atof(argv[1]);
+    const std::string json_file = argc == 4 ? argv[3] : "";
+    const auto n_samples = static_cast<size_t>(bench_report::audio_sample_rate * length_seconds);
+
+    std::vector<bench_report::Result> results;
+    bench_all<float>(generate_signal<float>(n_samples), results);
+    bench_all<double>(generate_signal<double>(n_samples), results);
+
+    bench_report::print_table(results);
+
+    if(!json_file.empty() && !bench_report::write_json(json_file, "periodic", results))
+        return 1;
+
+    return 0;
+}
@@ -0,0 +1,162 @@
+#include "bench_report.hpp"
+#include <RTNeural.h>
+#include <chrono>
+#include <random>
+
+namespace
+{
+using clock_t = std::chrono::high_resolution_clock;
+using second_t = std::chrono::duration<double>;
+
+template <typename T>
+std::vector<T> generate_signal(size_t n_samples, T range = (T)1)
+{
+    std::default_random_engine generator;
+    std::uniform_real_distribution<T> distribution(-range, range);
+
+    std::vector<T> signal(n_samples);
+    for(auto& x : signal)
+        x = distribution(generator);
+
+    return signal;
+}
+
+template <typename T>
+std::vector<std::vector<T>> random_matrix(int rows, int cols)
+{
+    const auto values = generate_signal<T>((size_t)rows * (size_t)cols, (T)0.1);
+    std::vector<std::vector<T>> matrix((size_t)rows);
+    for(int i = 0; i < rows; ++i)
+        matrix[(size_t)i].assign(values.begin() + (ptrdiff_t)i * cols, values.begin() + (ptrdiff_t)(i + 1) * cols);
+    return matrix;
+}
+
+/**
+ * Times the matrix products of one LSTM step (4 gates, each [hidden][hidden]),
+ * with a given prefetch distance. Each gate prefetches the start of the next.
+ */
+template <typename T>
+double time_kernel(size_t n_samples, int hidden_size, int distance)
+{
+    const auto gate_size = (size_t)hidden_size * (size_t)hidden_size;
+    const auto weights = generate_signal<T>(4 * gate_size, (T)0.1);
+    const auto vec = generate_signal<T>((size_t)hidden_size);
+    std::vector<T> out((size_t)hidden_size);
+    T sum = (T)0;
+
+    auto start = clock_t::now();
+    for(size_t n = 0; n < n_samples; ++n)
+    {
+        for(int g = 0; g < 4; ++g)
+        {
+            const auto* mat = weights.data() + (size_t)g * gate_size;
+            const auto* next = weights.data() + (size_t)((g + 1) % 4) * gate_size;
+            RTNeural::mat_vec_prefetched(mat, vec.data(), out.data(), hidden_size, hidden_size, distance, next, sizeof(T) * gate_size);
+        }
+        sum += out[0];
+    }
+    const auto duration = std::chrono::duration_cast<second_t>(clock_t::now() - start).count();
+
+    volatile T result = sum; // keep the products from being optimized away
+    (void)result;
+    return duration;
+}
+
+template <typename T, int hidden_size>
+double time_lstm(const std::vector<T>& signal)
+{
+    auto lstm = std::make_unique<RTNeural::LSTMLayerT<T, 1, hidden_size>>();
+    lstm->setWVals(random_matrix<T>(1, 4 * hidden_size));
+    lstm->setUVals(random_matrix<T>(hidden_size, 4 * hidden_size));
+    lstm->setBVals(random_matrix<T>(1, 4 * hidden_size)[0]);
+    lstm->reset();
+
+    auto start = clock_t::now();
+    for(const auto& x : signal)
+    {
+        const T ins[] = { x };
+        lstm->forward(ins);
+    }
+    return std::chrono::duration_cast<second_t>(clock_t::now() - start).count();
+}
+
+template <typename T, int size>
+double time_dense(const std::vector<T>& signal)
+{
+    auto dense = std::make_unique<RTNeural::DenseT<T, size, size>>();
+    dense->setWeights(random_matrix<T>(size, size));
+
+    const auto inputs = generate_signal<T>((size_t)size);
+    T ins alignas(RTNEURAL_DEFAULT_ALIGNMENT)[size];
+    std::copy(inputs.begin(), inputs.end(), ins);
+
+    auto start = clock_t::now();
+    for(const auto& x : signal)
+    {
+        ins[0] = x;
+        dense->forward(ins);
+    }
+    return std::chrono::duration_cast<second_t>(clock_t::now() - start).count();
+}
+
+template <typename T, int hidden_size>
+void bench_size(size_t n_samples, std::vector<bench_report::Result>& results)
+{
+    const auto precision = std::is_same<T, float>::value ? "float" : "double";
+    const auto name = "lstm" + std::to_string(hidden_size);
+
+    // the kernel sweep runs fewer samples for the big sizes, so that the whole sweep takes a similar time for each size
+    const auto kernel_samples = std::max(n_samples * 64 / (size_t)hidden_size, (size_t)1);
+    const auto heuristic = RTNeural::prefetch_distance(sizeof(T) * hidden_size, sizeof(T) * 4 * hidden_size * (hidden_size + 1));
+    for(int distance : { 0, 1, 2, 4, 8 })
+        results.push_back({ name + " gates", "distance " + std::to_string(distance), precision, kernel_samples, time_kernel<T>(kernel_samples, hidden_size, distance) });
+    results.push_back({ name + " gates", "heuristic (" + std::to_string(heuristic) + ")", precision, kernel_samples, time_kernel<T>(kernel_samples, hidden_size, heuristic) });
+
+    const auto signal = generate_signal<T>(kernel_samples);
+    results.push_back({ name, "LSTMLayerT", precision, signal.size(), time_lstm<T, hidden_size>(signal) });
+    results.push_back({ "dense" + std::to_string(hidden_size) + "x" + std::to_string(hidden_size), "DenseT", precision, signal.size(), time_dense<T, hidden_size>(signal) });
+}
+
+template <typename T>
+void bench_all(size_t n_samples, std::vector<bench_report::Result>& results)
+{
+    bench_size<T, 64>(n_samples, results);
+    bench_size<T, 128>(n_samples, results);
+    bench_size<T, 256>(n_samples, results);
+    bench_size<T, 512>(n_samples, results);
+    bench_size<T, 1024>(n_samples, results);
+}
+
+void help()
+{
+    std::cout << "RTNeural prefetching benchmarks:" << std::endl;
+    std::cout << "Usage: rtneural_prefetch_bench <length> [--json <file>]" << std::endl;
+    std::cout << "    Times the LSTM gate products for hidden sizes 64-1024, over a sweep" << std::endl;
+    std::cout << "    of prefetch distances, along with the heuristic distance, and times" << std::endl;
+    std::cout << "    LSTMLayerT and DenseT (as built, see RTNEURAL_PREFETCH) at the same sizes." << std::endl;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if(argc != 2 && argc != 4)
+    {
+        help();
+        return 1;
+    }
+
+    const auto length_seconds = std::atof(argv[1]);
+    const std::string json_file = argc == 4 ? argv[3] : "";
+    const auto n_samples = static_cast<size_t>(bench_report::audio_sample_rate * length_seconds);
+
+    std::vector<bench_report::Result> results;
+    bench_all<float>(n_samples, results);
+    bench_all<double>(n_samples, results);
+
+    bench_report::print_table(results);
+
+    if(!json_file.empty() && !bench_report::write_json(json_file, "prefetch", results))
+        return 1;
+
+    return 0;
+}
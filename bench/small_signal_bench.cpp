@@ -0,0 +1,122 @@
+#include "bench_report.hpp"
+#include <RTNeural.h>
+#include <chrono>
+#include <random>
+
+namespace
+{
+using clock_t = std::chrono::high_resolution_clock;
+using second_t = std::chrono::duration<double>;
+
+/** A test signal, with a given amplitude. */
+template <typename T>
+std::vector<T> generate_signal(size_t n_samples, T amplitude)
+{
+    std::default_random_engine generator;
+    std::uniform_real_distribution<T> distribution(-amplitude, amplitude);
+
+    std::vector<T> signal(n_samples);
+    for(auto& x : signal)
+        x = distribution(generator);
+
+    return signal;
+}
+
+template <typename LayerType>
+void set_random_weights(LayerType& layer, int in_size, int hidden_size)
+{
+    using T = typename std::remove_reference<decltype(layer.outs[0])>::type;
+    std::default_random_engine generator;
+    std::uniform_real_distribution<T> distribution((T)-0.4, (T)0.4);
+    auto random_matrix = [&](int rows, int cols)
+    {
+        std::vector<std::vector<T>> matrix((size_t)rows, std::vector<T>((size_t)cols));
+        for(auto& row : matrix)
+            for(auto& x : row)
+                x = distribution(generator);
+        return matrix;
+    };
+
+    layer.setWVals(random_matrix(in_size, 4 * hidden_size));
+    layer.setUVals(random_matrix(hidden_size, 4 * hidden_size));
+    layer.setBVals(random_matrix(1, 4 * hidden_size)[0]);
+}
+
+template <typename LayerType, typename T>
+double time_layer(LayerType& layer, const std::vector<T>& signal)
+{
+    layer.reset();
+    auto start = clock_t::now();
+    for(const auto& x : signal)
+    {
+        const T ins[] = { x };
+        layer.forward(ins);
+    }
+    return std::chrono::duration_cast<second_t>(clock_t::now() - start).count();
+}
+
+template <typename T, int hidden_size>
+void bench_size(double length_seconds, std::vector<bench_report::Result>& results)
+{
+    const auto precision = std::is_same<T, float>::value ? "float" : "double";
+    const auto n_samples = static_cast<size_t>(bench_report::audio_sample_rate * length_seconds);
+    const auto name = "lstm" + std::to_string(hidden_size);
+
+    RTNeural::LSTMLayerT<T, 1, hidden_size> lstm;
+    set_random_weights(lstm, 1, hidden_size);
+
+    RTNeural::SmallSignalLSTMT<T, 1, hidden_size> smallSignal;
+    set_random_weights(smallSignal, 1, hidden_size);
+    smallSignal.linearize();
+
+    // a quiet signal (-80 dBFS), which the small-signal model handles with the linear model,
+    // and a loud signal (-6 dBFS), for which it always uses the full LSTM
+    const auto quiet = generate_signal<T>(n_samples, (T)1.0e-4);
+    const auto loud = generate_signal<T>(n_samples, (T)0.5);
+
+    results.push_back({ name + " quiet", "LSTMLayerT", precision, n_samples, time_layer(lstm, quiet) });
+    results.push_back({ name + " quiet", "SmallSignalLSTMT", precision, n_samples, time_layer(smallSignal, quiet) });
+    results.push_back({ name + " loud", "LSTMLayerT", precision, n_samples, time_layer(lstm, loud) });
+    results.push_back({ name + " loud", "SmallSignalLSTMT", precision, n_samples, time_layer(smallSignal, loud) });
+}
+
+template <typename T>
+void bench_all(double length_seconds, std::vector<bench_report::Result>& results)
+{
+    bench_size<T, 8>(length_seconds, results);
+    bench_size<T, 16>(length_seconds, results);
+    bench_size<T, 32>(length_seconds, results);
+    bench_size<T, 64>(length_seconds, results);
+}
+
+void help()
+{
+    std::cout << "RTNeural small-signal LSTM benchmarks:" << std::endl;
+    std::cout << "Usage: rtneural_small_signal_bench <length> [--json <file>]" << std::endl;
+    std::cout << "    Compares LSTMLayerT against SmallSignalLSTMT, for a quiet signal" << std::endl;
+    std::cout << "    (which uses the linear model) and a loud signal (which does not)." << std::endl;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if(argc != 2 && argc != 4)
+    {
+        help();
+        return 1;
+    }
+
+    const auto length_seconds = std::atof(argv[1]);
+    const std::string json_file = argc == 4 ? argv[3] : "";
+
+    std::vector<bench_report::Result> results;
+    bench_all<float>(length_seconds, results);
+    bench_all<double>(length_seconds, results);
+
+    bench_report::print_table(results);
+
+    if(!json_file.empty() && !bench_report::write_json(json_file, "small_signal", results))
+        return 1;
+
+    return 0;
+}
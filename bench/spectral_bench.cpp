@@ -0,0 +1,216 @@
+#include "bench_report.hpp"
+#include <RTNeural.h>
+#include <chrono>
+#include <complex>
+#include <random>
+
+namespace
+{
+using clock_t = std::chrono::high_resolution_clock;
+using second_t = std::chrono::duration<double>;
+
+const double pi = 3.14159265358979323846;
+
+/** A recursive radix-2 FFT on std::complex, which allocates at each level. */
+template <typename T>
+std::vector<std::complex<T>> recursive_fft(const std::vector<std::complex<T>>& x)
+{
+    const auto n = x.size();
+    if(n == 1)
+        return x;
+
+    std::vector<std::complex<T>> even(n / 2), odd(n / 2);
+    for(size_t i = 0; i < n / 2; ++i)
+    {
+        even[i] = x[2 * i];
+        odd[i] = x[2 * i + 1];
+    }
+
+    const auto evenSpectrum = recursive_fft(even);
+    const auto oddSpectrum = recursive_fft(odd);
+
+    std::vector<std::complex<T>> X(n);
+    for(size_t k = 0; k < n / 2; ++k)
+    {
+        const auto t = std::polar((T)1, (T)(-2.0 * pi * (double)k / (double)n)) * oddSpectrum[k];
+        X[k] = evenSpectrum[k] + t;
+        X[k + n / 2] = evenSpectrum[k] - t;
+    }
+    return X;
+}
+
+/**
+ * The "do it yourself" pipeline: copies the frame out of a sample history,
+ * windows it, runs a complex FFT, and applies a dense mel matrix, allocating
+ * temporary buffers for each frame.
+ */
+template <typename T>
+struct NaiveFrontEnd
+{
+    NaiveFrontEnd(int fft_size, int hop_size, int num_mels, double sample_rate)
+        : fft_size(fft_size)
+        , hop_size(hop_size)
+        , num_mels(num_mels)
+    {
+        RTNeural::SpectralFrontEnd<T> reference { fft_size, hop_size, num_mels, sample_rate };
+        for(int m = 0; m < num_mels; ++m)
+        {
+            melMatrix.emplace_back();
+            for(int k = 0; k < fft_size / 2 + 1; ++k)
+                melMatrix.back().push_back(reference.getMelWeight(m, k));
+        }
+    }
+
+    template <typename ModelType>
+    void process(const std::vector<T>& signal, ModelType& model)
+    {
+        std::vector<T> history;
+        std::vector<T> modelInput((size_t)num_mels);
+        for(size_t n = 0; n < signal.size(); ++n)
+        {
+            history.push_back(signal[n]);
+            if((n + 1) % (size_t)hop_size != 0)
+                continue;
+
+            std::vector<std::complex<T>> frame((size_t)fft_size);
+            for(int i = 0; i < fft_size; ++i)
+            {
+                const auto idx = (long)history.size() - fft_size + i;
+                const auto window = (T)(0.5 - 0.5 * std::cos(2.0 * pi * (double)i / (double)fft_size));
+                frame[(size_t)i] = idx >= 0 ? history[(size_t)idx] * window : (T)0;
+            }
+
+            const auto spectrum = recursive_fft(frame);
+            std::vector<T> power;
+            for(int k = 0; k < fft_size / 2 + 1; ++k)
+                power.push_back(std::norm(spectrum[(size_t)k]));
+
+            std::vector<T> mel((size_t)num_mels, (T)0);
+            for(int m = 0; m < num_mels; ++m)
+            {
+                for(size_t k = 0; k < power.size(); ++k)
+                    mel[(size_t)m] += melMatrix[(size_t)m][k] * power[k];
+                mel[(size_t)m] = std::log(mel[(size_t)m] + (T)1.0e-10);
+            }
+
+            std::copy(mel.begin(), mel.end(), modelInput.begin());
+            model.forward(modelInput.data());
+        }
+    }
+
+    const int fft_size;
+    const int hop_size;
+    const int num_mels;
+    std::vector<std::vector<T>> melMatrix;
+};
+
+template <typename T>
+std::unique_ptr<RTNeural::Model<T>> create_model(int num_mels)
+{
+    std::default_random_engine generator;
+    std::uniform_real_distribution<double> distribution(-0.1, 0.1);
+
+    nlohmann::json dense;
+    dense["type"] = "dense";
+    dense["activation"] = "tanh";
+    dense["shape"] = { nullptr, nullptr, 8 };
+    dense["weights"] = { nlohmann::json::array(), nlohmann::json::array() };
+    for(int m = 0; m < num_mels; ++m)
+    {
+        auto row = nlohmann::json::array();
+        for(int i = 0; i < 8; ++i)
+            row.push_back(distribution(generator));
+        dense["weights"][0].push_back(row);
+    }
+    for(int i = 0; i < 8; ++i)
+        dense["weights"][1].push_back(distribution(generator));
+
+    nlohmann::json model;
+    model["in_shape"] = { nullptr, nullptr, num_mels };
+    model["layers"] = nlohmann::json::array({ dense });
+    return RTNeural::json_parser::parseJson<T>(model);
+}
+
+template <typename T>
+std::vector<T> generate_signal(size_t n_samples)
+{
+    std::default_random_engine generator;
+    std::uniform_real_distribution<T> distribution((T)-1, (T)1);
+
+    std::vector<T> signal(n_samples);
+    for(auto& x : signal)
+        x = distribution(generator);
+
+    return signal;
+}
+
+template <typename T>
+double time_naive(const std::vector<T>& signal, int fft_size, int hop_size, int num_mels)
+{
+    NaiveFrontEnd<T> frontEnd { fft_size, hop_size, num_mels, bench_report::audio_sample_rate };
+    auto model = create_model<T>(num_mels);
+
+    auto start = clock_t::now();
+    frontEnd.process(signal, *model);
+    return std::chrono::duration_cast<second_t>(clock_t::now() - start).count();
+}
+
+template <typename T>
+double time_front_end(const std::vector<T>& signal, int fft_size, int hop_size, int num_mels)
+{
+    RTNeural::SpectralFrontEnd<T> frontEnd { fft_size, hop_size, num_mels, bench_report::audio_sample_rate };
+    auto model = create_model<T>(num_mels);
+
+    constexpr int block_size = 256;
+    auto start = clock_t::now();
+    for(size_t n = 0; n < signal.size(); n += block_size)
+        frontEnd.processBlock(signal.data() + n, (int)std::min(signal.size() - n, (size_t)block_size), *model);
+    return std::chrono::duration_cast<second_t>(clock_t::now() - start).count();
+}
+
+template <typename T>
+void bench_all(double length_seconds, std::vector<bench_report::Result>& results)
+{
+    const auto precision = std::is_same<T, float>::value ? "float" : "double";
+    const auto signal = generate_signal<T>(static_cast<size_t>(bench_report::audio_sample_rate * length_seconds));
+
+    const int configs[][3] = { { 512, 128, 40 }, { 1024, 256, 64 }, { 2048, 512, 128 } };
+    for(const auto& config : configs)
+    {
+        const auto name = "fft" + std::to_string(config[0]) + " hop" + std::to_string(config[1]) + " mel" + std::to_string(config[2]);
+        results.push_back({ name, "naive", precision, signal.size(), time_naive(signal, config[0], config[1], config[2]) });
+        results.push_back({ name, "SpectralFrontEnd", precision, signal.size(), time_front_end(signal, config[0], config[1], config[2]) });
+    }
+}
+
+void help()
+{
+    std::cout << "RTNeural spectral front-end benchmarks:" << std::endl;
+    std::cout << "Usage: rtneural_spectral_bench <length> [--json <file>]" << std::endl;
+    std::cout << "    Compares computing log-mel features per frame with temporary buffers" << std::endl;
+    std::cout << "    against the streaming SpectralFrontEnd." << std::endl;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if(argc != 2 && argc != 4)
+    {
+        help();
+        return 1;
+    }
+
+    const auto length_seconds = std::atof(argv[1]);
+    const std::string json_file = argc == 4 ? argv[3] : "";
+
+    std::vector<bench_report::Result> results;
+    bench_all<float>(length_seconds, results);
+    bench_all<double>(length_seconds, results);
+
+    bench_report::print_table(results);
+
+    if(!json_file.empty() && !bench_report::write_json(json_file, "spectral", results))
+        return 1;
+
+    return 0;
+}
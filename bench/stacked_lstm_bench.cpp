@@ -0,0 +1,136 @@
+#include "bench_report.hpp"
+#include <RTNeural.h>
+#include <chrono>
+#include <random>
+
+namespace
+{
+using clock_t = std::chrono::high_resolution_clock;
+using second_t = std::chrono::duration<double>;
+
+nlohmann::json random_matrix(std::default_random_engine& generator, int rows, int cols)
+{
+    std::uniform_real_distribution<double> distribution(-0.5, 0.5);
+    auto matrix = nlohmann::json::array();
+    for(int i = 0; i < rows; ++i)
+    {
+        auto row = nlohmann::json::array();
+        for(int j = 0; j < cols; ++j)
+            row.push_back(distribution(generator));
+        matrix.push_back(row);
+    }
+    return matrix;
+}
+
+/** Creates a model json with `num_layers` LSTM layers, followed by a Dense layer with one output. */
+nlohmann::json stacked_model_json(int hidden_size, int num_layers)
+{
+    std::default_random_engine generator;
+
+    nlohmann::json model;
+    model["in_shape"] = { nullptr, nullptr, 1 };
+    model["layers"] = nlohmann::json::array();
+    for(int l = 0; l < num_layers; ++l)
+    {
+        nlohmann::json lstm;
+        lstm["type"] = "lstm";
+        lstm["activation"] = "";
+        lstm["shape"] = { nullptr, nullptr, hidden_size };
+        lstm["weights"] = { random_matrix(generator, l == 0 ? 1 : hidden_size, 4 * hidden_size),
+            random_matrix(generator, hidden_size, 4 * hidden_size),
+            random_matrix(generator, 1, 4 * hidden_size)[0] };
+        model["layers"].push_back(lstm);
+    }
+
+    nlohmann::json dense;
+    dense["type"] = "dense";
+    dense["activation"] = "";
+    dense["shape"] = { nullptr, nullptr, 1 };
+    dense["weights"] = { random_matrix(generator, hidden_size, 1), random_matrix(generator, 1, 1)[0] };
+    model["layers"].push_back(dense);
+
+    return model;
+}
+
+template <typename T>
+std::vector<T> generate_signal(size_t n_samples)
+{
+    std::default_random_engine generator;
+    std::uniform_real_distribution<T> distribution((T)-1, (T)1);
+
+    std::vector<T> signal(n_samples);
+    for(auto& x : signal)
+        x = distribution(generator);
+
+    return signal;
+}
+
+template <typename ModelType, typename T>
+double time_model(const nlohmann::json& modelJson, const std::vector<T>& signal)
+{
+    auto model = std::make_unique<ModelType>();
+    model->parseJson(modelJson);
+    model->reset();
+
+    auto start = clock_t::now();
+    for(const auto& x : signal)
+        model->forward(&x);
+    return std::chrono::duration_cast<second_t>(clock_t::now() - start).count();
+}
+
+template <typename T, int hidden_size, int num_layers, typename SeparateModel>
+void bench_stack(const std::vector<T>& signal, std::vector<bench_report::Result>& results)
+{
+    using StackedModel = RTNeural::ModelT<T, 1, 1,
+        RTNeural::StackedLSTMT<T, 1, hidden_size, num_layers>,
+        RTNeural::DenseT<T, hidden_size, 1>>;
+
+    const auto precision = std::is_same<T, float>::value ? "float" : "double";
+    const auto name = std::to_string(num_layers) + "x_lstm" + std::to_string(hidden_size);
+    const auto modelJson = stacked_model_json(hidden_size, num_layers);
+
+    results.push_back({ name, "separate", precision, signal.size(), time_model<SeparateModel>(modelJson, signal) });
+    results.push_back({ name, "stacked", precision, signal.size(), time_model<StackedModel>(modelJson, signal) });
+}
+
+template <typename T>
+void bench_all(double length_seconds, std::vector<bench_report::Result>& results)
+{
+    using namespace RTNeural;
+    const auto signal = generate_signal<T>(static_cast<size_t>(bench_report::audio_sample_rate * length_seconds));
+
+    bench_stack<T, 16, 2, ModelT<T, 1, 1, LSTMLayerT<T, 1, 16>, LSTMLayerT<T, 16, 16>, DenseT<T, 16, 1>>>(signal, results);
+    bench_stack<T, 32, 2, ModelT<T, 1, 1, LSTMLayerT<T, 1, 32>, LSTMLayerT<T, 32, 32>, DenseT<T, 32, 1>>>(signal, results);
+    bench_stack<T, 16, 3, ModelT<T, 1, 1, LSTMLayerT<T, 1, 16>, LSTMLayerT<T, 16, 16>, LSTMLayerT<T, 16, 16>, DenseT<T, 16, 1>>>(signal, results);
+}
+
+void help()
+{
+    std::cout << "RTNeural stacked LSTM benchmarks:" << std::endl;
+    std::cout << "Usage: rtneural_stacked_lstm_bench <length> [--json <file>]" << std::endl;
+    std::cout << "    Compares consecutive LSTMLayerTs against a fused StackedLSTMT." << std::endl;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if(argc != 2 && argc != 4)
+    {
+        help();
+        return 1;
+    }
+
+    const auto length_seconds = std::atof(argv[1]);
+    const std::string json_file = argc == 4 ? argv[3] : "";
+
+    std::vector<bench_report::Result> results;
+    bench_all<float>(length_seconds, results);
+    bench_all<double>(length_seconds, results);
+
+    bench_report::print_table(results);
+
+    if(!json_file.empty() && !bench_report::write_json(json_file, "stacked_lstm", results))
+        return 1;
+
+    return 0;
+}
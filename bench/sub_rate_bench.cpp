@@ -0,0 +1,132 @@
+#include "bench_report.hpp"
+#include <RTNeural.h>
+#include <chrono>
+#include <random>
+
+namespace
+{
+using clock_t = std::chrono::high_resolution_clock;
+using second_t = std::chrono::duration<double>;
+
+constexpr int hidden_size = 32;
+
+template <typename T>
+using ModelType = RTNeural::ModelT<T, 1, 1,
+    RTNeural::LSTMLayerT<T, 1, hidden_size>,
+    RTNeural::DenseT<T, hidden_size, 1>>;
+
+nlohmann::json random_matrix(std::default_random_engine& generator, int rows, int cols)
+{
+    std::uniform_real_distribution<double> distribution(-0.5, 0.5);
+    auto matrix = nlohmann::json::array();
+    for(int i = 0; i < rows; ++i)
+    {
+        auto row = nlohmann::json::array();
+        for(int j = 0; j < cols; ++j)
+            row.push_back(distribution(generator));
+        matrix.push_back(row);
+    }
+    return matrix;
+}
+
+nlohmann::json lstm_model_json()
+{
+    std::default_random_engine generator;
+
+    nlohmann::json lstm;
+    lstm["type"] = "lstm";
+    lstm["activation"] = "";
+    lstm["shape"] = { nullptr, nullptr, hidden_size };
+    lstm["weights"] = { random_matrix(generator, 1, 4 * hidden_size),
+        random_matrix(generator, hidden_size, 4 * hidden_size),
+        random_matrix(generator, 1, 4 * hidden_size)[0] };
+
+    nlohmann::json dense;
+    dense["type"] = "dense";
+    dense["activation"] = "";
+    dense["shape"] = { nullptr, nullptr, 1 };
+    dense["weights"] = { random_matrix(generator, hidden_size, 1), random_matrix(generator, 1, 1)[0] };
+
+    nlohmann::json model;
+    model["in_shape"] = { nullptr, nullptr, 1 };
+    model["layers"] = { lstm, dense };
+    return model;
+}
+
+template <typename T>
+std::vector<T> generate_signal(size_t n_samples)
+{
+    std::default_random_engine generator;
+    std::uniform_real_distribution<T> distribution((T)-1, (T)1);
+
+    std::vector<T> signal(n_samples);
+    for(auto& x : signal)
+        x = distribution(generator);
+
+    return signal;
+}
+
+template <typename ModelT, typename T>
+double time_model(ModelT& model, const std::vector<T>& signal)
+{
+    model.reset();
+    auto start = clock_t::now();
+    for(const auto& x : signal)
+        model.forward(&x);
+    return std::chrono::duration_cast<second_t>(clock_t::now() - start).count();
+}
+
+template <typename T>
+void bench_all(double length_seconds, std::vector<bench_report::Result>& results)
+{
+    const auto precision = std::is_same<T, float>::value ? "float" : "double";
+    const auto name = "lstm" + std::to_string(hidden_size);
+    const auto signal = generate_signal<T>(static_cast<size_t>(bench_report::audio_sample_rate * length_seconds));
+
+    auto model = std::make_unique<ModelType<T>>();
+    model->parseJson(lstm_model_json());
+    results.push_back({ name, "audio rate", precision, signal.size(), time_model(*model, signal) });
+
+    using Interpolation = RTNeural::SubRateInterpolation;
+    for(int factor : { 4, 16, 48 })
+    {
+        for(auto interpolation : { Interpolation::Linear, Interpolation::Cubic })
+        {
+            RTNeural::SubRateModel<T, ModelType<T>> subRate { *model, 1, 1, factor, interpolation };
+            const auto impl = "1/" + std::to_string(factor) + (interpolation == Interpolation::Linear ? " linear" : " cubic");
+            results.push_back({ name, impl, precision, signal.size(), time_model(subRate, signal) });
+        }
+    }
+}
+
+void help()
+{
+    std::cout << "RTNeural sub-rate benchmarks:" << std::endl;
+    std::cout << "Usage: rtneural_sub_rate_bench <length> [--json <file>]" << std::endl;
+    std::cout << "    Compares running an LSTM model at the audio rate against" << std::endl;
+    std::cout << "    running it at a fraction of the audio rate, with interpolated outputs." << std::endl;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if(argc != 2 && argc != 4)
+    {
+        help();
+        return 1;
+    }
+
+    const auto length_seconds = std::atof(argv[1]);
+    const std::string json_file = argc == 4 ? argv[3] : "";
+
+    std::vector<bench_report::Result> results;
+    bench_all<float>(length_seconds, results);
+    bench_all<double>(length_seconds, results);
+
+    bench_report::print_table(results);
+
+    if(!json_file.empty() && !bench_report::write_json(json_file, "sub_rate", results))
+        return 1;
+
+    return 0;
+}
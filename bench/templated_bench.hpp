@@ -2,24 +2,28 @@
 
 #include "bench_utils.hpp"
 #include "layer_creator.hpp"
+#include "perf_counters.hpp"
 #include <chrono>
 #include <RTNeural.h>
 
 #if MODELT_AVAILABLE
 
 double runTemplatedBench(const std::vector<vec_type>& signal, const size_t n_samples,
-    const std::string& layer_type, size_t in_size, size_t out_size)
+    const std::string& layer_type, size_t in_size, size_t out_size, PerfCounters& counters)
 {
     using namespace RTNeural;
     using clock_t = std::chrono::high_resolution_clock;
     using second_t = std::chrono::duration<double>;
 
-    auto run_layer = [=, &signal] (auto& layer) -> double
+    auto run_layer = [=, &signal, &counters] (auto& layer) -> double
     {
+        counters.start();
         auto start = clock_t::now();
         for(size_t i = 0; i < n_samples; ++i)
             layer.forward(signal[i].data());
-        return std::chrono::duration_cast<second_t>(clock_t::now() - start).count();
+        const auto duration = std::chrono::duration_cast<second_t>(clock_t::now() - start).count();
+        counters.stop();
+        return duration;
     };
 
     double duration = 10000.0;
@@ -24,6 +24,9 @@ def save_model_json(model, layers_to_skip=(keras.layers.InputLayer)):
         if isinstance(layer, keras.layers.Dense):
             return 'dense'
 
+        if isinstance(layer, keras.layers.Embedding):
+            return 'embedding'
+
         if isinstance(layer, keras.layers.Conv1D):
             return 'conv1d'
 
@@ -44,6 +47,10 @@ def save_model_json(model, layers_to_skip=(keras.layers.InputLayer)):
         if isinstance(layer, keras.layers.Activation):
             return 'activation'
 
+        # custom Snake layers, with one alpha per channel as their weights
+        if type(layer).__name__ == 'Snake':
+            return 'snake'
+
         return 'unknown'
 
     def get_layer_activation(layer):
@@ -67,6 +74,12 @@ def save_model_json(model, layers_to_skip=(keras.layers.InputLayer)):
 
         if layer.activation == keras.activations.elu:
             return 'elu'
+
+        if layer.activation in (tf.math.sin, tf.sin):
+            return 'sin'
+
+        if layer.activation in (tf.math.cos, tf.cos):
+            return 'cos'
         
         return ''
 
@@ -92,6 +105,11 @@ def save_model_json(model, layers_to_skip=(keras.layers.InputLayer)):
             layer_dict["num_filters_out"] = layer.output_shape[3]
             layer_dict["padding"] = str(layer.padding).lower()
 
+        # CIFG LSTMs (a LSTM subclass with `cifg = True`) have no forget gate,
+        # so their weights have the gates [input, candidate, output]
+        if layer_dict["type"] == "lstm" and getattr(layer, 'cifg', False):
+            layer_dict["cifg"] = True
+
         if layer_dict["type"] == "batchnorm":
             layer_dict["epsilon"] = layer.epsilon
 
@@ -109,11 +109,104 @@ int fastTanhTest(T limit)
     return result;
 }
 
+template <typename T>
+int fastSinTest(T limit)
+{
+    using namespace RTNeural;
+    constexpr int layerSize = 8;
+    constexpr int nIter = 1000;
+    constexpr T range = (T) 100;
+
+    auto testPeriodic = [=] (auto forwardFunc, const T (&test_outs)[layerSize], auto refFunc)
+    {
+        std::default_random_engine generator;
+        std::uniform_real_distribution<T> distribution(-range, range);
+
+        constexpr int layerSize = 8; // MSVC can't capture this in the lambda
+        T test_ins alignas(RTNEURAL_DEFAULT_ALIGNMENT) [layerSize];
+        T actual_outs[layerSize];
+
+        auto maxError = (T) 0;
+        auto maxErrorInput = (T) 0;
+        for(int i = 0; i < nIter; ++i)
+        {
+            // generate random input and reference
+            for(int n = 0; n < layerSize; ++n)
+            {
+                test_ins[n] = distribution(generator);
+                actual_outs[n] = refFunc(test_ins[n]);
+            }
+
+            // compute layer output
+            forwardFunc(test_ins);
+
+            // check for errors
+            for(int n = 0; n < layerSize; ++n)
+            {
+                auto error = std::abs(actual_outs[n] - test_outs[n]);
+                if(error > maxError)
+                {
+                    maxError = error;
+                    maxErrorInput = test_ins[n];
+                }
+            }
+        }
+
+        std::cout << "    Maximum error: " << maxError << ", at input value: " << maxErrorInput << std::endl;
+        if(maxError > limit)
+        {
+            std::cout << "    FAIL: Error is too high!" << std::endl;
+            return 1;
+        }
+
+        return 0;
+    };
+
+    auto stdSin = [] (T x) { return std::sin(x); };
+    auto stdCos = [] (T x) { return std::cos(x); };
+
+    int result = 0;
+    auto dtype = std::is_same<T, float>::value ? "float" : "double";
+
+    T test_outs alignas(RTNEURAL_DEFAULT_ALIGNMENT) [layerSize];
+    SinActivation<T> sinLayer { layerSize };
+    std::cout << "Testing SinActivation for data type " << dtype << std::endl;
+    result |= testPeriodic([&sinLayer, &test_outs] (const T (&test_ins)[layerSize])
+        {
+            sinLayer.forward(test_ins, test_outs);
+        }, test_outs, stdSin);
+
+    CosActivation<T> cosLayer { layerSize };
+    std::cout << "Testing CosActivation for data type " << dtype << std::endl;
+    result |= testPeriodic([&cosLayer, &test_outs] (const T (&test_ins)[layerSize])
+        {
+            cosLayer.forward(test_ins, test_outs);
+        }, test_outs, stdCos);
+
+    SinActivationT<T, layerSize> sinLayerT;
+    std::cout << "Testing SinActivationT for data type " << dtype << std::endl;
+    result |= testPeriodic([&sinLayerT] (const T (&test_ins)[layerSize])
+        {
+            sinLayerT.forward(test_ins);
+        }, sinLayerT.outs, stdSin);
+
+    CosActivationT<T, layerSize> cosLayerT;
+    std::cout << "Testing CosActivationT for data type " << dtype << std::endl;
+    result |= testPeriodic([&cosLayerT] (const T (&test_ins)[layerSize])
+        {
+            cosLayerT.forward(test_ins);
+        }, cosLayerT.outs, stdCos);
+
+    return result;
+}
+
 int approximationTests()
 {
     int result = 0;
     result |= fastTanhTest<float>(5.1e-5f);
     result |= fastTanhTest<double>(5.1e-5);
+    result |= fastSinTest<float>(1.0e-6f);
+    result |= fastSinTest<double>(1.0e-10);
 
     return result;
 }
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "json_fixtures.hpp"
+#include "load_csv.hpp"
+#include <RTNeural.h>
+#include <iostream>
+
+namespace batch_test
+{
+
+using TestType = double;
+
+/**
+ * Processes several segments of the LSTM test data (with different lengths)
+ * through a batch model, and checks that each stream matches the output of
+ * the regular model processing that segment on its own.
+ */
+int batch_model_test()
+{
+    std::cout << "TESTING BATCH MODEL..." << std::endl;
+
+    const std::string model_file = "models/lstm.json";
+    const std::string data_file = "test_data/lstm_x_python.csv";
+    constexpr double threshold = 1.0e-10;
+    constexpr int num_streams = 7;
+    constexpr int max_batch_size = 4; // smaller than num_streams, to test grouping
+
+    std::ifstream pythonX(data_file);
+    const auto xData = load_csv::loadFile<TestType>(pythonX);
+
+    std::vector<int> lengths(num_streams);
+    std::vector<const TestType*> inputs(num_streams);
+    for(int s = 0; s < num_streams; ++s)
+    {
+        lengths[s] = (int)xData.size() / (s + 2);
+        inputs[s] = xData.data() + s * 13;
+    }
+
+    std::vector<std::vector<TestType>> yBatch(num_streams);
+    std::vector<TestType*> outputs(num_streams);
+    for(int s = 0; s < num_streams; ++s)
+    {
+        yBatch[s].resize((size_t)lengths[s], (TestType)0);
+        outputs[s] = yBatch[s].data();
+    }
+
+    std::ifstream jsonStream(model_file, std::ifstream::binary);
+    nlohmann::json modelJson;
+    jsonStream >> modelJson;
+
+    auto batchModel = RTNeural::json_parser::parseJsonBatch<TestType>(modelJson, max_batch_size);
+    batchModel->process(inputs.data(), outputs.data(), lengths.data(), num_streams);
+
+    auto model = RTNeural::json_parser::parseJson<TestType>(modelJson);
+    size_t nErrs = 0;
+    TestType max_error = (TestType)0;
+    for(int s = 0; s < num_streams; ++s)
+    {
+        model->reset();
+        for(int n = 0; n < lengths[s]; ++n)
+        {
+            const auto yRef = model->forward(inputs[s] + n);
+            const auto err = std::abs(yRef - yBatch[s][(size_t)n]);
+            if(err > threshold)
+            {
+                max_error = std::max(err, max_error);
+                nErrs++;
+            }
+        }
+    }
+
+    if(nErrs > 0)
+    {
+        std::cout << "FAIL: " << nErrs << " errors!" << std::endl;
+        std::cout << "Maximum error: " << max_error << std::endl;
+        return 1;
+    }
+
+    // CIFG LSTMs have a different weight layout, so they must not be loaded as regular LSTMs
+    std::default_random_engine generator;
+    nlohmann::json cifgJson;
+    cifgJson["in_shape"] = { nullptr, nullptr, 1 };
+    cifgJson["layers"] = { json_fixtures::cifg_lstm_json(generator, 1, 8), json_fixtures::dense_json(generator, 8, 1, "") };
+    if(RTNeural::json_parser::parseJsonBatch<TestType>(cifgJson, max_batch_size) != nullptr)
+    {
+        std::cout << "FAIL: loaded a CIFG LSTM as a regular LSTM!" << std::endl;
+        return 1;
+    }
+
+    nlohmann::json unsupportedJson;
+    unsupportedJson["in_shape"] = { nullptr, nullptr, 1 };
+    unsupportedJson["layers"] = { json_fixtures::lstm_json(generator, 1, 8), json_fixtures::dense_json(generator, 8, 1, "") };
+    unsupportedJson["layers"][1]["type"] = "gru";
+    if(RTNeural::json_parser::parseJsonBatch<TestType>(unsupportedJson, max_batch_size) != nullptr)
+    {
+        std::cout << "FAIL: loaded a model with an unsupported layer type!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "SUCCESS" << std::endl;
+    return 0;
+}
+
+} // namespace batch_test
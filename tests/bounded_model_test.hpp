@@ -0,0 +1,187 @@
+#pragma once
+
+#include "json_fixtures.hpp"
+#include <RTNeural.h>
+#include <iostream>
+#include <random>
+
+namespace bounded_model_test
+{
+
+using TestType = double;
+
+constexpr int num_samples = 1000;
+
+using json_fixtures::random_matrix;
+using json_fixtures::cifg_lstm_json;
+using json_fixtures::dense_json;
+using json_fixtures::lstm_json;
+
+nlohmann::json activation_json(const std::string& activation, int size)
+{
+    nlohmann::json layer;
+    layer["type"] = "activation";
+    layer["activation"] = activation;
+    layer["shape"] = { nullptr, nullptr, size };
+    layer["weights"] = nlohmann::json::array();
+    return layer;
+}
+
+nlohmann::json model_json(int in_size, const nlohmann::json& layers)
+{
+    nlohmann::json model;
+    model["in_shape"] = { nullptr, nullptr, in_size };
+    model["layers"] = layers;
+    return model;
+}
+
+/** Runs a BoundedModel and a Model<T> loaded from the same json, and compares their outputs. */
+template <typename BoundedModelType>
+int check_model(BoundedModelType& model, const nlohmann::json& modelJson, const std::string& test_name)
+{
+    if(!model.parseJson(modelJson))
+    {
+        std::cout << "  " << test_name << " FAIL: model was not loaded!" << std::endl;
+        return 1;
+    }
+
+    auto refModel = RTNeural::json_parser::parseJson<TestType>(modelJson);
+    refModel->reset();
+    model.reset();
+
+    if(model.getInSize() != refModel->getInSize() || model.getOutSize() != refModel->getOutSize())
+    {
+        std::cout << "  " << test_name << " FAIL: wrong model sizes!" << std::endl;
+        return 1;
+    }
+
+    std::default_random_engine generator;
+    std::uniform_real_distribution<TestType> distribution(-1.0, 1.0);
+    std::vector<TestType> input((size_t)model.getInSize());
+
+    constexpr double threshold = 1.0e-12;
+    size_t nErrs = 0;
+    for(int n = 0; n < num_samples; ++n)
+    {
+        for(auto& x : input)
+            x = distribution(generator);
+
+        model.forward(input.data());
+        refModel->forward(input.data());
+        for(int i = 0; i < model.getOutSize(); ++i)
+        {
+            if(std::abs(model.getOutputs()[i] - refModel->getOutputs()[i]) > threshold)
+                nErrs++;
+        }
+    }
+
+    if(nErrs > 0)
+    {
+        std::cout << "  " << test_name << " FAIL: " << nErrs << " errors!" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+/** Loading a model should reset the state left over from the previous model. */
+template <typename BoundedModelType>
+int reload_test(BoundedModelType& model, const nlohmann::json& modelJson)
+{
+    const TestType x[] = { (TestType)0.5 };
+
+    model.parseJson(modelJson);
+    const auto yFresh = model.forward(x);
+    for(int n = 0; n < 100; ++n)
+        model.forward(x);
+
+    model.parseJson(modelJson);
+    const auto yReloaded = model.forward(x);
+    if(yReloaded != yFresh)
+    {
+        std::cout << "  reload FAIL: the state was not reset when loading the model!" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+int bounded_model_test()
+{
+    std::cout << "TESTING BOUNDED MODEL..." << std::endl;
+
+    std::default_random_engine generator;
+    int result = 0;
+
+    // one model type, loaded with models of different shapes
+    using ModelType = RTNeural::BoundedModel<TestType, 24, 6>;
+    auto model = std::make_unique<ModelType>();
+
+    result |= check_model(*model,
+        model_json(1, { dense_json(generator, 1, 8, "tanh"), lstm_json(generator, 8, 24), dense_json(generator, 24, 1, "") }),
+        "dense -> lstm -> dense");
+
+    result |= check_model(*model,
+        model_json(3, { lstm_json(generator, 3, 5), lstm_json(generator, 5, 13), dense_json(generator, 13, 4, "softmax") }),
+        "stacked lstm -> softmax");
+
+    result |= check_model(*model,
+        model_json(2, { dense_json(generator, 2, 16, "relu"), dense_json(generator, 16, 9, "elu"), dense_json(generator, 9, 7, ""),
+                          activation_json("sigmoid", 7), activation_json("tanh", 7), dense_json(generator, 7, 2, "") }),
+        "dense mlp with standalone activations");
+
+    // models that don't fit
+    auto tooWide = model_json(1, { dense_json(generator, 1, 32, "tanh"), dense_json(generator, 32, 1, "") });
+    if(model->parseJson(tooWide))
+    {
+        std::cout << "  FAIL: loaded a model with layers wider than max_size!" << std::endl;
+        result |= 1;
+    }
+
+    auto tooDeep = model_json(1, nlohmann::json::array());
+    tooDeep["layers"].push_back(dense_json(generator, 1, 4, ""));
+    for(int l = 0; l < 6; ++l)
+        tooDeep["layers"].push_back(dense_json(generator, 4, 4, "tanh"));
+    if(model->parseJson(tooDeep))
+    {
+        std::cout << "  FAIL: loaded a model with more than max_layers layers!" << std::endl;
+        result |= 1;
+    }
+
+    if(model->parseJson(model_json(1, { cifg_lstm_json(generator, 1, 8), dense_json(generator, 8, 1, "") })))
+    {
+        std::cout << "  FAIL: loaded a CIFG LSTM as a regular LSTM!" << std::endl;
+        result |= 1;
+    }
+
+    // a model that fails partway through loading should leave no layers behind
+    if(model->getNumLayers() != 0 || model->getOutSize() != 0 || model->getOutputs() == nullptr)
+    {
+        std::cout << "  FAIL: a partially loaded model was kept!" << std::endl;
+        result |= 1;
+    }
+
+    result |= reload_test(*model, model_json(1, { lstm_json(generator, 1, 8), dense_json(generator, 8, 1, "") }));
+
+    using SmallModelType = RTNeural::BoundedModel<TestType, 16, 4, 256>;
+    auto smallModel = std::make_unique<SmallModelType>();
+    if(smallModel->parseJson(model_json(1, { lstm_json(generator, 1, 16), dense_json(generator, 16, 1, "") })))
+    {
+        std::cout << "  FAIL: loaded a model with more than max_weights weights!" << std::endl;
+        result |= 1;
+    }
+
+    // the model should still work after failing to load another model
+    result |= check_model(*smallModel, model_json(1, { lstm_json(generator, 1, 4), dense_json(generator, 4, 1, "") }), "small model");
+
+    if(result != 0)
+    {
+        std::cout << "FAIL!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "SUCCESS" << std::endl;
+    return 0;
+}
+
+} // namespace bounded_model_test
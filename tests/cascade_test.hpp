@@ -0,0 +1,148 @@
+#pragma once
+
+#include "json_fixtures.hpp"
+#include <RTNeural.h>
+#include <iostream>
+#include <random>
+
+namespace cascade_test
+{
+
+using TestType = double;
+
+constexpr int in_size = 4;
+constexpr int num_classes = 3;
+constexpr int hidden_size = 12;
+
+using json_fixtures::random_matrix;
+
+template <typename T>
+RTNeural::Dense<T>* random_dense(std::default_random_engine& generator, int layer_in_size, int layer_out_size)
+{
+    auto* dense = new RTNeural::Dense<T>(layer_in_size, layer_out_size);
+    dense->setWeights(random_matrix<T>(generator, layer_out_size, layer_in_size));
+    auto bias = random_matrix<T>(generator, 1, layer_out_size)[0];
+    dense->setBias(bias.data());
+    return dense;
+}
+
+/** Dense -> Softmax */
+template <typename T>
+std::unique_ptr<RTNeural::Model<T>> small_classifier(std::default_random_engine& generator)
+{
+    auto model = std::make_unique<RTNeural::Model<T>>(in_size);
+    model->addLayer(random_dense<T>(generator, in_size, num_classes));
+    model->addLayer(new RTNeural::SoftmaxActivation<T>(num_classes));
+    return model;
+}
+
+/** LSTM -> Dense -> Softmax */
+template <typename T>
+std::unique_ptr<RTNeural::Model<T>> large_classifier(std::default_random_engine& generator)
+{
+    auto model = std::make_unique<RTNeural::Model<T>>(in_size);
+
+    auto* lstm = new RTNeural::LSTMLayer<T>(in_size, hidden_size);
+    lstm->setWVals(random_matrix<T>(generator, in_size, 4 * hidden_size));
+    lstm->setUVals(random_matrix<T>(generator, hidden_size, 4 * hidden_size));
+    lstm->setBVals(random_matrix<T>(generator, 1, 4 * hidden_size)[0]);
+    model->addLayer(lstm);
+
+    model->addLayer(random_dense<T>(generator, hidden_size, num_classes));
+    model->addLayer(new RTNeural::SoftmaxActivation<T>(num_classes));
+    return model;
+}
+
+/** Runs a model over every frame, and returns the outputs for each frame. */
+template <typename ModelType>
+std::vector<std::vector<TestType>> run_model(ModelType& model, const std::vector<std::vector<TestType>>& frames)
+{
+    std::vector<std::vector<TestType>> outputs;
+    model.reset();
+    for(const auto& frame : frames)
+    {
+        model.forward(frame.data());
+        outputs.emplace_back(model.getOutputs(), model.getOutputs() + num_classes);
+    }
+    return outputs;
+}
+
+bool outputs_match(const TestType* y, const std::vector<TestType>& yRef)
+{
+    constexpr double threshold = 1.0e-12;
+    for(int i = 0; i < num_classes; ++i)
+        if(std::abs(y[i] - yRef[(size_t)i]) > threshold)
+            return false;
+    return true;
+}
+
+/**
+ * Checks that the cascade returns the outputs of the small model when it
+ * is confident, and that the outputs of the large model on escalated steps
+ * match the large model running on every step (i.e. the state of the large
+ * model is kept consistent while it is skipped).
+ */
+int cascade_model_test()
+{
+    std::cout << "TESTING CASCADE MODEL..." << std::endl;
+
+    constexpr int num_frames = 2000;
+
+    std::default_random_engine generator;
+    auto smallModel = small_classifier<TestType>(generator);
+    auto largeModel = large_classifier<TestType>(generator);
+
+    const auto frames = random_matrix<TestType>(generator, num_frames, in_size);
+    const auto ySmall = run_model(*smallModel, frames);
+    const auto yLarge = run_model(*largeModel, frames);
+
+    // escalate about half of the steps
+    std::vector<TestType> confidences;
+    for(const auto& y : ySmall)
+        confidences.push_back(*std::max_element(y.begin(), y.end()));
+    std::nth_element(confidences.begin(), confidences.begin() + num_frames / 2, confidences.end());
+    const auto medianConfidence = confidences[num_frames / 2];
+
+    using CascadeType = RTNeural::CascadeModel<TestType, RTNeural::Model<TestType>, RTNeural::Model<TestType>>;
+    auto check_cascade = [&](TestType threshold, int history_length, const std::string& test_name)
+    {
+        CascadeType cascade { *smallModel, *largeModel, in_size, num_classes, threshold, history_length };
+        cascade.reset();
+
+        size_t nErrs = 0;
+        for(int n = 0; n < num_frames; ++n)
+        {
+            const auto* y = cascade.forward(frames[(size_t)n].data());
+            const auto& yRef = cascade.wasEscalated() ? yLarge[(size_t)n] : ySmall[(size_t)n];
+            if(!outputs_match(y, yRef))
+                nErrs++;
+        }
+
+        std::cout << "  " << test_name << ": escalation rate " << cascade.getEscalationRate() << std::endl;
+        if(nErrs > 0)
+            std::cout << "  FAIL: " << nErrs << " errors!" << std::endl;
+        return std::make_pair(nErrs, cascade.getEscalationRate());
+    };
+
+    int result = 0;
+
+    const auto neverEscalate = check_cascade((TestType)0, 0, "never escalate");
+    result |= neverEscalate.first > 0 || neverEscalate.second != 0.0;
+
+    const auto alwaysEscalate = check_cascade((TestType)2, 0, "always escalate");
+    result |= alwaysEscalate.first > 0 || alwaysEscalate.second != 1.0;
+
+    const auto someEscalate = check_cascade(medianConfidence, num_frames, "escalate with full history");
+    result |= someEscalate.first > 0 || someEscalate.second == 0.0 || someEscalate.second == 1.0;
+
+    if(result != 0)
+    {
+        std::cout << "FAIL!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "SUCCESS" << std::endl;
+    return 0;
+}
+
+} // namespace cascade_test
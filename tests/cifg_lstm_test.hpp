@@ -0,0 +1,188 @@
+#pragma once
+
+#include "json_fixtures.hpp"
+#include "load_csv.hpp"
+#include "test_configs.hpp"
+#include <RTNeural.h>
+#include <iostream>
+#include <random>
+
+namespace cifg_lstm_test
+{
+constexpr int hidden_size = 8;
+constexpr int num_samples = 2000;
+
+using json_fixtures::LSTMWeights;
+using json_fixtures::random_lstm_weights;
+using json_fixtures::set_lstm_weights;
+
+/**
+ * Returns the weights of a regular LSTM which matches a CIFG LSTM. Since
+ * sigmoid(-x) = 1 - sigmoid(x), the forget gate is the input gate with
+ * negated weights.
+ */
+std::vector<float> to_lstm_row(const std::vector<float>& row)
+{
+    std::vector<float> out;
+    out.insert(out.end(), row.begin(), row.begin() + hidden_size); // input
+    for(int k = 0; k < hidden_size; ++k)
+        out.push_back(-row[(size_t)k]); // forget
+    out.insert(out.end(), row.begin() + hidden_size, row.end()); // candidate, output
+    return out;
+}
+
+LSTMWeights to_lstm_weights(const LSTMWeights& weights)
+{
+    LSTMWeights lstm;
+    for(const auto& row : weights.W)
+        lstm.W.push_back(to_lstm_row(row));
+    for(const auto& row : weights.U)
+        lstm.U.push_back(to_lstm_row(row));
+    lstm.b = to_lstm_row(weights.b);
+    return lstm;
+}
+
+std::vector<float> input_signal(int in_size)
+{
+    std::default_random_engine generator;
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    std::vector<float> signal((size_t)(num_samples * in_size));
+    for(auto& x : signal)
+        x = distribution(generator);
+    return signal;
+}
+
+bool check_outputs(const float* expected, const float* actual, const std::string& what)
+{
+    for(int i = 0; i < hidden_size; ++i)
+    {
+        if(std::abs(expected[i] - actual[i]) > 1.0e-5f)
+        {
+            std::cout << "  " << what << " FAIL: output " << actual[i] << ", expected " << expected[i] << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/** A static CIFG LSTM should match the equivalent regular LSTM, with and without sample rate correction. */
+template <int in_size, RTNeural::SampleRateCorrectionMode mode, typename PrepareFunc>
+int static_test(const std::string& what, PrepareFunc&& prepare)
+{
+    const auto weights = random_lstm_weights(in_size, hidden_size, 3);
+    RTNeural::CIFGLSTMLayerT<float, in_size, hidden_size, mode> cifg;
+    RTNeural::LSTMLayerT<float, in_size, hidden_size, mode> lstm;
+    set_lstm_weights(cifg, weights);
+    set_lstm_weights(lstm, to_lstm_weights(weights));
+    prepare(cifg);
+    prepare(lstm);
+
+    const auto signal = input_signal(in_size);
+    float ins alignas(RTNEURAL_DEFAULT_ALIGNMENT)[in_size];
+    for(int n = 0; n < num_samples; ++n)
+    {
+        std::copy(signal.begin() + n * in_size, signal.begin() + (n + 1) * in_size, ins);
+        cifg.forward(ins);
+        lstm.forward(ins);
+        if(!check_outputs(lstm.outs, cifg.outs, what))
+            return 1;
+    }
+
+    return 0;
+}
+
+/** A dynamic CIFG LSTM should match the equivalent regular LSTM. */
+int dynamic_test()
+{
+    constexpr int in_size = 3;
+    const auto weights = random_lstm_weights(in_size, hidden_size, 3);
+    RTNeural::CIFGLSTMLayer<float> cifg(in_size, hidden_size);
+    RTNeural::LSTMLayer<float> lstm(in_size, hidden_size);
+    set_lstm_weights(cifg, weights);
+    set_lstm_weights(lstm, to_lstm_weights(weights));
+    cifg.reset();
+    lstm.reset();
+
+    const auto signal = input_signal(in_size);
+    float cifgOuts[hidden_size];
+    float lstmOuts[hidden_size];
+    for(int n = 0; n < num_samples; ++n)
+    {
+        cifg.forward(&signal[(size_t)(n * in_size)], cifgOuts);
+        lstm.forward(&signal[(size_t)(n * in_size)], lstmOuts);
+        if(!check_outputs(lstmOuts, cifgOuts, "dynamic"))
+            return 1;
+    }
+
+    return 0;
+}
+
+/** Layers with the "cifg" attribute should be loaded as CIFG LSTMs by both parsers. */
+int json_test()
+{
+    const auto weights = random_lstm_weights(1, hidden_size, 3);
+    const auto lstmWeights = to_lstm_weights(weights);
+
+    nlohmann::json modelJson;
+    modelJson["in_shape"] = { nullptr, nullptr, 1 };
+    modelJson["layers"] = nlohmann::json::array();
+    modelJson["layers"].push_back({ { "type", "lstm" }, { "activation", "" }, { "shape", { nullptr, nullptr, hidden_size } }, { "cifg", true },
+        { "weights", { weights.W, weights.U, weights.b } } });
+
+    auto model = RTNeural::json_parser::parseJson<float>(modelJson);
+    RTNeural::ModelT<float, 1, hidden_size, RTNeural::CIFGLSTMLayerT<float, 1, hidden_size>> modelT;
+    modelT.parseJson(modelJson);
+
+    RTNeural::LSTMLayerT<float, 1, hidden_size> lstm;
+    set_lstm_weights(lstm, lstmWeights);
+
+    if(model->layers.size() != 1 || model->layers[0]->getName() != "cifg_lstm")
+    {
+        std::cout << "  json FAIL: the layer was not loaded as a CIFG LSTM!" << std::endl;
+        return 1;
+    }
+
+    model->reset();
+    modelT.reset();
+    lstm.reset();
+    const auto signal = input_signal(1);
+    for(int n = 0; n < num_samples; ++n)
+    {
+        const float ins[] = { signal[(size_t)n] };
+        model->forward(ins);
+        modelT.forward(ins);
+        lstm.forward(ins);
+        if(!check_outputs(lstm.outs, model->getOutputs(), "json (Model)") || !check_outputs(lstm.outs, modelT.getOutputs(), "json (ModelT)"))
+            return 1;
+    }
+
+    return 0;
+}
+
+int cifg_lstm_test()
+{
+    std::cout << "TESTING CIFG LSTM..." << std::endl;
+    using Mode = RTNeural::SampleRateCorrectionMode;
+
+    int result = 0;
+    result |= dynamic_test();
+    result |= static_test<1, Mode::None>("static (1 input)", [](auto&) {});
+    result |= static_test<4, Mode::None>("static (4 inputs)", [](auto&) {});
+    result |= static_test<1, Mode::NoInterp>("sample rate correction (no interpolation)", [](auto& layer)
+        { layer.prepare(2); });
+    result |= static_test<4, Mode::LinInterp>("sample rate correction (linear interpolation)", [](auto& layer)
+        { layer.prepare(1.5f); });
+    result |= json_test();
+
+    if(result != 0)
+    {
+        std::cout << "FAIL!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "SUCCESS" << std::endl;
+    return 0;
+}
+
+} // namespace cifg_lstm_test
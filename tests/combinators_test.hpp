@@ -0,0 +1,152 @@
+#pragma once
+
+#include "json_fixtures.hpp"
+#include <RTNeural.h>
+#include <iostream>
+#include <random>
+
+namespace combinators_test
+{
+
+using TestType = double;
+
+constexpr int num_samples = 1000;
+
+using json_fixtures::random_matrix;
+using json_fixtures::dense_json;
+using json_fixtures::lstm_json;
+
+/**
+ * Dense(2 -> 8, tanh)
+ * -> Residual(Dense(8 -> 8, tanh))
+ * -> Concat(LSTM(8 -> 4), Dense(8 -> 4, tanh))
+ * -> Add(Dense(8 -> 1), LSTM(8 -> 4) -> Dense(4 -> 1))
+ */
+nlohmann::json combinators_model_json()
+{
+    std::default_random_engine generator;
+
+    nlohmann::json residual;
+    residual["type"] = "residual";
+    residual["shape"] = { nullptr, nullptr, 8 };
+    residual["layers"] = { dense_json(generator, 8, 8, "tanh") };
+
+    nlohmann::json concat;
+    concat["type"] = "parallel";
+    concat["merge"] = "concat";
+    concat["shape"] = { nullptr, nullptr, 8 };
+    concat["branches"] = { { { "layers", { lstm_json(generator, 8, 4) } } },
+        { { "layers", { dense_json(generator, 8, 4, "tanh") } } } };
+
+    nlohmann::json add;
+    add["type"] = "parallel";
+    add["merge"] = "add";
+    add["shape"] = { nullptr, nullptr, 1 };
+    add["branches"] = { { { "layers", { dense_json(generator, 8, 1, "") } } },
+        { { "layers", { lstm_json(generator, 8, 4), dense_json(generator, 4, 1, "") } } } };
+
+    nlohmann::json model;
+    model["in_shape"] = { nullptr, nullptr, 2 };
+    model["layers"] = { dense_json(generator, 2, 8, "tanh"), residual, concat, add };
+    return model;
+}
+
+/** Reference implementation: runs each block as a separate dynamic model, and merges the outputs by hand. */
+std::vector<TestType> process_reference(const nlohmann::json& modelJson, const std::vector<TestType>& x)
+{
+    using namespace RTNeural::json_parser;
+    const auto& layers = modelJson["layers"];
+
+    nlohmann::json inputJson;
+    inputJson["layers"] = { layers[0] };
+    auto input = parseJson<TestType>(getExpertJson(inputJson, 2));
+    auto residual = parseJson<TestType>(getExpertJson(layers[1], 8));
+    auto concat0 = parseJson<TestType>(getExpertJson(layers[2]["branches"][0], 8));
+    auto concat1 = parseJson<TestType>(getExpertJson(layers[2]["branches"][1], 8));
+    auto add0 = parseJson<TestType>(getExpertJson(layers[3]["branches"][0], 8));
+    auto add1 = parseJson<TestType>(getExpertJson(layers[3]["branches"][1], 8));
+
+    for(auto* model : { input.get(), residual.get(), concat0.get(), concat1.get(), add0.get(), add1.get() })
+        model->reset();
+
+    std::vector<TestType> y(x.size() / 2);
+    for(size_t n = 0; n < y.size(); ++n)
+    {
+        input->forward(&x[2 * n]);
+
+        TestType h[8];
+        residual->forward(input->getOutputs());
+        for(int i = 0; i < 8; ++i)
+            h[i] = input->getOutputs()[i] + residual->getOutputs()[i];
+
+        TestType c[8];
+        concat0->forward(h);
+        concat1->forward(h);
+        std::copy(concat0->getOutputs(), concat0->getOutputs() + 4, c);
+        std::copy(concat1->getOutputs(), concat1->getOutputs() + 4, c + 4);
+
+        y[n] = add0->forward(c) + add1->forward(c);
+    }
+
+    return y;
+}
+
+using ModelType = RTNeural::ModelT<TestType, 2, 1,
+    RTNeural::DenseT<TestType, 2, 8>,
+    RTNeural::TanhActivationT<TestType, 8>,
+    RTNeural::ResidualT<TestType,
+        RTNeural::DenseT<TestType, 8, 8>,
+        RTNeural::TanhActivationT<TestType, 8>>,
+    RTNeural::ConcatT<TestType,
+        RTNeural::LSTMLayerT<TestType, 8, 4>,
+        RTNeural::SequentialT<TestType,
+            RTNeural::DenseT<TestType, 8, 4>,
+            RTNeural::TanhActivationT<TestType, 4>>>,
+    RTNeural::ParallelT<TestType, RTNeural::ParallelMerge::Add,
+        RTNeural::DenseT<TestType, 8, 1>,
+        RTNeural::SequentialT<TestType,
+            RTNeural::LSTMLayerT<TestType, 8, 4>,
+            RTNeural::DenseT<TestType, 4, 1>>>>;
+
+int combinators_test()
+{
+    std::cout << "TESTING COMBINATORS..." << std::endl;
+
+    std::default_random_engine generator;
+    std::uniform_real_distribution<TestType> distribution(-1.0, 1.0);
+    std::vector<TestType> x(2 * num_samples);
+    for(auto& sample : x)
+        sample = distribution(generator);
+
+    const auto modelJson = combinators_model_json();
+    const auto yRef = process_reference(modelJson, x);
+
+    auto model = std::make_unique<ModelType>();
+    model->parseJson(modelJson);
+    model->reset();
+
+    constexpr double threshold = 1.0e-12;
+    size_t nErrs = 0;
+    TestType max_error = 0.0;
+    for(size_t n = 0; n < yRef.size(); ++n)
+    {
+        const auto err = std::abs(model->forward(&x[2 * n]) - yRef[n]);
+        if(err > threshold)
+        {
+            max_error = std::max(err, max_error);
+            nErrs++;
+        }
+    }
+
+    if(nErrs > 0)
+    {
+        std::cout << "FAIL: " << nErrs << " errors!" << std::endl;
+        std::cout << "Maximum error: " << max_error << std::endl;
+        return 1;
+    }
+
+    std::cout << "SUCCESS" << std::endl;
+    return 0;
+}
+
+} // namespace combinators_test
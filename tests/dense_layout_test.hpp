@@ -0,0 +1,89 @@
+#pragma once
+
+#include "json_fixtures.hpp"
+#include <RTNeural.h>
+#include <iostream>
+#include <random>
+
+namespace dense_layout_test
+{
+
+using TestType = double;
+
+constexpr int num_samples = 100;
+
+using json_fixtures::random_matrix;
+
+/** Checks that a DenseT layer matches the dynamic Dense layer, and uses the expected weights layout. */
+template <int in_size, int out_size>
+int dense_layout_test(bool expect_column_major)
+{
+    const auto test_name = std::to_string(in_size) + " -> " + std::to_string(out_size);
+
+    std::default_random_engine generator;
+    auto weights = random_matrix<TestType>(generator, out_size, in_size);
+    auto bias = random_matrix<TestType>(generator, 1, out_size)[0];
+
+    RTNeural::Dense<TestType> dense { in_size, out_size };
+    dense.setWeights(weights);
+    dense.setBias(bias.data());
+
+    RTNeural::DenseT<TestType, in_size, out_size> denseT;
+    denseT.setWeights(weights);
+    denseT.setBias(bias.data());
+
+    if(RTNEURAL_DENSE_COLUMN_MAJOR && denseT.column_major != expect_column_major)
+    {
+        std::cout << "  " << test_name << " FAIL: unexpected weights layout!" << std::endl;
+        return 1;
+    }
+
+    constexpr double threshold = 1.0e-12;
+    size_t nErrs = 0;
+    TestType ins alignas(RTNEURAL_DEFAULT_ALIGNMENT)[in_size];
+    TestType outs[out_size];
+    for(int n = 0; n < num_samples; ++n)
+    {
+        const auto x = random_matrix<TestType>(generator, 1, in_size)[0];
+        std::copy(x.begin(), x.end(), ins);
+
+        dense.forward(ins, outs);
+        denseT.forward(ins);
+        for(int i = 0; i < out_size; ++i)
+            if(std::abs(denseT.outs[i] - outs[i]) > threshold)
+                nErrs++;
+    }
+
+    if(nErrs > 0)
+    {
+        std::cout << "  " << test_name << " FAIL: " << nErrs << " errors!" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+int dense_layout_test()
+{
+    std::cout << "TESTING DENSE LAYOUTS..." << std::endl;
+
+    int result = 0;
+    result |= dense_layout_test<8, 128>(true);
+    result |= dense_layout_test<16, 32>(true);
+    result |= dense_layout_test<32, 33>(true);
+    result |= dense_layout_test<4, 64>(false);
+    result |= dense_layout_test<8, 16>(false);
+    result |= dense_layout_test<64, 1>(false);
+    result |= dense_layout_test<3, 5>(false);
+
+    if(result != 0)
+    {
+        std::cout << "FAIL!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "SUCCESS" << std::endl;
+    return 0;
+}
+
+} // namespace dense_layout_test
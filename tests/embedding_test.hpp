@@ -0,0 +1,209 @@
+#pragma once
+
+#include "json_fixtures.hpp"
+#include <RTNeural.h>
+#include <iostream>
+#include <random>
+
+namespace embedding_test
+{
+constexpr int num_categories = 4;
+constexpr int hidden_size = 8;
+constexpr int in_size = 1 + num_categories; // one audio input, followed by a one-hot category
+
+using json_fixtures::random_matrix;
+using json_fixtures::dense_json;
+
+/** A model with an audio input and a one-hot category input: dense -> tanh -> dense. */
+nlohmann::json one_hot_model_json()
+{
+    std::default_random_engine generator;
+    nlohmann::json model;
+    model["in_shape"] = { nullptr, nullptr, in_size };
+    model["layers"] = { dense_json(generator, in_size, hidden_size, "tanh"), dense_json(generator, hidden_size, 1, "") };
+    return model;
+}
+
+/** A model with a category index input: embedding -> dense. */
+nlohmann::json embedding_model_json()
+{
+    std::default_random_engine generator;
+    nlohmann::json embedding;
+    embedding["type"] = "embedding";
+    embedding["activation"] = "";
+    embedding["shape"] = { nullptr, nullptr, hidden_size };
+    embedding["weights"] = { random_matrix(generator, num_categories, hidden_size) };
+
+    nlohmann::json model;
+    model["in_shape"] = { nullptr, nullptr, 1 };
+    model["layers"] = { embedding, dense_json(generator, hidden_size, 1, "") };
+    return model;
+}
+
+/** The inputs at sample n: an audio signal, and a category which changes every 100 samples (with some gaps and blends). */
+void get_inputs(int n, float (&ins)[in_size])
+{
+    ins[0] = std::sin(0.01f * (float)n);
+    std::fill(ins + 1, ins + in_size, 0.0f);
+
+    const auto segment = n / 100;
+    if(segment % 5 == 3)
+        return; // no category
+
+    if(segment % 5 == 4)
+    {
+        ins[1] = 0.25f; // a blend of two categories
+        ins[3] = 0.75f;
+        return;
+    }
+
+    ins[1 + (segment * 3) % num_categories] = 1.0f;
+}
+
+/** The embedding layers should output the rows of their tables, with the index rounded and clamped. */
+int embedding_layer_test()
+{
+    std::default_random_engine generator;
+    const auto table = random_matrix(generator, num_categories, hidden_size).get<std::vector<std::vector<float>>>();
+
+    RTNeural::Embedding<float> embedding(num_categories, hidden_size);
+    embedding.setWeights(table);
+
+    RTNeural::EmbeddingT<float, num_categories, hidden_size> embeddingT;
+    embeddingT.setWeights(table);
+
+    int result = 0;
+    const std::pair<float, int> indices[] = { { 0.0f, 0 }, { 2.0f, 2 }, { 0.9f, 1 }, { 3.0f, 3 }, { 7.0f, 3 }, { -2.0f, 0 }, { 2.0f, 2 } };
+    for(const auto& index : indices)
+    {
+        const float ins[] = { index.first };
+        float outs[hidden_size];
+        embedding.forward(ins, outs);
+        embeddingT.forward(ins);
+
+        for(int i = 0; i < hidden_size; ++i)
+        {
+            const auto expected = table[(size_t)index.second][(size_t)i];
+            if(outs[i] != expected || embeddingT.outs[i] != expected)
+            {
+                std::cout << "  embedding FAIL at index " << index.first << std::endl;
+                result = 1;
+                break;
+            }
+        }
+    }
+
+    return result;
+}
+
+/** Models with one-hot inputs should match the plain dense model, with or without the rewrite. */
+int one_hot_test()
+{
+    const auto modelJson = one_hot_model_json();
+    auto plainModel = RTNeural::json_parser::parseJson<float>(modelJson);
+
+    auto oneHotJson = modelJson;
+    oneHotJson["one_hot_inputs"] = { { "start", 1 }, { "count", num_categories } };
+    auto oneHotModel = RTNeural::json_parser::parseJson<float>(oneHotJson);
+
+    const auto* oneHotDense = dynamic_cast<const RTNeural::OneHotDense<float>*>(oneHotModel->layers.front());
+    if(oneHotDense == nullptr)
+    {
+        std::cout << "  the loader did not rewrite the one-hot inputs!" << std::endl;
+        return 1;
+    }
+
+    RTNeural::ModelT<float, in_size, 1,
+        RTNeural::OneHotDenseT<float, in_size, hidden_size, 1, num_categories>,
+        RTNeural::TanhActivationT<float, hidden_size>,
+        RTNeural::DenseT<float, hidden_size, 1>>
+        modelT;
+    modelT.parseJson(modelJson);
+
+    float maxError = 0.0f;
+    for(int n = 0; n < 1000; ++n)
+    {
+        float ins alignas(RTNEURAL_DEFAULT_ALIGNMENT)[in_size];
+        get_inputs(n, ins);
+
+        const auto expected = plainModel->forward(ins);
+        maxError = std::max(maxError, std::abs(oneHotModel->forward(ins) - expected));
+        maxError = std::max(maxError, std::abs(modelT.forward(ins) - expected));
+    }
+
+    if(maxError > 1.0e-6f)
+    {
+        std::cout << "  one-hot dense FAIL: error " << maxError << std::endl;
+        return 1;
+    }
+
+    // if every input is one-hot, there is nothing left for the dense part, so the layer is kept as is
+    std::default_random_engine generator;
+    nlohmann::json allOneHotJson;
+    allOneHotJson["in_shape"] = { nullptr, nullptr, num_categories };
+    allOneHotJson["layers"] = { dense_json(generator, num_categories, hidden_size, "tanh"), dense_json(generator, hidden_size, 1, "") };
+    allOneHotJson["one_hot_inputs"] = { { "start", 0 }, { "count", num_categories } };
+    auto allOneHotModel = RTNeural::json_parser::parseJson<float>(allOneHotJson);
+    if(dynamic_cast<const RTNeural::OneHotDense<float>*>(allOneHotModel->layers.front()) != nullptr)
+    {
+        std::cout << "  the loader rewrote a layer where every input is one-hot!" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+/** An embedding model should match the same model with a one-hot input. */
+int embedding_model_test()
+{
+    const auto modelJson = embedding_model_json();
+    auto model = RTNeural::json_parser::parseJson<float>(modelJson);
+
+    RTNeural::ModelT<float, 1, 1,
+        RTNeural::EmbeddingT<float, num_categories, hidden_size>,
+        RTNeural::DenseT<float, hidden_size, 1>>
+        modelT;
+    modelT.parseJson(modelJson);
+
+    const auto table = modelJson["layers"][0]["weights"][0].get<std::vector<std::vector<float>>>();
+    const auto& dense = modelJson["layers"][1]["weights"];
+
+    int result = 0;
+    for(int category : { 0, 1, 3, 2, 2, 0 })
+    {
+        float expected = dense[1][0].get<float>();
+        for(int i = 0; i < hidden_size; ++i)
+            expected += table[(size_t)category][(size_t)i] * dense[0][(size_t)i][0].get<float>();
+
+        const float ins[] = { (float)category };
+        const auto error = std::max(std::abs(model->forward(ins) - expected), std::abs(modelT.forward(ins) - expected));
+        if(error > 1.0e-6f)
+        {
+            std::cout << "  embedding model FAIL for category " << category << ": error " << error << std::endl;
+            result = 1;
+        }
+    }
+
+    return result;
+}
+
+int embedding_test()
+{
+    std::cout << "TESTING EMBEDDING LAYERS..." << std::endl;
+
+    int result = 0;
+    result |= embedding_layer_test();
+    result |= one_hot_test();
+    result |= embedding_model_test();
+
+    if(result != 0)
+    {
+        std::cout << "FAIL!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "SUCCESS" << std::endl;
+    return 0;
+}
+
+} // namespace embedding_test
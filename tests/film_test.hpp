@@ -0,0 +1,208 @@
+#pragma once
+
+#include "json_fixtures.hpp"
+#include <RTNeural.h>
+#include <iostream>
+#include <random>
+
+namespace film_test
+{
+
+using TestType = double;
+
+constexpr int hidden_size = 8;
+constexpr int num_controls = 2;
+constexpr int num_samples = 1000;
+
+using json_fixtures::random_matrix;
+using json_fixtures::dense_json;
+
+/**
+ * Dense(1 -> 8) -> FiLM(8, tanh) -> Dense(8 -> 1),
+ * with FiLM conditioning: Dense(2 -> 8, tanh) -> Dense(8 -> 16)
+ */
+nlohmann::json film_model_json(unsigned seed = std::default_random_engine::default_seed)
+{
+    std::default_random_engine generator { seed };
+
+    nlohmann::json film;
+    film["type"] = "film";
+    film["activation"] = "tanh";
+    film["shape"] = { nullptr, nullptr, hidden_size };
+    film["num_controls"] = num_controls;
+    film["weights"] = nlohmann::json::array();
+    film["layers"] = { dense_json(generator, num_controls, hidden_size, "tanh"), dense_json(generator, hidden_size, 2 * hidden_size, "") };
+
+    nlohmann::json model;
+    model["in_shape"] = { nullptr, nullptr, 1 };
+    model["layers"] = { dense_json(generator, 1, hidden_size, ""), film, dense_json(generator, hidden_size, 1, "") };
+    return model;
+}
+
+using ConditioningType = RTNeural::ModelT<TestType, num_controls, 2 * hidden_size,
+    RTNeural::DenseT<TestType, num_controls, hidden_size>,
+    RTNeural::TanhActivationT<TestType, hidden_size>,
+    RTNeural::DenseT<TestType, hidden_size, 2 * hidden_size>>;
+
+using ModelType = RTNeural::ModelT<TestType, 1, 1,
+    RTNeural::DenseT<TestType, 1, hidden_size>,
+    RTNeural::FiLMT<TestType, hidden_size, ConditioningType>,
+    RTNeural::TanhActivationT<TestType, hidden_size>,
+    RTNeural::DenseT<TestType, hidden_size, 1>>;
+
+/** Reference implementation: computes the scale and shift with a separate model, and applies them by hand. */
+struct Reference
+{
+    explicit Reference(const nlohmann::json& modelJson)
+    {
+        using namespace RTNeural::json_parser;
+        const auto& layers = modelJson["layers"];
+
+        nlohmann::json inputJson;
+        inputJson["layers"] = { layers[0] };
+        input = parseJson<TestType>(getExpertJson(inputJson, 1));
+        conditioning = parseJson<TestType>(getExpertJson(layers[1], num_controls));
+
+        nlohmann::json outputJson;
+        outputJson["layers"] = { layers[2] };
+        output = parseJson<TestType>(getExpertJson(outputJson, hidden_size));
+    }
+
+    TestType forward(TestType x, const TestType* controls)
+    {
+        conditioning->forward(controls);
+        const auto* gammaBeta = conditioning->getOutputs();
+
+        input->forward(&x);
+        TestType h[hidden_size];
+        for(int i = 0; i < hidden_size; ++i)
+            h[i] = std::tanh(gammaBeta[i] * input->getOutputs()[i] + gammaBeta[hidden_size + i]);
+
+        return output->forward(h);
+    }
+
+    std::unique_ptr<RTNeural::Model<TestType>> input;
+    std::unique_ptr<RTNeural::Model<TestType>> conditioning;
+    std::unique_ptr<RTNeural::Model<TestType>> output;
+};
+
+/** Runs the model, with the controls changing every 100 samples, and checks that the conditioning only runs when they change. */
+template <typename ModelType, typename FiLMType>
+int check_model(ModelType& model, FiLMType& film, const nlohmann::json& modelJson, const std::vector<TestType>& x, const std::string& test_name)
+{
+    Reference reference { modelJson };
+
+    constexpr double threshold = 1.0e-12;
+    size_t nErrs = 0;
+    int numUpdates = 0;
+    TestType controls[num_controls] {};
+    for(size_t n = 0; n < x.size(); ++n)
+    {
+        if(n % 100 == 0)
+        {
+            controls[0] = (TestType)(n / 100) * 0.1;
+            controls[1] = (TestType)1 - controls[0];
+        }
+
+        if(film.setConditioning(controls))
+            numUpdates++;
+
+        const auto y = model.forward(&x[n]);
+        if(std::abs(y - reference.forward(x[n], controls)) > threshold)
+            nErrs++;
+    }
+
+    if(numUpdates != (int)x.size() / 100)
+    {
+        std::cout << "  " << test_name << " FAIL: conditioning ran " << numUpdates << " times!" << std::endl;
+        return 1;
+    }
+
+    if(nErrs > 0)
+    {
+        std::cout << "  " << test_name << " FAIL: " << nErrs << " errors!" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+/** Reloading the weights should recompute the scale and shift, even if the controls have not changed. */
+int reload_test(const std::vector<TestType>& x)
+{
+    const TestType controls[num_controls] = { (TestType)0.3, (TestType)0.7 };
+
+    auto model = std::make_unique<ModelType>();
+    model->parseJson(film_model_json());
+    model->get<1>().setConditioning(controls);
+
+    const auto otherJson = film_model_json(42);
+    model->parseJson(otherJson);
+    model->reset();
+    if(!model->get<1>().setConditioning(controls))
+    {
+        std::cout << "  reload FAIL: the conditioning did not run after loading new weights!" << std::endl;
+        return 1;
+    }
+
+    Reference reference { otherJson };
+    constexpr double threshold = 1.0e-12;
+    size_t nErrs = 0;
+    for(auto sample : x)
+    {
+        if(std::abs(model->forward(&sample) - reference.forward(sample, controls)) > threshold)
+            nErrs++;
+    }
+
+    if(nErrs > 0)
+    {
+        std::cout << "  reload FAIL: " << nErrs << " errors!" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+int film_test()
+{
+    std::cout << "TESTING FILM..." << std::endl;
+
+    std::default_random_engine generator;
+    std::uniform_real_distribution<TestType> distribution(-1.0, 1.0);
+    std::vector<TestType> x(num_samples);
+    for(auto& sample : x)
+        sample = distribution(generator);
+
+    const auto modelJson = film_model_json();
+    int result = 0;
+
+    auto dynamicModel = RTNeural::json_parser::parseJson<TestType>(modelJson);
+    dynamicModel->reset();
+    auto* film = dynamic_cast<RTNeural::FiLM<TestType>*>(dynamicModel->layers[1]);
+    if(film == nullptr)
+    {
+        std::cout << "  dynamic model FAIL: FiLM layer was not loaded!" << std::endl;
+        result |= 1;
+    }
+    else
+    {
+        result |= check_model(*dynamicModel, *film, modelJson, x, "dynamic model");
+    }
+
+    auto staticModel = std::make_unique<ModelType>();
+    staticModel->parseJson(modelJson);
+    staticModel->reset();
+    result |= check_model(*staticModel, staticModel->get<1>(), modelJson, x, "static model");
+    result |= reload_test(x);
+
+    if(result != 0)
+    {
+        std::cout << "FAIL!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "SUCCESS" << std::endl;
+    return 0;
+}
+
+} // namespace film_test
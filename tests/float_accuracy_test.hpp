@@ -0,0 +1,276 @@
+#pragma once
+
+#include "json_fixtures.hpp"
+#include "load_csv.hpp"
+#include "test_configs.hpp"
+#include <RTNeural.h>
+#include <iostream>
+#include <random>
+
+namespace float_accuracy_test
+{
+
+using json_fixtures::random_matrix;
+
+/** Summing many small values into a large one loses them in float, unless the sum is compensated. */
+int compensated_dot_product_test()
+{
+    constexpr int n = 10001;
+    std::vector<float> a((size_t)n, 1.0e-8f);
+    std::vector<float> b((size_t)n, 1.0f);
+    a[0] = 1.0f;
+
+    const auto expected = 1.0 + 1.0e-8 * (double)(n - 1);
+    const auto naiveError = std::abs((double)std::inner_product(a.begin(), a.end(), b.begin(), 0.0f) - expected);
+    const auto compensatedError = std::abs((double)RTNeural::compensated_dot_product(a.data(), b.data(), n) - expected);
+
+    if(compensatedError > 1.0e-7 || compensatedError > naiveError / 100.0)
+    {
+        std::cout << "  compensated dot product FAIL: error " << compensatedError << " (naive error " << naiveError << ")" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+/** Runs a float model against the reference data for one of the accuracy tests, at that test's threshold. */
+template <typename ModelType>
+int reference_test(ModelType& model, const std::string& test_name)
+{
+    const auto& test = tests.at(test_name);
+
+    std::ifstream jsonStream(test.model_file, std::ifstream::binary);
+    model.parseJson(jsonStream);
+    model.reset();
+
+    std::ifstream pythonX(test.x_data_file);
+    const auto xData = load_csv::loadFile<float>(pythonX);
+
+    std::ifstream pythonY(test.y_data_file);
+    const auto yRefData = load_csv::loadFile<float>(pythonY);
+
+    size_t nErrs = 0;
+    double max_error = 0.0;
+    for(size_t n = 0; n < xData.size(); ++n)
+    {
+        float input[] = { xData[n] };
+        const auto err = std::abs((double)model.forward(input) - (double)yRefData[n]);
+        max_error = std::max(err, max_error);
+        if(err > test.threshold)
+            nErrs++;
+    }
+
+    if(xData.empty() || nErrs > 0)
+    {
+        std::cout << "  " << test.name << " (float) FAIL: " << nErrs << " errors! Maximum error: " << max_error << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+/** A dynamic model, with the same `parseJson()` interface as ModelT. */
+struct DynamicModel
+{
+    void parseJson(std::ifstream& jsonStream) { model = RTNeural::json_parser::parseJson<float>(jsonStream); }
+    void reset() { model->reset(); }
+    float forward(const float* input) { return model->forward(input); }
+
+    std::unique_ptr<RTNeural::Model<float>> model;
+};
+
+/** A float LSTM should stay close to the same LSTM in double, over a long run. */
+int long_run_test()
+{
+    constexpr int hidden_size = 32;
+    constexpr int num_samples = 48000;
+
+    std::default_random_engine generator;
+    const auto W = random_matrix<double>(generator, 1, 4 * hidden_size, 0.4);
+    const auto U = random_matrix<double>(generator, hidden_size, 4 * hidden_size, 0.4);
+    const auto b = random_matrix<double>(generator, 1, 4 * hidden_size, 0.4)[0];
+    auto to_float = [](const std::vector<std::vector<double>>& matrix)
+    {
+        std::vector<std::vector<float>> out;
+        for(const auto& row : matrix)
+            out.emplace_back(row.begin(), row.end());
+        return out;
+    };
+
+    RTNeural::LSTMLayerT<double, 1, hidden_size> lstmDouble;
+    lstmDouble.setWVals(W);
+    lstmDouble.setUVals(U);
+    lstmDouble.setBVals(b);
+
+    RTNeural::LSTMLayerT<float, 1, hidden_size> lstmFloat;
+    lstmFloat.setWVals(to_float(W));
+    lstmFloat.setUVals(to_float(U));
+    lstmFloat.setBVals(to_float({ b })[0]);
+
+    double max_error = 0.0;
+    for(int n = 0; n < num_samples; ++n)
+    {
+        const auto x = std::sin(2.0 * 3.14159265358979323846 * 100.0 * (double)n / 48000.0);
+        const double xDouble[] = { x };
+        const float xFloat[] = { (float)x };
+        lstmDouble.forward(xDouble);
+        lstmFloat.forward(xFloat);
+
+        for(int i = 0; i < hidden_size; ++i)
+            max_error = std::max(max_error, std::abs((double)lstmFloat.outs[i] - lstmDouble.outs[i]));
+    }
+
+    if(max_error > 1.0e-6)
+    {
+        std::cout << "  long run FAIL: maximum error " << max_error << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * Gate sums where the first term is large and the rest are small: a float sum
+ * loses the small terms, unless it is compensated. Checks a fused LSTMDenseT
+ * against the same layer in double, with and without `RTNEURAL_COMPENSATED_SUMS`.
+ */
+int fused_compensated_sums_test()
+{
+    constexpr int in_size = 1000;
+    constexpr int hidden_size = 1;
+
+    // each gate: 1 * x_0 + 1e-8 * (x_1 + ... + x_999), with all x = 1
+    std::vector<std::vector<float>> W((size_t)in_size, std::vector<float>(4 * hidden_size, 1.0e-8f));
+    W[0] = std::vector<float>(4 * hidden_size, 1.0f);
+    auto setWeights = [&](auto& layer)
+    {
+        using T = std::remove_reference_t<decltype(layer.outs[0])>;
+        std::vector<std::vector<T>> WT;
+        for(const auto& row : W)
+            WT.emplace_back(row.begin(), row.end());
+        layer.setWVals(WT);
+        layer.setUVals(std::vector<std::vector<T>>(hidden_size, std::vector<T>(4 * hidden_size, (T)0)));
+        layer.setBVals(std::vector<T>(4 * hidden_size, (T)0));
+        layer.setWeights(std::vector<std::vector<T>>(1, std::vector<T>(hidden_size, (T)1)));
+        const T bias[] = { (T)0 };
+        layer.setBias(bias);
+    };
+    auto fusedFloat = std::make_unique<RTNeural::LSTMDenseT<float, in_size, hidden_size, 1>>();
+    auto fusedDouble = std::make_unique<RTNeural::LSTMDenseT<double, in_size, hidden_size, 1>>();
+    setWeights(*fusedFloat);
+    setWeights(*fusedDouble);
+
+    float xFloat alignas(RTNEURAL_DEFAULT_ALIGNMENT)[in_size];
+    double xDouble alignas(RTNEURAL_DEFAULT_ALIGNMENT)[in_size];
+    std::fill(std::begin(xFloat), std::end(xFloat), 1.0f);
+    std::fill(std::begin(xDouble), std::end(xDouble), 1.0);
+    fusedFloat->forward(xFloat);
+    fusedDouble->forward(xDouble);
+
+    // the small terms change the output by about 3.5e-6
+    const auto error = std::abs((double)fusedFloat->outs[0] - fusedDouble->outs[0]);
+    const bool compensated = RTNEURAL_COMPENSATED_SUMS != 0;
+    if(compensated ? error > 2.0e-7 : error < 1.0e-6)
+    {
+        std::cout << "  fused compensated sums FAIL: error " << error << " with compensated sums "
+                  << (compensated ? "on" : "off") << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * A cell state of 1, with increments of about 1e-8 per sample (with the forget gate at 1):
+ * a float cell state stays at 1, and a double cell state accumulates the increments.
+ * Checks a fused LSTMDenseT with and without `RTNEURAL_LSTM_DOUBLE_CELL_STATE`.
+ */
+int fused_double_cell_state_test()
+{
+    constexpr int num_samples = 10000;
+
+    // gates (i, f, c, o): i = sigmoid(40 x - 18.4), f = sigmoid(30), c = tanh(30), o = sigmoid(30)
+    RTNeural::LSTMDenseT<float, 1, 1, 1> fused;
+    fused.setWVals({ { 40.0f, 0.0f, 0.0f, 0.0f } });
+    fused.setUVals({ { 0.0f, 0.0f, 0.0f, 0.0f } });
+    fused.setBVals({ -18.4f, 30.0f, 30.0f, 30.0f });
+    fused.setWeights({ { 1.0f } });
+    const float bias[] = { 0.0f };
+    fused.setBias(bias);
+    fused.reset();
+
+    // the first sample loads c = 1, the rest add i = sigmoid(-18.4) to it
+    const float one[] = { 1.0f };
+    const float zero[] = { 0.0f };
+    fused.forward(one);
+    for(int n = 1; n < num_samples; ++n)
+        fused.forward(zero);
+
+    const auto increment = (double)(1.0f / (1.0f + std::exp(18.4f)));
+    const auto expected = 1.0 + (double)(num_samples - 1) * increment;
+    const auto cellState = (double)fused.getCellState()[0];
+    const bool doubleCell = RTNEURAL_LSTM_DOUBLE_CELL_STATE != 0;
+    if(doubleCell ? std::abs(cellState - expected) > 1.0e-9 : cellState != 1.0)
+    {
+        std::cout << "  fused double cell state FAIL: cell state " << cellState << " (increment " << increment
+                  << ") with double cell state " << (doubleCell ? "on" : "off") << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+int float_accuracy_test()
+{
+    std::cout << "TESTING FLOAT ACCURACY..." << std::endl;
+    std::cout << "  compensated sums: " << RTNEURAL_COMPENSATED_SUMS
+              << ", double LSTM cell state: " << RTNEURAL_LSTM_DOUBLE_CELL_STATE << std::endl;
+
+    int result = 0;
+    result |= compensated_dot_product_test();
+
+    DynamicModel denseModel, lstmModel, lstm1dModel;
+    result |= reference_test(denseModel, "dense");
+    result |= reference_test(lstmModel, "lstm");
+    result |= reference_test(lstm1dModel, "lstm_1d");
+
+    RTNeural::ModelT<float, 1, 1,
+        RTNeural::DenseT<float, 1, 8>,
+        RTNeural::TanhActivationT<float, 8>,
+        RTNeural::LSTMLayerT<float, 8, 8>,
+        RTNeural::DenseT<float, 8, 1>>
+        lstmModelT;
+    result |= reference_test(lstmModelT, "lstm");
+
+    RTNeural::ModelT<float, 1, 1,
+        RTNeural::LSTMLayerT<float, 1, 8>,
+        RTNeural::DenseT<float, 8, 1>>
+        lstm1dModelT;
+    result |= reference_test(lstm1dModelT, "lstm_1d");
+
+    // fused LSTM -> Dense layers
+    RTNeural::ModelT<float, 1, 1,
+        RTNeural::DenseT<float, 1, 8>,
+        RTNeural::TanhActivationT<float, 8>,
+        RTNeural::LSTMDenseT<float, 8, 8, 1>>
+        lstmModelFused;
+    result |= reference_test(lstmModelFused, "lstm");
+
+    RTNeural::ModelT<float, 1, 1, RTNeural::LSTMDenseT<float, 1, 8, 1>> lstm1dModelFused;
+    result |= reference_test(lstm1dModelFused, "lstm_1d");
+
+    result |= fused_compensated_sums_test();
+    result |= fused_double_cell_state_test();
+    result |= long_run_test();
+
+    if(result != 0)
+    {
+        std::cout << "FAIL!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "SUCCESS" << std::endl;
+    return 0;
+}
+
+} // namespace float_accuracy_test
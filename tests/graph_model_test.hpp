@@ -0,0 +1,319 @@
+#pragma once
+
+#include "json_fixtures.hpp"
+#include <RTNeural.h>
+#include <iostream>
+#include <random>
+
+namespace graph_model_test
+{
+
+using TestType = double;
+
+constexpr int num_samples = 1000;
+
+using json_fixtures::random_matrix;
+using json_fixtures::dense_json;
+using json_fixtures::lstm_json;
+
+nlohmann::json model_json(int in_size, const nlohmann::json& layers)
+{
+    nlohmann::json model;
+    model["in_shape"] = { nullptr, nullptr, in_size };
+    model["layers"] = layers;
+    return model;
+}
+
+nlohmann::json layers_node(const std::string& name, const nlohmann::json& inputs, const nlohmann::json& layers)
+{
+    nlohmann::json node;
+    node["name"] = name;
+    node["inputs"] = inputs;
+    node["layers"] = layers;
+    return node;
+}
+
+nlohmann::json merge_node(const std::string& name, const std::string& type, const nlohmann::json& inputs)
+{
+    nlohmann::json node;
+    node["name"] = name;
+    node["type"] = type;
+    node["inputs"] = inputs;
+    return node;
+}
+
+std::vector<TestType> random_signal(int size)
+{
+    std::default_random_engine generator;
+    std::uniform_real_distribution<TestType> distribution(-1.0, 1.0);
+
+    std::vector<TestType> signal((size_t)size);
+    for(auto& x : signal)
+        x = distribution(generator);
+    return signal;
+}
+
+int compare(const std::vector<TestType>& actual, const std::vector<TestType>& expected, const std::string& test_name)
+{
+    constexpr double threshold = 1.0e-12;
+    size_t nErrs = 0;
+    for(size_t i = 0; i < expected.size(); ++i)
+    {
+        if(std::abs(actual[i] - expected[i]) > threshold)
+            nErrs++;
+    }
+
+    if(actual.size() != expected.size() || nErrs > 0)
+    {
+        std::cout << "  " << test_name << " FAIL: " << nErrs << " errors!" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+/** A sequential model json should load as a graph with a single chain. */
+int sequential_test(std::default_random_engine& generator)
+{
+    const auto modelJson = model_json(1, { dense_json(generator, 1, 8, "tanh"), lstm_json(generator, 8, 8), dense_json(generator, 8, 1, "") });
+
+    auto graph = RTNeural::json_parser::parseGraphJson<TestType>(modelJson);
+    auto refModel = RTNeural::json_parser::parseJson<TestType>(modelJson);
+    graph->reset();
+    refModel->reset();
+
+    if(graph->getNumNodes() != 1 || graph->getInSize() != 1 || graph->getOutSize() != 1)
+    {
+        std::cout << "  sequential FAIL: wrong graph structure!" << std::endl;
+        return 1;
+    }
+
+    const auto input = random_signal(num_samples);
+    std::vector<TestType> actual, expected;
+    for(const auto& x : input)
+    {
+        actual.push_back(graph->forward(&x));
+        expected.push_back(refModel->forward(&x));
+    }
+
+    return compare(actual, expected, "sequential");
+}
+
+/**
+ * Two inputs, a residual add, a gating multiply, and a concatenation:
+ *
+ * audio, control -> front -> lstm -> sum -> gated -> cat -> out
+ *                        \-> skip -/      /        /
+ * control -> gate -----------------------/        /
+ * front ----------------------------------------/
+ */
+int multi_branch_test(std::default_random_engine& generator)
+{
+    const auto front = dense_json(generator, 3, 8, "tanh");
+    const auto lstm = lstm_json(generator, 8, 8);
+    const auto skip = dense_json(generator, 8, 8, "");
+    const auto gate = dense_json(generator, 2, 8, "sigmoid");
+    const auto out = dense_json(generator, 16, 1, "");
+
+    nlohmann::json graphJson;
+    graphJson["inputs"] = { { { "name", "audio" }, { "shape", { nullptr, nullptr, 1 } } },
+        { { "name", "control" }, { "shape", { nullptr, nullptr, 2 } } } };
+
+    // listed out of order, to check the topological sort
+    graphJson["nodes"] = {
+        layers_node("out", { "cat" }, nlohmann::json::array({ out })),
+        merge_node("cat", "concat", { "gated", "front" }),
+        merge_node("gated", "multiply", { "sum", "gate" }),
+        merge_node("sum", "add", { "lstm", "skip" }),
+        layers_node("front", { "audio", "control" }, nlohmann::json::array({ front })),
+        layers_node("lstm", { "front" }, nlohmann::json::array({ lstm })),
+        layers_node("skip", { "front" }, nlohmann::json::array({ skip })),
+        layers_node("gate", { "control" }, nlohmann::json::array({ gate })),
+    };
+    graphJson["outputs"] = { "out", "gated" };
+
+    auto graph = RTNeural::json_parser::parseGraphJson<TestType>(graphJson);
+    if(graph == nullptr || graph->getInSize() != 3 || graph->getOutSize() != 9)
+    {
+        std::cout << "  multi-branch FAIL: wrong graph structure!" << std::endl;
+        return 1;
+    }
+
+    // "sum" accumulates into the output of "lstm", and "gated" into the output of "sum"
+    if(!graph->isInPlace(4) || !graph->isInPlace(5))
+    {
+        std::cout << "  multi-branch FAIL: wrong in-place merges!" << std::endl;
+        return 1;
+    }
+
+    // reference: run each branch as a separate model
+    auto frontModel = RTNeural::json_parser::parseJson<TestType>(model_json(3, nlohmann::json::array({ front })));
+    auto lstmModel = RTNeural::json_parser::parseJson<TestType>(model_json(8, nlohmann::json::array({ lstm })));
+    auto skipModel = RTNeural::json_parser::parseJson<TestType>(model_json(8, nlohmann::json::array({ skip })));
+    auto gateModel = RTNeural::json_parser::parseJson<TestType>(model_json(2, nlohmann::json::array({ gate })));
+    auto outModel = RTNeural::json_parser::parseJson<TestType>(model_json(16, nlohmann::json::array({ out })));
+    lstmModel->reset();
+    graph->reset();
+
+    const auto input = random_signal(3 * num_samples);
+    std::vector<TestType> actual, expected;
+    for(int n = 0; n < num_samples; ++n)
+    {
+        const auto* x = input.data() + 3 * n;
+
+        graph->forward(x);
+        actual.insert(actual.end(), graph->getOutputs(), graph->getOutputs() + graph->getOutSize());
+
+        frontModel->forward(x);
+        lstmModel->forward(frontModel->getOutputs());
+        skipModel->forward(frontModel->getOutputs());
+        gateModel->forward(x + 1);
+
+        TestType cat[16];
+        for(int i = 0; i < 8; ++i)
+        {
+            cat[i] = (lstmModel->getOutputs()[i] + skipModel->getOutputs()[i]) * gateModel->getOutputs()[i];
+            cat[8 + i] = frontModel->getOutputs()[i];
+        }
+
+        expected.push_back(outModel->forward(cat));
+        expected.insert(expected.end(), cat, cat + 8);
+    }
+
+    return compare(actual, expected, "multi-branch");
+}
+
+/** processBlock() with worker threads should match sample-by-sample processing. */
+int block_test(std::default_random_engine& generator)
+{
+    // four parallel LSTM branches, summed
+    nlohmann::json graphJson;
+    graphJson["in_shape"] = { nullptr, nullptr, 1 };
+    graphJson["nodes"] = nlohmann::json::array();
+    for(int b = 0; b < 4; ++b)
+    {
+        const auto name = "branch" + std::to_string(b);
+        graphJson["nodes"].push_back(layers_node(name, { "input" }, { lstm_json(generator, 1, 8), dense_json(generator, 8, 1, "") }));
+    }
+    graphJson["nodes"].push_back(merge_node("sum", "add", { "branch0", "branch1", "branch2", "branch3" }));
+
+    auto refGraph = RTNeural::json_parser::parseGraphJson<TestType>(graphJson);
+    refGraph->reset();
+
+    const auto input = random_signal(num_samples);
+    std::vector<TestType> expected;
+    for(const auto& x : input)
+        expected.push_back(refGraph->forward(&x));
+
+    int result = 0;
+    for(int num_threads : { 1, 2, 4 })
+    {
+        auto graph = RTNeural::json_parser::parseGraphJson<TestType>(graphJson, 64);
+        graph->setNumThreads(num_threads);
+        graph->reset();
+
+        // uneven block sizes, some larger than the compiled block size
+        std::vector<TestType> actual(input.size());
+        for(int start = 0, block = 1; start < num_samples; start += block, block = block * 3 + 1)
+        {
+            const auto n = std::min(block, num_samples - start);
+            graph->processBlock(input.data() + start, actual.data() + start, n);
+        }
+
+        result |= compare(actual, expected, "block (" + std::to_string(num_threads) + " threads)");
+    }
+
+    return result;
+}
+
+/** A long chain of nodes should only need a couple of buffers. */
+int liveness_test(std::default_random_engine& generator)
+{
+    nlohmann::json graphJson;
+    graphJson["in_shape"] = { nullptr, nullptr, 4 };
+    graphJson["nodes"] = nlohmann::json::array();
+    std::string prev = "input";
+    for(int i = 0; i < 8; ++i)
+    {
+        const auto name = "node" + std::to_string(i);
+        graphJson["nodes"].push_back(layers_node(name, { prev }, nlohmann::json::array({ dense_json(generator, 4, 4, "tanh") })));
+        prev = name;
+    }
+
+    auto graph = RTNeural::json_parser::parseGraphJson<TestType>(graphJson);
+    if(graph->getNumLevels() != 8 || graph->getNumBuffers() > 3)
+    {
+        std::cout << "  liveness FAIL: " << graph->getNumBuffers() << " buffers for a chain of 8 nodes!" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+int invalid_graph_test(std::default_random_engine& generator)
+{
+    int result = 0;
+
+    nlohmann::json cycleJson;
+    cycleJson["in_shape"] = { nullptr, nullptr, 4 };
+    cycleJson["nodes"] = {
+        merge_node("a", "add", { "input", "b" }),
+        layers_node("b", { "a" }, nlohmann::json::array({ dense_json(generator, 4, 4, "") })),
+    };
+    if(RTNeural::json_parser::parseGraphJson<TestType>(cycleJson) != nullptr)
+    {
+        std::cout << "  FAIL: loaded a graph with a cycle!" << std::endl;
+        result |= 1;
+    }
+
+    nlohmann::json missingJson;
+    missingJson["in_shape"] = { nullptr, nullptr, 4 };
+    missingJson["nodes"] = nlohmann::json::array({ merge_node("a", "add", { "input", "nothing" }) });
+    if(RTNeural::json_parser::parseGraphJson<TestType>(missingJson) != nullptr)
+    {
+        std::cout << "  FAIL: loaded a graph with a missing input!" << std::endl;
+        result |= 1;
+    }
+
+    for(const auto* type : { "add", "multiply" })
+    {
+        nlohmann::json mismatchJson;
+        mismatchJson["in_shape"] = { nullptr, nullptr, 4 };
+        mismatchJson["nodes"] = {
+            layers_node("wide", { "input" }, nlohmann::json::array({ dense_json(generator, 4, 8, "") })),
+            merge_node("a", type, { "input", "wide" }),
+        };
+        if(RTNeural::json_parser::parseGraphJson<TestType>(mismatchJson) != nullptr)
+        {
+            std::cout << "  FAIL: loaded a graph with " << type << " inputs of different sizes!" << std::endl;
+            result |= 1;
+        }
+    }
+
+    return result;
+}
+
+int graph_model_test()
+{
+    std::cout << "TESTING GRAPH MODEL..." << std::endl;
+
+    std::default_random_engine generator;
+    int result = 0;
+
+    result |= sequential_test(generator);
+    result |= multi_branch_test(generator);
+    result |= block_test(generator);
+    result |= liveness_test(generator);
+    result |= invalid_graph_test(generator);
+
+    if(result != 0)
+    {
+        std::cout << "FAIL!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "SUCCESS" << std::endl;
+    return 0;
+}
+
+} // namespace graph_model_test
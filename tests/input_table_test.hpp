@@ -0,0 +1,158 @@
+#pragma once
+
+#include "load_csv.hpp"
+#include "test_configs.hpp"
+#include <RTNeural.h>
+#include <iostream>
+
+namespace input_table_test
+{
+
+/** Returns the largest error of a model against the reference outputs for one of the accuracy tests. */
+template <typename ForwardFn>
+double reference_error(const TestConfig& test, ForwardFn&& forward)
+{
+    std::ifstream pythonX(test.x_data_file);
+    const auto xData = load_csv::loadFile<float>(pythonX);
+
+    std::ifstream pythonY(test.y_data_file);
+    const auto yRefData = load_csv::loadFile<float>(pythonY);
+
+    if(xData.empty())
+        return std::numeric_limits<double>::max();
+
+    double max_error = 0.0;
+    for(size_t n = 0; n < xData.size(); ++n)
+    {
+        const float input[] = { xData[n] };
+        max_error = std::max(max_error, std::abs((double)forward(input) - (double)yRefData[n]));
+    }
+
+    return max_error;
+}
+
+/**
+ * Loads a dynamic model with an input table, and reports the error of the table against the
+ * reference outputs, which should still be within the threshold of the reference test.
+ */
+int dynamic_test(const std::string& test_name, RTNeural::InputTableOptions<float> options, int expected_layers)
+{
+    const auto& test = tests.at(test_name);
+    std::ifstream jsonStream(test.model_file, std::ifstream::binary);
+    auto model = RTNeural::json_parser::parseJson<float>(jsonStream, options);
+    model->reset();
+
+    const auto* table = dynamic_cast<const RTNeural::InputTable<float>*>(model->layers.front());
+    if(expected_layers == 0)
+    {
+        if(table != nullptr)
+        {
+            std::cout << "  " << test.name << ": no input table expected!" << std::endl;
+            return 1;
+        }
+
+        return 0;
+    }
+
+    if(table == nullptr || table->getNumLayers() != expected_layers)
+    {
+        std::cout << "  " << test.name << ": expected an input table of " << expected_layers << " layers!" << std::endl;
+        return 1;
+    }
+
+    const auto error = reference_error(test, [&](const float* input)
+        { return model->forward(input); });
+    std::cout << "  " << test.name << " (dynamic): table error " << table->getMaxError() << ", error vs. test data " << error << std::endl;
+
+    if(error > test.threshold)
+    {
+        std::cout << "  " << test.name << " FAIL: error should be less than " << test.threshold << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+/** A ModelT with an InputTableT should load from the same json, and match the reference outputs. */
+int static_test()
+{
+    const auto& test = tests.at("lstm");
+
+    RTNeural::ModelT<float, 1, 1,
+        RTNeural::InputTableT<float, 4096,
+            RTNeural::DenseT<float, 1, 8>,
+            RTNeural::TanhActivationT<float, 8>>,
+        RTNeural::LSTMLayerT<float, 8, 8>,
+        RTNeural::DenseT<float, 8, 1>>
+        model;
+
+    model.get<0>().setRange(-10.0f, 10.0f);
+    std::ifstream jsonStream(test.model_file, std::ifstream::binary);
+    model.parseJson(jsonStream);
+    model.reset();
+
+    const auto error = reference_error(test, [&](const float* input)
+        { return model.forward(input); });
+    std::cout << "  " << test.name << " (static): table error " << model.get<0>().getMaxError() << ", error vs. test data " << error << std::endl;
+
+    if(error > test.threshold)
+    {
+        std::cout << "  " << test.name << " FAIL: error should be less than " << test.threshold << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+/** Inputs outside of the table should be computed exactly by the wrapped layers. */
+int out_of_range_test()
+{
+    RTNeural::InputTableT<float, 16, RTNeural::DenseT<float, 1, 4>, RTNeural::TanhActivationT<float, 4>> table;
+    const std::vector<std::vector<float>> weights { { 0.5f }, { -1.0f }, { 2.0f }, { 0.1f } };
+    float bias[] = { 0.1f, 0.2f, -0.3f, 0.0f };
+    table.get<0>().setWeights(weights);
+    table.get<0>().setBias(bias);
+    table.tabulate();
+
+    int result = 0;
+    for(float x : { -5.0f, -0.3f, 0.7f, 3.0f })
+    {
+        const float ins[] = { x };
+        table.forward(ins);
+        for(int i = 0; i < 4; ++i)
+        {
+            const auto expected = std::tanh(weights[(size_t)i][0] * x + bias[i]);
+            const auto tolerance = std::abs(x) > 1.0f ? 1.0e-7f : 2.0e-2f; // coarse table inside [-1, 1], exact outside
+            if(std::abs(table.outs[i] - expected) > tolerance)
+            {
+                std::cout << "  input table FAIL at x = " << x << ": " << table.outs[i] << ", expected " << expected << std::endl;
+                result = 1;
+            }
+        }
+    }
+
+    return result;
+}
+
+int input_table_test()
+{
+    std::cout << "TESTING INPUT TABLES..." << std::endl;
+
+    int result = 0;
+    result |= dynamic_test("lstm", { -10.0f, 10.0f, 4096 }, 2);
+    result |= dynamic_test("dense", { -500.0f, 500.0f, 65536 }, 9);
+    result |= dynamic_test("lstm_1d", {}, 0);
+    result |= static_test();
+    result |= out_of_range_test();
+
+    if(result != 0)
+    {
+        std::cout << "FAIL!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "SUCCESS" << std::endl;
+    return 0;
+}
+
+} // namespace input_table_test
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <RTNeural.h>
+#include <random>
+#include <string>
+#include <vector>
+
+/** Random weights, and builders for model json with random weights, shared by the tests. */
+namespace json_fixtures
+{
+
+/** Returns a [rows][cols] json matrix of random values in [-range, range]. */
+inline nlohmann::json random_matrix(std::default_random_engine& generator, int rows, int cols, double range = 0.5)
+{
+    std::uniform_real_distribution<double> distribution(-range, range);
+    auto matrix = nlohmann::json::array();
+    for(int i = 0; i < rows; ++i)
+    {
+        auto row = nlohmann::json::array();
+        for(int j = 0; j < cols; ++j)
+            row.push_back(distribution(generator));
+        matrix.push_back(row);
+    }
+    return matrix;
+}
+
+/** Returns a [rows][cols] matrix of random values in [-range, range]. */
+template <typename T>
+inline std::vector<std::vector<T>> random_matrix(std::default_random_engine& generator, int rows, int cols, T range = (T)1)
+{
+    std::uniform_real_distribution<T> distribution(-range, range);
+    std::vector<std::vector<T>> matrix((size_t)rows, std::vector<T>((size_t)cols));
+    for(auto& row : matrix)
+        for(auto& x : row)
+            x = distribution(generator);
+    return matrix;
+}
+
+/** The kernel, recurrent, and bias weights of a LSTM layer, as passed to `setWVals()`, `setUVals()`, and `setBVals()`. */
+struct LSTMWeights
+{
+    std::vector<std::vector<float>> W;
+    std::vector<std::vector<float>> U;
+    std::vector<float> b;
+};
+
+/** Returns random weights in [-range, range] for a LSTM layer with `num_gates` gates (3 for a CIFG LSTM). */
+inline LSTMWeights random_lstm_weights(int in_size, int hidden_size, int num_gates = 4, float range = 0.5f)
+{
+    std::default_random_engine generator;
+    return { random_matrix<float>(generator, in_size, num_gates * hidden_size, range),
+        random_matrix<float>(generator, hidden_size, num_gates * hidden_size, range),
+        random_matrix<float>(generator, 1, num_gates * hidden_size, range)[0] };
+}
+
+template <typename LayerType>
+void set_lstm_weights(LayerType& layer, const LSTMWeights& weights)
+{
+    layer.setWVals(weights.W);
+    layer.setUVals(weights.U);
+    layer.setBVals(weights.b);
+}
+
+/** Returns the json for a dense layer with random weights. */
+inline nlohmann::json dense_json(std::default_random_engine& generator, int in_size, int out_size, const std::string& activation)
+{
+    nlohmann::json dense;
+    dense["type"] = "dense";
+    dense["activation"] = activation;
+    dense["shape"] = { nullptr, nullptr, out_size };
+    dense["weights"] = { random_matrix(generator, in_size, out_size), random_matrix(generator, 1, out_size)[0] };
+    return dense;
+}
+
+/** Returns the json for a LSTM layer with random weights. */
+inline nlohmann::json lstm_json(std::default_random_engine& generator, int in_size, int out_size)
+{
+    nlohmann::json lstm;
+    lstm["type"] = "lstm";
+    lstm["activation"] = "";
+    lstm["shape"] = { nullptr, nullptr, out_size };
+    lstm["weights"] = { random_matrix(generator, in_size, 4 * out_size),
+        random_matrix(generator, out_size, 4 * out_size),
+        random_matrix(generator, 1, 4 * out_size)[0] };
+    return lstm;
+}
+
+/** Returns the json for a CIFG LSTM layer with random weights. */
+inline nlohmann::json cifg_lstm_json(std::default_random_engine& generator, int in_size, int out_size)
+{
+    nlohmann::json lstm;
+    lstm["type"] = "lstm";
+    lstm["activation"] = "";
+    lstm["shape"] = { nullptr, nullptr, out_size };
+    lstm["cifg"] = true;
+    lstm["weights"] = { random_matrix(generator, in_size, 3 * out_size),
+        random_matrix(generator, out_size, 3 * out_size),
+        random_matrix(generator, 1, 3 * out_size)[0] };
+    return lstm;
+}
+
+} // namespace json_fixtures
@@ -0,0 +1,158 @@
+#pragma once
+
+#include "json_fixtures.hpp"
+#include <RTNeural.h>
+#include <iostream>
+#include <random>
+
+namespace lstm_dense_test
+{
+
+using TestType = double;
+
+constexpr int num_samples = 1000;
+
+using json_fixtures::random_matrix;
+using json_fixtures::dense_json;
+using json_fixtures::lstm_json;
+
+/** Checks that a ModelT (with fused layers) matches the dynamic model loaded from the same json. */
+template <int in_size, typename ModelType>
+int compare_models(const nlohmann::json& modelJson, const std::string& test_name)
+{
+    auto modelT = std::make_unique<ModelType>();
+    modelT->parseJson(modelJson);
+    modelT->reset();
+
+    auto model = RTNeural::json_parser::parseJson<TestType>(modelJson);
+    model->reset();
+
+    std::default_random_engine generator;
+    std::uniform_real_distribution<TestType> distribution(-1.0, 1.0);
+    TestType x alignas(RTNEURAL_DEFAULT_ALIGNMENT)[in_size];
+
+    constexpr double threshold = 1.0e-12;
+    size_t nErrs = 0;
+    TestType max_error = 0.0;
+    for(int n = 0; n < num_samples; ++n)
+    {
+        for(auto& sample : x)
+            sample = distribution(generator);
+
+        modelT->forward(x);
+        model->forward(x);
+        for(int i = 0; i < model->getOutSize(); ++i)
+        {
+            const auto err = std::abs(modelT->getOutputs()[i] - model->getOutputs()[i]);
+            if(err > threshold)
+            {
+                max_error = std::max(err, max_error);
+                nErrs++;
+            }
+        }
+    }
+
+    if(nErrs > 0)
+    {
+        std::cout << "  " << test_name << " FAIL: " << nErrs << " errors! Maximum error: " << max_error << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+int lstm_dense_test()
+{
+    std::cout << "TESTING LSTM + DENSE FUSION..." << std::endl;
+
+    using namespace RTNeural;
+    int result = 0;
+
+    // an explicit LSTMDenseT is loaded from consecutive lstm and dense entries
+    {
+        using FusedModel = ModelT<TestType, 1, 1, LSTMDenseT<TestType, 1, 16, 1>>;
+
+        std::default_random_engine generator;
+        nlohmann::json modelJson;
+        modelJson["in_shape"] = { nullptr, nullptr, 1 };
+        modelJson["layers"] = { lstm_json(generator, 1, 16), dense_json(generator, 16, 1, "") };
+        result |= compare_models<1, FusedModel>(modelJson, "lstm_dense");
+    }
+
+    // explicit LSTMDenseT in the middle of a model, with an activation after the Dense layer
+    {
+        using FusedModel = ModelT<TestType, 2, 3,
+            DenseT<TestType, 2, 8>,
+            TanhActivationT<TestType, 8>,
+            LSTMDenseT<TestType, 8, 8, 3>,
+            TanhActivationT<TestType, 3>>;
+
+        std::default_random_engine generator;
+        nlohmann::json modelJson;
+        modelJson["in_shape"] = { nullptr, nullptr, 2 };
+        modelJson["layers"] = { dense_json(generator, 2, 8, "tanh"), lstm_json(generator, 8, 8), dense_json(generator, 8, 3, "tanh") };
+        result |= compare_models<2, FusedModel>(modelJson, "dense -> lstm_dense");
+    }
+
+    using AmpModel = ModelT<TestType, 1, 1, LSTMLayerT<TestType, 1, 16>, DenseT<TestType, 16, 1>>;
+#if RTNEURAL_FUSE_LAYERS
+    // with RTNEURAL_FUSE_LAYERS, LSTM -> Dense is fused, and get<>() returns the fused layer for both indices
+    {
+        auto model = std::make_unique<AmpModel>();
+        static_assert(std::is_same<std::decay_t<decltype(model->get<0>())>, LSTMDenseT<TestType, 1, 16, 1>>::value,
+            "LSTMLayerT -> DenseT should be fused!");
+
+        if(&model->get<0>() != &model->get<1>())
+        {
+            std::cout << "  get<>() FAIL: the fused layer should be returned for both indices!" << std::endl;
+            result |= 1;
+        }
+
+        std::default_random_engine generator;
+        nlohmann::json modelJson;
+        modelJson["in_shape"] = { nullptr, nullptr, 1 };
+        modelJson["layers"] = { lstm_json(generator, 1, 16), dense_json(generator, 16, 1, "") };
+        result |= compare_models<1, AmpModel>(modelJson, "lstm -> dense");
+    }
+
+    // fused layer in the middle of a model, with an activation after the Dense layer
+    using MixedModel = ModelT<TestType, 2, 3,
+        DenseT<TestType, 2, 8>,
+        TanhActivationT<TestType, 8>,
+        LSTMLayerT<TestType, 8, 8>,
+        DenseT<TestType, 8, 3>,
+        TanhActivationT<TestType, 3>>;
+    {
+        static_assert(modelt_detail::fused_index<DenseT<TestType, 2, 8>, TanhActivationT<TestType, 8>, LSTMLayerT<TestType, 8, 8>, DenseT<TestType, 8, 3>, TanhActivationT<TestType, 3>>(4) == 3,
+            "Incorrect layer index after fusion!");
+
+        std::default_random_engine generator;
+        nlohmann::json modelJson;
+        modelJson["in_shape"] = { nullptr, nullptr, 2 };
+        modelJson["layers"] = { dense_json(generator, 2, 8, "tanh"), lstm_json(generator, 8, 8), dense_json(generator, 8, 3, "tanh") };
+        result |= compare_models<2, MixedModel>(modelJson, "dense -> lstm -> dense");
+    }
+
+    // LSTMs with sample rate correction are not fused
+    using CorrectedModel = ModelT<TestType, 1, 1, LSTMLayerT<TestType, 1, 8, SampleRateCorrectionMode::NoInterp>, DenseT<TestType, 8, 1>>;
+    static_assert(std::is_same<std::decay_t<decltype(std::declval<CorrectedModel&>().get<0>())>, LSTMLayerT<TestType, 1, 8, SampleRateCorrectionMode::NoInterp>>::value,
+        "LSTMLayerT with sample rate correction should not be fused!");
+#else
+    // by default, ModelT keeps the layers that it was given
+    static_assert(std::is_same<std::decay_t<decltype(std::declval<AmpModel&>().get<0>())>, LSTMLayerT<TestType, 1, 16>>::value,
+        "LSTMLayerT -> DenseT should only be fused with RTNEURAL_FUSE_LAYERS!");
+    static_assert(std::is_same<std::decay_t<decltype(std::declval<AmpModel&>().get<1>())>, DenseT<TestType, 16, 1>>::value,
+        "LSTMLayerT -> DenseT should only be fused with RTNEURAL_FUSE_LAYERS!");
+#endif
+
+    if(result != 0)
+    {
+        std::cout << "FAIL!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "SUCCESS" << std::endl;
+    return 0;
+}
+
+} // namespace lstm_dense_test
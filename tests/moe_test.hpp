@@ -0,0 +1,200 @@
+#pragma once
+
+#include "json_fixtures.hpp"
+#include <RTNeural.h>
+#include <iostream>
+#include <random>
+
+namespace moe_test
+{
+
+using TestType = double;
+
+constexpr int num_experts = 4;
+constexpr int hidden_size = 8;
+constexpr int num_samples = 1000;
+
+using json_fixtures::random_matrix;
+using json_fixtures::dense_json;
+using json_fixtures::lstm_json;
+
+/** Creates a model json with a single MoE layer, with LSTM -> Dense experts (1 input, 1 output). */
+nlohmann::json moe_model_json(int top_k, const std::string& idle_policy)
+{
+    std::default_random_engine generator;
+
+    nlohmann::json layer;
+    layer["type"] = "moe";
+    layer["activation"] = "";
+    layer["shape"] = { nullptr, nullptr, 1 };
+    layer["top_k"] = top_k;
+    layer["idle_policy"] = idle_policy;
+    layer["weights"] = { random_matrix(generator, 1, num_experts, 1.0), random_matrix(generator, 1, num_experts, 1.0)[0] };
+
+    layer["experts"] = nlohmann::json::array();
+    for(int e = 0; e < num_experts; ++e)
+    {
+        layer["experts"].push_back({ { "layers", { lstm_json(generator, 1, hidden_size), dense_json(generator, hidden_size, 1, "") } } });
+    }
+
+    nlohmann::json model;
+    model["in_shape"] = { nullptr, nullptr, 1 };
+    model["layers"] = { layer };
+    return model;
+}
+
+std::vector<TestType> test_signal()
+{
+    std::default_random_engine generator;
+    std::uniform_real_distribution<TestType> distribution(-2.0, 2.0);
+    std::vector<TestType> x(num_samples);
+    for(auto& sample : x)
+        sample = distribution(generator);
+    return x;
+}
+
+template <typename ModelType>
+std::vector<TestType> process(ModelType& model, const std::vector<TestType>& x)
+{
+    std::vector<TestType> y(x.size());
+    model.reset();
+    for(size_t n = 0; n < x.size(); ++n)
+        y[n] = model.forward(&x[n]);
+    return y;
+}
+
+/**
+ * Reference implementation: runs the gate and every expert separately,
+ * stepping only the selected experts (i.e. with the "freeze" policy).
+ */
+std::vector<TestType> process_reference(const nlohmann::json& modelJson, int top_k, const std::vector<TestType>& x)
+{
+    const auto& layer = modelJson["layers"][0];
+    auto gate = RTNeural::json_parser::createDense<TestType>(1, num_experts, layer["weights"]);
+
+    std::vector<std::unique_ptr<RTNeural::Model<TestType>>> experts;
+    for(const auto& expert : layer["experts"])
+    {
+        experts.push_back(RTNeural::json_parser::parseJson<TestType>(RTNeural::json_parser::getExpertJson(expert, 1)));
+        experts.back()->reset();
+    }
+
+    std::vector<TestType> y(x.size());
+    for(size_t n = 0; n < x.size(); ++n)
+    {
+        TestType logits[num_experts] {};
+        gate->forward(&x[n], logits);
+
+        int order[num_experts] = { 0, 1, 2, 3 };
+        std::sort(std::begin(order), std::end(order), [&logits](int a, int b)
+            { return logits[a] > logits[b]; });
+
+        TestType sum = 0.0;
+        TestType mix = 0.0;
+        for(int j = 0; j < top_k; ++j)
+        {
+            const auto weight = std::exp(logits[order[j]] - logits[order[0]]);
+            mix += weight * experts[(size_t)order[j]]->forward(&x[n]);
+            sum += weight;
+        }
+        y[n] = mix / sum;
+    }
+
+    return y;
+}
+
+int compare(const std::vector<TestType>& y, const std::vector<TestType>& yRef, const std::string& test_name)
+{
+    constexpr double threshold = 1.0e-10;
+
+    size_t nErrs = 0;
+    TestType max_error = 0.0;
+    for(size_t n = 0; n < y.size(); ++n)
+    {
+        const auto err = std::abs(y[n] - yRef[n]);
+        if(err > threshold)
+        {
+            max_error = std::max(err, max_error);
+            nErrs++;
+        }
+    }
+
+    if(nErrs > 0)
+    {
+        std::cout << "  " << test_name << " FAIL: " << nErrs << " errors! Maximum error: " << max_error << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+using Expert = RTNeural::ModelT<TestType, 1, 1,
+    RTNeural::LSTMLayerT<TestType, 1, hidden_size>,
+    RTNeural::DenseT<TestType, hidden_size, 1>>;
+
+template <int top_k, RTNeural::MoEIdlePolicy policy>
+using MoEModelT = RTNeural::ModelT<TestType, 1, 1,
+    RTNeural::MixtureOfExpertsT<TestType, 1, 1, top_k, policy, Expert, Expert, Expert, Expert>>;
+
+/** Checks that the templated MoE layer matches the dynamic one. */
+template <int top_k, RTNeural::MoEIdlePolicy policy>
+int templated_test(const std::string& policy_name, const std::vector<TestType>& x)
+{
+    const auto modelJson = moe_model_json(top_k, policy_name);
+    auto model = RTNeural::json_parser::parseJson<TestType>(modelJson);
+
+    MoEModelT<top_k, policy> modelT;
+    modelT.parseJson(modelJson);
+
+    return compare(process(modelT, x), process(*model, x), "templated k=" + std::to_string(top_k) + " " + policy_name);
+}
+
+int moe_test()
+{
+    std::cout << "TESTING MIXTURE OF EXPERTS..." << std::endl;
+
+    const auto x = test_signal();
+    int result = 0;
+
+    // sparse and dense evaluation against a reference implementation
+    for(int top_k : { 1, 2, num_experts })
+    {
+        const auto modelJson = moe_model_json(top_k, "freeze");
+        auto model = RTNeural::json_parser::parseJson<TestType>(modelJson);
+        result |= compare(process(*model, x), process_reference(modelJson, top_k, x), "dynamic k=" + std::to_string(top_k));
+    }
+
+    // invalid top_k values (or no experts) should fail to load
+    for(int top_k : { 0, -1, num_experts + 1 })
+    {
+        if(RTNeural::json_parser::parseJson<TestType>(moe_model_json(top_k, "freeze")) != nullptr)
+        {
+            std::cout << "  FAIL: loaded a MoE layer with top_k = " << top_k << "!" << std::endl;
+            result |= 1;
+        }
+    }
+
+    auto noExpertsJson = moe_model_json(1, "freeze");
+    noExpertsJson["layers"][0]["experts"] = nlohmann::json::array();
+    if(RTNeural::json_parser::parseJson<TestType>(noExpertsJson) != nullptr)
+    {
+        std::cout << "  FAIL: loaded a MoE layer with no experts!" << std::endl;
+        result |= 1;
+    }
+
+    result |= templated_test<1, RTNeural::MoEIdlePolicy::Freeze>("freeze", x);
+    result |= templated_test<2, RTNeural::MoEIdlePolicy::Freeze>("freeze", x);
+    result |= templated_test<2, RTNeural::MoEIdlePolicy::Reset>("reset", x);
+    result |= templated_test<2, RTNeural::MoEIdlePolicy::CatchUp>("catch_up", x);
+
+    if(result != 0)
+    {
+        std::cout << "FAIL!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "SUCCESS" << std::endl;
+    return 0;
+}
+
+} // namespace moe_test
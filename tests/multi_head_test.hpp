@@ -0,0 +1,206 @@
+#pragma once
+
+#include "json_fixtures.hpp"
+#include <RTNeural.h>
+#include <iostream>
+#include <random>
+
+namespace multi_head_test
+{
+
+using TestType = double;
+
+constexpr int in_size = 2;
+constexpr int trunk_size = 8;
+constexpr int num_samples = 1000;
+
+using json_fixtures::random_matrix;
+using json_fixtures::dense_json;
+using json_fixtures::lstm_json;
+
+/**
+ * Trunk: Dense(2 -> 8, tanh) -> LSTM(8 -> 8)
+ * Head 0: Dense(8 -> 2)
+ * Head 1: LSTM(8 -> 4) -> Dense(4 -> 1)
+ */
+nlohmann::json multi_head_json()
+{
+    std::default_random_engine generator;
+
+    nlohmann::json model;
+    model["in_shape"] = { nullptr, nullptr, in_size };
+    model["layers"] = { dense_json(generator, in_size, trunk_size, "tanh"), lstm_json(generator, trunk_size, trunk_size) };
+    model["heads"] = { { { "layers", { dense_json(generator, trunk_size, 2, "") } } },
+        { { "layers", { lstm_json(generator, trunk_size, 4), dense_json(generator, 4, 1, "") } } } };
+    return model;
+}
+
+using TrunkType = RTNeural::ModelT<TestType, in_size, trunk_size,
+    RTNeural::DenseT<TestType, in_size, trunk_size>,
+    RTNeural::TanhActivationT<TestType, trunk_size>,
+    RTNeural::LSTMLayerT<TestType, trunk_size, trunk_size>>;
+using Head0Type = RTNeural::ModelT<TestType, trunk_size, 2, RTNeural::DenseT<TestType, trunk_size, 2>>;
+using Head1Type = RTNeural::ModelT<TestType, trunk_size, 1,
+    RTNeural::LSTMLayerT<TestType, trunk_size, 4>,
+    RTNeural::DenseT<TestType, 4, 1>>;
+
+/** Reference implementation: runs the trunk and one head as a single sequential model. */
+std::unique_ptr<RTNeural::Model<TestType>> reference_model(const nlohmann::json& modelJson, int head)
+{
+    auto fullJson = modelJson;
+    for(const auto& l : modelJson["heads"][(size_t)head]["layers"])
+        fullJson["layers"].push_back(l);
+
+    auto model = RTNeural::json_parser::parseJson<TestType>(fullJson);
+    model->reset();
+    return model;
+}
+
+size_t count_errors(const TestType* y, const TestType* yRef, int n)
+{
+    constexpr double threshold = 1.0e-12;
+    size_t nErrs = 0;
+    for(int i = 0; i < n; ++i)
+        if(std::abs(y[i] - yRef[i]) > threshold)
+            nErrs++;
+    return nErrs;
+}
+
+int report(size_t nErrs, const std::string& test_name)
+{
+    if(nErrs > 0)
+    {
+        std::cout << "  " << test_name << " FAIL: " << nErrs << " errors!" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+/** Checks per-sample processing with dynamic models. */
+int dynamic_test(const nlohmann::json& modelJson, const std::vector<TestType>& x)
+{
+    using namespace RTNeural::json_parser;
+    auto trunk = parseJson<TestType>(modelJson);
+    auto head0 = parseJson<TestType>(getHeadJson(modelJson, 0, trunk_size));
+    auto head1 = parseJson<TestType>(getHeadJson(modelJson, 1, trunk_size));
+
+    using ModelType = RTNeural::Model<TestType>;
+    RTNeural::MultiHeadModel<TestType, ModelType, ModelType, ModelType> model { *trunk, *head0, *head1 };
+    model.reset();
+
+    auto ref0 = reference_model(modelJson, 0);
+    auto ref1 = reference_model(modelJson, 1);
+
+    TestType y0[2], y1[1];
+    TestType* outs[] = { y0, y1 };
+
+    size_t nErrs = 0;
+    for(int n = 0; n < num_samples; ++n)
+    {
+        model.forward(&x[(size_t)(n * in_size)], outs);
+        ref0->forward(&x[(size_t)(n * in_size)]);
+        ref1->forward(&x[(size_t)(n * in_size)]);
+
+        nErrs += count_errors(y0, ref0->getOutputs(), 2);
+        nErrs += count_errors(y1, ref1->getOutputs(), 1);
+        nErrs += count_errors(model.getHeadOutputs(1), ref1->getOutputs(), 1);
+    }
+
+    return report(nErrs, "dynamic models");
+}
+
+/**
+ * Checks block processing with static models, with head 1 disabled
+ * for the second block. The output buffer for the disabled head should
+ * be left untouched, and head 1 should be reset when it is re-enabled.
+ */
+int static_block_test(const nlohmann::json& modelJson, const std::vector<TestType>& x)
+{
+    using namespace RTNeural::json_parser;
+    TrunkType trunk;
+    trunk.parseJson(modelJson);
+    Head0Type head0;
+    head0.parseJson(getHeadJson(modelJson, 0, trunk_size));
+    Head1Type head1;
+    head1.parseJson(getHeadJson(modelJson, 1, trunk_size));
+
+    // an odd block size, so that blocks are split across chunks
+    RTNeural::MultiHeadModel<TestType, TrunkType, Head0Type, Head1Type> model { trunk, head0, head1, 7 };
+    model.reset();
+
+    auto ref0 = reference_model(modelJson, 0);
+    auto refTrunk = parseJson<TestType>(modelJson);
+    auto refHead1 = parseJson<TestType>(getHeadJson(modelJson, 1, trunk_size));
+    refTrunk->reset();
+
+    constexpr int block_sizes[] = { 300, 250, 450 };
+    constexpr TestType untouched = -100.0;
+    std::vector<TestType> y0((size_t)num_samples * 2);
+    std::vector<TestType> y1((size_t)num_samples, untouched);
+
+    size_t nErrs = 0;
+    int start = 0;
+    for(int block = 0; block < 3; ++block)
+    {
+        const auto head1Enabled = block != 1;
+        model.setHeadEnabled(1, head1Enabled);
+        if(block != 1)
+            refHead1->reset();
+
+        TestType* outs[] = { y0.data() + start * 2, y1.data() + start };
+        model.processBlock(&x[(size_t)(start * in_size)], outs, block_sizes[block]);
+
+        for(int n = start; n < start + block_sizes[block]; ++n)
+        {
+            ref0->forward(&x[(size_t)(n * in_size)]);
+            nErrs += count_errors(&y0[(size_t)(n * 2)], ref0->getOutputs(), 2);
+
+            refTrunk->forward(&x[(size_t)(n * in_size)]);
+            if(head1Enabled)
+            {
+                refHead1->forward(refTrunk->getOutputs());
+                nErrs += count_errors(&y1[(size_t)n], refHead1->getOutputs(), 1);
+            }
+            else if(y1[(size_t)n] != untouched)
+            {
+                nErrs++;
+            }
+        }
+
+        start += block_sizes[block];
+    }
+
+    if(model.isHeadEnabled(1) != true || model.getHeadOutSize(0) != 2)
+        nErrs++;
+
+    return report(nErrs, "static models");
+}
+
+int multi_head_test()
+{
+    std::cout << "TESTING MULTI-HEAD MODEL..." << std::endl;
+
+    std::default_random_engine generator;
+    std::uniform_real_distribution<TestType> distribution(-1.0, 1.0);
+    std::vector<TestType> x((size_t)(in_size * num_samples));
+    for(auto& sample : x)
+        sample = distribution(generator);
+
+    const auto modelJson = multi_head_json();
+
+    int result = 0;
+    result |= dynamic_test(modelJson, x);
+    result |= static_block_test(modelJson, x);
+
+    if(result != 0)
+    {
+        std::cout << "FAIL!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "SUCCESS" << std::endl;
+    return 0;
+}
+
+} // namespace multi_head_test
@@ -0,0 +1,228 @@
+#pragma once
+
+#include "json_fixtures.hpp"
+#include <RTNeural.h>
+#include <iostream>
+#include <random>
+
+namespace multirate_test
+{
+
+using TestType = double;
+
+constexpr int hidden_size = 8;
+constexpr int num_samples = 2048;
+
+using json_fixtures::random_matrix;
+using json_fixtures::dense_json;
+using json_fixtures::lstm_json;
+
+nlohmann::json decimated_json(int factor, const std::string& upsampling, int out_size, const nlohmann::json& layers)
+{
+    nlohmann::json decimated;
+    decimated["type"] = "decimated";
+    decimated["factor"] = factor;
+    decimated["upsampling"] = upsampling;
+    decimated["shape"] = { nullptr, nullptr, out_size };
+    decimated["weights"] = nlohmann::json::array();
+    decimated["layers"] = layers;
+    return decimated;
+}
+
+/**
+ * Encoder/decoder model:
+ * Dense(1 -> 8, tanh) -> Decimated(/2, linear)[ Dense(8 -> 8, tanh) -> Decimated(/4, hold)[ LSTM(8 -> 8) ] -> Dense(8 -> 8, tanh) ] -> Dense(8 -> 1)
+ */
+nlohmann::json nested_model_json()
+{
+    std::default_random_engine generator;
+
+    const auto inner = decimated_json(4, "hold", hidden_size, nlohmann::json::array({ lstm_json(generator, hidden_size, hidden_size) }));
+    const auto outer = decimated_json(2, "linear", hidden_size,
+        { dense_json(generator, hidden_size, hidden_size, "tanh"), inner, dense_json(generator, hidden_size, hidden_size, "tanh") });
+
+    nlohmann::json model;
+    model["in_shape"] = { nullptr, nullptr, 1 };
+    model["layers"] = { dense_json(generator, 1, hidden_size, "tanh"), outer, dense_json(generator, hidden_size, 1, "") };
+    return model;
+}
+
+using NestedModelType = RTNeural::ModelT<TestType, 1, 1,
+    RTNeural::DenseT<TestType, 1, hidden_size>,
+    RTNeural::TanhActivationT<TestType, hidden_size>,
+    RTNeural::DecimatedT<TestType, 2, RTNeural::UpsamplingMode::Linear,
+        RTNeural::DenseT<TestType, hidden_size, hidden_size>,
+        RTNeural::TanhActivationT<TestType, hidden_size>,
+        RTNeural::DecimatedT<TestType, 4, RTNeural::UpsamplingMode::Hold,
+            RTNeural::LSTMLayerT<TestType, hidden_size, hidden_size>>,
+        RTNeural::DenseT<TestType, hidden_size, hidden_size>,
+        RTNeural::TanhActivationT<TestType, hidden_size>>,
+    RTNeural::DenseT<TestType, hidden_size, 1>>;
+
+/** Decimated(/factor)[ LSTM(1 -> 8) ] -> Dense(8 -> 1) */
+nlohmann::json single_stage_json(int factor, const std::string& upsampling)
+{
+    std::default_random_engine generator;
+
+    nlohmann::json model;
+    model["in_shape"] = { nullptr, nullptr, 1 };
+    model["layers"] = { decimated_json(factor, upsampling, hidden_size, nlohmann::json::array({ lstm_json(generator, 1, hidden_size) })),
+        dense_json(generator, hidden_size, 1, "") };
+    return model;
+}
+
+template <int factor, RTNeural::UpsamplingMode upsampling>
+using SingleStageModelType = RTNeural::ModelT<TestType, 1, 1,
+    RTNeural::DecimatedT<TestType, factor, upsampling,
+        RTNeural::LSTMLayerT<TestType, 1, hidden_size>>,
+    RTNeural::DenseT<TestType, hidden_size, 1>>;
+
+std::vector<TestType> test_signal()
+{
+    std::default_random_engine generator;
+    std::uniform_real_distribution<TestType> distribution(-1.0, 1.0);
+    std::vector<TestType> x(num_samples);
+    for(auto& sample : x)
+        sample = distribution(generator);
+    return x;
+}
+
+template <typename ModelType>
+std::vector<TestType> process(ModelType& model, const std::vector<TestType>& x)
+{
+    model.reset();
+    std::vector<TestType> y(x.size());
+    for(size_t n = 0; n < x.size(); ++n)
+        y[n] = model.forward(&x[n]);
+    return y;
+}
+
+int check_outputs(const std::vector<TestType>& y, const std::vector<TestType>& yRef, const std::string& test_name)
+{
+    constexpr double threshold = 1.0e-12;
+    size_t nErrs = 0;
+    for(size_t n = 0; n < y.size(); ++n)
+    {
+        if(std::abs(y[n] - yRef[n]) > threshold)
+            nErrs++;
+    }
+
+    if(nErrs > 0)
+    {
+        std::cout << "  " << test_name << " FAIL: " << nErrs << " errors!" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * Reference for a single decimated stage: runs the LSTM on the block means of the input,
+ * then upsamples the LSTM outputs by hand before the output layer.
+ */
+std::vector<TestType> process_single_stage_reference(const nlohmann::json& modelJson, const std::vector<TestType>& x, int factor, bool linear)
+{
+    using namespace RTNeural::json_parser;
+    const auto& layers = modelJson["layers"];
+
+    auto lstm = parseJson<TestType>(getExpertJson(layers[0], 1));
+    nlohmann::json outputJson;
+    outputJson["layers"] = { layers[1] };
+    auto output = parseJson<TestType>(getExpertJson(outputJson, hidden_size));
+    lstm->reset();
+
+    std::vector<TestType> y(x.size());
+    TestType previous[hidden_size] {};
+    TestType current[hidden_size] {};
+    for(size_t block = 0; block < x.size() / (size_t)factor; ++block)
+    {
+        TestType mean = 0.0;
+        for(int i = 0; i < factor; ++i)
+            mean += x[block * (size_t)factor + (size_t)i];
+        mean /= (TestType)factor;
+
+        // the stage runs on the last sample of each block
+        const auto last = (block + 1) * (size_t)factor - 1;
+        lstm->forward(&mean);
+        std::copy(current, current + hidden_size, previous);
+        std::copy(lstm->getOutputs(), lstm->getOutputs() + hidden_size, current);
+
+        // the new outputs are used until the end of the next block
+        for(int i = 0; i < factor; ++i)
+        {
+            const auto n = last + (size_t)i;
+            if(n >= x.size())
+                break;
+
+            TestType h[hidden_size];
+            const auto t = (TestType)(i + 1) / (TestType)factor;
+            for(int k = 0; k < hidden_size; ++k)
+                h[k] = linear ? previous[k] + t * (current[k] - previous[k]) : current[k];
+
+            y[n] = output->forward(h);
+        }
+    }
+
+    // samples before the first block is complete see the initial (zero) state
+    TestType h[hidden_size] {};
+    for(size_t n = 0; n < (size_t)factor - 1; ++n)
+        y[n] = output->forward(h);
+
+    return y;
+}
+
+template <int factor, RTNeural::UpsamplingMode upsampling>
+int check_single_stage(const std::vector<TestType>& x, const std::string& test_name)
+{
+    const bool linear = upsampling == RTNeural::UpsamplingMode::Linear;
+    const auto modelJson = single_stage_json(factor, linear ? "linear" : "hold");
+    const auto yRef = process_single_stage_reference(modelJson, x, factor, linear);
+
+    int result = 0;
+
+    auto dynamicModel = RTNeural::json_parser::parseJson<TestType>(modelJson);
+    result |= check_outputs(process(*dynamicModel, x), yRef, test_name + " (dynamic)");
+
+    auto staticModel = std::make_unique<SingleStageModelType<factor, upsampling>>();
+    staticModel->parseJson(modelJson);
+    result |= check_outputs(process(*staticModel, x), yRef, test_name + " (static)");
+
+    return result;
+}
+
+int multirate_test()
+{
+    std::cout << "TESTING MULTI-RATE MODELS..." << std::endl;
+
+    const auto x = test_signal();
+    int result = 0;
+
+    result |= check_single_stage<1, RTNeural::UpsamplingMode::Linear>(x, "factor 1");
+    result |= check_single_stage<2, RTNeural::UpsamplingMode::Hold>(x, "factor 2, hold");
+    result |= check_single_stage<4, RTNeural::UpsamplingMode::Linear>(x, "factor 4, linear");
+    result |= check_single_stage<8, RTNeural::UpsamplingMode::Hold>(x, "factor 8, hold");
+
+    // nested stages: the static and dynamic implementations should match
+    const auto modelJson = nested_model_json();
+    auto dynamicModel = RTNeural::json_parser::parseJson<TestType>(modelJson);
+    if(dynamic_cast<RTNeural::Decimated<TestType>*>(dynamicModel->layers[2]) == nullptr)
+    {
+        std::cout << "  nested model FAIL: decimated layer was not loaded!" << std::endl;
+        result |= 1;
+    }
+
+    auto staticModel = std::make_unique<NestedModelType>();
+    staticModel->parseJson(modelJson);
+    result |= check_outputs(process(*staticModel, x), process(*dynamicModel, x), "nested model");
+
+    if(result != 0)
+    {
+        std::cout << "FAIL!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "SUCCESS" << std::endl;
+    return 0;
+}
+
+} // namespace multirate_test
@@ -0,0 +1,215 @@
+#pragma once
+
+#include "load_csv.hpp"
+#include "test_configs.hpp"
+#include <RTNeural.h>
+#include <iostream>
+
+namespace pcm_test
+{
+
+/** Integer samples should be scaled to [-1, 1), and outputs should be rounded and saturated. */
+int conversion_test()
+{
+    int result = 0;
+    auto check = [&result](bool ok, const std::string& what)
+    {
+        if(!ok)
+        {
+            std::cout << "  PCM conversion FAIL: " << what << std::endl;
+            result = 1;
+        }
+    };
+
+    RTNeural::PCMConverter<float> converter;
+
+    const int16_t ins16[] = { -32768, 16384, 0, 32767 };
+    float values[4];
+    converter.load(ins16, values, 4);
+    check(values[0] == -1.0f && values[1] == 0.5f && values[2] == 0.0f && values[3] == 32767.0f / 32768.0f, "int16 input");
+
+    const RTNeural::PCM24 ins24[] = { { { 0x00, 0x00, 0x80 } }, { { 0xff, 0xff, 0xff } }, { { 0x00, 0x00, 0x40 } } };
+    converter.load(ins24, values, 3);
+    check(values[0] == -1.0f && values[1] == -1.0f / 8388608.0f && values[2] == 0.5f, "24-bit input");
+
+    const int32_t ins32[] = { std::numeric_limits<int32_t>::min(), 1 << 30 };
+    converter.load(ins32, values, 2);
+    check(values[0] == -1.0f && values[1] == 0.5f, "int32 input");
+
+    const float outs[] = { 1.5f, -2.0f, 0.25f, -0.5f / 32768.0f, 1.4f / 32768.0f };
+    int16_t outs16[5];
+    converter.store(outs, outs16, 5);
+    check(outs16[0] == 32767 && outs16[1] == -32768 && outs16[2] == 8192 && outs16[3] == -1 && outs16[4] == 1, "int16 output");
+
+    RTNeural::PCM24 outs24[5];
+    converter.store(outs, outs24, 5);
+    const auto* bytes = outs24[2].bytes;
+    check(bytes[0] == 0x00 && bytes[1] == 0x00 && bytes[2] == 0x20, "24-bit output");
+    float roundTrip[5];
+    converter.load(outs24, roundTrip, 5);
+    check(roundTrip[0] == 8388607.0f / 8388608.0f && roundTrip[1] == -1.0f && roundTrip[2] == 0.25f, "24-bit round trip");
+
+    int32_t outs32[5];
+    converter.store(outs, outs32, 5);
+    check(outs32[0] > (1 << 30) && outs32[1] == std::numeric_limits<int32_t>::min() && outs32[2] == (1 << 29), "int32 output");
+
+    // volatile, so the compiler can't fold the conversion of the NaN
+    volatile float nan = std::numeric_limits<float>::quiet_NaN();
+    const float nanOuts[] = { nan };
+    converter.store(nanOuts, outs16, 1);
+    converter.store(nanOuts, outs24, 1);
+    converter.store(nanOuts, outs32, 1);
+    const auto* nanBytes = outs24[0].bytes;
+    check(outs16[0] == 0 && nanBytes[0] == 0x00 && nanBytes[1] == 0x00 && nanBytes[2] == 0x00 && outs32[0] == 0, "NaN output");
+
+    RTNeural::PCMConverter<float> gainConverter({ 2.0f, 0.5f });
+    converter.load(ins16, values, 4);
+    float gainValues[4];
+    gainConverter.load(ins16, gainValues, 4);
+    float floatOuts[1];
+    gainConverter.store(outs, floatOuts, 1);
+    check(gainValues[1] == 2.0f * values[1] && floatOuts[0] == 0.75f, "gain");
+
+    return result;
+}
+
+/** Dithered outputs should stay within 1 LSB of the undithered outputs, and be unbiased. */
+int dither_test()
+{
+    RTNeural::PCMOptions<double> options;
+    options.dither = true;
+    RTNeural::PCMConverter<double> ditherConverter(options);
+    RTNeural::PCMConverter<double> converter;
+
+    constexpr int num_samples = 100000;
+    double sumError = 0.0;
+    int maxDiff = 0;
+    for(int n = 0; n < num_samples; ++n)
+    {
+        const double x[] = { 0.3 * std::sin(0.001 * n) };
+        int16_t dithered[1];
+        int16_t plain[1];
+        ditherConverter.store(x, dithered, 1);
+        converter.store(x, plain, 1);
+
+        maxDiff = std::max(maxDiff, std::abs((int)dithered[0] - (int)plain[0]));
+        sumError += (double)dithered[0] - x[0] * 32768.0;
+    }
+
+    const auto meanError = sumError / num_samples;
+    if(maxDiff > 1 || std::abs(meanError) > 0.01)
+    {
+        std::cout << "  dither FAIL: max difference " << maxDiff << " LSB, mean error " << meanError << " LSB" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * The block entry points should give the same outputs as converting the
+ * samples separately, and running the model one sample at a time.
+ */
+int model_test()
+{
+    const auto& test = tests.at("lstm");
+    std::ifstream pythonX(test.x_data_file);
+    const auto xData = load_csv::loadFile<float>(pythonX);
+    if(xData.empty())
+    {
+        std::cout << "  PCM model FAIL: no test data!" << std::endl;
+        return 1;
+    }
+
+    const auto num_samples = (int)xData.size();
+    std::vector<int16_t> input((size_t)num_samples);
+    for(int n = 0; n < num_samples; ++n)
+        input[(size_t)n] = (int16_t)std::max(-32768.0f, std::min(32767.0f, std::round(xData[(size_t)n] * 32768.0f)));
+
+    std::ifstream jsonStream(test.model_file, std::ifstream::binary);
+    nlohmann::json modelJson;
+    jsonStream >> modelJson;
+
+    auto model = RTNeural::json_parser::parseJson<float>(modelJson);
+    RTNeural::ModelT<float, 1, 1,
+        RTNeural::DenseT<float, 1, 8>,
+        RTNeural::TanhActivationT<float, 8>,
+        RTNeural::LSTMLayerT<float, 8, 8>,
+        RTNeural::DenseT<float, 8, 1>>
+        modelT;
+    modelT.parseJson(modelJson);
+
+    // expected outputs, converted in separate passes
+    const RTNeural::PCMOptions<float> options { 0.5f, 4.0f };
+    std::vector<int16_t> expected((size_t)num_samples);
+    std::vector<float> expectedFloat((size_t)num_samples);
+    {
+        RTNeural::PCMConverter<float> converter(options);
+        std::vector<float> x((size_t)num_samples);
+        converter.load(input.data(), x.data(), num_samples);
+
+        model->reset();
+        for(int n = 0; n < num_samples; ++n)
+            x[(size_t)n] = model->forward(&x[(size_t)n]);
+
+        converter.store(x.data(), expected.data(), num_samples);
+        for(int n = 0; n < num_samples; ++n)
+            expectedFloat[(size_t)n] = x[(size_t)n] * 4.0f;
+    }
+
+    // processed in a few blocks of different sizes
+    auto process = [&](auto& m, auto* output)
+    {
+        RTNeural::PCMConverter<float> converter(options);
+        m.reset();
+        for(int start = 0, block = 1; start < num_samples; start += block, block = block * 2 + 1)
+            m.processBlock(input.data() + start, output + start, std::min(block, num_samples - start), converter);
+    };
+
+    std::vector<int16_t> output((size_t)num_samples);
+    std::vector<int16_t> outputT((size_t)num_samples);
+    std::vector<float> outputFloat((size_t)num_samples);
+    process(*model, output.data());
+    process(modelT, outputT.data());
+    process(modelT, outputFloat.data());
+
+    int result = 0;
+    if(output != expected || outputT != expected)
+    {
+        std::cout << "  PCM model FAIL: block outputs don't match!" << std::endl;
+        result = 1;
+    }
+
+    float maxError = 0.0f;
+    for(int n = 0; n < num_samples; ++n)
+        maxError = std::max(maxError, std::abs(outputFloat[(size_t)n] - expectedFloat[(size_t)n]));
+
+    if(maxError > 1.0e-6f || modelT.getOutputs()[0] != outputFloat.back() / 4.0f)
+    {
+        std::cout << "  PCM model FAIL: float outputs don't match (error " << maxError << ")!" << std::endl;
+        result = 1;
+    }
+
+    return result;
+}
+
+int pcm_test()
+{
+    std::cout << "TESTING PCM BLOCK PROCESSING..." << std::endl;
+
+    int result = 0;
+    result |= conversion_test();
+    result |= dither_test();
+    result |= model_test();
+
+    if(result != 0)
+    {
+        std::cout << "FAIL!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "SUCCESS" << std::endl;
+    return 0;
+}
+
+} // namespace pcm_test
@@ -0,0 +1,190 @@
+#pragma once
+
+#include "json_fixtures.hpp"
+#include <RTNeural.h>
+#include <iostream>
+#include <random>
+
+namespace prefetch_test
+{
+
+using json_fixtures::random_matrix;
+
+int check_outputs(const std::string& name, const float* test, const float* ref, int size)
+{
+    for(int i = 0; i < size; ++i)
+    {
+        if(std::abs(test[i] - ref[i]) > 1.0e-5f)
+        {
+            std::cout << "  " << name << " FAIL: output " << i << " is " << test[i] << ", expected " << ref[i] << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+int distance_test()
+{
+    if(!RTNEURAL_PREFETCH)
+        return 0;
+
+    int result = 0;
+    if(RTNeural::prefetch_distance(256, RTNEURAL_PREFETCH_MIN_BYTES - 1) != 0)
+    {
+        std::cout << "  small matrices should not be prefetched!" << std::endl;
+        result = 1;
+    }
+
+    if(RTNeural::prefetch_distance(256, RTNEURAL_PREFETCH_MIN_BYTES) != (RTNEURAL_PREFETCH_AHEAD_BYTES + 255) / 256)
+    {
+        std::cout << "  prefetch distance should cover RTNEURAL_PREFETCH_AHEAD_BYTES!" << std::endl;
+        result = 1;
+    }
+
+    if(RTNeural::prefetch_distance(RTNEURAL_PREFETCH_AHEAD_BYTES * 4, RTNEURAL_PREFETCH_MIN_BYTES) != 1)
+    {
+        std::cout << "  prefetch distance should be at least one row!" << std::endl;
+        result = 1;
+    }
+
+    return result;
+}
+
+/** Prefetching (including past the end of the matrix) must not change the matrix product. */
+int mat_vec_test()
+{
+    constexpr int rows = 96;
+    constexpr int cols = 40;
+
+    std::default_random_engine generator;
+    const auto mat = random_matrix<float>(generator, rows, cols, 0.2f);
+    const auto vec = random_matrix<float>(generator, 1, cols, 0.2f)[0];
+    const auto next = random_matrix<float>(generator, 1, 64, 0.2f)[0];
+
+    std::vector<float> flat;
+    for(const auto& row : mat)
+        flat.insert(flat.end(), row.begin(), row.end());
+
+    std::vector<float> ref((size_t)rows);
+    RTNeural::mat_vec_prefetched(flat.data(), vec.data(), ref.data(), rows, cols, 0);
+
+    int result = 0;
+    for(int distance : { 1, 2, 4, 8, 200 })
+    {
+        std::vector<float> test((size_t)rows);
+        RTNeural::mat_vec_prefetched(flat.data(), vec.data(), test.data(), rows, cols, distance, next.data(), next.size() * sizeof(float));
+        result |= check_outputs("mat-vec distance " + std::to_string(distance), test.data(), ref.data(), rows);
+    }
+
+    return result;
+}
+
+/** A Dense layer large enough to be prefetched should match the (unprefetched) reference. */
+template <int in_size, int out_size>
+int dense_test()
+{
+    std::default_random_engine generator;
+    const auto weights = random_matrix<float>(generator, out_size, in_size, 0.2f);
+    auto bias = random_matrix<float>(generator, 1, out_size, 0.2f)[0];
+    const auto input = random_matrix<float>(generator, 1, in_size, 0.2f)[0];
+
+    auto denseT = std::make_unique<RTNeural::DenseT<float, in_size, out_size>>();
+    denseT->setWeights(weights);
+    denseT->setBias(bias.data());
+
+    RTNeural::Dense<float> dense(in_size, out_size);
+    dense.setWeights(weights);
+    dense.setBias(bias.data());
+
+    float insT alignas(RTNEURAL_DEFAULT_ALIGNMENT)[in_size];
+    std::copy(input.begin(), input.end(), insT);
+    denseT->prefetchWeights();
+    denseT->forward(insT);
+
+    std::vector<float> outs((size_t)out_size);
+    dense.forward(input.data(), outs.data());
+
+    float ref[out_size];
+    for(int i = 0; i < out_size; ++i)
+        ref[i] = std::inner_product(weights[(size_t)i].begin(), weights[(size_t)i].end(), input.begin(), bias[(size_t)i]);
+
+    int result = 0;
+    result |= check_outputs("DenseT " + std::to_string(in_size) + "x" + std::to_string(out_size), denseT->outs, ref, out_size);
+    result |= check_outputs("Dense " + std::to_string(in_size) + "x" + std::to_string(out_size), outs.data(), ref, out_size);
+    return result;
+}
+
+/** Large LSTM layers (static, dynamic, and stacked/fused) should all compute the same outputs. */
+template <int in_size, int hidden_size>
+int lstm_test()
+{
+    constexpr int num_samples = 32;
+
+    std::default_random_engine generator;
+    const auto W = random_matrix<float>(generator, in_size, 4 * hidden_size, 0.2f);
+    const auto U = random_matrix<float>(generator, hidden_size, 4 * hidden_size, 0.2f);
+    const auto b = random_matrix<float>(generator, 1, 4 * hidden_size, 0.2f)[0];
+
+    auto lstmT = std::make_unique<RTNeural::LSTMLayerT<float, in_size, hidden_size>>();
+    lstmT->setWVals(W);
+    lstmT->setUVals(U);
+    lstmT->setBVals(b);
+
+    RTNeural::LSTMLayer<float> lstm(in_size, hidden_size);
+    lstm.setWVals(W);
+    lstm.setUVals(U);
+    lstm.setBVals(b);
+    lstm.reset();
+
+    auto stacked = std::make_unique<RTNeural::StackedLSTMT<float, in_size, hidden_size, 1>>();
+    stacked->setWVals(0, W);
+    stacked->setUVals(0, U);
+    stacked->setBVals(0, b);
+
+    const auto name = "LSTM " + std::to_string(in_size) + "x" + std::to_string(hidden_size);
+    std::vector<float> outs((size_t)hidden_size);
+    for(int n = 0; n < num_samples; ++n)
+    {
+        const auto input = random_matrix<float>(generator, 1, in_size, 0.2f)[0];
+        float insT alignas(RTNEURAL_DEFAULT_ALIGNMENT)[in_size];
+        std::copy(input.begin(), input.end(), insT);
+
+        lstmT->prefetchWeights();
+        lstmT->forward(insT);
+        stacked->prefetchWeights();
+        stacked->forward(insT);
+        lstm.forward(input.data(), outs.data());
+
+        if(check_outputs(name + " (static)", lstmT->outs, outs.data(), hidden_size)
+           || check_outputs(name + " (stacked)", stacked->outs, outs.data(), hidden_size))
+            return 1;
+    }
+
+    return 0;
+}
+
+int prefetch_test()
+{
+    std::cout << "TESTING SOFTWARE PREFETCHING..." << std::endl;
+
+    int result = 0;
+    result |= distance_test();
+    result |= mat_vec_test();
+    result |= dense_test<8, 4>();
+    result |= dense_test<512, 256>();
+    result |= dense_test<256, 512>();
+    result |= lstm_test<1, 192>();
+    result |= lstm_test<64, 192>();
+
+    if(result != 0)
+    {
+        std::cout << "FAIL!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "SUCCESS" << std::endl;
+    return 0;
+}
+
+} // namespace prefetch_test
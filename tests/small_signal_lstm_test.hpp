@@ -0,0 +1,197 @@
+#pragma once
+
+#include "json_fixtures.hpp"
+#include "load_csv.hpp"
+#include "test_configs.hpp"
+#include <RTNeural.h>
+#include <iostream>
+#include <random>
+
+namespace small_signal_lstm_test
+{
+constexpr int hidden_size = 8;
+
+using json_fixtures::random_lstm_weights;
+using json_fixtures::set_lstm_weights;
+
+float max_difference(const float* a, const float* b, int size)
+{
+    float diff = 0.0f;
+    for(int i = 0; i < size; ++i)
+        diff = std::max(diff, std::abs(a[i] - b[i]));
+    return diff;
+}
+
+/** The steady state should match the state that the full LSTM settles to. */
+int steady_state_test()
+{
+    const auto weights = random_lstm_weights(1, hidden_size, 4, 0.4f);
+
+    RTNeural::SmallSignalLSTMT<float, 1, hidden_size> smallSignal;
+    set_lstm_weights(smallSignal, weights);
+    if(!smallSignal.linearize())
+    {
+        std::cout << "  LSTM should have a steady state!" << std::endl;
+        return 1;
+    }
+
+    RTNeural::LSTMLayerT<float, 1, hidden_size> lstm;
+    set_lstm_weights(lstm, weights);
+    const float zero[] = { 0.0f };
+    for(int n = 0; n < 2000; ++n)
+        lstm.forward(zero);
+
+    const auto err = max_difference(smallSignal.getSteadyState(), lstm.outs, hidden_size);
+    if(err > 1.0e-5f)
+    {
+        std::cout << "  steady state FAIL: error " << err << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * For quiet inputs, the linear model should be used, and should closely track
+ * the full LSTM. When the signal grows, the layer should hand over to the full
+ * LSTM, and carry on without a jump in its outputs.
+ */
+template <int in_size>
+int tracking_test()
+{
+    const auto weights = random_lstm_weights(in_size, hidden_size, 4, 0.4f);
+
+    RTNeural::SmallSignalLSTMT<float, in_size, hidden_size> smallSignal;
+    set_lstm_weights(smallSignal, weights);
+    smallSignal.linearize();
+    smallSignal.reset();
+
+    RTNeural::SmallSignalLSTM<float> smallSignalDynamic(in_size, hidden_size);
+    set_lstm_weights(smallSignalDynamic, weights);
+    smallSignalDynamic.linearize();
+    smallSignalDynamic.reset();
+
+    RTNeural::LSTMLayerT<float, in_size, hidden_size> lstm;
+    set_lstm_weights(lstm, weights);
+
+    // quiet, then loud, then quiet again
+    constexpr int num_samples = 6000;
+    auto amplitude = [](int n) { return (n >= 2000 && n < 3000) ? 0.5f : 1.0e-4f; };
+
+    int linearSamples = 0;
+    int linearDuringLoud = 0;
+    float maxQuietError = 0.0f;
+    float maxError = 0.0f;
+    float maxDynamicError = 0.0f;
+    std::vector<float> dynamicOuts((size_t)hidden_size);
+    for(int n = 0; n < num_samples; ++n)
+    {
+        float ins alignas(RTNEURAL_DEFAULT_ALIGNMENT)[in_size];
+        for(int i = 0; i < in_size; ++i)
+            ins[i] = amplitude(n) * std::sin(0.05f * (float)(n * (i + 1)));
+
+        smallSignal.forward(ins);
+        smallSignalDynamic.forward(ins, dynamicOuts.data());
+        lstm.forward(ins);
+
+        const auto err = max_difference(smallSignal.outs, lstm.outs, hidden_size);
+        maxError = std::max(maxError, err);
+        maxDynamicError = std::max(maxDynamicError, max_difference(smallSignal.outs, dynamicOuts.data(), hidden_size));
+
+        if(smallSignal.isLinear())
+        {
+            linearSamples++;
+            maxQuietError = std::max(maxQuietError, err);
+            if(amplitude(n) > 0.1f)
+                linearDuringLoud++;
+        }
+    }
+
+    int result = 0;
+    if(linearSamples < num_samples / 2 || linearDuringLoud > 0)
+    {
+        std::cout << "  linear model used for " << linearSamples << " samples (" << linearDuringLoud << " loud samples)!" << std::endl;
+        result = 1;
+    }
+
+    if(maxQuietError > 1.0e-5f || maxError > 1.0e-4f)
+    {
+        std::cout << "  small-signal LSTM FAIL: quiet error " << maxQuietError << ", maximum error " << maxError << std::endl;
+        result = 1;
+    }
+
+    if(maxDynamicError > 1.0e-5f)
+    {
+        std::cout << "  dynamic small-signal LSTM FAIL: error " << maxDynamicError << std::endl;
+        result = 1;
+    }
+
+    return result;
+}
+
+/** A ModelT with a SmallSignalLSTMT should load and run the same json as a regular LSTM model. */
+int model_test()
+{
+    const auto& test = tests.at("lstm");
+
+    RTNeural::ModelT<float, 1, 1,
+        RTNeural::DenseT<float, 1, 8>,
+        RTNeural::TanhActivationT<float, 8>,
+        RTNeural::SmallSignalLSTMT<float, 8, 8>,
+        RTNeural::DenseT<float, 8, 1>>
+        model;
+
+    std::ifstream jsonStream(test.model_file, std::ifstream::binary);
+    model.parseJson(jsonStream);
+    model.reset();
+
+    if(!model.get<2>().isLinearized())
+    {
+        std::cout << "  ModelT did not linearize the LSTM!" << std::endl;
+        return 1;
+    }
+
+    std::ifstream pythonX(test.x_data_file);
+    const auto xData = load_csv::loadFile<float>(pythonX);
+
+    std::ifstream pythonY(test.y_data_file);
+    const auto yRefData = load_csv::loadFile<float>(pythonY);
+
+    size_t nErrs = 0;
+    for(size_t n = 0; n < xData.size(); ++n)
+    {
+        float input[] = { xData[n] };
+        if(std::abs(model.forward(input) - yRefData[n]) > test.threshold)
+            nErrs++;
+    }
+
+    if(xData.empty() || nErrs > 0)
+    {
+        std::cout << "  ModelT FAIL: " << nErrs << " errors!" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+int small_signal_lstm_test()
+{
+    std::cout << "TESTING SMALL-SIGNAL LSTM..." << std::endl;
+
+    int result = 0;
+    result |= steady_state_test();
+    result |= tracking_test<1>();
+    result |= tracking_test<4>();
+    result |= model_test();
+
+    if(result != 0)
+    {
+        std::cout << "FAIL!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "SUCCESS" << std::endl;
+    return 0;
+}
+
+} // namespace small_signal_lstm_test
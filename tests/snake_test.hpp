@@ -0,0 +1,157 @@
+#pragma once
+
+#include "load_csv.hpp"
+#include "test_configs.hpp"
+#include <RTNeural.h>
+#include <iostream>
+#include <random>
+
+namespace snake_test
+{
+constexpr int size = 6;
+constexpr int num_samples = 1000;
+
+/** The reference implementation, with std::sin. */
+double snake(double x, double alpha)
+{
+    if(alpha == 0.0)
+        return x;
+
+    const auto s = std::sin(alpha * x);
+    return x + s * s / alpha;
+}
+
+const std::vector<float> alphas { 0.5f, 1.0f, 2.0f, 7.5f, 0.0f, 24.0f };
+
+bool check_outputs(const float* ins, const float* outs, const std::vector<float>& alpha, const std::string& what)
+{
+    for(int i = 0; i < size; ++i)
+    {
+        const auto expected = snake((double)ins[i], (double)alpha[(size_t)(alpha.size() == 1 ? 0 : i)]);
+        if(std::abs(expected - (double)outs[i]) > 1.0e-5 * (1.0 + std::abs(expected)))
+        {
+            std::cout << "  " << what << " FAIL: output " << outs[i] << ", expected " << expected << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/** The dynamic and static layers should match the reference, with one alpha per channel, or one alpha in total. */
+int layer_test()
+{
+    RTNeural::SnakeActivation<float> snakeLayer(size);
+    RTNeural::SnakeActivationT<float, size> snakeLayerT;
+
+    std::default_random_engine generator;
+    std::uniform_real_distribution<float> distribution(-3.0f, 3.0f);
+
+    for(const auto& alpha : { alphas, std::vector<float> { 3.0f } })
+    {
+        snakeLayer.setAlphaVals(alpha);
+        snakeLayerT.setAlphaVals(alpha);
+
+        float ins alignas(RTNEURAL_DEFAULT_ALIGNMENT)[size];
+        float outs[size];
+        for(int n = 0; n < num_samples; ++n)
+        {
+            for(auto& x : ins)
+                x = distribution(generator);
+
+            snakeLayer.forward(ins, outs);
+            snakeLayerT.forward(ins);
+            if(!check_outputs(ins, outs, alpha, "SnakeActivation") || !check_outputs(ins, snakeLayerT.outs, alpha, "SnakeActivationT"))
+                return 1;
+        }
+    }
+
+    return 0;
+}
+
+nlohmann::json make_model_json(const nlohmann::json& alpha)
+{
+    nlohmann::json modelJson;
+    modelJson["in_shape"] = { nullptr, size };
+    modelJson["layers"] = nlohmann::json::array();
+    modelJson["layers"].push_back({ { "type", "dense" }, { "activation", "sin" }, { "shape", { nullptr, size } },
+        { "weights", { std::vector<std::vector<float>>((size_t)size, std::vector<float>((size_t)size, 0.25f)), std::vector<float>((size_t)size, 0.1f) } } });
+    modelJson["layers"].push_back({ { "type", "snake" }, { "activation", "" }, { "shape", { nullptr, size } }, { "weights", { alpha } } });
+    modelJson["layers"].push_back({ { "type", "activation" }, { "activation", "cos" }, { "shape", { nullptr, size } }, { "weights", nlohmann::json::array() } });
+    return modelJson;
+}
+
+/** Snake layers (with nested alpha values) and sin/cos activations should be loaded by both parsers. */
+int json_test()
+{
+    // alpha exported from PyTorch, with shape [1, channels, 1]
+    nlohmann::json alpha = nlohmann::json::array();
+    alpha.push_back(nlohmann::json::array());
+    for(auto a : alphas)
+        alpha[0].push_back({ a });
+
+    const auto modelJson = make_model_json(alpha);
+    auto model = RTNeural::json_parser::parseJson<float>(modelJson);
+    RTNeural::ModelT<float, size, size,
+        RTNeural::DenseT<float, size, size>,
+        RTNeural::SinActivationT<float, size>,
+        RTNeural::SnakeActivationT<float, size>,
+        RTNeural::CosActivationT<float, size>>
+        modelT;
+    modelT.parseJson(modelJson);
+
+    if(model->layers.size() != 4 || model->layers[1]->getName() != "sin" || model->layers[2]->getName() != "snake" || model->layers[3]->getName() != "cos")
+    {
+        std::cout << "  json FAIL: wrong layers!" << std::endl;
+        return 1;
+    }
+
+    for(int i = 0; i < size; ++i)
+    {
+        if(modelT.get<2>().getAlpha(i) != alphas[(size_t)i])
+        {
+            std::cout << "  json FAIL: wrong alpha values!" << std::endl;
+            return 1;
+        }
+    }
+
+    const float ins[size] = { 0.1f, -0.2f, 0.3f, 0.4f, -0.5f, 0.6f };
+    model->forward(ins);
+    modelT.forward(ins);
+
+    float dense = 0.1f;
+    for(auto x : ins)
+        dense += 0.25f * x;
+
+    for(int i = 0; i < size; ++i)
+    {
+        const auto expected = std::cos(snake(std::sin((double)dense), (double)alphas[(size_t)i]));
+        if(std::abs(model->getOutputs()[i] - expected) > 1.0e-5 || std::abs(modelT.getOutputs()[i] - expected) > 1.0e-5)
+        {
+            std::cout << "  json FAIL: output " << modelT.getOutputs()[i] << ", expected " << expected << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+int snake_test()
+{
+    std::cout << "TESTING SNAKE ACTIVATION..." << std::endl;
+
+    int result = 0;
+    result |= layer_test();
+    result |= json_test();
+
+    if(result != 0)
+    {
+        std::cout << "FAIL!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "SUCCESS" << std::endl;
+    return 0;
+}
+
+} // namespace snake_test
@@ -0,0 +1,234 @@
+#pragma once
+
+#include <RTNeural.h>
+#include <complex>
+#include <iostream>
+#include <random>
+
+namespace spectral_test
+{
+
+using TestType = double;
+
+constexpr int fft_size = 64;
+constexpr int hop_size = 16;
+constexpr int num_mels = 12;
+constexpr double sample_rate = 16000.0;
+constexpr int num_samples = 1000;
+
+const double pi = 3.14159265358979323846;
+
+std::vector<TestType> test_signal(int n_samples)
+{
+    std::default_random_engine generator;
+    std::uniform_real_distribution<TestType> distribution(-1.0, 1.0);
+    std::vector<TestType> x((size_t)n_samples);
+    for(auto& sample : x)
+        sample = distribution(generator);
+    return x;
+}
+
+std::vector<std::complex<double>> naive_dft(const TestType* x, int size)
+{
+    std::vector<std::complex<double>> X((size_t)size / 2 + 1);
+    for(int k = 0; k <= size / 2; ++k)
+    {
+        for(int n = 0; n < size; ++n)
+            X[(size_t)k] += x[n] * std::polar(1.0, -2.0 * pi * (double)k * (double)n / (double)size);
+    }
+    return X;
+}
+
+int fft_test()
+{
+    int result = 0;
+    for(int size = 4; size <= 1024; size *= 2)
+    {
+        const auto x = test_signal(size);
+        const auto XRef = naive_dft(x.data(), size);
+
+        RTNeural::FFT<TestType> fft { size };
+        std::vector<TestType> re((size_t)fft.getNumBins()), im((size_t)fft.getNumBins()), power((size_t)fft.getNumBins());
+        fft.performRealForward(x.data(), re.data(), im.data());
+        fft.performPowerSpectrum(x.data(), power.data());
+
+        size_t nErrs = 0;
+        for(size_t k = 0; k < XRef.size(); ++k)
+        {
+            if(std::abs(std::complex<double>(re[k], im[k]) - XRef[k]) > 1.0e-9)
+                nErrs++;
+            if(std::abs(power[k] - std::norm(XRef[k])) > 1.0e-9 * std::max(1.0, std::norm(XRef[k])))
+                nErrs++;
+        }
+
+        if(nErrs > 0)
+        {
+            std::cout << "  FFT size " << size << " FAIL: " << nErrs << " errors!" << std::endl;
+            result = 1;
+        }
+    }
+
+    return result;
+}
+
+/** Reference features: windows the last fft_size samples, and computes the (mel) power spectrum with a naive DFT. */
+std::vector<TestType> reference_features(const std::vector<TestType>& x, size_t end, bool mel, bool log_compression)
+{
+    std::vector<TestType> frame((size_t)fft_size, 0.0);
+    for(int n = 0; n < fft_size; ++n)
+    {
+        const auto idx = (long)end - fft_size + n;
+        const auto window = 0.5 - 0.5 * std::cos(2.0 * pi * (double)n / (double)fft_size);
+        frame[(size_t)n] = idx >= 0 ? x[(size_t)idx] * window : 0.0;
+    }
+
+    const auto X = naive_dft(frame.data(), fft_size);
+    std::vector<TestType> features;
+    if(!mel)
+    {
+        for(const auto& bin : X)
+            features.push_back(std::norm(bin));
+    }
+    else
+    {
+        auto hzToMel = [](double hz)
+        { return 2595.0 * std::log10(1.0 + hz / 700.0); };
+        auto melToHz = [](double mel)
+        { return 700.0 * (std::pow(10.0, mel / 2595.0) - 1.0); };
+
+        const auto melMax = hzToMel(0.5 * sample_rate);
+        for(int m = 0; m < num_mels; ++m)
+        {
+            const auto lower = melToHz(melMax * (double)m / (double)(num_mels + 1));
+            const auto centre = melToHz(melMax * (double)(m + 1) / (double)(num_mels + 1));
+            const auto upper = melToHz(melMax * (double)(m + 2) / (double)(num_mels + 1));
+
+            double sum = 0.0;
+            for(size_t k = 0; k < X.size(); ++k)
+            {
+                const auto freq = (double)k * sample_rate / (double)fft_size;
+                const auto weight = std::max(0.0, std::min((freq - lower) / (centre - lower), (upper - freq) / (upper - centre)));
+                sum += weight * std::norm(X[k]);
+            }
+            features.push_back(sum);
+        }
+    }
+
+    if(log_compression)
+    {
+        for(auto& f : features)
+            f = std::log(f + 1.0e-10);
+    }
+
+    return features;
+}
+
+int check_front_end(RTNeural::SpectralFrontEnd<TestType>& frontEnd, const std::vector<TestType>& x, bool mel, bool log_compression, const std::string& test_name)
+{
+    int numFrames = 0;
+    size_t nErrs = 0;
+    for(size_t n = 0; n < x.size(); ++n)
+    {
+        if(!frontEnd.pushSample(x[n]))
+            continue;
+
+        numFrames++;
+        const auto featuresRef = reference_features(x, n + 1, mel, log_compression);
+        for(size_t i = 0; i < featuresRef.size(); ++i)
+        {
+            if(std::abs(frontEnd.getFeatures()[i] - featuresRef[i]) > 1.0e-9)
+                nErrs++;
+        }
+    }
+
+    if(numFrames != (int)x.size() / hop_size)
+    {
+        std::cout << "  " << test_name << " FAIL: expected " << (int)x.size() / hop_size << " frames, got " << numFrames << std::endl;
+        return 1;
+    }
+
+    if(nErrs > 0)
+    {
+        std::cout << "  " << test_name << " FAIL: " << nErrs << " errors!" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+/** Runs a small model on the front-end output with processBlock(), and checks it against the model run on the reference features. */
+int check_process_block(const std::vector<TestType>& x)
+{
+    nlohmann::json dense;
+    dense["type"] = "dense";
+    dense["activation"] = "tanh";
+    dense["shape"] = { nullptr, nullptr, 1 };
+    dense["weights"] = { nlohmann::json::array(), nlohmann::json::array({ 0.1 }) };
+    for(int m = 0; m < num_mels; ++m)
+        dense["weights"][0].push_back(nlohmann::json::array({ 0.01 * (double)(m - num_mels / 2) }));
+
+    nlohmann::json modelJson;
+    modelJson["in_shape"] = { nullptr, nullptr, num_mels };
+    modelJson["layers"] = nlohmann::json::array({ dense });
+
+    auto model = RTNeural::json_parser::parseJson<TestType>(modelJson);
+    auto refModel = RTNeural::json_parser::parseJson<TestType>(modelJson);
+
+    RTNeural::SpectralFrontEnd<TestType> frontEnd { fft_size, hop_size, num_mels, sample_rate };
+    std::vector<TestType> y;
+    int numFrames = 0;
+    const auto blockSize = 100;
+    for(size_t start = 0; start < x.size(); start += blockSize)
+    {
+        const auto n = std::min((int)(x.size() - start), blockSize);
+        numFrames += frontEnd.processBlock(x.data() + start, n, *model, [&y](RTNeural::Model<TestType>& m)
+            { y.push_back(m.getOutputs()[0]); });
+    }
+
+    size_t nErrs = 0;
+    for(size_t frame = 0; frame < y.size(); ++frame)
+    {
+        const auto featuresRef = reference_features(x, (frame + 1) * hop_size, true, true);
+        if(std::abs(y[frame] - refModel->forward(featuresRef.data())) > 1.0e-9)
+            nErrs++;
+    }
+
+    if(numFrames != (int)x.size() / hop_size || nErrs > 0)
+    {
+        std::cout << "  processBlock FAIL: " << numFrames << " frames, " << nErrs << " errors!" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+int spectral_test()
+{
+    std::cout << "TESTING SPECTRAL FRONT-END..." << std::endl;
+
+    int result = fft_test();
+
+    const auto x = test_signal(num_samples);
+
+    RTNeural::SpectralFrontEnd<TestType> powerFrontEnd { fft_size, hop_size, 0, sample_rate, false };
+    result |= check_front_end(powerFrontEnd, x, false, false, "power spectrum");
+
+    RTNeural::SpectralFrontEnd<TestType> melFrontEnd { fft_size, hop_size, num_mels, sample_rate };
+    result |= check_front_end(melFrontEnd, x, true, true, "log-mel spectrum");
+
+    melFrontEnd.reset();
+    result |= check_front_end(melFrontEnd, x, true, true, "log-mel spectrum (after reset)");
+
+    result |= check_process_block(x);
+
+    if(result != 0)
+    {
+        std::cout << "FAIL!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "SUCCESS" << std::endl;
+    return 0;
+}
+
+} // namespace spectral_test
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "json_fixtures.hpp"
+#include <RTNeural.h>
+#include <iostream>
+#include <random>
+
+namespace stacked_lstm_test
+{
+
+using TestType = double;
+
+constexpr int num_samples = 1000;
+
+using json_fixtures::dense_json;
+using json_fixtures::lstm_json;
+
+/** Creates a model json with `num_layers` LSTM layers, followed by a Dense layer with one output. */
+nlohmann::json stacked_model_json(int in_size, int hidden_size, int num_layers)
+{
+    std::default_random_engine generator;
+
+    nlohmann::json model;
+    model["in_shape"] = { nullptr, nullptr, in_size };
+    model["layers"] = nlohmann::json::array();
+    for(int l = 0; l < num_layers; ++l)
+        model["layers"].push_back(lstm_json(generator, l == 0 ? in_size : hidden_size, hidden_size));
+
+    model["layers"].push_back(dense_json(generator, hidden_size, 1, ""));
+
+    return model;
+}
+
+/** Checks that a model with a stacked LSTM matches the same model with separate LSTM layers. */
+template <int in_size, typename StackedModel, typename ReferenceModel>
+int compare_models(int hidden_size, int num_layers)
+{
+    const auto modelJson = stacked_model_json(in_size, hidden_size, num_layers);
+
+    auto stackedModel = std::make_unique<StackedModel>();
+    stackedModel->parseJson(modelJson);
+    stackedModel->reset();
+
+    auto refModel = std::make_unique<ReferenceModel>();
+    refModel->parseJson(modelJson);
+    refModel->reset();
+
+    std::default_random_engine generator;
+    std::uniform_real_distribution<TestType> distribution(-1.0, 1.0);
+    TestType x alignas(RTNEURAL_DEFAULT_ALIGNMENT)[in_size];
+
+    constexpr double threshold = 1.0e-12;
+    size_t nErrs = 0;
+    TestType max_error = 0.0;
+    for(int n = 0; n < num_samples; ++n)
+    {
+        for(auto& sample : x)
+            sample = distribution(generator);
+
+        const auto err = std::abs(stackedModel->forward(x) - refModel->forward(x));
+        if(err > threshold)
+        {
+            max_error = std::max(err, max_error);
+            nErrs++;
+        }
+    }
+
+    if(nErrs > 0)
+    {
+        std::cout << "  " << num_layers << " layers FAIL: " << nErrs << " errors! Maximum error: " << max_error << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+int stacked_lstm_test()
+{
+    std::cout << "TESTING STACKED LSTM..." << std::endl;
+
+    using namespace RTNeural;
+    int result = 0;
+
+    result |= compare_models<1,
+        ModelT<TestType, 1, 1, StackedLSTMT<TestType, 1, 8, 1>, DenseT<TestType, 8, 1>>,
+        ModelT<TestType, 1, 1, LSTMLayerT<TestType, 1, 8>, DenseT<TestType, 8, 1>>>(8, 1);
+
+    result |= compare_models<1,
+        ModelT<TestType, 1, 1, StackedLSTMT<TestType, 1, 16, 2>, DenseT<TestType, 16, 1>>,
+        ModelT<TestType, 1, 1, LSTMLayerT<TestType, 1, 16>, LSTMLayerT<TestType, 16, 16>, DenseT<TestType, 16, 1>>>(16, 2);
+
+    result |= compare_models<4,
+        ModelT<TestType, 4, 1, StackedLSTMT<TestType, 4, 12, 3>, DenseT<TestType, 12, 1>>,
+        ModelT<TestType, 4, 1, LSTMLayerT<TestType, 4, 12>, LSTMLayerT<TestType, 12, 12>, LSTMLayerT<TestType, 12, 12>, DenseT<TestType, 12, 1>>>(12, 3);
+
+    if(result != 0)
+    {
+        std::cout << "FAIL!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "SUCCESS" << std::endl;
+    return 0;
+}
+
+} // namespace stacked_lstm_test
@@ -0,0 +1,201 @@
+#pragma once
+
+#include "json_fixtures.hpp"
+#include <RTNeural.h>
+#include <iostream>
+#include <random>
+
+namespace sub_rate_test
+{
+
+using TestType = double;
+
+constexpr int hidden_size = 8;
+constexpr int num_samples = 2048;
+
+using json_fixtures::dense_json;
+using json_fixtures::cifg_lstm_json;
+using json_fixtures::lstm_json;
+
+/** Creates a model json with LSTM(1 -> hidden_size) -> Dense(hidden_size -> 2), where the LSTM may be a CIFG LSTM. */
+nlohmann::json lstm_model_json(bool cifg = false)
+{
+    std::default_random_engine generator;
+
+    nlohmann::json model;
+    model["in_shape"] = { nullptr, nullptr, 1 };
+    model["layers"] = { cifg ? cifg_lstm_json(generator, 1, hidden_size) : lstm_json(generator, 1, hidden_size),
+        dense_json(generator, hidden_size, 2, "") };
+    return model;
+}
+
+template <template <typename, int, int, RTNeural::SampleRateCorrectionMode> class LSTMType,
+    RTNeural::SampleRateCorrectionMode mode = RTNeural::SampleRateCorrectionMode::None>
+using LSTMModelType = RTNeural::ModelT<TestType, 1, 2,
+    LSTMType<TestType, 1, hidden_size, mode>,
+    RTNeural::DenseT<TestType, hidden_size, 2>>;
+
+template <RTNeural::SampleRateCorrectionMode mode = RTNeural::SampleRateCorrectionMode::None>
+using ModelType = LSTMModelType<RTNeural::LSTMLayerT, mode>;
+
+std::vector<TestType> test_signal()
+{
+    std::default_random_engine generator;
+    std::uniform_real_distribution<TestType> distribution(-1.0, 1.0);
+    std::vector<TestType> x(num_samples);
+    for(auto& sample : x)
+        sample = distribution(generator);
+    return x;
+}
+
+/** Runs the reference model on the block averages of the input, and returns the outputs of each step. */
+template <typename ReferenceModel>
+std::vector<TestType> process_reference(ReferenceModel& model, const std::vector<TestType>& x, int factor)
+{
+    std::vector<TestType> y;
+    for(size_t n = 0; n + (size_t)factor <= x.size(); n += (size_t)factor)
+    {
+        TestType mean = 0.0;
+        for(int i = 0; i < factor; ++i)
+            mean += x[n + (size_t)i];
+        mean /= (TestType)factor;
+
+        model.forward(&mean);
+        y.push_back(model.getOutputs()[0]);
+        y.push_back(model.getOutputs()[1]);
+    }
+    return y;
+}
+
+/**
+ * Checks that the sub-rate outputs pass through the reference model
+ * outputs (delayed by one model step for cubic interpolation), and stay
+ * within the range of the neighbouring steps for linear interpolation.
+ */
+template <typename SubRateType>
+int check_outputs(SubRateType& subRate, const std::vector<TestType>& x, const std::vector<TestType>& yRef, const std::string& test_name)
+{
+    constexpr double threshold = 1.0e-12;
+    const auto factor = subRate.factor;
+    const auto delaySteps = subRate.interpolation == RTNeural::SubRateInterpolation::Linear ? 0 : 1;
+
+    size_t nErrs = 0;
+    for(size_t n = 0; n < x.size(); ++n)
+    {
+        subRate.forward(&x[n]);
+
+        // the output reaches the most recent model step one sample before the next step
+        const auto step = (int)((n + 1) / (size_t)factor) - 1 - delaySteps;
+        const auto reachesStep = (n + 2) % (size_t)factor == 0;
+        for(int i = 0; i < 2; ++i)
+        {
+            const auto yCurrent = step < 0 ? 0.0 : yRef[(size_t)(2 * step + i)];
+            const auto yPrevious = step < 1 ? 0.0 : yRef[(size_t)(2 * (step - 1) + i)];
+            const auto out = subRate.getOutputs()[i];
+
+            if(reachesStep && std::abs(out - yCurrent) > threshold)
+                nErrs++;
+
+            if(delaySteps == 0 && (out > std::max(yCurrent, yPrevious) + threshold || out < std::min(yCurrent, yPrevious) - threshold))
+                nErrs++;
+        }
+    }
+
+    if(subRate.getNumModelSteps() != x.size() / (size_t)factor)
+        nErrs++;
+
+    if(nErrs > 0)
+    {
+        std::cout << "  " << test_name << " FAIL: " << nErrs << " errors!" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+template <RTNeural::SubRateInterpolation interpolation>
+int sub_rate_interpolation_test(const std::vector<TestType>& x, int factor, const std::string& test_name)
+{
+    const auto modelJson = lstm_model_json();
+
+    ModelType<> model;
+    model.parseJson(modelJson);
+    RTNeural::SubRateModel<TestType, ModelType<>> subRate { model, 1, 2, factor, interpolation };
+    subRate.reset();
+
+    ModelType<> refModel;
+    refModel.parseJson(modelJson);
+    refModel.reset();
+    const auto yRef = process_reference(refModel, x, factor);
+
+    return check_outputs(subRate, x, yRef, test_name);
+}
+
+/** Checks that preparing the sub-rate model sets up the LSTM sample rate correction. */
+template <template <typename, int, int, RTNeural::SampleRateCorrectionMode> class LSTMType>
+int sub_rate_correction_test(const std::vector<TestType>& x, bool cifg, const std::string& test_name)
+{
+    constexpr double trainedSampleRate = 12000.0;
+    constexpr double hostSampleRate = 96000.0;
+    constexpr int factor = 4; // model runs at 24 kHz, so the LSTM delay should be 2 steps
+
+    const auto modelJson = lstm_model_json(cifg);
+
+    using CorrectedModel = LSTMModelType<LSTMType, RTNeural::SampleRateCorrectionMode::NoInterp>;
+    CorrectedModel model;
+    model.parseJson(modelJson);
+    RTNeural::SubRateModel<TestType, CorrectedModel> subRate { model, 1, 2, factor };
+    subRate.prepare(hostSampleRate, trainedSampleRate);
+
+    CorrectedModel refModel;
+    refModel.parseJson(modelJson);
+    refModel.template get<0>().prepare(2);
+    const auto yRef = process_reference(refModel, x, factor);
+
+    // the corrected model should not match the uncorrected one
+    LSTMModelType<LSTMType> uncorrectedModel;
+    uncorrectedModel.parseJson(modelJson);
+    uncorrectedModel.reset();
+    const auto yUncorrected = process_reference(uncorrectedModel, x, factor);
+    if(std::abs(yRef.back() - yUncorrected.back()) < 1.0e-6)
+    {
+        std::cout << "  " << test_name << " FAIL: the recurrent delay was not applied!" << std::endl;
+        return 1;
+    }
+
+    return check_outputs(subRate, x, yRef, test_name);
+}
+
+int sub_rate_test()
+{
+    std::cout << "TESTING SUB-RATE MODEL..." << std::endl;
+
+    const auto x = test_signal();
+    int result = 0;
+
+    using Interpolation = RTNeural::SubRateInterpolation;
+    result |= sub_rate_interpolation_test<Interpolation::Linear>(x, 1, "linear x1");
+    result |= sub_rate_interpolation_test<Interpolation::Linear>(x, 4, "linear x4");
+    result |= sub_rate_interpolation_test<Interpolation::Linear>(x, 32, "linear x32");
+    result |= sub_rate_interpolation_test<Interpolation::Cubic>(x, 4, "cubic x4");
+    result |= sub_rate_interpolation_test<Interpolation::Cubic>(x, 32, "cubic x32");
+    result |= sub_rate_correction_test<RTNeural::LSTMLayerT>(x, false, "sample rate correction");
+    result |= sub_rate_correction_test<RTNeural::CIFGLSTMLayerT>(x, true, "sample rate correction (CIFG)");
+
+    if(RTNeural::SubRateModel<TestType, ModelType<>>::getFactorForRate(48000.0, 2000.0) != 24)
+    {
+        std::cout << "  getFactorForRate FAIL!" << std::endl;
+        result |= 1;
+    }
+
+    if(result != 0)
+    {
+        std::cout << "FAIL!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "SUCCESS" << std::endl;
+    return 0;
+}
+
+} // namespace sub_rate_test
@@ -1,9 +1,31 @@
 #include "approx_tests.hpp"
 #include "bad_model_test.hpp"
+#include "batch_test.hpp"
+#include "bounded_model_test.hpp"
+#include "cascade_test.hpp"
+#include "cifg_lstm_test.hpp"
+#include "combinators_test.hpp"
 #include "conv2d_model.h"
+#include "dense_layout_test.hpp"
+#include "embedding_test.hpp"
+#include "film_test.hpp"
+#include "float_accuracy_test.hpp"
+#include "graph_model_test.hpp"
+#include "input_table_test.hpp"
 #include "load_csv.hpp"
+#include "lstm_dense_test.hpp"
 #include "model_test.hpp"
+#include "moe_test.hpp"
+#include "multi_head_test.hpp"
+#include "multirate_test.hpp"
+#include "pcm_test.hpp"
+#include "prefetch_test.hpp"
 #include "sample_rate_rnn_test.hpp"
+#include "small_signal_lstm_test.hpp"
+#include "snake_test.hpp"
+#include "spectral_test.hpp"
+#include "stacked_lstm_test.hpp"
+#include "sub_rate_test.hpp"
 #include "templated_tests.hpp"
 #include "test_configs.hpp"
 #include "util_tests.hpp"
@@ -22,6 +44,28 @@ void help()
     std::cout << "    approx" << std::endl;
     std::cout << "    sample_rate_rnn" << std::endl;
     std::cout << "    bad_model" << std::endl;
+    std::cout << "    batch" << std::endl;
+    std::cout << "    cascade" << std::endl;
+    std::cout << "    moe" << std::endl;
+    std::cout << "    combinators" << std::endl;
+    std::cout << "    sub_rate" << std::endl;
+    std::cout << "    stacked_lstm" << std::endl;
+    std::cout << "    lstm_dense" << std::endl;
+    std::cout << "    multi_head" << std::endl;
+    std::cout << "    dense_layout" << std::endl;
+    std::cout << "    film" << std::endl;
+    std::cout << "    multirate" << std::endl;
+    std::cout << "    spectral" << std::endl;
+    std::cout << "    bounded_model" << std::endl;
+    std::cout << "    graph_model" << std::endl;
+    std::cout << "    float_accuracy" << std::endl;
+    std::cout << "    prefetch" << std::endl;
+    std::cout << "    small_signal_lstm" << std::endl;
+    std::cout << "    input_table" << std::endl;
+    std::cout << "    embedding" << std::endl;
+    std::cout << "    pcm" << std::endl;
+    std::cout << "    cifg_lstm" << std::endl;
+    std::cout << "    snake" << std::endl;
     for(auto& testConfig : tests)
         std::cout << "    " << testConfig.first << std::endl;
     std::cout << "    conv2d" << std::endl;
@@ -107,6 +151,28 @@ int main(int argc, char* argv[])
         result |= approximationTests();
         result |= sampleRateRNNTest();
         result |= conv2d_test();
+        result |= batch_test::batch_model_test();
+        result |= cascade_test::cascade_model_test();
+        result |= moe_test::moe_test();
+        result |= combinators_test::combinators_test();
+        result |= sub_rate_test::sub_rate_test();
+        result |= stacked_lstm_test::stacked_lstm_test();
+        result |= lstm_dense_test::lstm_dense_test();
+        result |= multi_head_test::multi_head_test();
+        result |= dense_layout_test::dense_layout_test();
+        result |= film_test::film_test();
+        result |= multirate_test::multirate_test();
+        result |= spectral_test::spectral_test();
+        result |= bounded_model_test::bounded_model_test();
+        result |= graph_model_test::graph_model_test();
+        result |= float_accuracy_test::float_accuracy_test();
+        result |= prefetch_test::prefetch_test();
+        result |= small_signal_lstm_test::small_signal_lstm_test();
+        result |= input_table_test::input_table_test();
+        result |= embedding_test::embedding_test();
+        result |= pcm_test::pcm_test();
+        result |= cifg_lstm_test::cifg_lstm_test();
+        result |= snake_test::snake_test();
 
         for(auto& testConfig : tests)
         {
@@ -148,6 +214,116 @@ int main(int argc, char* argv[])
         return badModelTest();
     }
 
+    if(arg == "batch")
+    {
+        return batch_test::batch_model_test();
+    }
+
+    if(arg == "cascade")
+    {
+        return cascade_test::cascade_model_test();
+    }
+
+    if(arg == "moe")
+    {
+        return moe_test::moe_test();
+    }
+
+    if(arg == "combinators")
+    {
+        return combinators_test::combinators_test();
+    }
+
+    if(arg == "sub_rate")
+    {
+        return sub_rate_test::sub_rate_test();
+    }
+
+    if(arg == "stacked_lstm")
+    {
+        return stacked_lstm_test::stacked_lstm_test();
+    }
+
+    if(arg == "lstm_dense")
+    {
+        return lstm_dense_test::lstm_dense_test();
+    }
+
+    if(arg == "multi_head")
+    {
+        return multi_head_test::multi_head_test();
+    }
+
+    if(arg == "dense_layout")
+    {
+        return dense_layout_test::dense_layout_test();
+    }
+
+    if(arg == "film")
+    {
+        return film_test::film_test();
+    }
+
+    if(arg == "multirate")
+    {
+        return multirate_test::multirate_test();
+    }
+
+    if(arg == "spectral")
+    {
+        return spectral_test::spectral_test();
+    }
+
+    if(arg == "bounded_model")
+    {
+        return bounded_model_test::bounded_model_test();
+    }
+
+    if(arg == "graph_model")
+    {
+        return graph_model_test::graph_model_test();
+    }
+
+    if(arg == "float_accuracy")
+    {
+        return float_accuracy_test::float_accuracy_test();
+    }
+
+    if(arg == "prefetch")
+    {
+        return prefetch_test::prefetch_test();
+    }
+
+    if(arg == "small_signal_lstm")
+    {
+        return small_signal_lstm_test::small_signal_lstm_test();
+    }
+
+    if(arg == "input_table")
+    {
+        return input_table_test::input_table_test();
+    }
+
+    if(arg == "embedding")
+    {
+        return embedding_test::embedding_test();
+    }
+
+    if(arg == "pcm")
+    {
+        return pcm_test::pcm_test();
+    }
+
+    if(arg == "cifg_lstm")
+    {
+        return cifg_lstm_test::cifg_lstm_test();
+    }
+
+    if(arg == "snake")
+    {
+        return snake_test::snake_test();
+    }
+
 #if RTNEURAL_USE_EIGEN
     if(arg == "conv2d_model")
     {